@@ -3,6 +3,7 @@
 
 #include <tlRender/BakeApp/App.h>
 
+#include <tlRender/CPU/Render.h>
 #include <tlRender/GL/Render.h>
 
 #include <tlRender/Timeline/Util.h>
@@ -23,6 +24,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <fstream>
 
 namespace tl
 {
@@ -60,6 +62,28 @@ namespace tl
                 "Render",
                 std::optional<ftk::ImageType>(),
                 ftk::quotes(ftk::getImageTypeLabels()));
+            _cmdLine.renderer = ftk::CmdLineOption<RenderType>::create(
+                { "-renderer" },
+                "Renderer. The CPU renderer needs no display or graphics "
+                "card, for baking on machines that have neither.",
+                "Render",
+                RenderType::GL,
+                ftk::quotes(getRenderTypeLabels()));
+            _cmdLine.compare = ftk::CmdLineOption<std::string>::create(
+                { "-compare", "-c" },
+                "Compare the input against another timeline. The output is "
+                "the difference between the two, and the difference of each "
+                "frame is measured.",
+                "Compare");
+            _cmdLine.compareThreshold = ftk::CmdLineOption<float>::create(
+                { "-compareThreshold" },
+                "The error a pixel has to exceed to be counted as different.",
+                "Compare",
+                CompareOptions().differenceThreshold);
+            _cmdLine.compareStats = ftk::CmdLineOption<std::string>::create(
+                { "-compareStats" },
+                "Write the measurement of each frame to a JSON file.",
+                "Compare");
             // Offered only where there is something behind them: without
             // OCIO the color options are accepted and then quietly do
             // nothing, which reads as a broken build rather than one made
@@ -175,6 +199,12 @@ namespace tl
                 "Disk cache size in gigabytes. A size of zero disables the cache.",
                 "USD",
                 0);
+            _cmdLine.usdRenderThreadCount = ftk::CmdLineOption<int>::create(
+                { "-usdRenderThreadCount" },
+                "Number of frames to render at once. Each render thread has "
+                "its own OpenGL context; they share the disk cache.",
+                "USD",
+                static_cast<int>(usd::Options().renderThreadCount));
 #endif // TLRENDER_USD
 
             IApp::_init(
@@ -190,6 +220,10 @@ namespace tl
                     _cmdLine.inOutRange,
                     _cmdLine.renderSize,
                     _cmdLine.outputPixelType,
+                    _cmdLine.renderer,
+                    _cmdLine.compare,
+                    _cmdLine.compareThreshold,
+                    _cmdLine.compareStats,
 #if defined(TLRENDER_OCIO)
                     _cmdLine.ocioFileName,
                     _cmdLine.ocioInput,
@@ -218,6 +252,7 @@ namespace tl
                     _cmdLine.usdSRGB,
                     _cmdLine.usdStageCache,
                     _cmdLine.usdDiskCache,
+                    _cmdLine.usdRenderThreadCount,
 #endif // TLRENDER_USD
                 });
         }
@@ -241,12 +276,16 @@ namespace tl
         {
             _startTime = std::chrono::steady_clock::now();
 
-            // Create the window.
-            _window = ftk::gl::Window::create(
-                _context,
-                "tlbake",
-                ftk::Size2I(1, 1),
-                static_cast<int>(ftk::gl::WindowOptions::MakeCurrent));
+            // Create the window. The CPU renderer has no use for one.
+            const RenderType renderType = _cmdLine.renderer->getValue();
+            if (RenderType::GL == renderType)
+            {
+                _window = ftk::gl::Window::create(
+                    _context,
+                    "tlbake",
+                    ftk::Size2I(1, 1),
+                    static_cast<int>(ftk::gl::WindowOptions::MakeCurrent));
+            }
 
             // Read the timeline.
             Options options;
@@ -286,6 +325,18 @@ namespace tl
                 arg(_timeRange.start_time().value()).
                 arg(_timeRange.end_time_inclusive().value()));
             _inputTime = _timeRange.start_time();
+            _requestTime = _inputTime;
+            _videoRequestMax = _timeline->getVideoRequestMax();
+#if defined(TLRENDER_USD)
+            if (_cmdLine.usdRenderThreadCount->hasValue())
+            {
+                _videoRequestMax = std::max(
+                    _videoRequestMax,
+                    static_cast<size_t>(std::max(
+                        1,
+                        _cmdLine.usdRenderThreadCount->getValue())) * 2);
+            }
+#endif // TLRENDER_USD
             _outputTime = OTIO_NS::RationalTime(0.0, _timeRange.duration().rate());
 
             // Render information.
@@ -301,13 +352,46 @@ namespace tl
             }
             _print(ftk::Format("Render size: {0}").arg(_renderSize));
 
+            // Read the timeline to compare against.
+            if (_cmdLine.compare->hasValue())
+            {
+                ftk::Path compare(_cmdLine.compare->getValue());
+                const auto comparePaths = tl::getPaths(_context, compare, dirListOptions);
+                if (!comparePaths.empty())
+                {
+                    compare = comparePaths.front();
+                }
+                _compareTimeline = Timeline::create(_context, compare, options);
+                _compareOptions.compare = Compare::Difference;
+                _compareOptions.differenceStats = true;
+                if (_cmdLine.compareThreshold->hasValue())
+                {
+                    _compareOptions.differenceThreshold =
+                        _cmdLine.compareThreshold->getValue();
+                }
+                _compareStats = nlohmann::json::array();
+                _print(ftk::Format("Compare: {0}").arg(compare.get()));
+            }
+
             // Create the renderer.
-            _render = gl::Render::create(
-                _context->getLogSystem(),
-                _context->getSystem<ftk::FontSystem>());
-            _buffer = ftk::gl::OffscreenBuffer::create(
-                _renderSize,
-                ftk::gl::offscreenColorDefault);
+            switch (renderType)
+            {
+            case RenderType::CPU:
+                _cpuRender = cpu::Render::create(
+                    _context->getLogSystem(),
+                    _context->getSystem<ftk::FontSystem>());
+                _render = _cpuRender;
+                break;
+            default:
+                _render = gl::Render::create(
+                    _context->getLogSystem(),
+                    _context->getSystem<ftk::FontSystem>());
+                _buffer = ftk::gl::OffscreenBuffer::create(
+                    _renderSize,
+                    ftk::gl::offscreenColorDefault);
+                break;
+            }
+            _print(ftk::Format("Renderer: {0}").arg(renderType));
 
             // Set options. Before the writer: what the output's color
             // description says depends on whether the render goes through
@@ -444,6 +528,7 @@ namespace tl
 
             // Finish writing.
             _writer->finish();
+            _writeCompareStats();
 
             const size_t readErrorCount = _timeline->getReadErrorCount();
             if (readErrorCount > 0)
@@ -542,32 +627,22 @@ namespace tl
             if (_cmdLine.usdDiskCache->hasValue())
             {
                 std::stringstream ss;
-                ss << std::max(0, _cmdLine.usdDiskCache->getValue()) * ftk::gigabyte;
-                out["USD/DiskCacheByteCount"] = ss.str();
+                ss << std::max(0, _cmdLine.usdDiskCache->getValue());
+                out["USD/DiskCacheGB"] = ss.str();
+            }
+            if (_cmdLine.usdRenderThreadCount->hasValue())
+            {
+                std::stringstream ss;
+                ss << std::max(1, _cmdLine.usdRenderThreadCount->getValue());
+                out["USD/RenderThreadCount"] = ss.str();
             }
 #endif // TLRENDER_USD
 
             return out;
         }
 
-        void App::_tick()
+        void App::_readGL()
         {
-            _context->tick();
-
-            _printProgress();
-
-            // Render the video.
-            ftk::gl::OffscreenBufferBinding binding(_buffer);
-            _render->begin(_renderSize);
-            _render->setOCIOOptions(_ocioOptions);
-            _render->setLUTOptions(_lutOptions);
-            const auto videoData = _timeline->getVideo(_inputTime).future.get();
-            _render->drawVideo(
-                { videoData },
-                { ftk::Box2I(0, 0, _renderSize.w, _renderSize.h) });
-            _render->end();
-
-            // Write the frame.
             glPixelStorei(GL_PACK_ALIGNMENT, _outputInfo.layout.alignment);
 #if defined(FTK_API_GL_4_1)
             glPixelStorei(GL_PACK_SWAP_BYTES, _outputInfo.layout.endian != ftk::getEndian());
@@ -586,6 +661,108 @@ namespace tl
                 format,
                 type,
                 _outputImage->getData());
+        }
+
+        void App::_readCPU()
+        {
+            try
+            {
+                _cpuRender->copyImage(_outputImage);
+            }
+            catch (const std::exception&)
+            {
+                throw std::runtime_error(ftk::Format("Cannot write: \"{0}\"").arg(_cmdLine.output->getValue()));
+            }
+
+            // The swap glReadPixels() does with GL_PACK_SWAP_BYTES.
+            if (_outputInfo.layout.endian != ftk::getEndian())
+            {
+                const size_t bytes = ftk::getBitDepth(_outputInfo.type) / 8;
+                if (bytes > 1)
+                {
+                    uint8_t* data = _outputImage->getData();
+                    const size_t byteCount = _outputImage->getByteCount();
+                    for (size_t i = 0; i + bytes <= byteCount; i += bytes)
+                    {
+                        std::reverse(data + i, data + i + bytes);
+                    }
+                }
+            }
+        }
+
+        void App::_tick()
+        {
+            _context->tick();
+
+            _printProgress();
+
+            // Render the video.
+            std::unique_ptr<ftk::gl::OffscreenBufferBinding> binding;
+            if (_buffer)
+            {
+                binding.reset(new ftk::gl::OffscreenBufferBinding(_buffer));
+            }
+            _render->begin(_renderSize);
+            _render->setOCIOOptions(_ocioOptions);
+            _render->setLUTOptions(_lutOptions);
+            while (_videoRequests.size() < _videoRequestMax &&
+                _requestTime <= _timeRange.end_time_inclusive())
+            {
+                _videoRequests.push_back(_timeline->getVideo(_requestTime));
+                if (_compareTimeline)
+                {
+                    _compareRequests.push_back(_compareTimeline->getVideo(
+                        getCompareTime(
+                            _requestTime,
+                            _timeline->getTimeRange(),
+                            _compareTimeline->getTimeRange(),
+                            CompareTime::Relative)));
+                }
+                _requestTime += OTIO_NS::RationalTime(1, _requestTime.rate());
+            }
+            std::vector<VideoFrame> videoData;
+            videoData.push_back(_videoRequests.front().future.get());
+            _videoRequests.pop_front();
+            if (_compareTimeline)
+            {
+                videoData.push_back(_compareRequests.front().future.get());
+                _compareRequests.pop_front();
+            }
+            const ftk::Box2I box(0, 0, _renderSize.w, _renderSize.h);
+            _render->drawVideo(
+                videoData,
+                std::vector<ftk::Box2I>(videoData.size(), box),
+                {},
+                {},
+                _compareOptions);
+            _render->end();
+            if (_compareTimeline)
+            {
+                const CompareStats stats = _render->getCompareStats();
+                nlohmann::json json;
+                json["Time"] = _inputTime.value();
+                to_json(json["Stats"], stats);
+                _compareStats.push_back(json);
+                if (stats.valid)
+                {
+                    ++_compareFrames;
+                    if (stats.thresholdCount > 0)
+                    {
+                        ++_compareFramesDiffer;
+                    }
+                    _compareMaxError = std::max(_compareMaxError, stats.maxError);
+                }
+            }
+
+            // Write the frame.
+            if (_cpuRender)
+            {
+                _readCPU();
+            }
+            else
+            {
+                _readGL();
+            }
             // The time of the frame in the timeline, which is what
             // ioInfo.videoTime above describes. A sequence writer names each
             // file from it, so those keep the frame numbers of the timeline.
@@ -660,6 +837,27 @@ namespace tl
             }
         }
 
+        void App::_writeCompareStats()
+        {
+            if (!_compareTimeline)
+                return;
+
+            _print(ftk::Format("Compared frames: {0}").arg(_compareFrames));
+            _print(ftk::Format("Frames that differ: {0}").arg(_compareFramesDiffer));
+            _print(ftk::Format("Maximum error: {0}").arg(_compareMaxError));
+            if (_cmdLine.compareStats->hasValue())
+            {
+                const std::string fileName = _cmdLine.compareStats->getValue();
+                std::ofstream file(fileName);
+                file << _compareStats.dump(4);
+                if (!file)
+                {
+                    throw std::runtime_error(
+                        ftk::Format("Cannot write: \"{0}\"").arg(fileName));
+                }
+            }
+        }
+
         void App::_printProgress()
         {
             const int64_t c = static_cast<int64_t>(_inputTime.value() - _timeRange.start_time().value());
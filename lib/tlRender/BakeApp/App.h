@@ -19,6 +19,8 @@
 #include <ftk/GL/OffscreenBuffer.h>
 #include <ftk/Core/IApp.h>
 
+#include <list>
+
 namespace ftk
 {
     namespace gl
@@ -29,6 +31,11 @@ namespace ftk
 
 namespace tl
 {
+    namespace cpu
+    {
+        class Render;
+    }
+
     //! tlbake application
     namespace bake
     {
@@ -40,6 +47,10 @@ namespace tl
             std::shared_ptr<ftk::CmdLineOption<OTIO_NS::TimeRange> > inOutRange;
             std::shared_ptr<ftk::CmdLineOption<ftk::Size2I> > renderSize;
             std::shared_ptr<ftk::CmdLineOption<ftk::ImageType> > outputPixelType;
+            std::shared_ptr<ftk::CmdLineOption<RenderType> > renderer;
+            std::shared_ptr<ftk::CmdLineOption<std::string> > compare;
+            std::shared_ptr<ftk::CmdLineOption<float> > compareThreshold;
+            std::shared_ptr<ftk::CmdLineOption<std::string> > compareStats;
 #if defined(TLRENDER_OCIO)
             std::shared_ptr<ftk::CmdLineOption<std::string> > ocioFileName;
             std::shared_ptr<ftk::CmdLineOption<std::string> > ocioInput;
@@ -68,6 +79,7 @@ namespace tl
             std::shared_ptr<ftk::CmdLineOption<bool> > usdSRGB;
             std::shared_ptr<ftk::CmdLineOption<int> > usdStageCache;
             std::shared_ptr<ftk::CmdLineOption<int> > usdDiskCache;
+            std::shared_ptr<ftk::CmdLineOption<int> > usdRenderThreadCount;
 #endif // TLRENDER_USD
         };
 
@@ -97,7 +109,10 @@ namespace tl
             IOOptions _getIOOptions() const;
 
             void _tick();
+            void _readGL();
+            void _readCPU();
             void _writeAudio();
+            void _writeCompareStats();
             void _printProgress();
 
             CmdLine _cmdLine;
@@ -110,6 +125,23 @@ namespace tl
             OTIO_NS::TimeRange _timeRange;
             OTIO_NS::RationalTime _inputTime;
             OTIO_NS::RationalTime _outputTime;
+            //! Frames are asked for ahead of the one being written, so that
+            //! the readers have more than one to work on at a time. They are
+            //! written in the order they were asked for.
+            size_t _videoRequestMax = 1;
+            OTIO_NS::RationalTime _requestTime;
+            std::list<VideoRequest> _videoRequests;
+            //! The timeline the input is compared against, when baking the
+            //! difference between two. Its frames are asked for alongside
+            //! the input's, and the measurement of each is kept to be
+            //! written at the end.
+            std::shared_ptr<Timeline> _compareTimeline;
+            CompareOptions _compareOptions;
+            std::list<VideoRequest> _compareRequests;
+            nlohmann::json _compareStats;
+            size_t _compareFrames = 0;
+            size_t _compareFramesDiffer = 0;
+            float _compareMaxError = 0.F;
             bool _hasAudio = false;
             double _audioStartSeconds = 0.0;
             double _audioDurationSeconds = 0.0;
@@ -119,6 +151,9 @@ namespace tl
             std::shared_ptr<ftk::gl::Window> _window;
             std::shared_ptr<IIOPlugin> _usdPlugin;
             std::shared_ptr<IRender> _render;
+            //! The software renderer, when that is what renders; there is
+            //! then no window and no buffer.
+            std::shared_ptr<cpu::Render> _cpuRender;
             std::shared_ptr<ftk::gl::OffscreenBuffer> _buffer;
 
             std::shared_ptr<IWritePlugin> _writerPlugin;
@@ -0,0 +1,1197 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/CPU/RenderPrivate.h>
+
+#include <ftk/Core/Format.h>
+#include <ftk/Core/LogSystem.h>
+
+#include <Imath/half.h>
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace tl
+{
+    namespace cpu
+    {
+        void Buffer::resize(const ftk::Size2I& value)
+        {
+            if (value == size)
+                return;
+            size = value;
+            data.resize(static_cast<size_t>(std::max(0, size.w)) *
+                std::max(0, size.h) * 4);
+        }
+
+        void Buffer::clear(const ftk::Color4F& color)
+        {
+            const size_t count = static_cast<size_t>(size.w) * size.h;
+            for (size_t i = 0; i < count; ++i)
+            {
+                float* p = data.data() + i * 4;
+                p[0] = color.r;
+                p[1] = color.g;
+                p[2] = color.b;
+                p[3] = color.a;
+            }
+        }
+
+        void parallelRows(
+            int y0,
+            int y1,
+            size_t threadCount,
+            const std::function<void(int, int)>& fn)
+        {
+            const int rows = y1 - y0;
+            if (rows <= 0)
+                return;
+
+            // Bands of fewer rows than this cost more to start a thread for
+            // than they save.
+            const int bandMin = 16;
+            const size_t count = std::max(
+                static_cast<size_t>(1),
+                std::min(
+                    threadCount,
+                    static_cast<size_t>((rows + bandMin - 1) / bandMin)));
+            if (1 == count)
+            {
+                fn(y0, y1);
+                return;
+            }
+            const int band = (rows + static_cast<int>(count) - 1) / static_cast<int>(count);
+            std::vector<std::thread> threads;
+            threads.reserve(count - 1);
+            for (size_t i = 1; i < count; ++i)
+            {
+                const int a = y0 + static_cast<int>(i) * band;
+                const int b = std::min(y1, a + band);
+                if (a < b)
+                {
+                    threads.push_back(std::thread([&fn, a, b] { fn(a, b); }));
+                }
+            }
+            fn(y0, std::min(y1, y0 + band));
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+        }
+
+        namespace
+        {
+            enum class Component
+            {
+                U8,
+                U16,
+                U32,
+                F16,
+                F32
+            };
+
+            //! The layout of the pixel types whose channels are packed
+            //! together.
+            bool getPacked(ftk::ImageType type, int& channels, Component& component)
+            {
+                bool out = true;
+                switch (type)
+                {
+                case ftk::ImageType::L_U8: channels = 1; component = Component::U8; break;
+                case ftk::ImageType::L_U16: channels = 1; component = Component::U16; break;
+                case ftk::ImageType::L_U32: channels = 1; component = Component::U32; break;
+                case ftk::ImageType::L_F16: channels = 1; component = Component::F16; break;
+                case ftk::ImageType::L_F32: channels = 1; component = Component::F32; break;
+                case ftk::ImageType::LA_U8: channels = 2; component = Component::U8; break;
+                case ftk::ImageType::LA_U16: channels = 2; component = Component::U16; break;
+                case ftk::ImageType::LA_U32: channels = 2; component = Component::U32; break;
+                case ftk::ImageType::LA_F16: channels = 2; component = Component::F16; break;
+                case ftk::ImageType::LA_F32: channels = 2; component = Component::F32; break;
+                case ftk::ImageType::RGB_U8: channels = 3; component = Component::U8; break;
+                case ftk::ImageType::RGB_U16: channels = 3; component = Component::U16; break;
+                case ftk::ImageType::RGB_U32: channels = 3; component = Component::U32; break;
+                case ftk::ImageType::RGB_F16: channels = 3; component = Component::F16; break;
+                case ftk::ImageType::RGB_F32: channels = 3; component = Component::F32; break;
+                case ftk::ImageType::RGBA_U8: channels = 4; component = Component::U8; break;
+                case ftk::ImageType::RGBA_U16: channels = 4; component = Component::U16; break;
+                case ftk::ImageType::RGBA_U32: channels = 4; component = Component::U32; break;
+                case ftk::ImageType::RGBA_F16: channels = 4; component = Component::F16; break;
+                case ftk::ImageType::RGBA_F32: channels = 4; component = Component::F32; break;
+                default: out = false; break;
+                }
+                return out;
+            }
+
+            // The loops are over plain arrays of one type so that the
+            // compiler can vectorize them.
+            template<typename T, typename F>
+            void readRow(const uint8_t* in, int channels, int w, F&& convert, float* out)
+            {
+                const T* p = reinterpret_cast<const T*>(in);
+                switch (channels)
+                {
+                case 1:
+                    for (int x = 0; x < w; ++x, out += 4)
+                    {
+                        const float l = convert(p[x]);
+                        out[0] = l;
+                        out[1] = l;
+                        out[2] = l;
+                        out[3] = 1.F;
+                    }
+                    break;
+                case 2:
+                    for (int x = 0; x < w; ++x, p += 2, out += 4)
+                    {
+                        const float l = convert(p[0]);
+                        out[0] = l;
+                        out[1] = l;
+                        out[2] = l;
+                        out[3] = convert(p[1]);
+                    }
+                    break;
+                case 3:
+                    for (int x = 0; x < w; ++x, p += 3, out += 4)
+                    {
+                        out[0] = convert(p[0]);
+                        out[1] = convert(p[1]);
+                        out[2] = convert(p[2]);
+                        out[3] = 1.F;
+                    }
+                    break;
+                case 4:
+                    for (int x = 0; x < w * 4; ++x)
+                    {
+                        out[x] = convert(p[x]);
+                    }
+                    break;
+                default: break;
+                }
+            }
+
+            void readRow(const uint8_t* in, int channels, Component component, int w, float* out)
+            {
+                switch (component)
+                {
+                case Component::U8:
+                    readRow<uint8_t>(in, channels, w, [](uint8_t v) { return v / 255.F; }, out);
+                    break;
+                case Component::U16:
+                    readRow<uint16_t>(in, channels, w, [](uint16_t v) { return v / 65535.F; }, out);
+                    break;
+                case Component::U32:
+                    readRow<uint32_t>(in, channels, w, [](uint32_t v) { return static_cast<float>(v / 4294967295.0); }, out);
+                    break;
+                case Component::F16:
+                    readRow<uint16_t>(in, channels, w, [](uint16_t v)
+                        {
+                            Imath::half h;
+                            h.setBits(v);
+                            return static_cast<float>(h);
+                        }, out);
+                    break;
+                case Component::F32:
+                    readRow<float>(in, channels, w, [](float v) { return v; }, out);
+                    break;
+                default: break;
+                }
+            }
+
+            template<typename T, typename F>
+            void writeRow(const float* in, int channels, int w, F&& convert, uint8_t* out)
+            {
+                T* p = reinterpret_cast<T*>(out);
+                switch (channels)
+                {
+                case 1:
+                    for (int x = 0; x < w; ++x, in += 4)
+                    {
+                        p[x] = convert(in[0]);
+                    }
+                    break;
+                case 2:
+                    for (int x = 0; x < w; ++x, in += 4, p += 2)
+                    {
+                        p[0] = convert(in[0]);
+                        p[1] = convert(in[3]);
+                    }
+                    break;
+                case 3:
+                    for (int x = 0; x < w; ++x, in += 4, p += 3)
+                    {
+                        p[0] = convert(in[0]);
+                        p[1] = convert(in[1]);
+                        p[2] = convert(in[2]);
+                    }
+                    break;
+                case 4:
+                    for (int x = 0; x < w * 4; ++x)
+                    {
+                        p[x] = convert(in[x]);
+                    }
+                    break;
+                default: break;
+                }
+            }
+
+            void writeRow(const float* in, int channels, Component component, int w, uint8_t* out)
+            {
+                switch (component)
+                {
+                case Component::U8:
+                    writeRow<uint8_t>(in, channels, w, [](float v)
+                        {
+                            return static_cast<uint8_t>(std::min(std::max(v, 0.F), 1.F) * 255.F + .5F);
+                        }, out);
+                    break;
+                case Component::U16:
+                    writeRow<uint16_t>(in, channels, w, [](float v)
+                        {
+                            return static_cast<uint16_t>(std::min(std::max(v, 0.F), 1.F) * 65535.F + .5F);
+                        }, out);
+                    break;
+                case Component::U32:
+                    writeRow<uint32_t>(in, channels, w, [](float v)
+                        {
+                            return static_cast<uint32_t>(std::min(std::max(v, 0.F), 1.F) * 4294967295.0 + .5);
+                        }, out);
+                    break;
+                case Component::F16:
+                    writeRow<uint16_t>(in, channels, w, [](float v)
+                        {
+                            return Imath::half(v).bits();
+                        }, out);
+                    break;
+                case Component::F32:
+                    writeRow<float>(in, channels, w, [](float v) { return v; }, out);
+                    break;
+                default: break;
+                }
+            }
+
+            //! Read a row of planar or semi-planar Y'CbCr.
+            void readYUVRow(
+                const ftk::ImageInfo& info,
+                const uint8_t* data,
+                int y,
+                float* out)
+            {
+                bool semiPlanar = false;
+                bool u16 = false;
+                int xs = 1;
+                int ys = 1;
+                switch (info.type)
+                {
+                case ftk::ImageType::YUV_420P_U8: xs = 2; ys = 2; break;
+                case ftk::ImageType::YUV_422P_U8: xs = 2; break;
+                case ftk::ImageType::YUV_444P_U8: break;
+                case ftk::ImageType::YUV_420P_U16: xs = 2; ys = 2; u16 = true; break;
+                case ftk::ImageType::YUV_422P_U16: xs = 2; u16 = true; break;
+                case ftk::ImageType::YUV_444P_U16: u16 = true; break;
+                case ftk::ImageType::YUV_420SP_U8: xs = 2; ys = 2; semiPlanar = true; break;
+                case ftk::ImageType::YUV_420SP_U16: xs = 2; ys = 2; semiPlanar = true; u16 = true; break;
+                default: break;
+                }
+                const int w = info.size.w;
+                const int h = info.size.h;
+                const int cw = std::max(1, w / xs);
+                const int ch = std::max(1, h / ys);
+                const size_t bytes = u16 ? 2 : 1;
+                const uint8_t* yPlane = data;
+                const uint8_t* uPlane = yPlane + static_cast<size_t>(w) * h * bytes;
+                const uint8_t* vPlane = uPlane + static_cast<size_t>(cw) * ch * bytes;
+                const int cy = std::min(y / ys, ch - 1);
+                const auto get = [u16](const uint8_t* p, size_t i)
+                {
+                    return u16 ?
+                        reinterpret_cast<const uint16_t*>(p)[i] / 65535.F :
+                        p[i] / 255.F;
+                };
+
+                // The coefficients are the luma weights of red and blue.
+                float kr = .2126F;
+                float kb = .0722F;
+                if (ftk::YUVCoefficients::BT2020 == info.yuvCoefficients)
+                {
+                    kr = .2627F;
+                    kb = .0593F;
+                }
+                const float kg = 1.F - kr - kb;
+                const bool legal = ftk::VideoLevels::LegalRange == info.videoLevels;
+                const float yOffset = legal ? 16.F / 255.F : 0.F;
+                const float yScale = legal ? 255.F / 219.F : 1.F;
+                const float cOffset = 128.F / 255.F;
+                const float cScale = legal ? 255.F / 224.F : 1.F;
+                for (int x = 0; x < w; ++x, out += 4)
+                {
+                    const int cx = std::min(x / xs, cw - 1);
+                    const float yv = (get(yPlane, static_cast<size_t>(y) * w + x) - yOffset) * yScale;
+                    float cb = 0.F;
+                    float cr = 0.F;
+                    if (semiPlanar)
+                    {
+                        const size_t i = (static_cast<size_t>(cy) * cw + cx) * 2;
+                        cb = get(uPlane, i);
+                        cr = get(uPlane, i + 1);
+                    }
+                    else
+                    {
+                        const size_t i = static_cast<size_t>(cy) * cw + cx;
+                        cb = get(uPlane, i);
+                        cr = get(vPlane, i);
+                    }
+                    cb = (cb - cOffset) * cScale;
+                    cr = (cr - cOffset) * cScale;
+                    const float r = yv + 2.F * (1.F - kr) * cr;
+                    const float b = yv + 2.F * (1.F - kb) * cb;
+                    out[0] = r;
+                    out[1] = (yv - kr * r - kb * b) / kg;
+                    out[2] = b;
+                    out[3] = 1.F;
+                }
+            }
+
+            bool isYUV(ftk::ImageType type)
+            {
+                switch (type)
+                {
+                case ftk::ImageType::YUV_420P_U8:
+                case ftk::ImageType::YUV_422P_U8:
+                case ftk::ImageType::YUV_444P_U8:
+                case ftk::ImageType::YUV_420P_U16:
+                case ftk::ImageType::YUV_422P_U16:
+                case ftk::ImageType::YUV_444P_U16:
+                case ftk::ImageType::YUV_420SP_U8:
+                case ftk::ImageType::YUV_420SP_U16:
+                    return true;
+                default: break;
+                }
+                return false;
+            }
+        }
+
+        bool toBuffer(
+            const std::shared_ptr<ftk::Image>& image,
+            Buffer& buffer,
+            size_t threadCount)
+        {
+            if (!image || !image->isValid())
+                return false;
+            const ftk::ImageInfo& info = image->getInfo();
+            int channels = 0;
+            Component component = Component::U8;
+            const bool packed = getPacked(info.type, channels, component);
+            const bool yuv = isYUV(info.type);
+            if (!packed && !yuv)
+                return false;
+
+            buffer.resize(info.size);
+            const uint8_t* data = image->getData();
+            // Rows may be padded out to the alignment.
+            const size_t stride = image->getByteCount() / std::max(1, info.size.h);
+            parallelRows(
+                0,
+                info.size.h,
+                threadCount,
+                [&](int y0, int y1)
+                {
+                    for (int y = y0; y < y1; ++y)
+                    {
+                        if (packed)
+                        {
+                            readRow(
+                                data + y * stride,
+                                channels,
+                                component,
+                                info.size.w,
+                                buffer.getRow(y));
+                        }
+                        else
+                        {
+                            readYUVRow(info, data, y, buffer.getRow(y));
+                        }
+                    }
+                });
+            return true;
+        }
+
+        namespace
+        {
+            inline int clampi(int value, int min, int max)
+            {
+                return value < min ? min : (value > max ? max : value);
+            }
+
+            float mitchell(float x)
+            {
+                const float b = 1.F / 3.F;
+                const float c = 1.F / 3.F;
+                x = std::fabs(x);
+                const float x2 = x * x;
+                const float x3 = x2 * x;
+                if (x < 1.F)
+                {
+                    return ((12.F - 9.F * b - 6.F * c) * x3 +
+                        (-18.F + 12.F * b + 6.F * c) * x2 +
+                        (6.F - 2.F * b)) / 6.F;
+                }
+                if (x < 2.F)
+                {
+                    return ((-b - 6.F * c) * x3 +
+                        (6.F * b + 30.F * c) * x2 +
+                        (-12.F * b - 48.F * c) * x +
+                        (8.F * b + 24.F * c)) / 6.F;
+                }
+                return 0.F;
+            }
+        }
+
+        void sampleNearest(const Buffer& buffer, float x, float y, float* out)
+        {
+            const int ix = clampi(static_cast<int>(std::floor(x)), 0, buffer.size.w - 1);
+            const int iy = clampi(static_cast<int>(std::floor(y)), 0, buffer.size.h - 1);
+            const float* p = buffer.getRow(iy) + ix * 4;
+            out[0] = p[0];
+            out[1] = p[1];
+            out[2] = p[2];
+            out[3] = p[3];
+        }
+
+        void sampleLinear(const Buffer& buffer, float x, float y, float* out)
+        {
+            const float fx = x - .5F;
+            const float fy = y - .5F;
+            const float x0f = std::floor(fx);
+            const float y0f = std::floor(fy);
+            const float tx = fx - x0f;
+            const float ty = fy - y0f;
+            const int x0 = clampi(static_cast<int>(x0f), 0, buffer.size.w - 1);
+            const int x1 = clampi(static_cast<int>(x0f) + 1, 0, buffer.size.w - 1);
+            const int y0 = clampi(static_cast<int>(y0f), 0, buffer.size.h - 1);
+            const int y1 = clampi(static_cast<int>(y0f) + 1, 0, buffer.size.h - 1);
+            const float* r0 = buffer.getRow(y0);
+            const float* r1 = buffer.getRow(y1);
+            for (int c = 0; c < 4; ++c)
+            {
+                const float a = r0[x0 * 4 + c] + (r0[x1 * 4 + c] - r0[x0 * 4 + c]) * tx;
+                const float b = r1[x0 * 4 + c] + (r1[x1 * 4 + c] - r1[x0 * 4 + c]) * tx;
+                out[c] = a + (b - a) * ty;
+            }
+        }
+
+        void sampleMitchell(const Buffer& buffer, float x, float y, float* out)
+        {
+            const float fx = x - .5F;
+            const float fy = y - .5F;
+            const float bx = std::floor(fx);
+            const float by = std::floor(fy);
+            float c[4] = { 0.F, 0.F, 0.F, 0.F };
+            float total = 0.F;
+            for (int j = -1; j <= 2; ++j)
+            {
+                const float wy = mitchell(j - (fy - by));
+                const float* row = buffer.getRow(
+                    clampi(static_cast<int>(by) + j, 0, buffer.size.h - 1));
+                for (int i = -1; i <= 2; ++i)
+                {
+                    const float w = mitchell(i - (fx - bx)) * wy;
+                    const float* p = row + clampi(static_cast<int>(bx) + i, 0, buffer.size.w - 1) * 4;
+                    c[0] += w * p[0];
+                    c[1] += w * p[1];
+                    c[2] += w * p[2];
+                    c[3] += w * p[3];
+                    total += w;
+                }
+            }
+            const float s = total > 0.F ? 1.F / total : 1.F;
+            out[0] = c[0] * s;
+            out[1] = c[1] * s;
+            out[2] = c[2] * s;
+            out[3] = c[3] * s;
+        }
+
+        void sampleArea(
+            const Buffer& buffer,
+            float x,
+            float y,
+            float scaleX,
+            float scaleY,
+            float* out)
+        {
+            // The texels under the pixel, each weighed by how much of it
+            // the pixel covers.
+            const float hx = .5F / std::min(1.F, scaleX);
+            const float hy = .5F / std::min(1.F, scaleY);
+            const float x0 = x - hx;
+            const float x1 = x + hx;
+            const float y0 = y - hy;
+            const float y1 = y + hy;
+            float c[4] = { 0.F, 0.F, 0.F, 0.F };
+            float total = 0.F;
+            for (int j = static_cast<int>(std::floor(y0)); j < static_cast<int>(std::ceil(y1)); ++j)
+            {
+                const float wy = std::min(y1, j + 1.F) - std::max(y0, static_cast<float>(j));
+                const float* row = buffer.getRow(clampi(j, 0, buffer.size.h - 1));
+                for (int i = static_cast<int>(std::floor(x0)); i < static_cast<int>(std::ceil(x1)); ++i)
+                {
+                    const float w = (std::min(x1, i + 1.F) - std::max(x0, static_cast<float>(i))) * wy;
+                    const float* p = row + clampi(i, 0, buffer.size.w - 1) * 4;
+                    c[0] += w * p[0];
+                    c[1] += w * p[1];
+                    c[2] += w * p[2];
+                    c[3] += w * p[3];
+                    total += w;
+                }
+            }
+            const float s = total > 0.F ? 1.F / total : 1.F;
+            out[0] = c[0] * s;
+            out[1] = c[1] * s;
+            out[2] = c[2] * s;
+            out[3] = c[3] * s;
+        }
+
+        void sample(
+            const Buffer& buffer,
+            float x,
+            float y,
+            float scaleX,
+            float scaleY,
+            const ftk::ImageFilters& filters,
+            float* out)
+        {
+            const bool minify = scaleX < 1.F || scaleY < 1.F;
+            const ftk::ImageFilter filter = minify ? filters.minify : filters.magnify;
+            switch (filter)
+            {
+            case ftk::ImageFilter::Nearest:
+                sampleNearest(buffer, x, y, out);
+                break;
+            case ftk::ImageFilter::HighQuality:
+                if (minify)
+                {
+                    sampleArea(buffer, x, y, scaleX, scaleY, out);
+                }
+                else
+                {
+                    sampleMitchell(buffer, x, y, out);
+                }
+                break;
+            default:
+                sampleLinear(buffer, x, y, out);
+                break;
+            }
+        }
+
+#if defined(TLRENDER_OCIO)
+        void ocioApply(const OCIO::ConstCPUProcessorRcPtr& processor, float* data, int count)
+        {
+            if (processor && count > 0)
+            {
+                OCIO::PackedImageDesc desc(data, count, 1, 4);
+                processor->apply(desc);
+            }
+        }
+
+        namespace
+        {
+            // As the OpenGL renderer's, with processors for the CPU.
+            void ocioDataInit(OCIOData& data, const OCIOOptions& options)
+            {
+                switch (options.config)
+                {
+                case OCIOConfig::BuiltIn:
+                    data.config = OCIO::Config::CreateFromFile("ocio://default");
+                    break;
+                case OCIOConfig::EnvVar:
+                    data.config = OCIO::Config::CreateFromEnv();
+                    break;
+                case OCIOConfig::File:
+                    if (!options.fileName.empty())
+                    {
+                        data.config = OCIO::Config::CreateFromFile(options.fileName.c_str());
+                    }
+                    break;
+                default: break;
+                }
+                if (!data.config)
+                {
+                    throw std::runtime_error("Cannot get OCIO configuration");
+                }
+
+                std::string displaySrc = options.input;
+                if (data.config->hasRole(OCIO::ROLE_SCENE_LINEAR))
+                {
+                    const auto processor = data.config->getProcessor(
+                        options.input.c_str(),
+                        OCIO::ROLE_SCENE_LINEAR);
+                    if (!processor)
+                    {
+                        throw std::runtime_error("Cannot get OCIO processor");
+                    }
+                    data.toLinear = processor->getDefaultCPUProcessor();
+                    displaySrc = OCIO::ROLE_SCENE_LINEAR;
+                }
+
+                data.transform = OCIO::DisplayViewTransform::Create();
+                if (!data.transform)
+                {
+                    throw std::runtime_error("Cannot create OCIO transform");
+                }
+                data.transform->setSrc(displaySrc.c_str());
+                data.transform->setDisplay(options.display.c_str());
+                data.transform->setView(options.view.c_str());
+
+                data.lvp = OCIO::LegacyViewingPipeline::Create();
+                if (!data.lvp)
+                {
+                    throw std::runtime_error("Cannot create OCIO viewing pipeline");
+                }
+                data.lvp->setDisplayViewTransform(data.transform);
+                data.lvp->setLooksOverrideEnabled(true);
+                data.lvp->setLooksOverride(options.look.c_str());
+
+                const auto processor = data.lvp->getProcessor(
+                    data.config,
+                    data.config->getCurrentContext());
+                if (!processor)
+                {
+                    throw std::runtime_error("Cannot get OCIO processor");
+                }
+                data.display = processor->getDefaultCPUProcessor();
+                if (!data.display)
+                {
+                    throw std::runtime_error("Cannot get OCIO CPU processor");
+                }
+            }
+        }
+
+        std::shared_ptr<OCIOData> Render::Private::getOCIOData(const std::string& input)
+        {
+            // As the OpenGL renderer: an input that cannot be built is
+            // remembered as empty and drawn without color management.
+            auto i = ocioData.find(input);
+            if (i == ocioData.end())
+            {
+                auto data = std::make_shared<OCIOData>();
+                try
+                {
+                    OCIOOptions options = ocioOptions;
+                    options.input = input;
+                    ocioDataInit(*data, options);
+                }
+                catch (const std::exception&)
+                {
+                    data.reset();
+                }
+                i = ocioData.insert(std::make_pair(input, data)).first;
+            }
+            return i->second;
+        }
+#endif // TLRENDER_OCIO
+
+        size_t Render::Private::getThreadCount() const
+        {
+            return threadCount > 0 ?
+                threadCount :
+                std::max(1U, std::thread::hardware_concurrency());
+        }
+
+        ftk::V2F Render::Private::toPixels(const ftk::M44F& m, const ftk::V2F& v) const
+        {
+            const ftk::V3F n = m * ftk::V3F(v.x, v.y, 0.F);
+            const int h = target ? target->size.h : 0;
+            return ftk::V2F(
+                viewport.min.x + (n.x + 1.F) * .5F * viewport.w(),
+                (h - viewport.h() - viewport.min.y) + (n.y + 1.F) * .5F * viewport.h());
+        }
+
+        ftk::Box2I Render::Private::getBounds() const
+        {
+            if (!target)
+                return ftk::Box2I();
+            const int h = target->size.h;
+            // The viewport and clip rectangle count rows from the top, the
+            // target from the bottom.
+            int x0 = std::max(0, viewport.min.x);
+            int y0 = std::max(0, h - viewport.h() - viewport.min.y);
+            int x1 = std::min(target->size.w, viewport.min.x + viewport.w());
+            int y1 = std::min(h, h - viewport.min.y);
+            if (clipRectEnabled)
+            {
+                x0 = std::max(x0, clipRect.min.x);
+                y0 = std::max(y0, h - clipRect.h() - clipRect.min.y);
+                x1 = std::min(x1, clipRect.min.x + clipRect.w());
+                y1 = std::min(y1, h - clipRect.min.y);
+            }
+            // Empty boxes have a maximum below their minimum.
+            return ftk::Box2I(ftk::V2I(x0, y0), ftk::V2I(x1 - 1, y1 - 1));
+        }
+
+        namespace
+        {
+            inline float edge(const ftk::V2F& a, const ftk::V2F& b, float x, float y)
+            {
+                return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+            }
+
+            // Whether pixels exactly on an edge belong to the triangle, so
+            // that triangles sharing it do not both draw them. With the
+            // corners counter clockwise and rows counted from the bottom,
+            // those are the edges on the top and on the left.
+            inline bool isTopLeft(const ftk::V2F& a, const ftk::V2F& b)
+            {
+                const float dx = b.x - a.x;
+                const float dy = b.y - a.y;
+                return dy < 0.F || (0.F == dy && dx < 0.F);
+            }
+        }
+
+        void Render::Private::drawTriangle(
+            const ftk::V2F (&pixels)[3],
+            Blend mode,
+            const std::function<bool(const float (&)[3], float*)>& shader)
+        {
+            if (!target)
+                return;
+            int i0 = 0;
+            int i1 = 1;
+            int i2 = 2;
+            float area = edge(pixels[0], pixels[1], pixels[2].x, pixels[2].y);
+            if (0.F == area)
+                return;
+            if (area < 0.F)
+            {
+                std::swap(i1, i2);
+                area = -area;
+            }
+            const ftk::V2F& a = pixels[i0];
+            const ftk::V2F& b = pixels[i1];
+            const ftk::V2F& c = pixels[i2];
+            const bool tlA = isTopLeft(b, c);
+            const bool tlB = isTopLeft(c, a);
+            const bool tlC = isTopLeft(a, b);
+
+            const ftk::Box2I bounds = getBounds();
+            const int x0 = std::max(bounds.min.x, static_cast<int>(std::floor(std::min({ a.x, b.x, c.x }))));
+            const int x1 = std::min(bounds.max.x, static_cast<int>(std::ceil(std::max({ a.x, b.x, c.x }))));
+            const int y0 = std::max(bounds.min.y, static_cast<int>(std::floor(std::min({ a.y, b.y, c.y }))));
+            const int y1 = std::min(bounds.max.y, static_cast<int>(std::ceil(std::max({ a.y, b.y, c.y }))));
+            float weights[3] = { 0.F, 0.F, 0.F };
+            float color[4] = { 0.F, 0.F, 0.F, 0.F };
+            for (int y = y0; y <= y1; ++y)
+            {
+                float* row = target->getRow(y);
+                const float py = y + .5F;
+                for (int x = x0; x <= x1; ++x)
+                {
+                    const float px = x + .5F;
+                    const float wa = edge(b, c, px, py);
+                    const float wb = edge(c, a, px, py);
+                    const float wc = edge(a, b, px, py);
+                    if ((wa > 0.F || (0.F == wa && tlA)) &&
+                        (wb > 0.F || (0.F == wb && tlB)) &&
+                        (wc > 0.F || (0.F == wc && tlC)) &&
+                        (!mask || mask(px, py)))
+                    {
+                        weights[i0] = wa / area;
+                        weights[i1] = wb / area;
+                        weights[i2] = wc / area;
+                        if (shader(weights, color))
+                        {
+                            blend(row + x * 4, color, mode);
+                        }
+                    }
+                }
+            }
+        }
+
+        void Render::Private::drawBox(
+            const ftk::Box2I& box,
+            const ftk::M44F& m,
+            bool flipV,
+            Blend mode,
+            const std::function<void(int, const float*, const float*, float*)>& shader)
+        {
+            if (!target || !box.isValid())
+                return;
+
+            // The box through the transform is a parallelogram: a corner and
+            // the two sides from it.
+            const ftk::V2F o = toPixels(m, ftk::V2F(box.min.x, box.min.y));
+            const ftk::V2F px = toPixels(m, ftk::V2F(box.min.x + box.w(), box.min.y));
+            const ftk::V2F py = toPixels(m, ftk::V2F(box.min.x, box.min.y + box.h()));
+            const ftk::V2F ex(px.x - o.x, px.y - o.y);
+            const ftk::V2F ey(py.x - o.x, py.y - o.y);
+            const float det = ex.x * ey.y - ex.y * ey.x;
+            if (0.F == det)
+                return;
+
+            const ftk::Box2I bounds = getBounds();
+            const float xs[4] = { o.x, px.x, py.x, px.x + ey.x };
+            const float ys[4] = { o.y, px.y, py.y, px.y + ey.y };
+            const int x0 = std::max(bounds.min.x, static_cast<int>(std::floor(*std::min_element(xs, xs + 4))));
+            const int x1 = std::min(bounds.max.x, static_cast<int>(std::ceil(*std::max_element(xs, xs + 4))));
+            const int y0 = std::max(bounds.min.y, static_cast<int>(std::floor(*std::min_element(ys, ys + 4))));
+            const int y1 = std::min(bounds.max.y, static_cast<int>(std::ceil(*std::max_element(ys, ys + 4))));
+            if (x1 < x0 || y1 < y0)
+                return;
+
+            Buffer* target = this->target;
+            const auto& mask = this->mask;
+            parallelRows(
+                y0,
+                y1 + 1,
+                getThreadCount(),
+                [&](int rowStart, int rowEnd)
+                {
+                    const size_t width = x1 - x0 + 1;
+                    std::vector<int> xp(width);
+                    std::vector<float> u(width);
+                    std::vector<float> v(width);
+                    std::vector<float> colors(width * 4);
+                    for (int y = rowStart; y < rowEnd; ++y)
+                    {
+                        const float dy = y + .5F - o.y;
+                        int count = 0;
+                        for (int x = x0; x <= x1; ++x)
+                        {
+                            const float dx = x + .5F - o.x;
+                            const float s = (dx * ey.y - dy * ey.x) / det;
+                            const float t = (ex.x * dy - ex.y * dx) / det;
+                            if (s >= 0.F && s < 1.F && t >= 0.F && t < 1.F &&
+                                (!mask || mask(x + .5F, y + .5F)))
+                            {
+                                xp[count] = x;
+                                u[count] = s;
+                                v[count] = flipV ? (1.F - t) : t;
+                                ++count;
+                            }
+                        }
+                        if (count > 0)
+                        {
+                            shader(count, u.data(), v.data(), colors.data());
+                            float* row = target->getRow(y);
+                            for (int i = 0; i < count; ++i)
+                            {
+                                blend(row + xp[i] * 4, colors.data() + i * 4, mode);
+                            }
+                        }
+                    }
+                });
+        }
+
+        BufferBinding::BufferBinding(Render::Private& p, Buffer& buffer) :
+            _p(p),
+            _target(p.target),
+            _viewport(p.viewport),
+            _clipRectEnabled(p.clipRectEnabled),
+            _mask(p.mask)
+        {
+            p.target = &buffer;
+            p.viewport = ftk::Box2I(0, 0, buffer.size.w, buffer.size.h);
+            p.clipRectEnabled = false;
+            p.mask = nullptr;
+        }
+
+        BufferBinding::~BufferBinding()
+        {
+            _p.target = _target;
+            _p.viewport = _viewport;
+            _p.clipRectEnabled = _clipRectEnabled;
+            _p.mask = _mask;
+        }
+
+        void Render::_init(
+            const std::shared_ptr<ftk::LogSystem>& logSystem,
+            const std::shared_ptr<ftk::FontSystem>& fontSystem)
+        {
+            IRender::_init(logSystem, fontSystem);
+        }
+
+        Render::Render() :
+            _p(new Private)
+        {}
+
+        Render::~Render()
+        {}
+
+        std::shared_ptr<Render> Render::create(
+            const std::shared_ptr<ftk::LogSystem>& logSystem,
+            const std::shared_ptr<ftk::FontSystem>& fontSystem)
+        {
+            auto out = std::shared_ptr<Render>(new Render);
+            out->_init(logSystem, fontSystem);
+            return out;
+        }
+
+        size_t Render::getThreadCount() const
+        {
+            return _p->threadCount;
+        }
+
+        void Render::setThreadCount(size_t value)
+        {
+            _p->threadCount = value;
+        }
+
+        std::shared_ptr<ftk::Image> Render::getImage(ftk::ImageType type) const
+        {
+            auto out = ftk::Image::create(_p->render.size, type);
+            copyImage(out);
+            return out;
+        }
+
+        void Render::copyImage(const std::shared_ptr<ftk::Image>& image) const
+        {
+            FTK_P();
+            if (!image || image->getSize() != p.render.size)
+            {
+                throw std::runtime_error("The image does not match the render size");
+            }
+            int channels = 0;
+            Component component = Component::U8;
+            if (!getPacked(image->getType(), channels, component))
+            {
+                throw std::runtime_error(ftk::Format("Cannot convert the render to: {0}").
+                    arg(image->getType()));
+            }
+            // Row for row, so that the image is bottom to top as
+            // glReadPixels() gives it.
+            uint8_t* data = image->getData();
+            const size_t stride = image->getByteCount() / std::max(1, p.render.size.h);
+            parallelRows(
+                0,
+                p.render.size.h,
+                p.getThreadCount(),
+                [&](int y0, int y1)
+                {
+                    for (int y = y0; y < y1; ++y)
+                    {
+                        writeRow(
+                            p.render.getRow(y),
+                            channels,
+                            component,
+                            p.render.size.w,
+                            data + y * stride);
+                    }
+                });
+        }
+
+        void Render::setOCIOOptions(const OCIOOptions& value)
+        {
+            FTK_P();
+            if (value == p.ocioOptions)
+                return;
+
+#if defined(TLRENDER_OCIO)
+            p.ocioData.clear();
+            p.ocioInputCache.clear();
+#endif // TLRENDER_OCIO
+
+            p.ocioOptions = value;
+
+#if defined(TLRENDER_OCIO)
+            if (p.ocioOptions.enabled &&
+                !p.ocioOptions.input.empty() &&
+                !p.ocioOptions.display.empty() &&
+                !p.ocioOptions.view.empty())
+            {
+                auto data = std::make_shared<OCIOData>();
+                ocioDataInit(*data, p.ocioOptions);
+                p.ocioData[p.ocioOptions.input] = data;
+            }
+#endif // TLRENDER_OCIO
+        }
+
+        void Render::setOCIOInputResolver(
+            const std::function<std::string(
+                const std::string& path,
+                const ftk::ImageTags&)>& value)
+        {
+            FTK_P();
+#if defined(TLRENDER_OCIO)
+            p.ocioInputResolver = value;
+            p.ocioInputCache.clear();
+#endif // TLRENDER_OCIO
+        }
+
+        void Render::setLUTOptions(const LUTOptions& value)
+        {
+            FTK_P();
+            if (value == p.lutOptions)
+                return;
+
+#if defined(TLRENDER_OCIO)
+            p.lutData.reset();
+#endif // TLRENDER_OCIO
+
+            p.lutOptions = value;
+
+#if defined(TLRENDER_OCIO)
+            if (p.lutOptions.enabled && !p.lutOptions.fileName.empty())
+            {
+                auto lutData = std::unique_ptr<OCIOLUTData>(new OCIOLUTData);
+                lutData->config = OCIO::Config::CreateRaw();
+                if (!lutData->config)
+                {
+                    throw std::runtime_error("Cannot create OCIO configuration");
+                }
+                lutData->transform = OCIO::FileTransform::Create();
+                if (!lutData->transform)
+                {
+                    throw std::runtime_error("Cannot create OCIO transform");
+                }
+                lutData->transform->setSrc(p.lutOptions.fileName.c_str());
+                lutData->transform->validate();
+                lutData->processor = lutData->config->getProcessor(lutData->transform);
+                if (!lutData->processor)
+                {
+                    throw std::runtime_error("Cannot get OCIO processor");
+                }
+                lutData->cpuProcessor = lutData->processor->getDefaultCPUProcessor();
+                if (!lutData->cpuProcessor)
+                {
+                    throw std::runtime_error("Cannot get OCIO CPU processor");
+                }
+                p.lutData = std::move(lutData);
+            }
+#endif // TLRENDER_OCIO
+        }
+
+        CompareStats Render::getCompareStats() const
+        {
+            return _p->compareStats;
+        }
+
+        void Render::begin(
+            const ftk::Size2I& renderSize,
+            const ftk::RenderOptions& renderOptions)
+        {
+            FTK_P();
+            p.renderOptions = renderOptions;
+            p.render.resize(renderSize);
+            // Every render starts from transparent black.
+            p.render.clear();
+            p.target = &p.render;
+            p.viewport = ftk::Box2I(0, 0, renderSize.w, renderSize.h);
+            p.clipRectEnabled = false;
+            p.clipRect = ftk::Box2I();
+            p.mask = nullptr;
+            p.transform = ftk::ortho(
+                0.F,
+                static_cast<float>(renderSize.w),
+                static_cast<float>(renderSize.h),
+                0.F,
+                -1.F,
+                1.F);
+        }
+
+        void Render::end()
+        {}
+
+        ftk::Size2I Render::getRenderSize() const
+        {
+            return _p->render.size;
+        }
+
+        void Render::setRenderSize(const ftk::Size2I& value)
+        {
+            _p->render.resize(value);
+        }
+
+        ftk::RenderOptions Render::getRenderOptions() const
+        {
+            return _p->renderOptions;
+        }
+
+        ftk::Box2I Render::getViewport() const
+        {
+            return _p->viewport;
+        }
+
+        void Render::setViewport(const ftk::Box2I& value)
+        {
+            _p->viewport = value;
+        }
+
+        void Render::clearViewport(const ftk::Color4F& value)
+        {
+            FTK_P();
+            if (!p.target)
+                return;
+            const ftk::Box2I bounds = p.getBounds();
+            for (int y = bounds.min.y; y <= bounds.max.y; ++y)
+            {
+                float* row = p.target->getRow(y);
+                for (int x = bounds.min.x; x <= bounds.max.x; ++x)
+                {
+                    row[x * 4 + 0] = value.r;
+                    row[x * 4 + 1] = value.g;
+                    row[x * 4 + 2] = value.b;
+                    row[x * 4 + 3] = value.a;
+                }
+            }
+        }
+
+        bool Render::getClipRectEnabled() const
+        {
+            return _p->clipRectEnabled;
+        }
+
+        void Render::setClipRectEnabled(bool value)
+        {
+            _p->clipRectEnabled = value;
+        }
+
+        ftk::Box2I Render::getClipRect() const
+        {
+            return _p->clipRect;
+        }
+
+        void Render::setClipRect(const ftk::Box2I& value)
+        {
+            _p->clipRect = value;
+        }
+
+        ftk::M44F Render::getTransform() const
+        {
+            return _p->transform;
+        }
+
+        void Render::setTransform(const ftk::M44F& value)
+        {
+            _p->transform = value;
+        }
+
+        ftk::RenderDiag Render::getDiag() const
+        {
+            return ftk::RenderDiag();
+        }
+
+        std::string Render::_layerOCIOInput(
+            const std::string& layerInput,
+            const std::string& path,
+            const std::shared_ptr<ftk::Image>& image)
+        {
+            FTK_P();
+            std::string out = layerInput;
+#if defined(TLRENDER_OCIO)
+            if (out.empty() && p.ocioInputResolver && !path.empty())
+            {
+                auto i = p.ocioInputCache.find(path);
+                if (i == p.ocioInputCache.end())
+                {
+                    i = p.ocioInputCache.insert(std::make_pair(
+                        path,
+                        p.ocioInputResolver(
+                            path,
+                            image ? image->getTags() : ftk::ImageTags()))).first;
+                }
+                out = i->second;
+            }
+#endif // TLRENDER_OCIO
+            return out;
+        }
+    }
+}
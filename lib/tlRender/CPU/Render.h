@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include <tlRender/Timeline/IRender.h>
+
+namespace tl
+{
+    //! Timeline software rendering
+    namespace cpu
+    {
+        //! Timeline software renderer.
+        //!
+        //! Draws into memory rather than through OpenGL, for machines with
+        //! no display or no GPU to make a context on. The render is floating
+        //! point RGBA, and its rows run bottom to top as glReadPixels()
+        //! returns them, so the images it gives go to the same writers the
+        //! OpenGL renderer's do.
+        //!
+        //! The video is drawn in bands of rows, one per thread. Textures are
+        //! an OpenGL thing, so drawTexture() draws nothing.
+        class TL_API_TYPE Render : public IRender
+        {
+            FTK_NON_COPYABLE(Render);
+
+        protected:
+            void _init(
+                const std::shared_ptr<ftk::LogSystem>&,
+                const std::shared_ptr<ftk::FontSystem>&);
+
+            Render();
+
+        public:
+            TL_API virtual ~Render();
+
+            //! Create a new renderer.
+            TL_API static std::shared_ptr<Render> create(
+                const std::shared_ptr<ftk::LogSystem>&,
+                const std::shared_ptr<ftk::FontSystem>&);
+
+            //! Get the number of threads the rows are drawn with.
+            TL_API size_t getThreadCount() const;
+
+            //! Set the number of threads the rows are drawn with. Zero is
+            //! one per core.
+            TL_API void setThreadCount(size_t);
+
+            //! Get the render as a new image.
+            TL_API std::shared_ptr<ftk::Image> getImage(
+                ftk::ImageType = ftk::ImageType::RGBA_F32) const;
+
+            //! Copy the render into an image of the same size, converting it
+            //! to the image's type.
+            TL_API void copyImage(const std::shared_ptr<ftk::Image>&) const;
+
+            TL_API void setOCIOOptions(const OCIOOptions&) override;
+            TL_API void setOCIOInputResolver(
+                const std::function<std::string(
+                    const std::string& path,
+                    const ftk::ImageTags&)>&) override;
+            TL_API void setLUTOptions(const LUTOptions&) override;
+
+            TL_API void drawVideo(
+                const std::vector<VideoFrame>&,
+                const std::vector<ftk::Box2I>&,
+                const std::vector<ftk::ImageOptions>& = {},
+                const std::vector<DisplayOptions>& = {},
+                const CompareOptions& = CompareOptions(),
+                ftk::gl::TextureType colorBuffer = ftk::gl::offscreenColorDefault) override;
+            TL_API CompareStats getCompareStats() const override;
+
+            TL_API void begin(
+                const ftk::Size2I&,
+                const ftk::RenderOptions& = ftk::RenderOptions()) override;
+            TL_API void end() override;
+            TL_API ftk::Size2I getRenderSize() const override;
+            TL_API void setRenderSize(const ftk::Size2I&) override;
+            TL_API ftk::RenderOptions getRenderOptions() const override;
+            TL_API ftk::Box2I getViewport() const override;
+            TL_API void setViewport(const ftk::Box2I&) override;
+            TL_API void clearViewport(const ftk::Color4F&) override;
+            TL_API bool getClipRectEnabled() const override;
+            TL_API void setClipRectEnabled(bool) override;
+            TL_API ftk::Box2I getClipRect() const override;
+            TL_API void setClipRect(const ftk::Box2I&) override;
+            TL_API ftk::M44F getTransform() const override;
+            TL_API void setTransform(const ftk::M44F&) override;
+            TL_API void drawRect(
+                const ftk::Box2F&,
+                const ftk::Color4F&) override;
+            TL_API void drawRects(
+                const std::vector<ftk::Box2F>&,
+                const ftk::Color4F&) override;
+            TL_API void drawLine(
+                const ftk::V2F&,
+                const ftk::V2F&,
+                const ftk::Color4F&,
+                const ftk::LineOptions& = ftk::LineOptions()) override;
+            TL_API void drawLines(
+                const std::vector<std::pair<ftk::V2F, ftk::V2F> >&,
+                const ftk::Color4F&,
+                const ftk::LineOptions& = ftk::LineOptions()) override;
+            TL_API void drawMesh(
+                const ftk::TriMesh2F&,
+                const ftk::Color4F& = ftk::Color4F(1.F, 1.F, 1.F, 1.F),
+                const ftk::V2F& pos = ftk::V2F()) override;
+            TL_API void drawColorMesh(
+                const ftk::TriMesh2F&,
+                const ftk::Color4F& = ftk::Color4F(1.F, 1.F, 1.F, 1.F),
+                const ftk::V2F& pos = ftk::V2F()) override;
+            TL_API void drawTexture(
+                unsigned int,
+                const ftk::Box2I&,
+                bool flipV = false,
+                const ftk::Color4F& = ftk::Color4F(1.F, 1.F, 1.F),
+                ftk::AlphaBlend = ftk::AlphaBlend::Straight) override;
+            TL_API void drawText(
+                const std::vector<std::shared_ptr<ftk::Glyph> >&,
+                const ftk::FontMetrics&,
+                const ftk::V2F& position,
+                const ftk::Color4F& = ftk::Color4F(1.F, 1.F, 1.F, 1.F)) override;
+            TL_API void drawImage(
+                const std::shared_ptr<ftk::Image>&,
+                const ftk::TriMesh2F&,
+                const ftk::Color4F& = ftk::Color4F(1.F, 1.F, 1.F, 1.F),
+                const ftk::ImageOptions& = ftk::ImageOptions()) override;
+            TL_API void drawImage(
+                const std::shared_ptr<ftk::Image>&,
+                const ftk::Box2F&,
+                const ftk::Color4F& = ftk::Color4F(1.F, 1.F, 1.F, 1.F),
+                const ftk::ImageOptions& = ftk::ImageOptions()) override;
+            TL_API ftk::RenderDiag getDiag() const override;
+
+        private:
+            void _drawVideoA(
+                const std::vector<VideoFrame>&,
+                const std::vector<ftk::Box2I>&,
+                const std::vector<ftk::ImageOptions>&,
+                const std::vector<DisplayOptions>&);
+            void _drawVideoB(
+                const std::vector<VideoFrame>&,
+                const std::vector<ftk::Box2I>&,
+                const std::vector<ftk::ImageOptions>&,
+                const std::vector<DisplayOptions>&);
+            void _drawVideoWipe(
+                const std::vector<VideoFrame>&,
+                const std::vector<ftk::Box2I>&,
+                const std::vector<ftk::ImageOptions>&,
+                const std::vector<DisplayOptions>&,
+                const CompareOptions&);
+            void _drawVideoOverlay(
+                const std::vector<VideoFrame>&,
+                const std::vector<ftk::Box2I>&,
+                const std::vector<ftk::ImageOptions>&,
+                const std::vector<DisplayOptions>&,
+                const CompareOptions&);
+            //! Draw both files into a pair of buffers, for the comparisons
+            //! that combine them a pixel at a time. Answers whether there
+            //! are two to combine.
+            bool _drawVideoPair(
+                const std::vector<VideoFrame>&,
+                const std::vector<ftk::Box2I>&,
+                const std::vector<ftk::ImageOptions>&,
+                const std::vector<DisplayOptions>&);
+            void _drawVideoButterfly(const ftk::Box2I&);
+            void _drawVideoDifference(
+                const ftk::Box2I&,
+                const CompareOptions&);
+            //! Measure the difference between the pair.
+            void _drawVideoPairStats(float threshold);
+            void _drawVideoTile(
+                const std::vector<VideoFrame>&,
+                const std::vector<ftk::Box2I>&,
+                const std::vector<ftk::ImageOptions>&,
+                const std::vector<DisplayOptions>&);
+            void _drawVideo(
+                const VideoFrame&,
+                const ftk::Box2I&,
+                const std::shared_ptr<ftk::ImageOptions>&,
+                const DisplayOptions&,
+                const ftk::M44F& mvp);
+            std::string _layerOCIOInput(
+                const std::string& layerInput,
+                const std::string& path,
+                const std::shared_ptr<ftk::Image>&);
+
+            FTK_PRIVATE();
+        };
+    }
+}
@@ -0,0 +1,374 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/CPU/RenderPrivate.h>
+
+#include <ftk/Core/FontSystem.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace tl
+{
+    namespace cpu
+    {
+        namespace
+        {
+            void fillTriangle(
+                Render::Private& p,
+                const ftk::V2F& a,
+                const ftk::V2F& b,
+                const ftk::V2F& c,
+                const ftk::Color4F& color)
+            {
+                const ftk::V2F pixels[3] =
+                {
+                    p.toPixels(p.transform, a),
+                    p.toPixels(p.transform, b),
+                    p.toPixels(p.transform, c)
+                };
+                p.drawTriangle(
+                    pixels,
+                    Blend::Straight,
+                    [&color](const float (&)[3], float* out)
+                    {
+                        out[0] = color.r;
+                        out[1] = color.g;
+                        out[2] = color.b;
+                        out[3] = color.a;
+                        return true;
+                    });
+            }
+
+            void fillRect(
+                Render::Private& p,
+                const ftk::Box2F& rect,
+                const ftk::Color4F& color)
+            {
+                const ftk::V2F a(rect.min.x, rect.min.y);
+                const ftk::V2F b(rect.max.x, rect.min.y);
+                const ftk::V2F c(rect.max.x, rect.max.y);
+                const ftk::V2F d(rect.min.x, rect.max.y);
+                fillTriangle(p, a, b, c, color);
+                fillTriangle(p, c, d, a, color);
+            }
+
+            void fillLine(
+                Render::Private& p,
+                const ftk::V2F& v0,
+                const ftk::V2F& v1,
+                const ftk::Color4F& color,
+                const ftk::LineOptions& options)
+            {
+                // A quad the width of the line either side of it.
+                const float dx = v1.x - v0.x;
+                const float dy = v1.y - v0.y;
+                const float length = std::sqrt(dx * dx + dy * dy);
+                if (length <= 0.F)
+                    return;
+                const float w = options.width / 2.F;
+                const ftk::V2F n(-dy / length * w, dx / length * w);
+                const ftk::V2F a(v0.x + n.x, v0.y + n.y);
+                const ftk::V2F b(v1.x + n.x, v1.y + n.y);
+                const ftk::V2F c(v1.x - n.x, v1.y - n.y);
+                const ftk::V2F d(v0.x - n.x, v0.y - n.y);
+                fillTriangle(p, a, b, c, color);
+                fillTriangle(p, c, d, a, color);
+            }
+        }
+
+        void Render::drawRect(
+            const ftk::Box2F& rect,
+            const ftk::Color4F& color)
+        {
+            fillRect(*_p, rect, color);
+        }
+
+        void Render::drawRects(
+            const std::vector<ftk::Box2F>& rects,
+            const ftk::Color4F& color)
+        {
+            for (const auto& rect : rects)
+            {
+                fillRect(*_p, rect, color);
+            }
+        }
+
+        void Render::drawLine(
+            const ftk::V2F& v0,
+            const ftk::V2F& v1,
+            const ftk::Color4F& color,
+            const ftk::LineOptions& options)
+        {
+            fillLine(*_p, v0, v1, color, options);
+        }
+
+        void Render::drawLines(
+            const std::vector<std::pair<ftk::V2F, ftk::V2F> >& v,
+            const ftk::Color4F& color,
+            const ftk::LineOptions& options)
+        {
+            for (const auto& line : v)
+            {
+                fillLine(*_p, line.first, line.second, color, options);
+            }
+        }
+
+        void Render::drawMesh(
+            const ftk::TriMesh2F& mesh,
+            const ftk::Color4F& color,
+            const ftk::V2F& pos)
+        {
+            FTK_P();
+            for (const auto& triangle : mesh.triangles)
+            {
+                ftk::V2F v[3];
+                for (size_t i = 0; i < 3; ++i)
+                {
+                    // The indices count from one.
+                    const auto& vertex = mesh.v[triangle.v[i].v - 1];
+                    v[i] = ftk::V2F(vertex.x + pos.x, vertex.y + pos.y);
+                }
+                fillTriangle(p, v[0], v[1], v[2], color);
+            }
+        }
+
+        void Render::drawColorMesh(
+            const ftk::TriMesh2F& mesh,
+            const ftk::Color4F& color,
+            const ftk::V2F& pos)
+        {
+            FTK_P();
+            for (const auto& triangle : mesh.triangles)
+            {
+                ftk::V2F pixels[3];
+                ftk::V4F colors[3];
+                for (size_t i = 0; i < 3; ++i)
+                {
+                    const auto& vertex = mesh.v[triangle.v[i].v - 1];
+                    pixels[i] = p.toPixels(
+                        p.transform,
+                        ftk::V2F(vertex.x + pos.x, vertex.y + pos.y));
+                    colors[i] = triangle.v[i].c > 0 ?
+                        mesh.c[triangle.v[i].c - 1] :
+                        ftk::V4F(1.F, 1.F, 1.F, 1.F);
+                }
+                p.drawTriangle(
+                    pixels,
+                    Blend::Straight,
+                    [&colors, &color](const float (&w)[3], float* out)
+                    {
+                        out[0] = (colors[0].x * w[0] + colors[1].x * w[1] + colors[2].x * w[2]) * color.r;
+                        out[1] = (colors[0].y * w[0] + colors[1].y * w[1] + colors[2].y * w[2]) * color.g;
+                        out[2] = (colors[0].z * w[0] + colors[1].z * w[1] + colors[2].z * w[2]) * color.b;
+                        out[3] = (colors[0].w * w[0] + colors[1].w * w[1] + colors[2].w * w[2]) * color.a;
+                        return true;
+                    });
+            }
+        }
+
+        void Render::drawTexture(
+            unsigned int,
+            const ftk::Box2I&,
+            bool,
+            const ftk::Color4F&,
+            ftk::AlphaBlend)
+        {}
+
+        void Render::drawText(
+            const std::vector<std::shared_ptr<ftk::Glyph> >& glyphs,
+            const ftk::FontMetrics& fontMetrics,
+            const ftk::V2F& pos,
+            const ftk::Color4F& color)
+        {
+            FTK_P();
+            float x = 0.F;
+            int32_t rsbDeltaPrev = 0;
+            for (const auto& glyph : glyphs)
+            {
+                if (!glyph)
+                    continue;
+
+                // Kerning, as the OpenGL renderer does it.
+                if (rsbDeltaPrev - glyph->lsbDelta > 32)
+                {
+                    x -= 1.F;
+                }
+                else if (rsbDeltaPrev - glyph->lsbDelta < -31)
+                {
+                    x += 1.F;
+                }
+                rsbDeltaPrev = glyph->rsbDelta;
+
+                if (glyph->image && glyph->image->isValid())
+                {
+                    // The glyph image is coverage, to multiply the alpha by.
+                    const auto& image = glyph->image;
+                    const ftk::Size2I& size = image->getSize();
+                    const uint8_t* data = image->getData();
+                    const size_t stride = image->getByteCount() / size.h;
+                    const ftk::Box2I box(
+                        static_cast<int>(std::round(pos.x + x + glyph->offset.x)),
+                        static_cast<int>(std::round(pos.y + fontMetrics.ascender - glyph->offset.y)),
+                        size.w,
+                        size.h);
+                    p.drawBox(
+                        box,
+                        p.transform,
+                        false,
+                        Blend::Straight,
+                        [&size, data, stride, &color](int count, const float* u, const float* v, float* out)
+                        {
+                            for (int i = 0; i < count; ++i, out += 4)
+                            {
+                                const int tx = std::min(static_cast<int>(u[i] * size.w), size.w - 1);
+                                const int ty = std::min(static_cast<int>(v[i] * size.h), size.h - 1);
+                                out[0] = color.r;
+                                out[1] = color.g;
+                                out[2] = color.b;
+                                out[3] = color.a * data[ty * stride + tx] / 255.F;
+                            }
+                        });
+                }
+
+                x += glyph->advance;
+            }
+        }
+
+        void Render::drawImage(
+            const std::shared_ptr<ftk::Image>& image,
+            const ftk::TriMesh2F& mesh,
+            const ftk::Color4F& color,
+            const ftk::ImageOptions& options)
+        {
+            FTK_P();
+            Buffer buffer;
+            if (!toBuffer(image, buffer, p.getThreadCount()))
+                return;
+            const ftk::ImageInfo& info = image->getInfo();
+            const float w = static_cast<float>(buffer.size.w);
+            const float h = static_cast<float>(buffer.size.h);
+            for (const auto& triangle : mesh.triangles)
+            {
+                ftk::V2F pixels[3];
+                ftk::V2F t[3];
+                for (size_t i = 0; i < 3; ++i)
+                {
+                    pixels[i] = p.toPixels(p.transform, mesh.v[triangle.v[i].v - 1]);
+                    ftk::V2F uv = triangle.v[i].t > 0 ? mesh.t[triangle.v[i].t - 1] : ftk::V2F();
+                    if (info.layout.mirror.x)
+                    {
+                        uv.x = 1.F - uv.x;
+                    }
+                    if (info.layout.mirror.y)
+                    {
+                        uv.y = 1.F - uv.y;
+                    }
+                    t[i] = ftk::V2F(uv.x * w, uv.y * h);
+                }
+
+                // How many pixels a texel covers, from the areas of the
+                // triangle on screen and in the image.
+                const float pixelArea = std::fabs(
+                    (pixels[1].x - pixels[0].x) * (pixels[2].y - pixels[0].y) -
+                    (pixels[1].y - pixels[0].y) * (pixels[2].x - pixels[0].x));
+                const float texelArea = std::fabs(
+                    (t[1].x - t[0].x) * (t[2].y - t[0].y) -
+                    (t[1].y - t[0].y) * (t[2].x - t[0].x));
+                const float scale = texelArea > 0.F ? std::sqrt(pixelArea / texelArea) : 1.F;
+
+                p.drawTriangle(
+                    pixels,
+                    Blend::Straight,
+                    [&buffer, &t, scale, &options, &color](const float (&wt)[3], float* out)
+                    {
+                        sample(
+                            buffer,
+                            t[0].x * wt[0] + t[1].x * wt[1] + t[2].x * wt[2],
+                            t[0].y * wt[0] + t[1].y * wt[1] + t[2].y * wt[2],
+                            scale,
+                            scale,
+                            options.imageFilters,
+                            out);
+                        out[0] *= color.r;
+                        out[1] *= color.g;
+                        out[2] *= color.b;
+                        out[3] *= color.a;
+                        return true;
+                    });
+            }
+        }
+
+        void Render::drawImage(
+            const std::shared_ptr<ftk::Image>& image,
+            const ftk::Box2F& rect,
+            const ftk::Color4F& color,
+            const ftk::ImageOptions& options)
+        {
+            _p->drawImage(
+                image,
+                ftk::Box2I(
+                    static_cast<int>(std::round(rect.min.x)),
+                    static_cast<int>(std::round(rect.min.y)),
+                    static_cast<int>(std::round(rect.w())),
+                    static_cast<int>(std::round(rect.h()))),
+                color,
+                options.imageFilters,
+                Blend::Straight);
+        }
+
+        void Render::Private::drawImage(
+            const std::shared_ptr<ftk::Image>& image,
+            const ftk::Box2I& box,
+            const ftk::Color4F& color,
+            const ftk::ImageFilters& filters,
+            Blend mode,
+            const std::function<void(float*, int)>& span)
+        {
+            Buffer buffer;
+            if (!toBuffer(image, buffer, getThreadCount()))
+                return;
+            const ftk::ImageInfo& info = image->getInfo();
+
+            // How many pixels a texel covers along each side of the box.
+            const ftk::V2F o = toPixels(transform, ftk::V2F(box.min.x, box.min.y));
+            const ftk::V2F px = toPixels(transform, ftk::V2F(box.min.x + box.w(), box.min.y));
+            const ftk::V2F py = toPixels(transform, ftk::V2F(box.min.x, box.min.y + box.h()));
+            const float scaleX = std::hypot(px.x - o.x, px.y - o.y) / buffer.size.w;
+            const float scaleY = std::hypot(py.x - o.x, py.y - o.y) / buffer.size.h;
+
+            const float w = static_cast<float>(buffer.size.w);
+            const float h = static_cast<float>(buffer.size.h);
+            const bool mirrorX = info.layout.mirror.x;
+            const bool mirrorY = info.layout.mirror.y;
+            drawBox(
+                box,
+                transform,
+                false,
+                mode,
+                [&](int count, const float* u, const float* v, float* out)
+                {
+                    float* c = out;
+                    for (int i = 0; i < count; ++i, c += 4)
+                    {
+                        sample(
+                            buffer,
+                            (mirrorX ? (1.F - u[i]) : u[i]) * w,
+                            (mirrorY ? (1.F - v[i]) : v[i]) * h,
+                            scaleX,
+                            scaleY,
+                            filters,
+                            c);
+                        c[0] *= color.r;
+                        c[1] *= color.g;
+                        c[2] *= color.b;
+                        c[3] *= color.a;
+                    }
+                    if (span)
+                    {
+                        span(out, count);
+                    }
+                });
+        }
+    }
+}
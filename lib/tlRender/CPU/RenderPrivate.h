@@ -0,0 +1,259 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include <tlRender/CPU/Render.h>
+
+#if defined(TLRENDER_OCIO)
+#include <OpenColorIO/OpenColorIO.h>
+#endif // TLRENDER_OCIO
+
+#include <functional>
+#include <map>
+
+#if defined(TLRENDER_OCIO)
+namespace OCIO = OCIO_NAMESPACE;
+#endif // TLRENDER_OCIO
+
+namespace tl
+{
+    namespace cpu
+    {
+        //! Floating point RGBA pixels. The rows of what is drawn into run
+        //! bottom to top, as an OpenGL framebuffer's do; the rows of a
+        //! converted image stay in the order they were stored in.
+        struct Buffer
+        {
+            ftk::Size2I size;
+            std::vector<float> data;
+
+            //! Resize the buffer. The pixels are kept when the size is the
+            //! same.
+            void resize(const ftk::Size2I&);
+
+            //! Fill the buffer with a color.
+            void clear(const ftk::Color4F& = ftk::Color4F(0.F, 0.F, 0.F, 0.F));
+
+            float* getRow(int y)
+            {
+                return data.data() + static_cast<size_t>(y) * size.w * 4;
+            }
+
+            const float* getRow(int y) const
+            {
+                return data.data() + static_cast<size_t>(y) * size.w * 4;
+            }
+        };
+
+        //! How what is drawn combines with what is there.
+        enum class Blend
+        {
+            //! Replace it.
+            None,
+
+            //! Over it, with the color not yet multiplied by its alpha;
+            //! ftk's straight alpha blending.
+            Straight,
+
+            //! Over it, with the color already multiplied by its alpha; what
+            //! the video is drawn with.
+            Premultiplied
+        };
+
+        //! Run a function over rows [y0, y1), split into a band for each
+        //! thread.
+        void parallelRows(
+            int y0,
+            int y1,
+            size_t threadCount,
+            const std::function<void(int, int)>&);
+
+        //! Convert an image to floating point RGBA. Answers false for the
+        //! pixel types there is no conversion for.
+        bool toBuffer(
+            const std::shared_ptr<ftk::Image>&,
+            Buffer&,
+            size_t threadCount);
+
+        //! Sample a buffer at a position in texels, clamped to the edges.
+        void sampleNearest(const Buffer&, float x, float y, float* out);
+        void sampleLinear(const Buffer&, float x, float y, float* out);
+
+        //! Sample a buffer with the Mitchell-Netravali filter the OpenGL
+        //! display shader enlarges with.
+        void sampleMitchell(const Buffer&, float x, float y, float* out);
+
+        //! Average the texels a pixel covers, for reducing. The scale is
+        //! pixels per texel.
+        void sampleArea(
+            const Buffer&,
+            float x,
+            float y,
+            float scaleX,
+            float scaleY,
+            float* out);
+
+        //! Sample a buffer with the filter the scale calls for.
+        void sample(
+            const Buffer&,
+            float x,
+            float y,
+            float scaleX,
+            float scaleY,
+            const ftk::ImageFilters&,
+            float* out);
+
+#if defined(TLRENDER_OCIO)
+        struct OCIOData
+        {
+            OCIO::ConstConfigRcPtr config;
+            OCIO::DisplayViewTransformRcPtr transform;
+            OCIO::LegacyViewingPipelineRcPtr lvp;
+            // As the OpenGL renderer splits the transform around the color
+            // corrections when the configuration names a scene_linear role;
+            // without the role toLinear is empty.
+            OCIO::ConstCPUProcessorRcPtr toLinear;
+            OCIO::ConstCPUProcessorRcPtr display;
+        };
+
+        struct OCIOLUTData
+        {
+            OCIO::ConstConfigRcPtr config;
+            OCIO::FileTransformRcPtr transform;
+            OCIO::ConstProcessorRcPtr processor;
+            OCIO::ConstCPUProcessorRcPtr cpuProcessor;
+        };
+
+        //! Apply a processor to a row of RGBA pixels.
+        void ocioApply(const OCIO::ConstCPUProcessorRcPtr&, float*, int count);
+#endif // TLRENDER_OCIO
+
+        struct Render::Private
+        {
+            size_t threadCount = 0;
+            ftk::RenderOptions renderOptions;
+            Buffer render;
+
+            // What is being drawn into: the render, or one of the buffers.
+            Buffer* target = nullptr;
+            ftk::Box2I viewport;
+            bool clipRectEnabled = false;
+            ftk::Box2I clipRect;
+            ftk::M44F transform;
+            // Which pixels may be drawn, in the target's pixels; for the
+            // wipe, which the OpenGL renderer does with the stencil.
+            std::function<bool(float, float)> mask;
+
+            OCIOOptions ocioOptions;
+            LUTOptions lutOptions;
+#if defined(TLRENDER_OCIO)
+            // Keyed by the input color space, as the OpenGL renderer's.
+            std::map<std::string, std::shared_ptr<OCIOData> > ocioData;
+            std::function<std::string(
+                const std::string&,
+                const ftk::ImageTags&)> ocioInputResolver;
+            std::map<std::string, std::string> ocioInputCache;
+            std::unique_ptr<OCIOLUTData> lutData;
+
+            std::shared_ptr<OCIOData> getOCIOData(const std::string& input);
+#endif // TLRENDER_OCIO
+
+            std::map<std::string, Buffer> buffers;
+            CompareStats compareStats;
+
+            size_t getThreadCount() const;
+
+            //! Where a point lands in the target's pixels through a
+            //! transform and the viewport.
+            ftk::V2F toPixels(const ftk::M44F&, const ftk::V2F&) const;
+
+            //! The pixels of the target that may be drawn: the viewport,
+            //! within the clip rectangle when it is enabled.
+            ftk::Box2I getBounds() const;
+
+            //! Draw a triangle. The shader is given the weights of the three
+            //! corners at a pixel and answers its color, or false to leave
+            //! it.
+            void drawTriangle(
+                const ftk::V2F (&pixels)[3],
+                Blend,
+                const std::function<bool(const float (&)[3], float*)>& shader);
+
+            //! Draw a box through a transform, one band of rows per thread.
+            //! The shader is given a span of pixels and where each falls in
+            //! the box, from zero to one with the first row at the top or,
+            //! flipped, the bottom, and answers their colors.
+            void drawBox(
+                const ftk::Box2I&,
+                const ftk::M44F&,
+                bool flipV,
+                Blend,
+                const std::function<void(
+                    int count,
+                    const float* u,
+                    const float* v,
+                    float* out)>& shader);
+
+            //! Draw an image into a box. The span function, when there is
+            //! one, is given the colors ahead of the blend.
+            void drawImage(
+                const std::shared_ptr<ftk::Image>&,
+                const ftk::Box2I&,
+                const ftk::Color4F&,
+                const ftk::ImageFilters&,
+                Blend,
+                const std::function<void(float*, int)>& span = nullptr);
+        };
+
+        //! Draw into a buffer, with a viewport that covers it, until the
+        //! binding goes out of scope.
+        class BufferBinding
+        {
+        public:
+            BufferBinding(Render::Private&, Buffer&);
+            ~BufferBinding();
+
+        private:
+            Render::Private& _p;
+            Buffer* _target = nullptr;
+            ftk::Box2I _viewport;
+            bool _clipRectEnabled = false;
+            std::function<bool(float, float)> _mask;
+        };
+
+        //! Blend a pixel.
+        inline void blend(float* dst, const float* src, Blend mode)
+        {
+            switch (mode)
+            {
+            case Blend::None:
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+                dst[3] = src[3];
+                break;
+            case Blend::Straight:
+            {
+                const float a = src[3];
+                const float ia = 1.F - a;
+                dst[0] = src[0] * a + dst[0] * ia;
+                dst[1] = src[1] * a + dst[1] * ia;
+                dst[2] = src[2] * a + dst[2] * ia;
+                dst[3] = a + dst[3] * ia;
+                break;
+            }
+            case Blend::Premultiplied:
+            {
+                const float ia = 1.F - src[3];
+                dst[0] = src[0] + dst[0] * ia;
+                dst[1] = src[1] + dst[1] * ia;
+                dst[2] = src[2] + dst[2] * ia;
+                dst[3] = src[3] + dst[3] * ia;
+                break;
+            }
+            default: break;
+            }
+        }
+    }
+}
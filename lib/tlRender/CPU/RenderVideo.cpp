@@ -0,0 +1,974 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/CPU/RenderPrivate.h>
+
+#include <ftk/Core/Format.h>
+#include <ftk/Core/Math.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+namespace tl
+{
+    namespace cpu
+    {
+        namespace
+        {
+            ftk::ImageFilters imageFilters(
+                const std::vector<ftk::ImageOptions>& imageOptions,
+                size_t index)
+            {
+                return index < imageOptions.size() ?
+                    imageOptions[index].imageFilters :
+                    ftk::ImageFilters();
+            }
+
+            //! How many pixels a texel of a buffer covers, drawn into a box
+            //! through a transform.
+            ftk::V2F getScale(
+                const Render::Private& p,
+                const ftk::Box2I& box,
+                const ftk::M44F& m,
+                const ftk::Size2I& size)
+            {
+                const ftk::V2F o = p.toPixels(m, ftk::V2F(box.min.x, box.min.y));
+                const ftk::V2F x = p.toPixels(m, ftk::V2F(box.min.x + box.w(), box.min.y));
+                const ftk::V2F y = p.toPixels(m, ftk::V2F(box.min.x, box.min.y + box.h()));
+                return ftk::V2F(
+                    std::hypot(x.x - o.x, x.y - o.y) / std::max(1, size.w),
+                    std::hypot(y.x - o.x, y.y - o.y) / std::max(1, size.h));
+            }
+
+            //! Whether a point is inside a triangle, either way around.
+            bool inside(const ftk::V2F (&t)[3], float x, float y)
+            {
+                const float d0 = (t[1].x - t[0].x) * (y - t[0].y) - (t[1].y - t[0].y) * (x - t[0].x);
+                const float d1 = (t[2].x - t[1].x) * (y - t[1].y) - (t[2].y - t[1].y) * (x - t[1].x);
+                const float d2 = (t[0].x - t[2].x) * (y - t[2].y) - (t[0].y - t[2].y) * (x - t[2].x);
+                return (d0 >= 0.F && d1 >= 0.F && d2 >= 0.F) ||
+                    (d0 <= 0.F && d1 <= 0.F && d2 <= 0.F);
+            }
+        }
+
+        void Render::drawVideo(
+            const std::vector<VideoFrame>& videoFrame,
+            const std::vector<ftk::Box2I>& boxes,
+            const std::vector<ftk::ImageOptions>& imageOptions,
+            const std::vector<DisplayOptions>& displayOptions,
+            const CompareOptions& compareOptions,
+            ftk::gl::TextureType)
+        {
+            _p->compareStats = CompareStats();
+            switch (compareOptions.compare)
+            {
+            case Compare::None:
+                _drawVideoA(videoFrame, boxes, imageOptions, displayOptions);
+                break;
+            case Compare::B:
+                _drawVideoB(videoFrame, boxes, imageOptions, displayOptions);
+                break;
+            case Compare::Wipe:
+                _drawVideoWipe(
+                    videoFrame,
+                    boxes,
+                    imageOptions,
+                    displayOptions,
+                    compareOptions);
+                break;
+            case Compare::Butterfly:
+                if (videoFrame.size() > 1 &&
+                    !boxes.empty() &&
+                    _drawVideoPair(videoFrame, boxes, imageOptions, displayOptions))
+                {
+                    _drawVideoButterfly(boxes[0]);
+                }
+                else
+                {
+                    _drawVideoA(videoFrame, boxes, imageOptions, displayOptions);
+                }
+                break;
+            case Compare::Overlay:
+                _drawVideoOverlay(
+                    videoFrame,
+                    boxes,
+                    imageOptions,
+                    displayOptions,
+                    compareOptions);
+                break;
+            case Compare::Difference:
+                if (videoFrame.size() > 1 &&
+                    !boxes.empty() &&
+                    _drawVideoPair(videoFrame, boxes, imageOptions, displayOptions))
+                {
+                    _drawVideoDifference(boxes[0], compareOptions);
+                }
+                else
+                {
+                    _drawVideoA(videoFrame, boxes, imageOptions, displayOptions);
+                }
+                break;
+            case Compare::Horizontal:
+            case Compare::Vertical:
+            case Compare::Tile:
+                _drawVideoTile(videoFrame, boxes, imageOptions, displayOptions);
+                break;
+            default: break;
+            }
+        }
+
+        void Render::_drawVideoA(
+            const std::vector<VideoFrame>& videoFrame,
+            const std::vector<ftk::Box2I>& boxes,
+            const std::vector<ftk::ImageOptions>& imageOptions,
+            const std::vector<DisplayOptions>& displayOptions)
+        {
+            if (!videoFrame.empty() && !boxes.empty())
+            {
+                _drawVideo(
+                    videoFrame[0],
+                    boxes[0],
+                    !imageOptions.empty() ? std::make_shared<ftk::ImageOptions>(imageOptions[0]) : nullptr,
+                    !displayOptions.empty() ? displayOptions[0] : DisplayOptions(),
+                    getTransform());
+            }
+        }
+
+        void Render::_drawVideoB(
+            const std::vector<VideoFrame>& videoFrame,
+            const std::vector<ftk::Box2I>& boxes,
+            const std::vector<ftk::ImageOptions>& imageOptions,
+            const std::vector<DisplayOptions>& displayOptions)
+        {
+            if (videoFrame.size() > 1 && boxes.size() > 1)
+            {
+                _drawVideo(
+                    videoFrame[1],
+                    boxes[1],
+                    imageOptions.size() > 1 ? std::make_shared<ftk::ImageOptions>(imageOptions[1]) : nullptr,
+                    displayOptions.size() > 1 ? displayOptions[1] : DisplayOptions(),
+                    getTransform());
+            }
+        }
+
+        void Render::_drawVideoWipe(
+            const std::vector<VideoFrame>& videoFrame,
+            const std::vector<ftk::Box2I>& boxes,
+            const std::vector<ftk::ImageOptions>& imageOptions,
+            const std::vector<DisplayOptions>& displayOptions,
+            const CompareOptions& compareOptions)
+        {
+            FTK_P();
+
+            float radius = 0.F;
+            float x = 0.F;
+            float y = 0.F;
+            if (!boxes.empty())
+            {
+                radius = std::max(boxes[0].w(), boxes[0].h()) * 2.5F;
+                x = boxes[0].w() * compareOptions.wipeCenter.x;
+                y = boxes[0].h() * compareOptions.wipeCenter.y;
+            }
+            const float rotation = compareOptions.wipeRotation;
+            ftk::V2F pts[4];
+            for (size_t i = 0; i < 4; ++i)
+            {
+                float rad = ftk::deg2rad(rotation + 90.F * i + 90.F);
+                pts[i] = p.toPixels(
+                    p.transform,
+                    ftk::V2F(cos(rad) * radius + x, sin(rad) * radius + y));
+            }
+
+            // The triangles mask the pixels as the stencil does for the
+            // OpenGL renderer.
+            const ftk::V2F a[3] = { pts[0], pts[1], pts[2] };
+            p.mask = [&a](float px, float py) { return inside(a, px, py); };
+            _drawVideoA(videoFrame, boxes, imageOptions, displayOptions);
+
+            const ftk::V2F b[3] = { pts[2], pts[3], pts[0] };
+            p.mask = [&b](float px, float py) { return inside(b, px, py); };
+            _drawVideoB(videoFrame, boxes, imageOptions, displayOptions);
+
+            p.mask = nullptr;
+        }
+
+        void Render::_drawVideoOverlay(
+            const std::vector<VideoFrame>& videoFrame,
+            const std::vector<ftk::Box2I>& boxes,
+            const std::vector<ftk::ImageOptions>& imageOptions,
+            const std::vector<DisplayOptions>& displayOptions,
+            const CompareOptions& compareOptions)
+        {
+            FTK_P();
+
+            _drawVideoB(videoFrame, boxes, imageOptions, displayOptions);
+            if (!videoFrame.empty() && !boxes.empty())
+            {
+                const ftk::Size2I size(boxes[0].w(), boxes[0].h());
+                Buffer& buffer = p.buffers["overlay"];
+                buffer.resize(size);
+                buffer.clear();
+                {
+                    BufferBinding binding(p, buffer);
+                    _drawVideo(
+                        videoFrame[0],
+                        ftk::Box2I(ftk::V2I(), size),
+                        !imageOptions.empty() ? std::make_shared<ftk::ImageOptions>(imageOptions[0]) : nullptr,
+                        !displayOptions.empty() ? displayOptions[0] : DisplayOptions(),
+                        ftk::ortho(
+                            0.F,
+                            static_cast<float>(size.w),
+                            static_cast<float>(size.h),
+                            0.F,
+                            -1.F,
+                            1.F));
+                }
+
+                const ftk::ImageFilters filters = imageFilters(imageOptions, 0);
+                const ftk::V2F scale = getScale(p, boxes[0], p.transform, size);
+                const float overlay = compareOptions.overlay;
+                p.drawBox(
+                    boxes[0],
+                    p.transform,
+                    true,
+                    Blend::Straight,
+                    [&buffer, &filters, scale, overlay](int count, const float* u, const float* v, float* out)
+                    {
+                        for (int i = 0; i < count; ++i, out += 4)
+                        {
+                            sample(
+                                buffer,
+                                u[i] * buffer.size.w,
+                                v[i] * buffer.size.h,
+                                scale.x,
+                                scale.y,
+                                filters,
+                                out);
+                            out[3] *= overlay;
+                        }
+                    });
+            }
+        }
+
+        bool Render::_drawVideoPair(
+            const std::vector<VideoFrame>& videoFrame,
+            const std::vector<ftk::Box2I>& boxes,
+            const std::vector<ftk::ImageOptions>& imageOptions,
+            const std::vector<DisplayOptions>& displayOptions)
+        {
+            FTK_P();
+            const ftk::Size2I size(boxes[0].w(), boxes[0].h());
+
+            // Each file into a buffer of its own, drawn through the whole
+            // display pipeline so that what is combined is what would have
+            // been shown.
+            for (size_t i = 0; i < 2; ++i)
+            {
+                const std::string name = ftk::Format("compare{0}").arg(i);
+                if (videoFrame.size() <= i || boxes.size() <= i)
+                {
+                    p.buffers.erase(name);
+                    continue;
+                }
+                Buffer& buffer = p.buffers[name];
+                buffer.resize(size);
+                buffer.clear();
+                BufferBinding binding(p, buffer);
+                _drawVideo(
+                    videoFrame[i],
+                    boxes[i],
+                    imageOptions.size() > i ?
+                        std::make_shared<ftk::ImageOptions>(imageOptions[i]) :
+                        nullptr,
+                    displayOptions.size() > i ?
+                        displayOptions[i] :
+                        DisplayOptions(),
+                    ftk::ortho(
+                        0.F,
+                        static_cast<float>(size.w),
+                        static_cast<float>(size.h),
+                        0.F,
+                        -1.F,
+                        1.F));
+            }
+
+            return p.buffers.count("compare0") && p.buffers.count("compare1");
+        }
+
+        void Render::_drawVideoButterfly(const ftk::Box2I& box)
+        {
+            FTK_P();
+            const Buffer& a = p.buffers["compare0"];
+            const Buffer& b = p.buffers["compare1"];
+            p.drawBox(
+                box,
+                p.transform,
+                true,
+                Blend::Premultiplied,
+                [&a, &b](int count, const float* u, const float* v, float* out)
+                {
+                    // The same half of both, the second one mirrored, so
+                    // that the middle of the picture is on both sides of
+                    // the seam.
+                    for (int i = 0; i < count; ++i, out += 4)
+                    {
+                        if (u[i] < .5F)
+                        {
+                            sampleLinear(a, u[i] * a.size.w, v[i] * a.size.h, out);
+                        }
+                        else
+                        {
+                            sampleLinear(b, (1.F - u[i]) * b.size.w, v[i] * b.size.h, out);
+                        }
+                    }
+                });
+        }
+
+        void Render::_drawVideoDifference(
+            const ftk::Box2I& box,
+            const CompareOptions& compareOptions)
+        {
+            FTK_P();
+            if (compareOptions.differenceStats)
+            {
+                _drawVideoPairStats(compareOptions.differenceThreshold);
+            }
+            const Buffer& a = p.buffers["compare0"];
+            const Buffer& b = p.buffers["compare1"];
+            const float gain = compareOptions.differenceGain;
+            p.drawBox(
+                box,
+                p.transform,
+                true,
+                Blend::Premultiplied,
+                [&a, &b, gain](int count, const float* u, const float* v, float* out)
+                {
+                    float cb[4];
+                    for (int i = 0; i < count; ++i, out += 4)
+                    {
+                        sampleLinear(a, u[i] * a.size.w, v[i] * a.size.h, out);
+                        sampleLinear(b, u[i] * b.size.w, v[i] * b.size.h, cb);
+                        out[0] = std::fabs(out[0] - cb[0]) * gain;
+                        out[1] = std::fabs(out[1] - cb[1]) * gain;
+                        out[2] = std::fabs(out[2] - cb[2]) * gain;
+                        out[3] = std::max(out[3], cb[3]);
+                    }
+                });
+        }
+
+        void Render::_drawVideoPairStats(float threshold)
+        {
+            FTK_P();
+            const Buffer& a = p.buffers["compare0"];
+            const Buffer& b = p.buffers["compare1"];
+            const ftk::Size2I size = a.size;
+            if (!size.isValid() || b.size != size)
+                return;
+
+            // The same measurements the OpenGL renderer reduces on the GPU,
+            // summed a band of rows at a time.
+            struct Sums
+            {
+                float maxError = 0.F;
+                double error = 0.0;
+                double squared = 0.0;
+                size_t thresholdCount = 0;
+                int minX = std::numeric_limits<int>::max();
+                int minY = std::numeric_limits<int>::max();
+                int maxX = -1;
+                int maxY = -1;
+            };
+            Sums sums;
+            std::mutex mutex;
+            parallelRows(
+                0,
+                size.h,
+                p.getThreadCount(),
+                [&](int y0, int y1)
+                {
+                    Sums band;
+                    for (int y = y0; y < y1; ++y)
+                    {
+                        const float* ra = a.getRow(y);
+                        const float* rb = b.getRow(y);
+                        for (int x = 0; x < size.w; ++x, ra += 4, rb += 4)
+                        {
+                            const float dr = std::fabs(ra[0] - rb[0]);
+                            const float dg = std::fabs(ra[1] - rb[1]);
+                            const float db = std::fabs(ra[2] - rb[2]);
+                            const float e = std::max(dr, std::max(dg, db));
+                            band.maxError = std::max(band.maxError, e);
+                            band.error += (dr + dg + db) / 3.0;
+                            band.squared += (dr * dr + dg * dg + db * db) / 3.0;
+                            if (e > threshold)
+                            {
+                                ++band.thresholdCount;
+                                band.minX = std::min(band.minX, x);
+                                band.minY = std::min(band.minY, y);
+                                band.maxX = std::max(band.maxX, x);
+                                band.maxY = std::max(band.maxY, y);
+                            }
+                        }
+                    }
+                    std::lock_guard<std::mutex> lock(mutex);
+                    sums.maxError = std::max(sums.maxError, band.maxError);
+                    sums.error += band.error;
+                    sums.squared += band.squared;
+                    sums.thresholdCount += band.thresholdCount;
+                    sums.minX = std::min(sums.minX, band.minX);
+                    sums.minY = std::min(sums.minY, band.minY);
+                    sums.maxX = std::max(sums.maxX, band.maxX);
+                    sums.maxY = std::max(sums.maxY, band.maxY);
+                });
+
+            CompareStats& stats = p.compareStats;
+            stats.valid = true;
+            stats.pixelCount = static_cast<size_t>(size.w) * size.h;
+            stats.maxError = sums.maxError;
+            stats.meanError = static_cast<float>(sums.error / stats.pixelCount);
+            const float mse = static_cast<float>(sums.squared / stats.pixelCount);
+            stats.psnr = mse > 0.F ?
+                (10.F * std::log10(1.F / mse)) :
+                std::numeric_limits<float>::infinity();
+            stats.thresholdCount = sums.thresholdCount;
+            if (stats.thresholdCount > 0)
+            {
+                // The buffer rows run bottom to top; the pair was drawn
+                // with the first row of the images at the top.
+                stats.thresholdBox = ftk::Box2I(
+                    sums.minX,
+                    size.h - 1 - sums.maxY,
+                    sums.maxX - sums.minX + 1,
+                    sums.maxY - sums.minY + 1);
+            }
+        }
+
+        void Render::_drawVideoTile(
+            const std::vector<VideoFrame>& videoFrame,
+            const std::vector<ftk::Box2I>& boxes,
+            const std::vector<ftk::ImageOptions>& imageOptions,
+            const std::vector<DisplayOptions>& displayOptions)
+        {
+            for (size_t i = 0; i < videoFrame.size() && i < boxes.size(); ++i)
+            {
+                _drawVideo(
+                    videoFrame[i],
+                    boxes[i],
+                    i < imageOptions.size() ? std::make_shared<ftk::ImageOptions>(imageOptions[i]) : nullptr,
+                    i < displayOptions.size() ? displayOptions[i] : DisplayOptions(),
+                    getTransform());
+            }
+        }
+
+        namespace
+        {
+            float knee(float x, float f)
+            {
+                return logf(x * f + 1.F) / f;
+            }
+
+            float knee2(float x, float y)
+            {
+                float f0 = 0.F;
+                float f1 = 1.F;
+                while (knee(x, f1) > y)
+                {
+                    f0 = f1;
+                    f1 = f1 * 2.F;
+                }
+                for (size_t i = 0; i < 30; ++i)
+                {
+                    const float f2 = (f0 + f1) / 2.F;
+                    if (knee(x, f2) < y)
+                    {
+                        f1 = f2;
+                    }
+                    else
+                    {
+                        f0 = f2;
+                    }
+                }
+                return (f0 + f1) / 2.F;
+            }
+
+            //! The color corrections of the display pipeline, with the
+            //! values the OpenGL renderer sets as uniforms.
+            struct Corrections
+            {
+                bool colorEnabled = false;
+                ftk::V3F colorAdd;
+                ftk::M44F colorMatrix;
+                bool levelsEnabled = false;
+                Levels levels;
+                float levelsGamma = 1.F;
+                bool exposureEnabled = false;
+                float v = 0.F;
+                float d = 0.F;
+                float k = 0.F;
+                float f = 0.F;
+                float g = 1.F;
+                float s = 1.F;
+                float softClip = 0.F;
+
+                explicit Corrections(const DisplayOptions& displayOptions)
+                {
+                    colorEnabled =
+                        displayOptions.color != Color() &&
+                        displayOptions.color.enabled;
+                    colorAdd = displayOptions.color.add;
+                    if (colorEnabled)
+                    {
+                        colorMatrix = color(displayOptions.color);
+                    }
+                    levelsEnabled = displayOptions.levels.enabled;
+                    levels = displayOptions.levels;
+                    levelsGamma = displayOptions.levels.gamma > 0.F ?
+                        (1.F / displayOptions.levels.gamma) :
+                        1000000.F;
+                    exposureEnabled = displayOptions.exposure.enabled;
+                    if (exposureEnabled)
+                    {
+                        v = powf(2.F, displayOptions.exposure.exposure + 2.47393F);
+                        d = displayOptions.exposure.defog;
+                        k = powf(2.F, displayOptions.exposure.kneeLow);
+                        f = knee2(
+                            powf(2.F, displayOptions.exposure.kneeHigh) - k,
+                            powf(2.F, 3.5F) - k);
+                        g = displayOptions.exposure.gamma > 0.F ?
+                            (1.F / displayOptions.exposure.gamma) :
+                            1000000.F;
+                        s = powf(2.F, -3.5F * g);
+                    }
+                    softClip = displayOptions.softClip.enabled ?
+                        displayOptions.softClip.value :
+                        0.F;
+                }
+
+                void apply(float* c) const
+                {
+                    if (colorEnabled)
+                    {
+                        const ftk::V4F tmp = colorMatrix * ftk::V4F(
+                            c[0] + colorAdd.x,
+                            c[1] + colorAdd.y,
+                            c[2] + colorAdd.z,
+                            1.F);
+                        c[0] = tmp.x;
+                        c[1] = tmp.y;
+                        c[2] = tmp.z;
+                    }
+                    if (levelsEnabled)
+                    {
+                        for (int i = 0; i < 3; ++i)
+                        {
+                            float tmp = (c[i] - levels.inLow) / levels.inHigh;
+                            if (tmp >= 0.F)
+                            {
+                                tmp = powf(tmp, levelsGamma);
+                            }
+                            c[i] = tmp * levels.outHigh + levels.outLow;
+                        }
+                    }
+                    if (exposureEnabled)
+                    {
+                        for (int i = 0; i < 3; ++i)
+                        {
+                            float tmp = std::max(0.F, c[i] - d) * v;
+                            if (tmp > k)
+                            {
+                                tmp = k + knee(tmp - k, f);
+                            }
+                            if (tmp > 0.F)
+                            {
+                                tmp = powf(tmp, g);
+                            }
+                            c[i] = tmp * s;
+                        }
+                    }
+                    if (softClip > 0.F)
+                    {
+                        const float tmp = 1.F - softClip;
+                        for (int i = 0; i < 3; ++i)
+                        {
+                            if (c[i] > tmp)
+                            {
+                                c[i] = tmp + (1.F - expf(-(c[i] - tmp) / softClip)) * softClip;
+                            }
+                        }
+                    }
+                }
+            };
+        }
+
+        void Render::_drawVideo(
+            const VideoFrame& videoFrame,
+            const ftk::Box2I& box,
+            const std::shared_ptr<ftk::ImageOptions>& imageOptions,
+            const DisplayOptions& displayOptions,
+            const ftk::M44F& mvp)
+        {
+            FTK_P();
+
+            const ftk::Size2I size = box.size();
+            const ftk::ImageFilters filters = imageOptions.get() ?
+                imageOptions->imageFilters :
+                ftk::ImageFilters();
+
+            // The box a layer occupies within the buffer, as the OpenGL
+            // renderer places it.
+            const auto layerBox = [&videoFrame, &size](
+                const std::optional<ftk::Box2F>& bounds)
+            {
+                ftk::Box2I out(ftk::V2I(), size);
+                if (bounds.has_value() && videoFrame.canvasSize.isValid())
+                {
+                    const float sx = size.w /
+                        static_cast<float>(videoFrame.canvasSize.w);
+                    const float sy = size.h /
+                        static_cast<float>(videoFrame.canvasSize.h);
+                    out = ftk::Box2I(
+                        ftk::V2I(
+                            std::lround(bounds.value().min.x * sx),
+                            std::lround(bounds.value().min.y * sy)),
+                        ftk::V2I(
+                            std::lround(bounds.value().max.x * sx),
+                            std::lround(bounds.value().max.y * sy)));
+                }
+                return out;
+            };
+
+            // Whether the layers composite in linear; see the OpenGL
+            // renderer.
+            bool perLayer = false;
+            std::vector<std::pair<std::string, std::string> > layerInputs;
+#if defined(TLRENDER_OCIO)
+            if (p.ocioOptions.enabled &&
+                !p.ocioOptions.display.empty() &&
+                !p.ocioOptions.view.empty())
+            {
+                const std::string itemInput = !displayOptions.ocioInput.empty() ?
+                    displayOptions.ocioInput :
+                    p.ocioOptions.input;
+                for (const auto& layer : videoFrame.layers)
+                {
+                    std::string in = _layerOCIOInput(
+                        layer.ocioInput, layer.path, layer.image);
+                    if (in.empty())
+                    {
+                        in = itemInput;
+                    }
+                    std::string inB = _layerOCIOInput(
+                        layer.ocioInputB, layer.pathB, layer.imageB);
+                    if (inB.empty())
+                    {
+                        inB = itemInput;
+                    }
+                    layerInputs.push_back(std::make_pair(in, inB));
+                }
+                std::string probe;
+                for (const auto& i : layerInputs)
+                {
+                    if (!i.first.empty())
+                    {
+                        probe = i.first;
+                        break;
+                    }
+                    if (!i.second.empty())
+                    {
+                        probe = i.second;
+                        break;
+                    }
+                }
+                if (!probe.empty())
+                {
+                    const auto data = p.getOCIOData(probe);
+                    perLayer = data && data->toLinear;
+                }
+            }
+#endif // TLRENDER_OCIO
+
+            // The transform of a layer to scene linear, applied to its
+            // colors ahead of the blend.
+            const auto toLinear = [&p](const std::string& input)
+            {
+                std::function<void(float*, int)> out;
+#if defined(TLRENDER_OCIO)
+                if (!input.empty())
+                {
+                    const auto data = p.getOCIOData(input);
+                    if (data && data->toLinear)
+                    {
+                        out = [data](float* colors, int count)
+                        {
+                            ocioApply(data->toLinear, colors, count);
+                        };
+                    }
+                }
+#endif // TLRENDER_OCIO
+                return out;
+            };
+
+            Buffer& video = p.buffers["video"];
+            video.resize(size);
+            video.clear();
+            {
+                BufferBinding binding(p, video);
+                const ftk::M44F transformPrev = p.transform;
+                p.transform = ftk::ortho(
+                    0.F,
+                    static_cast<float>(size.w),
+                    static_cast<float>(size.h),
+                    0.F,
+                    -1.F,
+                    1.F);
+
+                for (size_t layerIndex = 0; layerIndex < videoFrame.layers.size(); ++layerIndex)
+                {
+                    const auto& layer = videoFrame.layers[layerIndex];
+                    const std::string layerInput =
+                        perLayer && layerIndex < layerInputs.size() ?
+                        layerInputs[layerIndex].first :
+                        std::string();
+                    const std::string layerInputB =
+                        perLayer && layerIndex < layerInputs.size() ?
+                        layerInputs[layerIndex].second :
+                        std::string();
+                    const ftk::ImageFilters layerFilters = imageOptions.get() ?
+                        imageOptions->imageFilters :
+                        layer.imageOptions.imageFilters;
+                    const ftk::ImageFilters layerFiltersB = imageOptions.get() ?
+                        imageOptions->imageFilters :
+                        layer.imageOptionsB.imageFilters;
+                    switch (layer.transition)
+                    {
+                    case Transition::Dissolve:
+                    {
+                        if (layer.image && layer.imageB)
+                        {
+                            Buffer& dissolve = p.buffers["dissolve"];
+                            dissolve.resize(size);
+                            dissolve.clear();
+                            {
+                                BufferBinding binding(p, dissolve);
+                                p.drawImage(
+                                    layer.image,
+                                    getBox(
+                                        layerBox(layer.bounds),
+                                        layer.image->getInfo(),
+                                        displayOptions.aspectRatio),
+                                    ftk::Color4F(1.F, 1.F, 1.F),
+                                    layerFilters,
+                                    Blend::None,
+                                    toLinear(layerInput));
+                            }
+                            Buffer& dissolve2 = p.buffers["dissolve2"];
+                            dissolve2.resize(size);
+                            dissolve2.clear();
+                            {
+                                BufferBinding binding(p, dissolve2);
+                                p.drawImage(
+                                    layer.imageB,
+                                    getBox(
+                                        layerBox(layer.boundsB),
+                                        layer.imageB->getInfo(),
+                                        displayOptions.aspectRatio),
+                                    ftk::Color4F(1.F, 1.F, 1.F),
+                                    layerFiltersB,
+                                    Blend::None,
+                                    toLinear(layerInputB));
+                            }
+                            const float t = layer.transitionValue;
+                            p.drawBox(
+                                ftk::Box2I(ftk::V2I(), size),
+                                p.transform,
+                                true,
+                                Blend::Straight,
+                                [&dissolve, &dissolve2, t](int count, const float* u, const float* v, float* out)
+                                {
+                                    float c2[4];
+                                    for (int i = 0; i < count; ++i, out += 4)
+                                    {
+                                        const float x = u[i] * dissolve.size.w;
+                                        const float y = v[i] * dissolve.size.h;
+                                        sampleNearest(dissolve, x, y, out);
+                                        sampleNearest(dissolve2, x, y, c2);
+                                        for (int j = 0; j < 4; ++j)
+                                        {
+                                            out[j] = out[j] * (1.F - t) + c2[j] * t;
+                                        }
+                                    }
+                                });
+                        }
+                        else if (layer.image)
+                        {
+                            p.drawImage(
+                                layer.image,
+                                getBox(
+                                    layerBox(layer.bounds),
+                                    layer.image->getInfo(),
+                                    displayOptions.aspectRatio),
+                                ftk::Color4F(1.F, 1.F, 1.F, 1.F - layer.transitionValue),
+                                layerFilters,
+                                Blend::Straight,
+                                toLinear(layerInput));
+                        }
+                        else if (layer.imageB)
+                        {
+                            p.drawImage(
+                                layer.imageB,
+                                getBox(
+                                    layerBox(layer.boundsB),
+                                    layer.imageB->getInfo(),
+                                    displayOptions.aspectRatio),
+                                ftk::Color4F(1.F, 1.F, 1.F, layer.transitionValue),
+                                layerFiltersB,
+                                Blend::Straight,
+                                toLinear(layerInputB));
+                        }
+                        break;
+                    }
+                    default:
+                        if (layer.image)
+                        {
+                            p.drawImage(
+                                layer.image,
+                                getBox(
+                                    layerBox(layer.bounds),
+                                    layer.image->getInfo(),
+                                    displayOptions.aspectRatio),
+                                ftk::Color4F(1.F, 1.F, 1.F),
+                                layerFilters,
+                                Blend::Straight,
+                                toLinear(layerInput));
+                        }
+                        break;
+                    }
+                }
+
+                p.transform = transformPrev;
+            }
+
+            // The display pipeline, in the order of the OpenGL renderer's
+            // display shader.
+            std::function<void(float*, int)> before;
+            std::function<void(float*, int)> after;
+#if defined(TLRENDER_OCIO)
+            std::shared_ptr<OCIOData> ocioData;
+            if (p.ocioOptions.enabled &&
+                !p.ocioOptions.display.empty() &&
+                !p.ocioOptions.view.empty())
+            {
+                const std::string input = perLayer ?
+                    std::string("scene_linear") :
+                    (!displayOptions.ocioInput.empty() ? displayOptions.ocioInput : p.ocioOptions.input);
+                if (!input.empty())
+                {
+                    ocioData = p.getOCIOData(input);
+                }
+            }
+            OCIO::ConstCPUProcessorRcPtr toLinearProcessor;
+            OCIO::ConstCPUProcessorRcPtr displayProcessor;
+            OCIO::ConstCPUProcessorRcPtr lutProcessor;
+            if (ocioData)
+            {
+                toLinearProcessor = ocioData->toLinear;
+                displayProcessor = ocioData->display;
+            }
+            if (p.lutData)
+            {
+                lutProcessor = p.lutData->cpuProcessor;
+            }
+            const LUTOrder lutOrder = p.lutOptions.order;
+            before = [toLinearProcessor, lutProcessor, lutOrder](float* c, int count)
+            {
+                if (LUTOrder::PreConfig == lutOrder)
+                {
+                    ocioApply(lutProcessor, c, count);
+                }
+                ocioApply(toLinearProcessor, c, count);
+            };
+            after = [displayProcessor, lutProcessor, lutOrder](float* c, int count)
+            {
+                ocioApply(displayProcessor, c, count);
+                if (LUTOrder::PostConfig == lutOrder)
+                {
+                    ocioApply(lutProcessor, c, count);
+                }
+            };
+#endif // TLRENDER_OCIO
+
+            const Corrections corrections(displayOptions);
+            const ftk::ChannelDisplay channels = displayOptions.channels;
+            const bool negative = displayOptions.negative;
+            const bool mirrorX = displayOptions.mirror.x;
+            const bool mirrorY = displayOptions.mirror.y;
+            const ftk::V2F scale = getScale(p, box, mvp, size);
+            p.drawBox(
+                box,
+                mvp,
+                true,
+                Blend::Premultiplied,
+                [&](int count, const float* u, const float* v, float* out)
+                {
+                    float* c = out;
+                    for (int i = 0; i < count; ++i, c += 4)
+                    {
+                        sample(
+                            video,
+                            (mirrorX ? (1.F - u[i]) : u[i]) * size.w,
+                            (mirrorY ? (1.F - v[i]) : v[i]) * size.h,
+                            scale.x,
+                            scale.y,
+                            filters,
+                            c);
+                        if (negative)
+                        {
+                            c[0] = 1.F - c[0];
+                            c[1] = 1.F - c[1];
+                            c[2] = 1.F - c[2];
+                        }
+                    }
+                    if (before)
+                    {
+                        before(out, count);
+                    }
+                    c = out;
+                    for (int i = 0; i < count; ++i, c += 4)
+                    {
+                        corrections.apply(c);
+                    }
+                    if (after)
+                    {
+                        after(out, count);
+                    }
+                    c = out;
+                    for (int i = 0; i < count; ++i, c += 4)
+                    {
+                        switch (channels)
+                        {
+                        case ftk::ChannelDisplay::Red:
+                            c[1] = c[0];
+                            c[2] = c[0];
+                            break;
+                        case ftk::ChannelDisplay::Green:
+                            c[0] = c[1];
+                            c[2] = c[1];
+                            break;
+                        case ftk::ChannelDisplay::Blue:
+                            c[0] = c[2];
+                            c[1] = c[2];
+                            break;
+                        case ftk::ChannelDisplay::Alpha:
+                            c[0] = c[3];
+                            c[1] = c[3];
+                            c[2] = c[3];
+                            break;
+                        default: break;
+                        }
+                    }
+                });
+        }
+    }
+}
@@ -0,0 +1,325 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/CPUTest/RenderTest.h>
+
+#include <tlRender/CPU/Render.h>
+
+#include <tlRender/Timeline/CompareOptions.h>
+#include <tlRender/Timeline/DisplayOptions.h>
+#include <tlRender/Timeline/Transition.h>
+
+#include <ftk/Core/Assert.h>
+#include <ftk/Core/Context.h>
+#include <ftk/Core/FontSystem.h>
+#include <ftk/Core/Format.h>
+
+#include <cmath>
+
+namespace tl
+{
+    namespace cpu_test
+    {
+        RenderTest::RenderTest(const std::shared_ptr<ftk::Context>& context) :
+            ITest(context, "tl::cpu_test::RenderTest")
+        {}
+
+        RenderTest::~RenderTest()
+        {}
+
+        std::shared_ptr<RenderTest> RenderTest::create(
+            const std::shared_ptr<ftk::Context>& context)
+        {
+            return std::shared_ptr<RenderTest>(new RenderTest(context));
+        }
+
+        namespace
+        {
+            const ftk::Size2I imageSize(64, 32);
+
+            std::shared_ptr<ftk::Image> createImage(uint8_t value)
+            {
+                auto out = ftk::Image::create(imageSize, ftk::ImageType::RGBA_U8);
+                uint8_t* p = out->getData();
+                std::fill(p, p + out->getByteCount(), value);
+                return out;
+            }
+
+            VideoFrame createFrame(uint8_t value)
+            {
+                VideoLayer layer;
+                layer.image = createImage(value);
+                VideoFrame out;
+                out.size = imageSize;
+                out.layers.push_back(layer);
+                return out;
+            }
+
+            //! A pixel of the render, counting rows from the top; the image
+            //! rows run bottom to top as glReadPixels() gives them.
+            const uint8_t* getPixel(const std::shared_ptr<ftk::Image>& image, int x, int y)
+            {
+                const ftk::Size2I& size = image->getSize();
+                return image->getData() + ((size.h - 1 - y) * size.w + x) * 4;
+            }
+        }
+
+        void RenderTest::run()
+        {
+            _image();
+            _prims();
+            _dissolve();
+            _display();
+            _compare();
+            _compareStats();
+        }
+
+        void RenderTest::_image()
+        {
+            auto render = cpu::Render::create(
+                _context->getLogSystem(),
+                _context->getSystem<ftk::FontSystem>());
+            render->begin(imageSize);
+            FTK_CHECK(imageSize == render->getRenderSize());
+            render->drawRect(
+                ftk::Box2F(0.F, 0.F, imageSize.w, 1.F),
+                ftk::Color4F(1.F, 0.F, 0.F));
+            render->end();
+
+            auto image = render->getImage(ftk::ImageType::RGBA_U8);
+            FTK_CHECK(imageSize == image->getSize());
+            const uint8_t* p = getPixel(image, 0, 0);
+            FTK_CHECK(255 == p[0] && 0 == p[1] && 0 == p[2] && 255 == p[3]);
+            p = getPixel(image, 0, 1);
+            FTK_CHECK(0 == p[0] && 0 == p[3]);
+
+            for (auto type : {
+                ftk::ImageType::L_U8,
+                ftk::ImageType::RGB_U16,
+                ftk::ImageType::RGBA_F16,
+                ftk::ImageType::RGBA_F32 })
+            {
+                image = render->getImage(type);
+                FTK_CHECK(type == image->getType());
+            }
+
+            try
+            {
+                render->copyImage(ftk::Image::create(
+                    ftk::Size2I(1, 1),
+                    ftk::ImageType::RGBA_U8));
+                FTK_CHECK(false);
+            }
+            catch (const std::exception&)
+            {}
+        }
+
+        void RenderTest::_prims()
+        {
+            auto render = cpu::Render::create(
+                _context->getLogSystem(),
+                _context->getSystem<ftk::FontSystem>());
+            render->begin(imageSize);
+            render->setClipRectEnabled(true);
+            render->setClipRect(ftk::Box2I(0, 0, 8, 8));
+            render->drawRect(
+                ftk::Box2F(0.F, 0.F, imageSize.w, imageSize.h),
+                ftk::Color4F(1.F, 1.F, 1.F));
+            render->setClipRectEnabled(false);
+            render->drawLine(
+                ftk::V2F(0.F, 20.5F),
+                ftk::V2F(imageSize.w, 20.5F),
+                ftk::Color4F(0.F, 1.F, 0.F));
+            render->end();
+
+            auto image = render->getImage(ftk::ImageType::RGBA_U8);
+            FTK_CHECK(255 == getPixel(image, 4, 4)[0]);
+            FTK_CHECK(0 == getPixel(image, 10, 10)[3]);
+            FTK_CHECK(255 == getPixel(image, 30, 20)[1]);
+        }
+
+        void RenderTest::_dissolve()
+        {
+            auto render = cpu::Render::create(
+                _context->getLogSystem(),
+                _context->getSystem<ftk::FontSystem>());
+
+            VideoLayer layer;
+            layer.image = createImage(0);
+            layer.imageB = createImage(255);
+            layer.transition = Transition::Dissolve;
+            VideoFrame frame;
+            frame.size = imageSize;
+            frame.layers.push_back(layer);
+            const std::vector<ftk::Box2I> boxes =
+            {
+                ftk::Box2I(0, 0, imageSize.w, imageSize.h)
+            };
+            for (float value : { 0.F, .5F, 1.F })
+            {
+                frame.layers[0].transitionValue = value;
+                render->begin(imageSize);
+                render->drawVideo({ frame }, boxes);
+                render->end();
+                auto image = render->getImage(ftk::ImageType::RGBA_U8);
+                const uint8_t* p = getPixel(image, 10, 10);
+                _print(ftk::Format("Dissolve: {0}: {1}").arg(value).arg(static_cast<int>(p[0])));
+                FTK_CHECK(std::abs(p[0] - value * 255.F) <= 1.F);
+                FTK_CHECK(255 == p[3]);
+            }
+        }
+
+        void RenderTest::_display()
+        {
+            auto render = cpu::Render::create(
+                _context->getLogSystem(),
+                _context->getSystem<ftk::FontSystem>());
+
+            const std::vector<VideoFrame> frames = { createFrame(128) };
+            const std::vector<ftk::Box2I> boxes =
+            {
+                ftk::Box2I(0, 0, imageSize.w, imageSize.h)
+            };
+
+            {
+                DisplayOptions o;
+                o.negative = true;
+                render->begin(imageSize);
+                render->drawVideo(frames, boxes, {}, { o });
+                render->end();
+                auto image = render->getImage(ftk::ImageType::RGBA_U8);
+                FTK_CHECK(127 == getPixel(image, 10, 10)[0]);
+            }
+            {
+                // Levels that map the value to the top of the range.
+                DisplayOptions o;
+                o.levels.enabled = true;
+                o.levels.inLow = 0.F;
+                o.levels.inHigh = 128.F / 255.F;
+                render->begin(imageSize);
+                render->drawVideo(frames, boxes, {}, { o });
+                render->end();
+                auto image = render->getImage(ftk::ImageType::RGBA_U8);
+                FTK_CHECK(255 == getPixel(image, 10, 10)[0]);
+            }
+            {
+                DisplayOptions o;
+                o.exposure.enabled = true;
+                o.exposure.exposure = 1.F;
+                o.exposure.defog = .1F;
+                o.exposure.kneeLow = -1.F;
+                o.exposure.kneeHigh = 1.F;
+                o.softClip.enabled = true;
+                o.softClip.value = .5F;
+                o.channels = ftk::ChannelDisplay::Red;
+                render->begin(imageSize);
+                render->drawVideo(frames, boxes, {}, { o });
+                render->end();
+                auto image = render->getImage(ftk::ImageType::RGBA_U8);
+                const uint8_t* p = getPixel(image, 10, 10);
+                FTK_CHECK(p[0] == p[1] && p[0] == p[2]);
+            }
+        }
+
+        void RenderTest::_compare()
+        {
+            auto render = cpu::Render::create(
+                _context->getLogSystem(),
+                _context->getSystem<ftk::FontSystem>());
+            const std::vector<VideoFrame> frames = { createFrame(0), createFrame(255) };
+            const std::vector<ftk::Box2I> boxes =
+            {
+                ftk::Box2I(ftk::V2I(), imageSize),
+                ftk::Box2I(ftk::V2I(), imageSize)
+            };
+            for (auto compare : getCompareEnums())
+            {
+                CompareOptions options;
+                options.compare = compare;
+                render->begin(imageSize);
+                render->drawVideo(frames, boxes, {}, {}, options);
+                render->end();
+                auto image = render->getImage(ftk::ImageType::RGBA_U8);
+                _print(ftk::Format("Compare {0}: {1}").
+                    arg(compare).
+                    arg(static_cast<int>(getPixel(image, 10, 10)[0])));
+                if (Compare::Wipe == compare)
+                {
+                    // The first file on the left of the wipe, the second on
+                    // the right.
+                    FTK_CHECK(0 == getPixel(image, 2, 16)[0]);
+                    FTK_CHECK(255 == getPixel(image, imageSize.w - 3, 16)[0]);
+                }
+                else if (Compare::Difference == compare)
+                {
+                    FTK_CHECK(255 == getPixel(image, 10, 10)[0]);
+                }
+            }
+        }
+
+        void RenderTest::_compareStats()
+        {
+            auto render = cpu::Render::create(
+                _context->getLogSystem(),
+                _context->getSystem<ftk::FontSystem>());
+            const std::vector<ftk::Box2I> boxes =
+            {
+                ftk::Box2I(ftk::V2I(), imageSize),
+                ftk::Box2I(ftk::V2I(), imageSize)
+            };
+            CompareOptions compareOptions;
+            compareOptions.compare = Compare::Difference;
+            compareOptions.differenceStats = true;
+            compareOptions.differenceThreshold = .1F;
+
+            auto draw = [&](const std::vector<VideoFrame>& frames)
+            {
+                render->begin(imageSize);
+                render->drawVideo(
+                    frames,
+                    boxes,
+                    { ftk::ImageOptions(), ftk::ImageOptions() },
+                    { DisplayOptions(), DisplayOptions() },
+                    compareOptions);
+                render->end();
+                return render->getCompareStats();
+            };
+
+            // The same picture twice.
+            CompareStats stats = draw({ createFrame(128), createFrame(128) });
+            FTK_CHECK(stats.valid);
+            FTK_CHECK(static_cast<size_t>(imageSize.w * imageSize.h) == stats.pixelCount);
+            FTK_CHECK(0.F == stats.maxError);
+            FTK_CHECK(0.F == stats.meanError);
+            FTK_CHECK(std::isinf(stats.psnr));
+            FTK_CHECK(0 == stats.thresholdCount);
+
+            // Black against white, which differs everywhere by full scale.
+            stats = draw({ createFrame(0), createFrame(255) });
+            FTK_CHECK(stats.valid);
+            FTK_CHECK(1.F == stats.maxError);
+            FTK_CHECK(1.F == stats.meanError);
+            FTK_CHECK(0.F == stats.psnr);
+            FTK_CHECK(static_cast<size_t>(imageSize.w * imageSize.h) == stats.thresholdCount);
+            FTK_CHECK(ftk::Box2I(ftk::V2I(), imageSize) == stats.thresholdBox);
+
+            // One pixel, which the box has to find.
+            VideoFrame frame = createFrame(128);
+            auto image = createImage(128);
+            uint8_t* p = image->getData() + (5 * imageSize.w + 10) * 4;
+            p[0] = 0;
+            frame.layers[0].image = image;
+            stats = draw({ createFrame(128), frame });
+            FTK_CHECK(1 == stats.thresholdCount);
+            FTK_CHECK(ftk::Box2I(10, 5, 1, 1) == stats.thresholdBox);
+            _print(ftk::Format("Compare stats: max {0} mean {1} PSNR {2}").
+                arg(stats.maxError).
+                arg(stats.meanError).
+                arg(stats.psnr));
+
+            // Without the pair there is nothing measured.
+            stats = draw({ createFrame(128) });
+            FTK_CHECK(!stats.valid);
+        }
+    }
+}
@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/CorePy/Bindings.h>
+
+#include <tlRender/Core/Audio.h>
+
+#include <ftk/Core/Image.h>
+
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include <algorithm>
+
+namespace py = pybind11;
+
+namespace tl
+{
+    namespace python
+    {
+        namespace
+        {
+            //! Get the NumPy type of an image channel, or an empty string
+            //! when the channels are not whole bytes.
+            std::string getFormat(ftk::ImageType type)
+            {
+                std::string out;
+                switch (type)
+                {
+                case ftk::ImageType::L_U8:
+                case ftk::ImageType::LA_U8:
+                case ftk::ImageType::RGB_U8:
+                case ftk::ImageType::RGBA_U8:
+                    out = py::format_descriptor<uint8_t>::format();
+                    break;
+                case ftk::ImageType::L_U16:
+                case ftk::ImageType::LA_U16:
+                case ftk::ImageType::RGB_U16:
+                case ftk::ImageType::RGBA_U16:
+                    out = py::format_descriptor<uint16_t>::format();
+                    break;
+                case ftk::ImageType::L_U32:
+                case ftk::ImageType::LA_U32:
+                case ftk::ImageType::RGB_U32:
+                case ftk::ImageType::RGBA_U32:
+                    out = py::format_descriptor<uint32_t>::format();
+                    break;
+                case ftk::ImageType::L_F16:
+                case ftk::ImageType::LA_F16:
+                case ftk::ImageType::RGB_F16:
+                case ftk::ImageType::RGBA_F16:
+                    out = "e";
+                    break;
+                case ftk::ImageType::L_F32:
+                case ftk::ImageType::LA_F32:
+                case ftk::ImageType::RGB_F32:
+                case ftk::ImageType::RGBA_F32:
+                    out = py::format_descriptor<float>::format();
+                    break;
+                default: break;
+                }
+                return out;
+            }
+
+            py::buffer_info getBufferInfo(const std::shared_ptr<ftk::Image>& image)
+            {
+                // Rows, columns, and channels, in the order they are shown: an
+                // image stored bottom up is given a negative row stride. The
+                // planar YUV and packed types are given as their bytes.
+                const ftk::ImageInfo& info = image->getInfo();
+                const std::string format = getFormat(info.type);
+                if (format.empty())
+                {
+                    return py::buffer_info(
+                        image->getData(),
+                        1,
+                        py::format_descriptor<uint8_t>::format(),
+                        1,
+                        { static_cast<py::ssize_t>(image->getByteCount()) },
+                        { static_cast<py::ssize_t>(1) });
+                }
+                const py::ssize_t channelCount = ftk::getChannelCount(info.type);
+                const py::ssize_t channelByteCount = ftk::getBitDepth(info.type) / 8;
+                const py::ssize_t alignment = std::max(info.layout.alignment, 1);
+                py::ssize_t rowByteCount = info.size.w * channelCount * channelByteCount;
+                rowByteCount = (rowByteCount + alignment - 1) / alignment * alignment;
+                uint8_t* data = image->getData();
+                py::ssize_t rowStride = rowByteCount;
+                if (info.layout.mirror.y && info.size.h > 0)
+                {
+                    data += (info.size.h - 1) * rowByteCount;
+                    rowStride = -rowByteCount;
+                }
+                return py::buffer_info(
+                    data,
+                    channelByteCount,
+                    format,
+                    3,
+                    {
+                        static_cast<py::ssize_t>(info.size.h),
+                        static_cast<py::ssize_t>(info.size.w),
+                        channelCount
+                    },
+                    {
+                        rowStride,
+                        channelCount * channelByteCount,
+                        channelByteCount
+                    });
+            }
+        }
+
+        void array(py::module_& m)
+        {
+            // The arrays view the memory rather than copying it, and keep
+            // the image or audio alive for as long as they do.
+            m.def(
+                "imageArray",
+                [](const std::shared_ptr<ftk::Image>& image)
+                {
+                    if (!image)
+                    {
+                        throw py::value_error("The image is null");
+                    }
+                    const py::buffer_info info = getBufferInfo(image);
+                    return py::array(
+                        py::dtype(info),
+                        info.shape,
+                        info.strides,
+                        info.ptr,
+                        py::capsule(
+                            new std::shared_ptr<ftk::Image>(image),
+                            [](void* value)
+                            {
+                                delete static_cast<std::shared_ptr<ftk::Image>*>(value);
+                            }));
+                },
+                py::arg("image"),
+                "Get a NumPy array that views the image memory.");
+
+            m.def(
+                "audioArray",
+                [](const std::shared_ptr<Audio>& audio)
+                {
+                    if (!audio)
+                    {
+                        throw py::value_error("The audio is null");
+                    }
+                    return py::array::ensure(py::cast(audio));
+                },
+                py::arg("audio"),
+                "Get a NumPy array that views the audio memory.");
+        }
+    }
+}
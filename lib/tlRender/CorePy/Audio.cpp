@@ -42,10 +42,41 @@ namespace tl
                 .def(pybind11::self == pybind11::self)
                 .def(pybind11::self != pybind11::self);
             
-            py::class_<Audio, std::shared_ptr<Audio> >(m, "Audio")
+            // The buffer is the samples by the channels, so that NumPy can
+            // view the audio without a copy.
+            py::class_<Audio, std::shared_ptr<Audio> >(m, "Audio", py::buffer_protocol())
                 .def(py::init(&Audio::create),
                     py::arg("info"),
                     py::arg("sampleCount"))
+                .def_buffer(
+                    [](Audio& value)
+                    {
+                        const AudioInfo& info = value.getInfo();
+                        const py::ssize_t byteCount = getByteCount(info.type);
+                        std::string format;
+                        switch (info.type)
+                        {
+                        case AudioType::S8: format = py::format_descriptor<int8_t>::format(); break;
+                        case AudioType::S16: format = py::format_descriptor<int16_t>::format(); break;
+                        case AudioType::S32: format = py::format_descriptor<int32_t>::format(); break;
+                        case AudioType::F32: format = py::format_descriptor<float>::format(); break;
+                        case AudioType::F64: format = py::format_descriptor<double>::format(); break;
+                        default: break;
+                        }
+                        return py::buffer_info(
+                            value.getData(),
+                            byteCount,
+                            format,
+                            2,
+                            {
+                                static_cast<py::ssize_t>(value.getSampleCount()),
+                                static_cast<py::ssize_t>(info.channelCount)
+                            },
+                            {
+                                static_cast<py::ssize_t>(info.channelCount * byteCount),
+                                byteCount
+                            });
+                    })
                 .def_property_readonly("info", &Audio::getInfo, py::return_value_policy::copy)
                 .def_property_readonly("channelCount", &Audio::getChannelCount)
                 .def_property_readonly("type", &Audio::getType)
@@ -15,6 +15,7 @@ namespace tl
         {
             audio(m);
             audioResample(m);
+            array(m);
             hdr(m);
             time(m);
             url(m);
@@ -11,6 +11,7 @@ namespace tl
 {
     namespace python
     {
+        TL_API void array(pybind11::module_&);
         TL_API void audio(pybind11::module_&);
         TL_API void audioResample(pybind11::module_&);
         TL_API void hdr(pybind11::module_&);
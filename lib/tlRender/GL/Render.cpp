@@ -7,8 +7,10 @@
 #include <ftk/GL/Util.h>
 #include <ftk/Core/Format.h>
 #include <ftk/Core/LogSystem.h>
+#include <ftk/Core/Memory.h>
 
 #include <array>
+#include <atomic>
 #include <list>
 
 #define _USE_MATH_DEFINES
@@ -18,6 +20,25 @@ namespace tl
 {
     namespace gl
     {
+        bool TileOptions::operator == (const TileOptions& other) const
+        {
+            return
+                threshold == other.threshold &&
+                size == other.size &&
+                cacheMB == other.cacheMB;
+        }
+
+        bool TileOptions::operator != (const TileOptions& other) const
+        {
+            return !(*this == other);
+        }
+
+        namespace
+        {
+            std::atomic<size_t> frameUploadByteCount(0);
+            std::atomic<size_t> tileByteCount(0);
+        }
+
 #if defined(TLRENDER_OCIO)
         OCIOTexture::OCIOTexture(
             unsigned id,
@@ -274,6 +295,7 @@ namespace tl
             IRender::_init(logSystem, fontSystem);
             FTK_P();
             p.baseRender = ftk::gl::Render::create(logSystem, fontSystem);
+            p.tiles.setMax(p.tileOptions.cacheMB * ftk::megabyte);
         }
 
         Render::Render() :
@@ -281,7 +303,9 @@ namespace tl
         {}
 
         Render::~Render()
-        {}
+        {
+            tileByteCount -= _p->tileByteCount;
+        }
 
         std::shared_ptr<Render> Render::create(
             const std::shared_ptr<ftk::LogSystem>& logSystem,
@@ -300,6 +324,16 @@ namespace tl
 
             p.baseRender->begin(renderSize, renderOptions);
 
+            if (0 == p.maxTextureSize)
+            {
+                GLint maxTextureSize = 0;
+                glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+                p.maxTextureSize = maxTextureSize;
+            }
+            p.uploadStats = UploadStats();
+            std::swap(p.uploadImages, p.uploadImagesPrev);
+            p.uploadImages.clear();
+
             if (!p.shaders["wipe"])
             {
                 p.shaders["wipe"] = ftk::gl::Shader::create(
@@ -312,6 +346,12 @@ namespace tl
                     vertexSource(),
                     textureFragmentSource());
             }
+            if (!p.shaders["tile"])
+            {
+                p.shaders["tile"] = ftk::gl::Shader::create(
+                    vertexSource(),
+                    textureFragmentSource());
+            }
             if (!p.shaders["butterfly"])
             {
                 p.shaders["butterfly"] = ftk::gl::Shader::create(
@@ -324,6 +364,14 @@ namespace tl
                     vertexSource(),
                     differenceFragmentSource());
             }
+#if !defined(FTK_API_GLES_2)
+            if (!p.shaders["differenceStats"])
+            {
+                p.shaders["differenceStats"] = ftk::gl::Shader::create(
+                    vertexSource(),
+                    differenceStatsFragmentSource());
+            }
+#endif // FTK_API_GLES_2
             if (!p.shaders["dissolve"])
             {
                 p.shaders["dissolve"] = ftk::gl::Shader::create(
@@ -344,6 +392,51 @@ namespace tl
         {
             FTK_P();
             p.baseRender->end();
+
+            p.uploadStatsFrame = p.uploadStats;
+            frameUploadByteCount = p.uploadStats.frameByteCount;
+            const size_t tileByteCountNew = p.tiles.getSize();
+            tileByteCount += tileByteCountNew;
+            tileByteCount -= p.tileByteCount;
+            p.tileByteCount = tileByteCountNew;
+        }
+
+        const TileOptions& Render::getTileOptions() const
+        {
+            return _p->tileOptions;
+        }
+
+        void Render::setTileOptions(const TileOptions& value)
+        {
+            FTK_P();
+            if (value == p.tileOptions)
+                return;
+            const bool clear = value.size != p.tileOptions.size;
+            p.tileOptions = value;
+            if (clear)
+            {
+                p.tiles.clear();
+            }
+            p.tiles.setMax(p.tileOptions.cacheMB * ftk::megabyte);
+        }
+
+        UploadStats Render::getUploadStats() const
+        {
+            FTK_P();
+            UploadStats out = p.uploadStatsFrame;
+            out.tileCount = p.tiles.getCount();
+            out.tileByteCount = p.tiles.getSize();
+            return out;
+        }
+
+        size_t Render::getFrameUploadByteCount()
+        {
+            return frameUploadByteCount;
+        }
+
+        size_t Render::getTileByteCount()
+        {
+            return tileByteCount;
         }
 
         void Render::setOCIOOptions(const OCIOOptions& value)
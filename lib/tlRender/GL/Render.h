@@ -17,6 +17,44 @@ namespace tl
         struct OCIOData;
 #endif // TLRENDER_OCIO
 
+        //! Options for drawing large images in tiles.
+        //!
+        //! A tiled image is uploaded a tile at a time, and only the tiles
+        //! that are in view, reduced to about the size they are drawn at.
+        //! The tiles stay on the GPU between frames until the cache is
+        //! full.
+        struct TL_API_TYPE TileOptions
+        {
+            //! Images wider or taller than this are drawn in tiles. Images
+            //! larger than the maximum texture size always are.
+            int threshold = 8192;
+
+            //! Tile size.
+            int size = 1024;
+
+            //! Tile cache size in megabytes.
+            float cacheMB = 512.F;
+
+            TL_API bool operator == (const TileOptions&) const;
+            TL_API bool operator != (const TileOptions&) const;
+        };
+
+        //! Texture upload statistics.
+        struct TL_API_TYPE UploadStats
+        {
+            //! Bytes uploaded for the last frame.
+            size_t frameByteCount = 0;
+
+            //! Tiles uploaded for the last frame.
+            size_t frameTileCount = 0;
+
+            //! Tiles in the cache.
+            size_t tileCount = 0;
+
+            //! Bytes in the tile cache.
+            size_t tileByteCount = 0;
+        };
+
         //! Timeline OpenGL renderer.
         class TL_API_TYPE Render : public IRender
         {
@@ -44,6 +82,22 @@ namespace tl
                     const ftk::ImageTags&)>&) override;
             TL_API void setLUTOptions(const LUTOptions&) override;
 
+            //! Get the tile options.
+            TL_API const TileOptions& getTileOptions() const;
+
+            //! Set the tile options.
+            TL_API void setTileOptions(const TileOptions&);
+
+            //! Get the texture upload statistics.
+            TL_API UploadStats getUploadStats() const;
+
+            //! Get the bytes uploaded for the last frame any renderer
+            //! finished.
+            TL_API static size_t getFrameUploadByteCount();
+
+            //! Get the bytes in the tile caches of all the renderers.
+            TL_API static size_t getTileByteCount();
+
             TL_API void drawBackground(
                 const std::vector<ftk::Box2I>&,
                 const ftk::M44F& vm,
@@ -56,6 +110,7 @@ namespace tl
                 const std::vector<DisplayOptions>& = {},
                 const CompareOptions& = CompareOptions(),
                 ftk::gl::TextureType colorBuffer = ftk::gl::offscreenColorDefault) override;
+            TL_API CompareStats getCompareStats() const override;
             TL_API void drawForeground(
                 const std::vector<ftk::Box2I>&,
                 const ftk::M44F& vm,
@@ -133,6 +188,18 @@ namespace tl
 #endif // TLRENDER_OCIO
             std::shared_ptr<ftk::gl::Shader> _toLinearShader(
                 const std::string& input);
+            //! Draw an image in tiles. Answers false when the image is
+            //! drawn whole instead.
+            bool _drawImageTiles(
+                const std::shared_ptr<ftk::Image>&,
+                const ftk::Box2F&,
+                const ftk::Color4F&,
+                const ftk::ImageOptions&);
+            //! Count an image drawn whole towards the uploads.
+            void _countUpload(
+                const std::shared_ptr<ftk::Image>&,
+                const ftk::ImageOptions&);
+
             std::string _layerOCIOInput(
                 const std::string& layerInput,
                 const std::string& path,
@@ -193,6 +260,8 @@ namespace tl
             void _drawVideoPairShader(
                 const std::string& shader,
                 const ftk::Box2I&);
+            //! Measure the difference between the pair.
+            void _drawVideoPairStats(float threshold);
             void _drawVideoTile(
                 const std::vector<VideoFrame>&,
                 const std::vector<ftk::Box2I>&,
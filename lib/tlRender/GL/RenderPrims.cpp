@@ -81,6 +81,7 @@ namespace tl
             const ftk::Color4F& color,
             const ftk::ImageOptions& options)
         {
+            _countUpload(image, options);
             _p->baseRender->drawImage(image, mesh, color, options);
         }
 
@@ -90,7 +91,11 @@ namespace tl
             const ftk::Color4F& color,
             const ftk::ImageOptions& options)
         {
-            _p->baseRender->drawImage(image, rect, color, options);
+            if (!_drawImageTiles(image, rect, color, options))
+            {
+                _countUpload(image, options);
+                _p->baseRender->drawImage(image, rect, color, options);
+            }
         }
     }
 }
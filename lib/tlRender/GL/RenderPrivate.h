@@ -9,13 +9,16 @@
 #include <ftk/GL/OffscreenBuffer.h>
 #include <ftk/GL/Render.h>
 #include <ftk/GL/Shader.h>
+#include <ftk/GL/Texture.h>
 #include <ftk/GL/TextureAtlas.h>
+#include <ftk/Core/LRUCache.h>
 
 #if defined(TLRENDER_OCIO)
 #include <OpenColorIO/OpenColorIO.h>
 #endif // TLRENDER_OCIO
 
 #include <list>
+#include <map>
 
 #if defined(TLRENDER_OCIO)
 namespace OCIO = OCIO_NAMESPACE;
@@ -42,6 +45,9 @@ namespace tl
         std::string dissolveFragmentSource();
         std::string butterflyFragmentSource();
         std::string differenceFragmentSource();
+#if !defined(FTK_API_GLES_2)
+        std::string differenceStatsFragmentSource();
+#endif // FTK_API_GLES_2
 
 #if defined(TLRENDER_OCIO)
         struct OCIOTexture
@@ -97,6 +103,25 @@ namespace tl
         };
 #endif // TLRENDER_OCIO
 
+        //! One tile of an image on the GPU.
+        struct TextureTile
+        {
+            // What the tile was copied from; an image at the same address
+            // that is not this one misses.
+            std::weak_ptr<ftk::Image> image;
+            std::shared_ptr<ftk::gl::Texture> texture;
+            // The texture coordinates inside the border.
+            ftk::V2F uvMin;
+            ftk::V2F uvMax;
+        };
+
+        //! Copy a tile of an image, reduced by a power of two. The box is
+        //! in the reduced image's texels.
+        std::shared_ptr<ftk::Image> copyTile(
+            const std::shared_ptr<ftk::Image>&,
+            int level,
+            const ftk::Box2I&);
+
         struct Render::Private
         {
             std::shared_ptr<ftk::gl::Render> baseRender;
@@ -125,6 +150,26 @@ namespace tl
             std::map<std::string, std::shared_ptr<ftk::gl::OffscreenBuffer> > buffers;
             std::map<std::string, std::shared_ptr<ftk::gl::VBO> > vbos;
             std::map<std::string, std::shared_ptr<ftk::gl::VAO> > vaos;
+
+            // The difference statistics are reduced through a chain of
+            // buffers, each a quarter the width and height of the last,
+            // until a single pixel is left to read back.
+            std::vector<std::shared_ptr<ftk::gl::OffscreenBuffer> > statsBuffers;
+            std::vector<std::shared_ptr<ftk::gl::OffscreenBuffer> > statsBoxBuffers;
+            CompareStats compareStats;
+
+            TileOptions tileOptions;
+            int maxTextureSize = 0;
+            ftk::LRUCache<std::string, std::shared_ptr<TextureTile> > tiles;
+            size_t tileByteCount = 0;
+
+            // The uploads of the frame being drawn, and of the last one.
+            UploadStats uploadStats;
+            UploadStats uploadStatsFrame;
+            // The images drawn whole this frame and the last, to tell which
+            // were uploaded.
+            std::map<const ftk::Image*, std::weak_ptr<ftk::Image> > uploadImages;
+            std::map<const ftk::Image*, std::weak_ptr<ftk::Image> > uploadImagesPrev;
         };
     }
 }
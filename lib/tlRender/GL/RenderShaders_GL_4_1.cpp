@@ -448,5 +448,82 @@ namespace tl
                 "    outColor.a = max(c.a, cB.a);\n"
                 "}\n";
         }
+
+        std::string differenceStatsFragmentSource()
+        {
+            return
+                "#version 410\n"
+                "\n"
+                "out vec4 outColor;\n"
+                "\n"
+                "uniform sampler2D textureSampler;\n"
+                "uniform sampler2D textureSamplerB;\n"
+                "uniform int       inputWidth;\n"
+                "uniform int       inputHeight;\n"
+                "uniform float     threshold;\n"
+                "\n"
+                "// Modes:\n"
+                "// * 0 - Measure the pair: maximum, sum, sum of squares, count\n"
+                "// * 1 - Reduce the measurements; the count stays exact as\n"
+                "//       long as it is no more than 2^24, which the renderer\n"
+                "//       keeps to by stopping the chain in time\n"
+                "// * 2 - Box the pair's pixels over the threshold: min x, min y,\n"
+                "//       max x, max y\n"
+                "// * 3 - Reduce the boxes\n"
+                "uniform int mode;\n"
+                "\n"
+                "void main()\n"
+                "{\n"
+                "    // Each output pixel covers four by four of the input.\n"
+                "    ivec2 base = ivec2(gl_FragCoord.xy) * 4;\n"
+                "    vec4 stats = vec4(0.0, 0.0, 0.0, 0.0);\n"
+                "    vec4 box = vec4(1.0e30, 1.0e30, -1.0, -1.0);\n"
+                "    for (int y = 0; y < 4; ++y)\n"
+                "    {\n"
+                "        for (int x = 0; x < 4; ++x)\n"
+                "        {\n"
+                "            ivec2 p = base + ivec2(x, y);\n"
+                "            if (p.x >= inputWidth || p.y >= inputHeight)\n"
+                "            {\n"
+                "                continue;\n"
+                "            }\n"
+                "            if (0 == mode || 2 == mode)\n"
+                "            {\n"
+                "                vec4 c = texelFetch(textureSampler, p, 0);\n"
+                "                vec4 cB = texelFetch(textureSamplerB, p, 0);\n"
+                "                vec3 d = abs(c.rgb - cB.rgb);\n"
+                "                float e = max(d.r, max(d.g, d.b));\n"
+                "                if (0 == mode)\n"
+                "                {\n"
+                "                    stats.r = max(stats.r, e);\n"
+                "                    stats.g += (d.r + d.g + d.b) / 3.0;\n"
+                "                    stats.b += dot(d, d) / 3.0;\n"
+                "                    stats.a += e > threshold ? 1.0 : 0.0;\n"
+                "                }\n"
+                "                else if (e > threshold)\n"
+                "                {\n"
+                "                    box.xy = min(box.xy, vec2(p));\n"
+                "                    box.zw = max(box.zw, vec2(p));\n"
+                "                }\n"
+                "            }\n"
+                "            else\n"
+                "            {\n"
+                "                vec4 c = texelFetch(textureSampler, p, 0);\n"
+                "                if (1 == mode)\n"
+                "                {\n"
+                "                    stats.r = max(stats.r, c.r);\n"
+                "                    stats.gba += c.gba;\n"
+                "                }\n"
+                "                else\n"
+                "                {\n"
+                "                    box.xy = min(box.xy, c.xy);\n"
+                "                    box.zw = max(box.zw, c.zw);\n"
+                "                }\n"
+                "            }\n"
+                "        }\n"
+                "    }\n"
+                "    outColor = mode < 2 ? stats : box;\n"
+                "}\n";
+        }
     }
 }
@@ -0,0 +1,392 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/GL/RenderPrivate.h>
+
+#include <ftk/GL/GL.h>
+#include <ftk/GL/Util.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace tl
+{
+    namespace gl
+    {
+        namespace
+        {
+            //! The pixel types that can be drawn in tiles: one texture each,
+            //! with the channels the shader samples as they are.
+            bool isTileable(ftk::ImageType type)
+            {
+                switch (type)
+                {
+                case ftk::ImageType::RGB_U8:
+                case ftk::ImageType::RGB_U16:
+                case ftk::ImageType::RGB_F16:
+                case ftk::ImageType::RGB_F32:
+                case ftk::ImageType::RGBA_U8:
+                case ftk::ImageType::RGBA_U16:
+                case ftk::ImageType::RGBA_F16:
+                case ftk::ImageType::RGBA_F32:
+                    return true;
+                default: break;
+                }
+                return false;
+            }
+
+            //! Average each block of texels.
+            template<typename T>
+            void reduceTile(
+                const uint8_t* src,
+                size_t srcStride,
+                const ftk::Size2I& srcSize,
+                int channels,
+                int level,
+                const ftk::Box2I& box,
+                uint8_t* dst)
+            {
+                const int step = 1 << level;
+                const float round = std::is_integral<T>::value ? .5F : 0.F;
+                for (int y = 0; y < box.h(); ++y)
+                {
+                    T* out = reinterpret_cast<T*>(dst) + static_cast<size_t>(y) * box.w() * channels;
+                    const int sy0 = (box.min.y + y) * step;
+                    const int sy1 = std::min(sy0 + step, srcSize.h);
+                    for (int x = 0; x < box.w(); ++x, out += channels)
+                    {
+                        const int sx0 = (box.min.x + x) * step;
+                        const int sx1 = std::min(sx0 + step, srcSize.w);
+                        float sum[4] = { 0.F, 0.F, 0.F, 0.F };
+                        for (int sy = sy0; sy < sy1; ++sy)
+                        {
+                            const T* in = reinterpret_cast<const T*>(src + sy * srcStride) + sx0 * channels;
+                            for (int sx = sx0; sx < sx1; ++sx, in += channels)
+                            {
+                                for (int c = 0; c < channels; ++c)
+                                {
+                                    sum[c] += in[c];
+                                }
+                            }
+                        }
+                        const float n = static_cast<float>((sy1 - sy0) * (sx1 - sx0));
+                        for (int c = 0; c < channels; ++c)
+                        {
+                            out[c] = static_cast<T>(sum[c] / n + round);
+                        }
+                    }
+                }
+            }
+
+            //! Take the first texel of each block, for the types there is no
+            //! arithmetic for here.
+            void decimateTile(
+                const uint8_t* src,
+                size_t srcStride,
+                size_t pixelByteCount,
+                int level,
+                const ftk::Box2I& box,
+                uint8_t* dst)
+            {
+                for (int y = 0; y < box.h(); ++y)
+                {
+                    const uint8_t* in = src + static_cast<size_t>((box.min.y + y) << level) * srcStride;
+                    uint8_t* out = dst + static_cast<size_t>(y) * box.w() * pixelByteCount;
+                    for (int x = 0; x < box.w(); ++x, out += pixelByteCount)
+                    {
+                        memcpy(
+                            out,
+                            in + static_cast<size_t>((box.min.x + x) << level) * pixelByteCount,
+                            pixelByteCount);
+                    }
+                }
+            }
+
+            std::string getTileKey(
+                const ftk::Image* image,
+                int level,
+                int x,
+                int y,
+                const ftk::ImageFilters& filters)
+            {
+                return
+                    std::to_string(reinterpret_cast<uintptr_t>(image)) + "/" +
+                    std::to_string(level) + "/" +
+                    std::to_string(x) + "/" +
+                    std::to_string(y) + "/" +
+                    std::to_string(static_cast<int>(filters.minify)) + "/" +
+                    std::to_string(static_cast<int>(filters.magnify));
+            }
+        }
+
+        std::shared_ptr<ftk::Image> copyTile(
+            const std::shared_ptr<ftk::Image>& image,
+            int level,
+            const ftk::Box2I& box)
+        {
+            const ftk::ImageInfo& info = image->getInfo();
+            auto out = ftk::Image::create(ftk::ImageInfo(box.w(), box.h(), info.type));
+            const int channels = ftk::getChannelCount(info.type);
+            const size_t pixelByteCount = channels * ftk::getBitDepth(info.type) / 8;
+            const size_t srcStride = image->getByteCount() / std::max(1, info.size.h);
+            const uint8_t* src = image->getData();
+            uint8_t* dst = out->getData();
+            if (0 == level)
+            {
+                const size_t rowByteCount = box.w() * pixelByteCount;
+                for (int y = 0; y < box.h(); ++y)
+                {
+                    memcpy(
+                        dst + y * rowByteCount,
+                        src + (box.min.y + y) * srcStride + box.min.x * pixelByteCount,
+                        rowByteCount);
+                }
+                return out;
+            }
+            switch (info.type)
+            {
+            case ftk::ImageType::RGB_U8:
+            case ftk::ImageType::RGBA_U8:
+                reduceTile<uint8_t>(src, srcStride, info.size, channels, level, box, dst);
+                break;
+            case ftk::ImageType::RGB_U16:
+            case ftk::ImageType::RGBA_U16:
+                reduceTile<uint16_t>(src, srcStride, info.size, channels, level, box, dst);
+                break;
+            case ftk::ImageType::RGB_F32:
+            case ftk::ImageType::RGBA_F32:
+                reduceTile<float>(src, srcStride, info.size, channels, level, box, dst);
+                break;
+            default:
+                decimateTile(src, srcStride, pixelByteCount, level, box, dst);
+                break;
+            }
+            return out;
+        }
+
+        bool Render::_drawImageTiles(
+            const std::shared_ptr<ftk::Image>& image,
+            const ftk::Box2F& rect,
+            const ftk::Color4F& color,
+            const ftk::ImageOptions& options)
+        {
+            FTK_P();
+            if (!image || !p.shaders["tile"])
+                return false;
+            const ftk::ImageInfo& info = image->getInfo();
+            const ftk::Size2I& size = info.size;
+            const bool large =
+                p.maxTextureSize > 0 &&
+                (size.w > p.maxTextureSize || size.h > p.maxTextureSize);
+            if (!isTileable(info.type) ||
+                (!large &&
+                    size.w <= p.tileOptions.threshold &&
+                    size.h <= p.tileOptions.threshold) ||
+                // The channels are picked out by ftk's image shader, so
+                // only an image too large for it goes without.
+                (!large && options.channelDisplay != ftk::ChannelDisplay::Color) ||
+                rect.w() <= 0.F ||
+                rect.h() <= 0.F)
+            {
+                return false;
+            }
+
+            // Where the image lands, in normalized device coordinates.
+            const ftk::M44F transform = getTransform();
+            const auto toNDC = [&transform](float x, float y)
+            {
+                const ftk::V3F v = transform * ftk::V3F(x, y, 0.F);
+                return ftk::V2F(v.x, v.y);
+            };
+
+            // Reduce to the power of two nearest the size the image is drawn
+            // at, rounding down so that nothing is drawn blurrier than it
+            // would have been whole.
+            const ftk::Box2I viewport = getViewport();
+            const ftk::V2F n0 = toNDC(rect.min.x, rect.min.y);
+            const ftk::V2F n1 = toNDC(rect.min.x + rect.w(), rect.min.y);
+            const ftk::V2F n2 = toNDC(rect.min.x, rect.min.y + rect.h());
+            const float drawnW = std::hypot(
+                (n1.x - n0.x) * .5F * viewport.w(),
+                (n1.y - n0.y) * .5F * viewport.h());
+            const float drawnH = std::hypot(
+                (n2.x - n0.x) * .5F * viewport.w(),
+                (n2.y - n0.y) * .5F * viewport.h());
+            int level = 0;
+            if (drawnW > 0.F && drawnH > 0.F)
+            {
+                const float scale = std::min(size.w / drawnW, size.h / drawnH);
+                if (scale >= 2.F)
+                {
+                    level = static_cast<int>(std::floor(std::log2(scale)));
+                }
+            }
+            const int step = 1 << level;
+            const ftk::Size2I levelSize(
+                (size.w + step - 1) / step,
+                (size.h + step - 1) / step);
+            int tileSize = std::max(1, p.tileOptions.size);
+            if (p.maxTextureSize > 2)
+            {
+                tileSize = std::min(tileSize, p.maxTextureSize - 2);
+            }
+
+            auto shader = p.shaders["tile"];
+            shader->bind();
+            shader->setUniform("color", color);
+            shader->setUniform("textureSampler", 0);
+            ftk::gl::setAlphaBlend(options.alphaBlend);
+            glActiveTexture(static_cast<GLenum>(GL_TEXTURE0));
+
+            ftk::gl::TextureOptions textureOptions;
+            textureOptions.filters = options.imageFilters;
+            const size_t pixelByteCount =
+                ftk::getChannelCount(info.type) * ftk::getBitDepth(info.type) / 8;
+            const auto& mirror = info.layout.mirror;
+            for (int ty = 0; ty * tileSize < levelSize.h; ++ty)
+            {
+                for (int tx = 0; tx * tileSize < levelSize.w; ++tx)
+                {
+                    // The tile in the reduced image, and in the full one.
+                    const int lx0 = tx * tileSize;
+                    const int ly0 = ty * tileSize;
+                    const int lx1 = std::min(lx0 + tileSize, levelSize.w);
+                    const int ly1 = std::min(ly0 + tileSize, levelSize.h);
+                    const int sx0 = lx0 * step;
+                    const int sy0 = ly0 * step;
+                    const int sx1 = std::min(lx1 * step, size.w);
+                    const int sy1 = std::min(ly1 * step, size.h);
+
+                    // Where the tile lands in the rectangle.
+                    float x0 = rect.min.x + sx0 / static_cast<float>(size.w) * rect.w();
+                    float x1 = rect.min.x + sx1 / static_cast<float>(size.w) * rect.w();
+                    float y0 = rect.min.y + sy0 / static_cast<float>(size.h) * rect.h();
+                    float y1 = rect.min.y + sy1 / static_cast<float>(size.h) * rect.h();
+                    if (mirror.x)
+                    {
+                        x0 = rect.min.x + rect.w() - (x0 - rect.min.x);
+                        x1 = rect.min.x + rect.w() - (x1 - rect.min.x);
+                    }
+                    if (mirror.y)
+                    {
+                        y0 = rect.min.y + rect.h() - (y0 - rect.min.y);
+                        y1 = rect.min.y + rect.h() - (y1 - rect.min.y);
+                    }
+
+                    // Leave the tiles that are out of view.
+                    const ftk::V2F corners[4] =
+                    {
+                        toNDC(x0, y0),
+                        toNDC(x1, y0),
+                        toNDC(x1, y1),
+                        toNDC(x0, y1)
+                    };
+                    bool left = true;
+                    bool right = true;
+                    bool below = true;
+                    bool above = true;
+                    for (const auto& c : corners)
+                    {
+                        left &= c.x < -1.F;
+                        right &= c.x > 1.F;
+                        below &= c.y < -1.F;
+                        above &= c.y > 1.F;
+                    }
+                    if (left || right || below || above)
+                        continue;
+
+                    const std::string key = getTileKey(
+                        image.get(),
+                        level,
+                        tx,
+                        ty,
+                        options.imageFilters);
+                    std::shared_ptr<TextureTile> tile;
+                    if (!p.tiles.get(key, tile) || tile->image.lock() != image)
+                    {
+                        // A border of a texel on each side, from the tiles
+                        // around it, so that filtering has no seams.
+                        const int bx0 = std::max(0, lx0 - 1);
+                        const int by0 = std::max(0, ly0 - 1);
+                        const int bx1 = std::min(levelSize.w, lx1 + 1);
+                        const int by1 = std::min(levelSize.h, ly1 + 1);
+                        const ftk::Box2I border(bx0, by0, bx1 - bx0, by1 - by0);
+                        auto tileImage = copyTile(image, level, border);
+
+                        tile = std::make_shared<TextureTile>();
+                        tile->image = image;
+                        tile->texture = ftk::gl::Texture::create(
+                            tileImage->getInfo(),
+                            textureOptions);
+                        tile->texture->copy(tileImage);
+                        const float w = border.w();
+                        const float h = border.h();
+                        tile->uvMin = ftk::V2F((lx0 - bx0) / w, (ly0 - by0) / h);
+                        tile->uvMax = ftk::V2F((lx1 - bx0) / w, (ly1 - by0) / h);
+                        const size_t byteCount = border.w() * border.h() * pixelByteCount;
+                        p.tiles.add(key, tile, byteCount);
+
+                        p.uploadStats.frameByteCount += byteCount;
+                        ++p.uploadStats.frameTileCount;
+                    }
+
+                    glBindTexture(GL_TEXTURE_2D, tile->texture->getID());
+                    if (p.vbos["video"])
+                    {
+                        ftk::TriMesh2F mesh;
+                        mesh.v.push_back(ftk::V2F(x0, y0));
+                        mesh.v.push_back(ftk::V2F(x1, y0));
+                        mesh.v.push_back(ftk::V2F(x1, y1));
+                        mesh.v.push_back(ftk::V2F(x0, y1));
+                        mesh.t.push_back(ftk::V2F(tile->uvMin.x, tile->uvMin.y));
+                        mesh.t.push_back(ftk::V2F(tile->uvMax.x, tile->uvMin.y));
+                        mesh.t.push_back(ftk::V2F(tile->uvMax.x, tile->uvMax.y));
+                        mesh.t.push_back(ftk::V2F(tile->uvMin.x, tile->uvMax.y));
+                        ftk::Triangle2 tri;
+                        tri.v[0] = ftk::Vertex2(1, 1);
+                        tri.v[1] = ftk::Vertex2(2, 2);
+                        tri.v[2] = ftk::Vertex2(3, 3);
+                        mesh.triangles.push_back(tri);
+                        tri.v[0] = ftk::Vertex2(3, 3);
+                        tri.v[1] = ftk::Vertex2(4, 4);
+                        tri.v[2] = ftk::Vertex2(1, 1);
+                        mesh.triangles.push_back(tri);
+                        p.vbos["video"]->copy(convert(mesh, p.vbos["video"]->getType()));
+                    }
+                    if (p.vaos["video"])
+                    {
+                        p.vaos["video"]->bind();
+                        p.vaos["video"]->draw(GL_TRIANGLES, 0, p.vbos["video"]->getSize());
+                    }
+                }
+            }
+            return true;
+        }
+
+        void Render::_countUpload(
+            const std::shared_ptr<ftk::Image>& image,
+            const ftk::ImageOptions& options)
+        {
+            FTK_P();
+            if (!image)
+                return;
+            // ftk keeps the textures of cached images, so one drawn the frame
+            // before is taken as already there.
+            const auto i = p.uploadImagesPrev.find(image.get());
+            const bool uploaded =
+                !options.cache ||
+                i == p.uploadImagesPrev.end() ||
+                i->second.lock() != image;
+            const auto j = p.uploadImages.find(image.get());
+            if (uploaded && (j == p.uploadImages.end() || j->second.lock() != image))
+            {
+                p.uploadStats.frameByteCount += image->getByteCount();
+            }
+            p.uploadImages[image.get()] = image;
+        }
+    }
+}
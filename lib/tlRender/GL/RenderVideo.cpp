@@ -9,25 +9,15 @@
 #include <ftk/Core/Format.h>
 #include <ftk/Core/Math.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
 namespace tl
 {
     namespace gl
     {
-        namespace
-        {
-            ftk::Box2I xform(const ftk::Box2I& box, const ftk::M44F& vm)
-            {
-                ftk::Box2I out;
-                const ftk::V3F v0 = vm * ftk::V3F(box.min.x, box.min.y, 0.F);
-                const ftk::V3F v1 = vm * ftk::V3F(box.max.x + 1, box.max.y + 1, 0.F);
-                out.min.x = std::round(v0.x);
-                out.min.y = std::round(v0.y);
-                out.max.x = std::round(v1.x - 1);
-                out.max.y = std::round(v1.y - 1);
-                return out;
-            }
-        }
-
         void Render::drawBackground(
             const std::vector<ftk::Box2I>& boxes,
             const ftk::M44F& vm,
@@ -35,107 +25,7 @@ namespace tl
             const CompareOptions& compareOptions)
         {
             glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
-
-            // Draw the background.
-            const ftk::Box2I rect(ftk::V2I(0, 0), getRenderSize());
-            switch (options.type)
-            {
-            case Background::Solid:
-                IRender::drawRect(rect, options.solidColor);
-                break;
-            case Background::Checkers:
-                drawColorMesh(
-                    ftk::checkers(
-                        rect,
-                        options.checkersColor.first,
-                        options.checkersColor.second,
-                        options.checkersSize),
-                    ftk::Color4F(1.F, 1.F, 1.F));
-                break;
-            case Background::Gradient:
-            {
-                ftk::TriMesh2F mesh;
-                mesh.v.push_back(ftk::V2F(rect.min.x, rect.min.y));
-                mesh.v.push_back(ftk::V2F(rect.max.x, rect.min.y));
-                mesh.v.push_back(ftk::V2F(rect.max.x, rect.max.y));
-                mesh.v.push_back(ftk::V2F(rect.min.x, rect.max.y));
-                mesh.c.push_back(ftk::V4F(
-                    options.gradientColor.first.r,
-                    options.gradientColor.first.g,
-                    options.gradientColor.first.b,
-                    options.gradientColor.first.a));
-                mesh.c.push_back(ftk::V4F(
-                    options.gradientColor.second.r,
-                    options.gradientColor.second.g,
-                    options.gradientColor.second.b,
-                    options.gradientColor.second.a));
-                mesh.triangles.push_back({
-                    ftk::Vertex2(1, 0, 1),
-                    ftk::Vertex2(3, 0, 2),
-                    ftk::Vertex2(2, 0, 1), });
-                mesh.triangles.push_back({
-                    ftk::Vertex2(1, 0, 1),
-                    ftk::Vertex2(4, 0, 2),
-                    ftk::Vertex2(3, 0, 2), });
-                drawColorMesh(
-                    mesh,
-                    ftk::Color4F(1.F, 1.F, 1.F));
-                break;
-            }
-            default: break;
-            }
-
-            // Draw the outline.
-            if (options.outline.enabled && !boxes.empty())
-            {
-                glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
-
-                size_t start = 0;
-                size_t end = boxes.size();
-                switch (compareOptions.compare)
-                {
-                    case Compare::None:
-                        if (!boxes.empty())
-                        {
-                            end = 1;
-                        }
-                        break;
-                    case Compare::B:
-                        if (boxes.size() > 1)
-                        {
-                            start = 1;
-                            end = 2;
-                        }
-                        break;
-                    default: break;
-                }
-                for (size_t i = start; i < end; ++i)
-                {
-                    const ftk::Box2I box = xform(boxes[i], vm);
-
-                    ftk::TriMesh2F mesh;
-                    mesh.v.push_back(ftk::V2F(box.min.x, box.min.y));
-                    mesh.v.push_back(ftk::V2F(box.max.x + 1, box.min.y));
-                    mesh.v.push_back(ftk::V2F(box.max.x + 1, box.max.y + 1));
-                    mesh.v.push_back(ftk::V2F(box.min.x, box.max.y + 1));
-                    const int w = options.outline.width;
-                    mesh.v.push_back(ftk::V2F(box.min.x - w, box.min.y - w));
-                    mesh.v.push_back(ftk::V2F(box.max.x + 1 + w, box.min.y - w));
-                    mesh.v.push_back(ftk::V2F(box.max.x + 1 + w, box.max.y + 1 + w));
-                    mesh.v.push_back(ftk::V2F(box.min.x - w, box.max.y + 1 + w));
-
-                    mesh.triangles.push_back({ ftk::Vertex2(1), ftk::Vertex2(2), ftk::Vertex2(5) });
-                    mesh.triangles.push_back({ ftk::Vertex2(2), ftk::Vertex2(6), ftk::Vertex2(5) });
-                    mesh.triangles.push_back({ ftk::Vertex2(2), ftk::Vertex2(3), ftk::Vertex2(6) });
-                    mesh.triangles.push_back({ ftk::Vertex2(3), ftk::Vertex2(7), ftk::Vertex2(6) });
-                    mesh.triangles.push_back({ ftk::Vertex2(3), ftk::Vertex2(4), ftk::Vertex2(7) });
-                    mesh.triangles.push_back({ ftk::Vertex2(4), ftk::Vertex2(8), ftk::Vertex2(7) });
-                    mesh.triangles.push_back({ ftk::Vertex2(4), ftk::Vertex2(1), ftk::Vertex2(8) });
-                    mesh.triangles.push_back({ ftk::Vertex2(1), ftk::Vertex2(5), ftk::Vertex2(8) });
-
-                    drawMesh(mesh, options.outline.color);
-                }
-            }
+            IRender::drawBackground(boxes, vm, options, compareOptions);
         }
 
         namespace
@@ -161,6 +51,7 @@ namespace tl
             const CompareOptions& compareOptions,
             ftk::gl::TextureType colorBuffer)
         {
+            _p->compareStats = CompareStats();
             switch (compareOptions.compare)
             {
             case Compare::None:
@@ -634,6 +525,179 @@ namespace tl
             }
         }
 
+        void Render::_drawVideoPairStats(float threshold)
+        {
+            FTK_P();
+#if !defined(FTK_API_GLES_2)
+            const ftk::Size2I size = p.buffers["compare0"]->getSize();
+            if (!size.isValid())
+                return;
+
+            // The sizes of the reductions, down to a single pixel or six
+            // levels, whichever comes first. A pixel at level n covers up to
+            // 16^n of the input, so after six its count may reach 2^24, past
+            // which a float no longer holds every integer. What is left is
+            // read back and summed on the CPU in 64 bits.
+            const size_t levelMax = 6;
+            std::vector<ftk::Size2I> sizes;
+            ftk::Size2I reduced = size;
+            do
+            {
+                reduced = ftk::Size2I((reduced.w + 3) / 4, (reduced.h + 3) / 4);
+                sizes.push_back(reduced);
+            } while ((reduced.w > 1 || reduced.h > 1) && sizes.size() < levelMax);
+
+            // Floating point, so that the sums are not clamped, and nearest
+            // filtering, so that nothing is blended on the way down.
+            ftk::gl::OffscreenBufferOptions offscreenBufferOptions;
+            offscreenBufferOptions.colorFilters.minify = ftk::ImageFilter::Nearest;
+            offscreenBufferOptions.colorFilters.magnify = ftk::ImageFilter::Nearest;
+            for (auto buffers : { &p.statsBuffers, &p.statsBoxBuffers })
+            {
+                buffers->resize(sizes.size());
+                for (size_t i = 0; i < sizes.size(); ++i)
+                {
+                    if (ftk::gl::doCreate(
+                        (*buffers)[i],
+                        sizes[i],
+                        ftk::gl::TextureType::RGBA_F32,
+                        offscreenBufferOptions))
+                    {
+                        (*buffers)[i] = ftk::gl::OffscreenBuffer::create(
+                            sizes[i],
+                            ftk::gl::TextureType::RGBA_F32,
+                            offscreenBufferOptions);
+                    }
+                }
+            }
+
+            const ftk::gl::SetAndRestore scissorTest(GL_SCISSOR_TEST, GL_FALSE);
+            const ftk::gl::SetAndRestore blend(GL_BLEND, GL_FALSE);
+            auto shader = p.shaders["differenceStats"];
+            shader->bind();
+            shader->setUniform("textureSampler", 0);
+            shader->setUniform("textureSamplerB", 1);
+            shader->setUniform("threshold", threshold);
+            std::array<std::vector<float>, 2> values;
+            const std::array<std::vector<std::shared_ptr<ftk::gl::OffscreenBuffer> >*, 2> chains =
+            {
+                &p.statsBuffers,
+                &p.statsBoxBuffers
+            };
+            for (size_t chain = 0; chain < chains.size(); ++chain)
+            {
+                const auto& buffers = *chains[chain];
+                for (size_t i = 0; i < buffers.size(); ++i)
+                {
+                    const ftk::Size2I& inputSize = 0 == i ? size : sizes[i - 1];
+                    shader->setUniform("mode", static_cast<int>(chain * 2 + (i > 0 ? 1 : 0)));
+                    shader->setUniform("inputWidth", inputSize.w);
+                    shader->setUniform("inputHeight", inputSize.h);
+                    shader->setUniform("transform.mvp", ftk::ortho(
+                        0.F,
+                        static_cast<float>(sizes[i].w),
+                        0.F,
+                        static_cast<float>(sizes[i].h),
+                        -1.F,
+                        1.F));
+
+                    glActiveTexture(static_cast<GLenum>(GL_TEXTURE0));
+                    glBindTexture(
+                        GL_TEXTURE_2D,
+                        0 == i ?
+                            p.buffers["compare0"]->getColorID() :
+                            buffers[i - 1]->getColorID());
+                    glActiveTexture(static_cast<GLenum>(GL_TEXTURE1));
+                    glBindTexture(GL_TEXTURE_2D, p.buffers["compare1"]->getColorID());
+
+                    ftk::gl::OffscreenBufferBinding binding(buffers[i]);
+                    glViewport(0, 0, sizes[i].w, sizes[i].h);
+                    if (p.vbos["video"])
+                    {
+                        p.vbos["video"]->copy(convert(
+                            ftk::mesh(ftk::Box2I(0, 0, sizes[i].w, sizes[i].h)),
+                            p.vbos["video"]->getType()));
+                    }
+                    if (p.vaos["video"])
+                    {
+                        p.vaos["video"]->bind();
+                        p.vaos["video"]->draw(GL_TRIANGLES, 0, p.vbos["video"]->getSize());
+                    }
+                    if (i == buffers.size() - 1)
+                    {
+                        values[chain].resize(static_cast<size_t>(sizes[i].w) * sizes[i].h * 4);
+                        glReadPixels(
+                            0,
+                            0,
+                            sizes[i].w,
+                            sizes[i].h,
+                            GL_RGBA,
+                            GL_FLOAT,
+                            values[chain].data());
+                    }
+                }
+            }
+
+            // Each partial count is exact, so rounding them before they are
+            // added keeps the total exact.
+            float maxError = 0.F;
+            double errorSum = 0.0;
+            double squareSum = 0.0;
+            uint64_t thresholdCount = 0;
+            for (size_t i = 0; i < values[0].size(); i += 4)
+            {
+                maxError = std::max(maxError, values[0][i]);
+                errorSum += values[0][i + 1];
+                squareSum += values[0][i + 2];
+                thresholdCount += static_cast<uint64_t>(std::round(values[0][i + 3]));
+            }
+            std::array<float, 4> box =
+            {
+                std::numeric_limits<float>::max(),
+                std::numeric_limits<float>::max(),
+                -1.F,
+                -1.F
+            };
+            for (size_t i = 0; i < values[1].size(); i += 4)
+            {
+                box[0] = std::min(box[0], values[1][i]);
+                box[1] = std::min(box[1], values[1][i + 1]);
+                box[2] = std::max(box[2], values[1][i + 2]);
+                box[3] = std::max(box[3], values[1][i + 3]);
+            }
+
+            CompareStats& stats = p.compareStats;
+            stats.valid = true;
+            stats.pixelCount = static_cast<size_t>(size.w) * size.h;
+            stats.maxError = maxError;
+            stats.meanError = static_cast<float>(errorSum / stats.pixelCount);
+            const double mse = squareSum / stats.pixelCount;
+            stats.psnr = mse > 0.0 ?
+                static_cast<float>(10.0 * std::log10(1.0 / mse)) :
+                std::numeric_limits<float>::infinity();
+            stats.thresholdCount = static_cast<size_t>(thresholdCount);
+            if (stats.thresholdCount > 0)
+            {
+                // The buffer rows run bottom to top; the pair was drawn
+                // with the first row of the images at the top.
+                const int minX = static_cast<int>(box[0]);
+                const int minY = static_cast<int>(box[1]);
+                const int maxX = static_cast<int>(box[2]);
+                const int maxY = static_cast<int>(box[3]);
+                stats.thresholdBox = ftk::Box2I(
+                    minX,
+                    size.h - 1 - maxY,
+                    maxX - minX + 1,
+                    maxY - minY + 1);
+            }
+#endif // FTK_API_GLES_2
+        }
+
+        CompareStats Render::getCompareStats() const
+        {
+            return _p->compareStats;
+        }
+
         void Render::_drawVideoButterfly(
             const std::vector<VideoFrame>& videoFrame,
             const std::vector<ftk::Box2I>& boxes,
@@ -666,6 +730,10 @@ namespace tl
             if (_drawVideoPair(
                 videoFrame, boxes, imageOptions, displayOptions, colorBuffer))
             {
+                if (compareOptions.differenceStats)
+                {
+                    _drawVideoPairStats(compareOptions.differenceThreshold);
+                }
                 p.shaders["difference"]->bind();
                 p.shaders["difference"]->setUniform(
                     "gain",
@@ -1308,303 +1376,8 @@ namespace tl
             const ForegroundOptions& options,
             const CompareOptions& compareOptions)
         {
-            size_t start = 0;
-            size_t end = boxes.size();
-            switch (compareOptions.compare)
-            {
-                case Compare::None:
-                case Compare::Wipe:
-                case Compare::Butterfly:
-                case Compare::Overlay:
-                case Compare::Difference:
-                    if (!boxes.empty())
-                    {
-                        end = 1;
-                    }
-                    break;
-                case Compare::B:
-                    if (boxes.size() > 1)
-                    {
-                        start = 1;
-                        end = 2;
-                    }
-                    break;
-                default: break;
-            }
-            for (size_t i = start; i < end; ++i)
-            {
-                const ftk::Box2I& box = boxes[i];
-                const ftk::Box2I boxT = xform(box, vm);
-
-                if (options.grid.enabled &&
-                    GridCellMode::CellSize == options.grid.cellMode)
-                {
-                    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
-
-                    const ftk::Size2I cellSizeT(
-                        ftk::length(
-                            vm * ftk::V3F(0.F, 0.F, 0.F) -
-                            vm * ftk::V3F(options.grid.cellSize, 0.F, 0.F)),
-                        ftk::length(
-                            vm * ftk::V3F(0.F, 0.F, 0.F) -
-                            vm * ftk::V3F(0.F, options.grid.cellSize, 0.F)));
-
-                    if (cellSizeT.w > options.grid.lineWidth + 10.F &&
-                        cellSizeT.h > options.grid.lineWidth + 10.F)
-                    {
-                        const ftk::Size2I& renderSize = getRenderSize();
-                        ftk::M44F mi;
-                        ftk::invert(vm, mi);
-                        const ftk::V3F v0 = mi * ftk::V3F(0.F, 0.F, 0.F);
-                        const ftk::V3F v1 = mi * ftk::V3F(renderSize.w, renderSize.h, 0.F);
-                        const ftk::V2F v2(
-                            std::max(static_cast<int>(v0.x) / options.grid.cellSize * options.grid.cellSize, box.min.x),
-                            std::max(static_cast<int>(v0.y) / options.grid.cellSize * options.grid.cellSize, box.min.y));
-                        const ftk::V2F v3(
-                            std::min(static_cast<int>(v1.x) / options.grid.cellSize * options.grid.cellSize, box.max.x),
-                            std::min(static_cast<int>(v1.y) / options.grid.cellSize * options.grid.cellSize, box.max.y));
-
-                        if (options.grid.labels != GridLabels::None)
-                        {
-                            auto fontSystem = _fontSystem.lock();
-                            const ftk::FontMetrics fontMetrics = fontSystem->getMetrics(options.grid.fontInfo);
-                            std::string text = getLabel(
-                                options.grid.labels,
-                                GridLabels::Pixels == options.grid.labels ? v3.x : v3.x / options.grid.cellSize,
-                                GridLabels::Pixels == options.grid.labels ? v3.y : v3.y / options.grid.cellSize);
-                            ftk::Size2I size =
-                                fontSystem->getSize(text, options.grid.fontInfo) +
-                                options.grid.textMargin * 2;
-                            if (size.w <= cellSizeT.w - options.grid.lineWidth &&
-                                size.h <= cellSizeT.h - options.grid.lineWidth)
-                            {
-                                for (int y = v2.y, i = v2.y / options.grid.cellSize;
-                                    y <= v3.y + 1;
-                                    y += options.grid.cellSize, ++i)
-                                {
-                                    for (int x = v2.x, j = v2.x / options.grid.cellSize;
-                                        x <= v3.x + 1;
-                                        x += options.grid.cellSize, ++j)
-                                    {
-                                        text = getLabel(
-                                            options.grid.labels,
-                                            GridLabels::Pixels == options.grid.labels ? (x - box.min.x) : j,
-                                            GridLabels::Pixels == options.grid.labels ? (y - box.min.y) : i);
-                                        size =
-                                            fontSystem->getSize(text, options.grid.fontInfo) +
-                                            options.grid.textMargin * 2;
-                                        const ftk::V3F v4 = vm * ftk::V3F(x, y, 0.F);
-                                        const ftk::V2F v5(v4.x, v4.y);
-                                        if (v5.x + options.grid.lineWidth / 2.F + size.w <= boxT.max.x &&
-                                            v5.y + options.grid.lineWidth / 2.F + size.h <= boxT.max.y)
-                                        {
-                                            drawRect(
-                                                ftk::Box2F(
-                                                    v5.x + options.grid.lineWidth / 2.F,
-                                                    v5.y + options.grid.lineWidth / 2.F,
-                                                    size.w,
-                                                    size.h),
-                                                options.grid.overlayColor);
-                                            drawText(
-                                                fontSystem->getGlyphs(text, options.grid.fontInfo),
-                                                fontMetrics,
-                                                ftk::V2F(
-                                                    v5.x + options.grid.lineWidth / 2.F + options.grid.textMargin,
-                                                    v5.y + options.grid.lineWidth / 2.F + options.grid.textMargin),
-                                                options.grid.textColor);
-                                        }
-                                    }
-                                }
-                            }
-                        }
-
-                        std::vector<ftk::Box2F> rects;
-                        for (int y = v2.y, i = v2.y / options.grid.cellSize;
-                            y <= v3.y + 1;
-                            y += options.grid.cellSize, ++i)
-                        {
-                            const ftk::V3F v0 = vm * ftk::V3F(box.min.x, y, 0.F);
-                            const ftk::V3F v1 = vm * ftk::V3F(box.max.x + 1, y, 0.F);
-                            const ftk::V2I v2(
-                                ftk::clamp(static_cast<int>(v0.x), boxT.min.x, boxT.max.x),
-                                ftk::clamp(static_cast<int>(v0.y), boxT.min.y, boxT.max.y));
-                            const ftk::V2I v3(
-                                ftk::clamp(static_cast<int>(v1.x), boxT.min.x, boxT.max.x),
-                                ftk::clamp(static_cast<int>(v1.y), boxT.min.y, boxT.max.y));
-                            rects.push_back(ftk::Box2F(
-                                v2.x,
-                                v2.y - options.grid.lineWidth / 2,
-                                v3.x - v2.x + 1,
-                                options.grid.lineWidth));
-                        }
-                        for (int x = v2.x, j = v2.x / options.grid.cellSize;
-                            x <= v3.x + 1;
-                            x += options.grid.cellSize, ++j)
-                        {
-                            const ftk::V3F v0 = vm * ftk::V3F(x, box.min.y, 0.F);
-                            const ftk::V3F v1 = vm * ftk::V3F(x, box.max.y + 1, 0.F);
-                            const ftk::V2I v2(
-                                ftk::clamp(static_cast<int>(v0.x), boxT.min.x, boxT.max.x),
-                                ftk::clamp(static_cast<int>(v0.y), boxT.min.y, boxT.max.y));
-                            const ftk::V2I v3(
-                                ftk::clamp(static_cast<int>(v1.x), boxT.min.x, boxT.max.x),
-                                ftk::clamp(static_cast<int>(v1.y), boxT.min.y, boxT.max.y));
-                            rects.push_back(ftk::Box2F(
-                                v2.x - options.grid.lineWidth / 2,
-                                v2.y,
-                                options.grid.lineWidth,
-                                v3.y - v2.y + 1));
-                        }
-                        drawRects(rects, options.grid.color);
-                    }
-                }
-
-                if (options.grid.enabled &&
-                    GridCellMode::CellCount == options.grid.cellMode)
-                {
-                    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
-
-                    const ftk::V2I cellCount(
-                        std::max(1, options.grid.cellCount.x),
-                        std::max(1, options.grid.cellCount.y));
-
-                    const ftk::Size2I cellSize(
-                        box.w() / static_cast<float>(cellCount.x),
-                        box.h() / static_cast<float>(cellCount.y));
-                    const ftk::Size2I cellSizeT(
-                        ftk::length(
-                            vm * ftk::V3F(0.F, 0.F, 0.F) -
-                            vm * ftk::V3F(cellSize.w, 0.F, 0.F)),
-                        ftk::length(
-                            vm * ftk::V3F(0.F, 0.F, 0.F) -
-                            vm * ftk::V3F(0.F, cellSize.h, 0.F)));
-
-                    if (cellSizeT.w > options.grid.lineWidth + 10.F &&
-                        cellSizeT.h > options.grid.lineWidth + 10.F)
-                    {
-                        if (options.grid.labels != GridLabels::None)
-                        {
-                            auto fontSystem = _fontSystem.lock();
-                            const ftk::FontMetrics fontMetrics = fontSystem->getMetrics(options.grid.fontInfo);
-                            const ftk::V3F v1 = vm * ftk::V3F(box.w(), box.h(), 0.F);
-                            std::string text = getLabel(
-                                options.grid.labels,
-                                GridLabels::Pixels == options.grid.labels ? v1.x : v1.x / cellSize.w,
-                                GridLabels::Pixels == options.grid.labels ? v1.y : v1.y / cellSize.h);
-                            ftk::Size2I size =
-                                fontSystem->getSize(text, options.grid.fontInfo) +
-                                options.grid.textMargin * 2;
-                            if (size.w <= cellSizeT.w - options.grid.lineWidth &&
-                                size.h <= cellSizeT.h - options.grid.lineWidth)
-                            {
-                                for (int i = 0; i < options.grid.cellCount.y; ++i)
-                                {
-                                    const int y = box.min.y + i / static_cast<float>(options.grid.cellCount.y) * box.h();
-                                    for (int j = 0; j < options.grid.cellCount.x; ++j)
-                                    {
-                                        const int x = box.min.x + j / static_cast<float>(options.grid.cellCount.x) * box.w();
-                                        text = getLabel(
-                                            options.grid.labels,
-                                            GridLabels::Pixels == options.grid.labels ? (x - box.min.x) : j,
-                                            GridLabels::Pixels == options.grid.labels ? (y - box.min.y) : i);
-                                        size =
-                                            fontSystem->getSize(text, options.grid.fontInfo) +
-                                            options.grid.textMargin * 2;
-                                        const ftk::V3F v2 = vm * ftk::V3F(x, y, 0.F);
-                                        const ftk::V2F v3(
-                                            ftk::clamp(static_cast<int>(v2.x), boxT.min.x, boxT.max.x),
-                                            ftk::clamp(static_cast<int>(v2.y), boxT.min.y, boxT.max.y));
-                                        drawRect(
-                                            ftk::Box2F(
-                                                v3.x + options.grid.lineWidth / 2,
-                                                v3.y + options.grid.lineWidth / 2,
-                                                size.w,
-                                                size.h),
-                                            options.grid.overlayColor);
-                                        drawText(
-                                            fontSystem->getGlyphs(text, options.grid.fontInfo),
-                                            fontMetrics,
-                                            ftk::V2F(
-                                                v3.x + options.grid.lineWidth / 2 + options.grid.textMargin,
-                                                v3.y + options.grid.lineWidth / 2 + options.grid.textMargin),
-                                            options.grid.textColor);
-                                    }
-                                }
-                            }
-                        }
-
-                        std::vector<ftk::Box2F> rects;
-                        for (int i = 0; i <= cellCount.y; ++i)
-                        {
-                            const float y = box.min.y + i / static_cast<float>(options.grid.cellCount.y) * box.h();
-                            const ftk::V3F v0 = vm * ftk::V3F(box.min.x, y, 0.F);
-                            const ftk::V3F v1 = vm * ftk::V3F(box.max.x + 1, y, 0.F);
-                            const ftk::V2I v2(
-                                ftk::clamp(static_cast<int>(v0.x), boxT.min.x, boxT.max.x),
-                                ftk::clamp(static_cast<int>(v0.y), boxT.min.y, boxT.max.y));
-                            const ftk::V2I v3(
-                                ftk::clamp(static_cast<int>(v1.x), boxT.min.x, boxT.max.x),
-                                ftk::clamp(static_cast<int>(v1.y), boxT.min.y, boxT.max.y));
-                            rects.push_back(ftk::Box2F(
-                                v2.x,
-                                v2.y - options.grid.lineWidth / 2,
-                                boxT.w(),
-                                options.grid.lineWidth));
-                        }
-                        for (int i = 0; i <= cellCount.x; ++i)
-                        {
-                            const float x = box.min.x + i / static_cast<float>(options.grid.cellCount.x) * box.w();
-                            const ftk::V3F v0 = vm * ftk::V3F(x, box.min.y, 0.F);
-                            const ftk::V3F v1 = vm * ftk::V3F(x, box.max.y + 1, 0.F);
-                            const ftk::V2I v2(
-                                ftk::clamp(static_cast<int>(v0.x), boxT.min.x, boxT.max.x),
-                                ftk::clamp(static_cast<int>(v0.y), boxT.min.y, boxT.max.y));
-                            const ftk::V2I v3(
-                                ftk::clamp(static_cast<int>(v1.x), boxT.min.x, boxT.max.x),
-                                ftk::clamp(static_cast<int>(v1.y), boxT.min.y, boxT.max.y));
-                            rects.push_back(ftk::Box2F(
-                                v2.x - options.grid.lineWidth / 2,
-                                v2.y,
-                                options.grid.lineWidth,
-                                boxT.h()));
-                        }
-                        drawRects(rects, options.grid.color);
-                    }
-                }
-
-                if (options.centerMarker.enabled)
-                {
-                    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
-                    std::vector<ftk::Box2F> centerMarker;
-                    const ftk::V2F c(
-                        box.x() + box.w() / 2.F,
-                        box.y() + box.h() / 2.F);
-                    const ftk::V3F v = vm * ftk::V3F(c.x, c.y, 0.F);
-                    const float a = 1.F / 3.F;
-                    const float b = 2.F / 3.F;
-                    centerMarker.push_back(ftk::Box2F(
-                        v.x - options.centerMarker.width / 2,
-                        v.y - options.centerMarker.size,
-                        options.centerMarker.width,
-                        options.centerMarker.size * b));
-                    centerMarker.push_back(ftk::Box2F(
-                        v.x - options.centerMarker.width / 2,
-                        v.y + options.centerMarker.size * a,
-                        options.centerMarker.width,
-                        options.centerMarker.size * b));
-                    centerMarker.push_back(ftk::Box2F(
-                        v.x - options.centerMarker.size,
-                        v.y - options.centerMarker.width / 2,
-                        options.centerMarker.size * b,
-                        options.centerMarker.width));
-                    centerMarker.push_back(ftk::Box2F(
-                        v.x + options.centerMarker.size * a,
-                        v.y - options.centerMarker.width / 2,
-                        options.centerMarker.size * b,
-                        options.centerMarker.width));
-                    drawRects(centerMarker, options.centerMarker.color);
-                }
-            }
+            glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE);
+            IRender::drawForeground(boxes, vm, options, compareOptions);
         }
     }
 }
@@ -12,6 +12,7 @@
 #include <tlRender/Timeline/ForegroundOptions.h>
 #include <tlRender/Timeline/Transition.h>
 
+#include <ftk/GL/GL.h>
 #include <ftk/GL/OffscreenBuffer.h>
 #include <ftk/GL/Texture.h>
 #include <ftk/GL/Window.h>
@@ -22,6 +23,9 @@
 #include <ftk/Core/Mesh.h>
 #include <ftk/Core/Format.h>
 
+#include <algorithm>
+#include <cmath>
+
 #if defined(TLRENDER_OCIO)
 #include <OpenColorIO/OpenColorIO.h>
 namespace OCIO = OCIO_NAMESPACE;
@@ -82,11 +86,13 @@ namespace tl
         void RenderTest::run()
         {
             _compare();
+            _compareStats();
             _dissolve();
             _display();
             _background();
             _foreground();
             _prims();
+            _tiles();
             _color();
         }
 
@@ -245,6 +251,83 @@ namespace tl
             render->end();
         }
 
+        //! An image over the tile threshold, which is drawn a tile at a
+        //! time and then from the cache.
+        void RenderTest::_tiles()
+        {
+            auto window = createWindow(_context);
+            auto render = gl::Render::create(
+                _context->getLogSystem(),
+                _context->getSystem<ftk::FontSystem>());
+            gl::TileOptions tileOptions;
+            tileOptions.threshold = 16;
+            tileOptions.size = 16;
+            render->setTileOptions(tileOptions);
+            FTK_CHECK(tileOptions == render->getTileOptions());
+
+            auto buffer = ftk::gl::OffscreenBuffer::create(
+                imageSize,
+                ftk::gl::TextureType::RGBA_U8);
+            ftk::gl::OffscreenBufferBinding bufferBinding(buffer);
+            auto image = createImage(255);
+            const ftk::Box2F box(0.F, 0.F, imageSize.w, imageSize.h);
+            auto draw = [&]
+            {
+                render->begin(imageSize);
+                render->drawImage(image, box);
+                render->end();
+                return render->getUploadStats();
+            };
+
+            // Every tile the first time.
+            gl::UploadStats stats = draw();
+            FTK_CHECK(8 == stats.frameTileCount);
+            FTK_CHECK(stats.frameByteCount > 0);
+            FTK_CHECK(8 == stats.tileCount);
+            FTK_CHECK(gl::Render::getTileByteCount() >= stats.tileByteCount);
+            std::vector<uint8_t> pixels(imageSize.w * imageSize.h * 4);
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glReadPixels(
+                0,
+                0,
+                imageSize.w,
+                imageSize.h,
+                GL_RGBA,
+                GL_UNSIGNED_BYTE,
+                pixels.data());
+            FTK_CHECK(std::all_of(
+                pixels.begin(),
+                pixels.end(),
+                [](uint8_t value) { return 255 == value; }));
+
+            // None the second.
+            stats = draw();
+            FTK_CHECK(0 == stats.frameTileCount);
+            FTK_CHECK(0 == stats.frameByteCount);
+
+            // A different image at the same size misses.
+            image = createImage(128);
+            stats = draw();
+            FTK_CHECK(8 == stats.frameTileCount);
+            _print(ftk::Format("Tiles: {0} {1}").
+                arg(stats.tileCount).
+                arg(stats.tileByteCount));
+
+            // Out of view there is nothing to upload.
+            image = createImage(64);
+            render->begin(imageSize);
+            render->setTransform(ftk::ortho(
+                1000.F,
+                1000.F + imageSize.w,
+                1000.F + imageSize.h,
+                1000.F,
+                -1.F,
+                1.F));
+            render->drawImage(image, box);
+            render->end();
+            FTK_CHECK(0 == render->getUploadStats().frameTileCount);
+        }
+
         void RenderTest::_compare()
         {
             auto window = createWindow(_context);
@@ -342,6 +425,80 @@ namespace tl
             }
         }
 
+        void RenderTest::_compareStats()
+        {
+            // The measurement needs floating point buffers read back, which
+            // OpenGL ES 2 does not have.
+#if !defined(FTK_API_GLES_2)
+            auto window = createWindow(_context);
+            auto render = gl::Render::create(
+                _context->getLogSystem(),
+                _context->getSystem<ftk::FontSystem>());
+            auto buffer = ftk::gl::OffscreenBuffer::create(
+                imageSize,
+                ftk::gl::offscreenColorDefault);
+            ftk::gl::OffscreenBufferBinding bufferBinding(buffer);
+            const std::vector<ftk::Box2I> boxes =
+            {
+                ftk::Box2I(ftk::V2I(), imageSize),
+                ftk::Box2I(ftk::V2I(), imageSize)
+            };
+            CompareOptions compareOptions;
+            compareOptions.compare = Compare::Difference;
+            compareOptions.differenceStats = true;
+            compareOptions.differenceThreshold = .1F;
+
+            auto draw = [&](const std::vector<VideoFrame>& frames)
+            {
+                render->begin(imageSize);
+                render->drawVideo(
+                    frames,
+                    boxes,
+                    { ftk::ImageOptions(), ftk::ImageOptions() },
+                    { DisplayOptions(), DisplayOptions() },
+                    compareOptions);
+                render->end();
+                return render->getCompareStats();
+            };
+
+            // The same picture twice.
+            CompareStats stats = draw({ createFrame(128), createFrame(128) });
+            FTK_CHECK(stats.valid);
+            FTK_CHECK(static_cast<size_t>(imageSize.w * imageSize.h) == stats.pixelCount);
+            FTK_CHECK(0.F == stats.maxError);
+            FTK_CHECK(0.F == stats.meanError);
+            FTK_CHECK(std::isinf(stats.psnr));
+            FTK_CHECK(0 == stats.thresholdCount);
+
+            // Black against white, which differs everywhere by full scale.
+            stats = draw({ createFrame(0), createFrame(255) });
+            FTK_CHECK(stats.valid);
+            FTK_CHECK(1.F == stats.maxError);
+            FTK_CHECK(1.F == stats.meanError);
+            FTK_CHECK(0.F == stats.psnr);
+            FTK_CHECK(static_cast<size_t>(imageSize.w * imageSize.h) == stats.thresholdCount);
+            FTK_CHECK(ftk::Box2I(ftk::V2I(), imageSize) == stats.thresholdBox);
+
+            // One pixel, which the box has to find.
+            VideoFrame frame = createFrame(128);
+            auto image = createImage(128);
+            uint8_t* p = image->getData() + (5 * imageSize.w + 10) * 4;
+            p[0] = 0;
+            frame.layers[0].image = image;
+            stats = draw({ createFrame(128), frame });
+            FTK_CHECK(1 == stats.thresholdCount);
+            FTK_CHECK(ftk::Box2I(10, 5, 1, 1) == stats.thresholdBox);
+            _print(ftk::Format("Compare stats: max {0} mean {1} PSNR {2}").
+                arg(stats.maxError).
+                arg(stats.meanError).
+                arg(stats.psnr));
+
+            // Without the pair there is nothing measured.
+            stats = draw({ createFrame(128) });
+            FTK_CHECK(!stats.valid);
+#endif // FTK_API_GLES_2
+        }
+
         void RenderTest::_background()
         {
             auto window = createWindow(_context);
@@ -25,11 +25,13 @@ namespace tl
 
         private:
             void _compare();
+            void _compareStats();
             void _dissolve();
             void _display();
             void _background();
             void _foreground();
             void _prims();
+            void _tiles();
             void _color();
         };
     }
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/IO/Completion.h>
+
+#include <mutex>
+
+namespace tl
+{
+    namespace
+    {
+        thread_local std::shared_ptr<Completion> current;
+    }
+
+    struct Completion::Private
+    {
+        // The callback is called with the lock held, so that once the
+        // completion is closed it is never called again. The lock is the
+        // owner's alone, so one owner's completions do not hold up
+        // another's.
+        std::mutex mutex;
+        std::function<void()> callback;
+    };
+
+    Completion::Completion() :
+        _p(new Private)
+    {}
+
+    Completion::~Completion()
+    {}
+
+    std::shared_ptr<Completion> Completion::create(
+        const std::function<void()>& callback)
+    {
+        auto out = std::shared_ptr<Completion>(new Completion);
+        out->_p->callback = callback;
+        return out;
+    }
+
+    void Completion::notify()
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        if (p.callback)
+        {
+            p.callback();
+        }
+    }
+
+    void Completion::close()
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        p.callback = nullptr;
+    }
+
+    CompletionScope::CompletionScope(const std::shared_ptr<Completion>& value) :
+        _prev(current)
+    {
+        current = value;
+    }
+
+    CompletionScope::~CompletionScope()
+    {
+        current = _prev;
+    }
+
+    std::shared_ptr<Completion> getCompletion()
+    {
+        return current;
+    }
+
+    void notifyCompletion(const std::shared_ptr<Completion>& value)
+    {
+        if (value)
+        {
+            value->notify();
+        }
+    }
+}
@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include <tlRender/Core/Export.h>
+
+#include <ftk/Core/Util.h>
+
+#include <functional>
+#include <memory>
+
+namespace tl
+{
+    //! Wakes whoever is waiting on I/O requests when one of them completes.
+    //!
+    //! A request's result comes back in a std::future, which has no way
+    //! to say that it is ready. Whoever waits on futures -- a timeline's
+    //! request thread, a player's cache thread -- creates a completion,
+    //! and the requests it makes carry it with their promise. Whoever
+    //! completes a request notifies that completion, and so wakes only
+    //! the owner of the request.
+    //!
+    //! Requests pick up the completion of the thread that makes them, see
+    //! CompletionScope, so that the readers need not pass it along.
+    class TL_API_TYPE Completion
+    {
+        FTK_NON_COPYABLE(Completion);
+
+    public:
+        TL_API ~Completion();
+
+        //! Create a new completion. The callback is called on the thread
+        //! that completed the request, and should do no more than wake
+        //! the thread that is waiting.
+        TL_API static std::shared_ptr<Completion> create(
+            const std::function<void()>&);
+
+        //! Call the callback, unless the completion is closed.
+        TL_API void notify();
+
+        //! Stop calling the callback. Requests can outlive their owner, so
+        //! the owner closes the completion before it goes away.
+        TL_API void close();
+
+    private:
+        Completion();
+
+        FTK_PRIVATE();
+    };
+
+    //! Makes a completion the one that requests made on this thread carry,
+    //! for as long as the scope lasts.
+    class TL_API_TYPE CompletionScope
+    {
+        FTK_NON_COPYABLE(CompletionScope);
+
+    public:
+        TL_API explicit CompletionScope(const std::shared_ptr<Completion>&);
+
+        TL_API ~CompletionScope();
+
+    private:
+        std::shared_ptr<Completion> _prev;
+    };
+
+    //! Get the completion that requests made on this thread carry. Null
+    //! when there is none; the caller then simply waits on the future.
+    TL_API std::shared_ptr<Completion> getCompletion();
+
+    //! Notify a request's completion, if it has one. Called after the
+    //! promise is set.
+    TL_API void notifyCompletion(const std::shared_ptr<Completion>&);
+}
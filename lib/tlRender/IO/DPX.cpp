@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/IO/DPX.h>
+
+#include <ftk/Core/Format.h>
+#include <ftk/Core/LogSystem.h>
+
+namespace tl
+{
+    namespace dpx
+    {
+        void ReadPlugin::_init(
+            const std::shared_ptr<ftk::LogSystem>& logSystem,
+            const std::shared_ptr<IReadPlugin>& fallback)
+        {
+            IReadPlugin::_init(
+                "DPX",
+                {
+                    { ".dpx", FileType::Seq },
+                    { ".cin", FileType::Seq }
+                },
+                logSystem);
+            _fallback = fallback;
+
+            logSystem->print(
+                "tl::dpx::ReadPlugin",
+                ftk::Format(
+                    "\n"
+                    "    * Formats: {0}\n"
+                    "    * Fallback: {1}").
+                arg(".dpx, .cin").
+                arg(fallback ? fallback->getPluginName() : "None"));
+        }
+
+        std::shared_ptr<ReadPlugin> ReadPlugin::create(
+            const std::shared_ptr<ftk::LogSystem>& logSystem,
+            const std::shared_ptr<IReadPlugin>& fallback)
+        {
+            auto out = std::shared_ptr<ReadPlugin>(new ReadPlugin);
+            out->_init(logSystem, fallback);
+            return out;
+        }
+
+        std::shared_ptr<IDecode> ReadPlugin::decode(const IOOptions& options)
+        {
+            return Decode::create(_fallback ? _fallback->decode(options) : nullptr);
+        }
+    }
+}
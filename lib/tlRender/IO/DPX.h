@@ -0,0 +1,72 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include <tlRender/IO/SeqIO.h>
+
+namespace tl
+{
+    //! DPX and Cineon image I/O.
+    //!
+    //! Scans are mostly 10-bit RGB filled into 32-bit words, read at film
+    //! resolutions and frame rates, so that layout is read natively: the
+    //! file is memory mapped and each row is unpacked straight into a
+    //! 16-bit RGB image, swapping the words when the file's byte order is
+    //! not the machine's.
+    namespace dpx
+    {
+        //! DPX and Cineon decoder.
+        //!
+        //! Files this does not read natively, such as 12-bit or YCbCr DPX,
+        //! go to the fallback decoder when there is one.
+        class TL_API_TYPE Decode : public IDecode
+        {
+        protected:
+            Decode(const std::shared_ptr<IDecode>& fallback);
+
+        public:
+            TL_API virtual ~Decode();
+
+            //! Create a new decoder.
+            TL_API static std::shared_ptr<Decode> create(
+                const std::shared_ptr<IDecode>& fallback = nullptr);
+
+            TL_API IOInfo getInfo(
+                const std::string& fileName,
+                const ftk::MemFile* = nullptr) override;
+            TL_API VideoData readVideo(
+                const std::string& fileName,
+                const ftk::MemFile*,
+                const OTIO_NS::RationalTime&,
+                const IOOptions& = IOOptions()) override;
+
+        private:
+            std::shared_ptr<IDecode> _fallback;
+        };
+
+        //! DPX and Cineon read plugin.
+        class TL_API_TYPE ReadPlugin : public IReadPlugin
+        {
+        protected:
+            void _init(
+                const std::shared_ptr<ftk::LogSystem>&,
+                const std::shared_ptr<IReadPlugin>& fallback);
+
+            ReadPlugin() = default;
+
+        public:
+            //! Create a new plugin. The fallback plugin decodes the files
+            //! this one does not read natively.
+            TL_API static std::shared_ptr<ReadPlugin> create(
+                const std::shared_ptr<ftk::LogSystem>&,
+                const std::shared_ptr<IReadPlugin>& fallback = nullptr);
+
+            TL_API std::shared_ptr<IDecode> decode(
+                const IOOptions& = IOOptions()) override;
+
+        private:
+            std::shared_ptr<IReadPlugin> _fallback;
+        };
+    }
+}
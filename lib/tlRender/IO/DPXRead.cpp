@@ -0,0 +1,606 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/IO/DPX.h>
+
+#include <ftk/Core/FileIO.h>
+#include <ftk/Core/Format.h>
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TLRENDER_DPX_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define TLRENDER_DPX_NEON
+#include <arm_neon.h>
+#endif
+
+namespace tl
+{
+    namespace dpx
+    {
+        namespace
+        {
+            bool isMSB()
+            {
+                const uint32_t one = 1;
+                return 0 == *reinterpret_cast<const uint8_t*>(&one);
+            }
+
+            //! Reads the header fields in the file's byte order, and throws
+            //! rather than reading past the end of a truncated file.
+            class Header
+            {
+            public:
+                Header(const uint8_t* p, size_t size, bool msb) :
+                    _p(p),
+                    _size(size),
+                    _msb(msb)
+                {}
+
+                uint8_t u8(size_t offset) const
+                {
+                    _check(offset, 1);
+                    return _p[offset];
+                }
+
+                uint16_t u16(size_t offset) const
+                {
+                    _check(offset, 2);
+                    const uint8_t* p = _p + offset;
+                    return _msb ?
+                        (p[0] << 8 | p[1]) :
+                        (p[1] << 8 | p[0]);
+                }
+
+                uint32_t u32(size_t offset) const
+                {
+                    _check(offset, 4);
+                    const uint8_t* p = _p + offset;
+                    return _msb ?
+                        (uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | p[3]) :
+                        (uint32_t(p[3]) << 24 | uint32_t(p[2]) << 16 | uint32_t(p[1]) << 8 | p[0]);
+                }
+
+                std::string text(size_t offset, size_t size) const
+                {
+                    _check(offset, size);
+                    const char* p = reinterpret_cast<const char*>(_p + offset);
+                    return std::string(p, strnlen(p, size));
+                }
+
+            private:
+                void _check(size_t offset, size_t size) const
+                {
+                    if (offset + size > _size)
+                    {
+                        throw std::runtime_error("Truncated header");
+                    }
+                }
+
+                const uint8_t* _p = nullptr;
+                size_t _size = 0;
+                bool _msb = true;
+            };
+
+            //! A field the file leaves undefined.
+            const uint32_t undefined = 0xffffffff;
+
+            //! How the rows of the file are turned into rows of the image.
+            enum class Convert
+            {
+                Copy,
+                Swap16,
+                Unpack10
+            };
+
+            struct Layout
+            {
+                ftk::ImageInfo info;
+                ftk::ImageTags tags;
+                size_t         dataOffset   = 0;
+                size_t         rowByteCount = 0;
+                size_t         rowStride    = 0;
+                Convert        convert      = Convert::Copy;
+
+                //! The bytes in a row of the image, when that is not the
+                //! same as a row of the file.
+                size_t         imageRowByteCount = 0;
+
+                //! 32-bit words are swapped when the file's byte order is
+                //! not the machine's, and shifted to method A when the
+                //! padding is at the top.
+                bool           swap         = false;
+                int            shift        = 0;
+            };
+
+            bool setOrientation(int orientation, ftk::ImageInfo& info)
+            {
+                // Rows are stored from the top unless the orientation says
+                // otherwise; the transposed orientations are rare enough to
+                // leave to the fallback.
+                bool out = true;
+                switch (orientation)
+                {
+                case 0: info.layout.mirror.y = true; break;
+                case 1: info.layout.mirror.x = true; info.layout.mirror.y = true; break;
+                case 2: break;
+                case 3: info.layout.mirror.x = true; break;
+                default: out = false; break;
+                }
+                return out;
+            }
+
+            const std::array<std::string, 13> transfers =
+            {
+                "User defined",
+                "Printing density",
+                "Linear",
+                "Logarithmic",
+                "Unspecified video",
+                "SMPTE 274M",
+                "ITU-R 709-4",
+                "ITU-R 601-5 system B or G",
+                "ITU-R 601-5 system M",
+                "Composite video (NTSC)",
+                "Composite video (PAL)",
+                "Z (depth) - linear",
+                "Z (depth) - homogeneous"
+            };
+
+            bool getDPXLayout(const Header& header, bool msb, Layout& out)
+            {
+                out.dataOffset = header.u32(4);
+                const int orientation = header.u16(768);
+                const uint32_t width = header.u32(772);
+                const uint32_t height = header.u32(776);
+
+                // Only the first image element is read.
+                const int descriptor = header.u8(800);
+                const int transfer = header.u8(801);
+                const int bitDepth = header.u8(803);
+                const int packing = header.u16(804);
+                const int encoding = header.u16(806);
+                const uint32_t elementOffset = header.u32(808);
+                const uint32_t eolPadding = header.u32(812);
+                if (encoding != 0 || 0 == width || 0 == height)
+                {
+                    return false;
+                }
+                if (elementOffset != 0 && elementOffset != undefined)
+                {
+                    out.dataOffset = elementOffset;
+                }
+
+                size_t channelCount = 0;
+                switch (descriptor)
+                {
+                case 6: channelCount = 1; break;
+                case 50: channelCount = 3; break;
+                case 51: channelCount = 4; break;
+                default: return false;
+                }
+                switch (bitDepth)
+                {
+                case 8:
+                    out.info.type = getIntImageType(channelCount, 8);
+                    out.rowByteCount = width * channelCount;
+                    break;
+                case 16:
+                    out.info.type = getIntImageType(channelCount, 16);
+                    out.rowByteCount = width * channelCount * 2;
+                    if (msb != isMSB())
+                    {
+                        out.convert = Convert::Swap16;
+                    }
+                    break;
+                case 10:
+                    // RGB filled into 32-bit words, unpacked to 16 bits a
+                    // channel. Packed 10-bit crosses word boundaries and
+                    // goes to the fallback.
+                    if (channelCount != 3 || (packing != 1 && packing != 2))
+                    {
+                        return false;
+                    }
+                    out.info.type = ftk::ImageType::RGB_U16;
+                    out.rowByteCount = width * 4;
+                    out.imageRowByteCount = width * 3 * 2;
+                    out.convert = Convert::Unpack10;
+                    out.swap = msb != isMSB();
+                    out.shift = 2 == packing ? 2 : 0;
+                    break;
+                default: return false;
+                }
+                if (ftk::ImageType::None == out.info.type)
+                {
+                    return false;
+                }
+
+                // Filled rows start on a word; packed ones only do when
+                // they happen to fill one.
+                out.rowStride = (out.rowByteCount + 3) / 4 * 4;
+                if (0 == packing && out.rowStride != out.rowByteCount)
+                {
+                    return false;
+                }
+                if (eolPadding != undefined)
+                {
+                    out.rowStride += eolPadding;
+                }
+
+                out.info.size = ftk::Size2I(width, height);
+                if (!setOrientation(orientation, out.info))
+                {
+                    return false;
+                }
+
+                if (const std::string value = header.text(160, 100); !value.empty())
+                {
+                    out.tags["Creator"] = value;
+                }
+                if (const std::string value = header.text(260, 200); !value.empty())
+                {
+                    out.tags["Project"] = value;
+                }
+                if (const std::string value = header.text(460, 200); !value.empty())
+                {
+                    out.tags["Copyright"] = value;
+                }
+                if (const std::string value = header.text(136, 24); !value.empty())
+                {
+                    out.tags["Creation Time"] = value;
+                }
+                if (transfer < static_cast<int>(transfers.size()))
+                {
+                    out.tags["Transfer"] = transfers[transfer];
+                }
+                return true;
+            }
+
+            bool getCineonLayout(const Header& header, bool msb, Layout& out)
+            {
+                out.dataOffset = header.u32(4);
+                const int orientation = header.u8(192);
+                const int channelCount = header.u8(193);
+                const int bitDepth = header.u8(198);
+                const uint32_t width = header.u32(200);
+                const uint32_t height = header.u32(204);
+                const int interleave = header.u8(680);
+                const int packing = header.u8(681);
+                const uint32_t eolPadding = header.u32(684);
+
+                // 10-bit RGB, pixel interleaved and left justified in 32-bit
+                // words, which is the same word as DPX method A.
+                if (channelCount != 3 ||
+                    bitDepth != 10 ||
+                    header.u8(198 + 28) != 10 ||
+                    header.u8(198 + 56) != 10 ||
+                    interleave != 0 ||
+                    packing != 5 ||
+                    0 == width ||
+                    0 == height)
+                {
+                    return false;
+                }
+                out.info.type = ftk::ImageType::RGB_U16;
+                out.info.size = ftk::Size2I(width, height);
+                out.rowByteCount = width * 4;
+                out.imageRowByteCount = width * 3 * 2;
+                out.rowStride = out.rowByteCount;
+                if (eolPadding != undefined)
+                {
+                    out.rowStride += eolPadding;
+                }
+                out.convert = Convert::Unpack10;
+                out.swap = msb != isMSB();
+
+                // Cineon numbers the orientations bottom to top before right
+                // to left, the other way around from DPX.
+                const std::array<int, 4> dpxOrientations = { 0, 2, 1, 3 };
+                if (orientation >= static_cast<int>(dpxOrientations.size()) ||
+                    !setOrientation(dpxOrientations[orientation], out.info))
+                {
+                    return false;
+                }
+
+                if (const std::string value = header.text(136, 12); !value.empty())
+                {
+                    out.tags["Creation Date"] = value;
+                }
+                if (const std::string value = header.text(148, 12); !value.empty())
+                {
+                    out.tags["Creation Time"] = value;
+                }
+                return true;
+            }
+
+            //! Get the layout of the file, or false when it is not one that
+            //! is read natively.
+            bool getLayout(const uint8_t* p, size_t size, Layout& out)
+            {
+                if (size < 4)
+                {
+                    return false;
+                }
+                const uint32_t magic =
+                    uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | p[3];
+                switch (magic)
+                {
+                case 0x53445058: return getDPXLayout(Header(p, size, true), true, out);
+                case 0x58504453: return getDPXLayout(Header(p, size, false), false, out);
+                case 0x802a5fd7: return getCineonLayout(Header(p, size, true), true, out);
+                case 0xd75f2a80: return getCineonLayout(Header(p, size, false), false, out);
+                default: break;
+                }
+                return false;
+            }
+
+            uint32_t swap32(uint32_t value)
+            {
+                return
+                    (value >> 24) |
+                    ((value >> 8) & 0xff00) |
+                    ((value << 8) & 0xff0000) |
+                    (value << 24);
+            }
+
+            //! Unpack 10-bit RGB words to 16-bit channels, four words at a
+            //! time. The low bits are filled from the high ones, so that full
+            //! scale stays full scale.
+            void unpack10(
+                const uint8_t* in,
+                uint8_t* out,
+                size_t count,
+                bool swap,
+                int shift)
+            {
+                size_t i = 0;
+#if defined(TLRENDER_DPX_SSE2)
+                // Each pixel is stored as eight bytes, the last two of which
+                // the next pixel writes over, so the loop stops while there is
+                // a word after the four.
+                const __m128i mask = _mm_set1_epi32(0x3ff);
+                const __m128i bias = _mm_set1_epi32(0x8000);
+                const __m128i bias16 = _mm_set1_epi16(static_cast<short>(0x8000));
+                const __m128i shiftV = _mm_cvtsi32_si128(shift);
+                for (; i + 4 < count; i += 4)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 4));
+                    if (swap)
+                    {
+                        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+                        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+                        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+                    }
+                    v = _mm_sll_epi32(v, shiftV);
+                    __m128i r = _mm_srli_epi32(v, 22);
+                    __m128i g = _mm_and_si128(_mm_srli_epi32(v, 12), mask);
+                    __m128i b = _mm_and_si128(_mm_srli_epi32(v, 2), mask);
+                    r = _mm_or_si128(_mm_slli_epi32(r, 6), _mm_srli_epi32(r, 4));
+                    g = _mm_or_si128(_mm_slli_epi32(g, 6), _mm_srli_epi32(g, 4));
+                    b = _mm_or_si128(_mm_slli_epi32(b, 6), _mm_srli_epi32(b, 4));
+
+                    // SSE2 only packs with signed saturation, so the values
+                    // are moved into the signed range and back.
+                    const __m128i rg = _mm_xor_si128(
+                        _mm_packs_epi32(_mm_sub_epi32(r, bias), _mm_sub_epi32(g, bias)),
+                        bias16);
+                    const __m128i rgi = _mm_unpacklo_epi16(rg, _mm_srli_si128(rg, 8));
+                    const __m128i lo = _mm_unpacklo_epi32(rgi, b);
+                    const __m128i hi = _mm_unpackhi_epi32(rgi, b);
+                    uint8_t* outP = out + i * 6;
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(outP), lo);
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(outP + 6), _mm_srli_si128(lo, 8));
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(outP + 12), hi);
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(outP + 18), _mm_srli_si128(hi, 8));
+                }
+#elif defined(TLRENDER_DPX_NEON)
+                const uint32x4_t mask = vdupq_n_u32(0x3ff);
+                const int32x4_t shiftV = vdupq_n_s32(shift);
+                for (; i + 4 <= count; i += 4)
+                {
+                    uint8x16_t bytes = vld1q_u8(in + i * 4);
+                    if (swap)
+                    {
+                        bytes = vrev32q_u8(bytes);
+                    }
+                    const uint32x4_t v = vshlq_u32(vreinterpretq_u32_u8(bytes), shiftV);
+                    uint32x4_t r = vshrq_n_u32(v, 22);
+                    uint32x4_t g = vandq_u32(vshrq_n_u32(v, 12), mask);
+                    uint32x4_t b = vandq_u32(vshrq_n_u32(v, 2), mask);
+                    uint16x4x3_t rgb;
+                    rgb.val[0] = vmovn_u32(vorrq_u32(vshlq_n_u32(r, 6), vshrq_n_u32(r, 4)));
+                    rgb.val[1] = vmovn_u32(vorrq_u32(vshlq_n_u32(g, 6), vshrq_n_u32(g, 4)));
+                    rgb.val[2] = vmovn_u32(vorrq_u32(vshlq_n_u32(b, 6), vshrq_n_u32(b, 4)));
+                    vst3_u16(reinterpret_cast<uint16_t*>(out + i * 6), rgb);
+                }
+#endif // TLRENDER_DPX_SSE2
+                uint16_t* outP = reinterpret_cast<uint16_t*>(out) + i * 3;
+                for (; i < count; ++i, outP += 3)
+                {
+                    uint32_t v = 0;
+                    std::memcpy(&v, in + i * 4, 4);
+                    if (swap)
+                    {
+                        v = swap32(v);
+                    }
+                    v <<= shift;
+                    const uint32_t r = v >> 22;
+                    const uint32_t g = (v >> 12) & 0x3ff;
+                    const uint32_t b = (v >> 2) & 0x3ff;
+                    outP[0] = static_cast<uint16_t>(r << 6 | r >> 4);
+                    outP[1] = static_cast<uint16_t>(g << 6 | g >> 4);
+                    outP[2] = static_cast<uint16_t>(b << 6 | b >> 4);
+                }
+            }
+
+            //! Copy 16-bit values, swapping them eight at a time.
+            void swap16(const uint8_t* in, uint8_t* out, size_t count)
+            {
+                size_t i = 0;
+#if defined(TLRENDER_DPX_SSE2)
+                for (; i + 8 <= count; i += 8)
+                {
+                    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 2));
+                    _mm_storeu_si128(
+                        reinterpret_cast<__m128i*>(out + i * 2),
+                        _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+                }
+#elif defined(TLRENDER_DPX_NEON)
+                for (; i + 8 <= count; i += 8)
+                {
+                    vst1q_u8(out + i * 2, vrev16q_u8(vld1q_u8(in + i * 2)));
+                }
+#endif // TLRENDER_DPX_SSE2
+                for (; i < count; ++i)
+                {
+                    out[i * 2] = in[i * 2 + 1];
+                    out[i * 2 + 1] = in[i * 2];
+                }
+            }
+
+            //! The bytes of a file, mapped when it is on disk.
+            struct Data
+            {
+                std::shared_ptr<ftk::FileIO> fileIO;
+                std::vector<uint8_t> buffer;
+                const uint8_t* p = nullptr;
+                size_t size = 0;
+            };
+
+            Data getData(const std::string& fileName, const ftk::MemFile* memory)
+            {
+                Data out;
+                if (memory)
+                {
+                    out.p = memory->p;
+                    out.size = memory->size;
+                }
+                else
+                {
+                    const auto path = std::filesystem::u8path(fileName);
+                    if (!std::filesystem::exists(path))
+                    {
+                        throw std::runtime_error(ftk::Format(
+                            "No such file or directory: \"{0}\"").arg(fileName).str());
+                    }
+                    out.fileIO = ftk::FileIO::create(path, ftk::FileMode::Read);
+                    out.size = out.fileIO->getSize();
+                    out.p = out.fileIO->getMemP();
+                    if (!out.p)
+                    {
+                        out.buffer.resize(out.size);
+                        out.fileIO->read(out.buffer.data(), out.size);
+                        out.p = out.buffer.data();
+                    }
+                }
+                return out;
+            }
+
+            bool getLayout(const std::string& fileName, const Data& data, Layout& out)
+            {
+                try
+                {
+                    return getLayout(data.p, data.size, out);
+                }
+                catch (const std::exception&)
+                {
+                    throw std::runtime_error(ftk::Format(
+                        "Cannot read file: \"{0}\"").arg(fileName).str());
+                }
+            }
+        }
+
+        Decode::Decode(const std::shared_ptr<IDecode>& fallback) :
+            _fallback(fallback)
+        {}
+
+        Decode::~Decode()
+        {}
+
+        std::shared_ptr<Decode> Decode::create(const std::shared_ptr<IDecode>& fallback)
+        {
+            return std::shared_ptr<Decode>(new Decode(fallback));
+        }
+
+        IOInfo Decode::getInfo(
+            const std::string& fileName,
+            const ftk::MemFile* memory)
+        {
+            const Data data = getData(fileName, memory);
+            Layout layout;
+            if (!getLayout(fileName, data, layout))
+            {
+                if (_fallback)
+                {
+                    return _fallback->getInfo(fileName, memory);
+                }
+                throw std::runtime_error(
+                    ftk::Format("Unsupported file: \"{0}\"").arg(fileName).str());
+            }
+            IOInfo out;
+            out.video.push_back(layout.info);
+            out.tags = layout.tags;
+            return out;
+        }
+
+        VideoData Decode::readVideo(
+            const std::string& fileName,
+            const ftk::MemFile* memory,
+            const OTIO_NS::RationalTime& time,
+            const IOOptions& options)
+        {
+            const Data data = getData(fileName, memory);
+            Layout layout;
+            if (!getLayout(fileName, data, layout))
+            {
+                if (_fallback)
+                {
+                    return _fallback->readVideo(fileName, memory, time, options);
+                }
+                throw std::runtime_error(
+                    ftk::Format("Unsupported file: \"{0}\"").arg(fileName).str());
+            }
+            const size_t height = layout.info.size.h;
+            if (layout.dataOffset > data.size ||
+                (height - 1) * layout.rowStride + layout.rowByteCount >
+                data.size - layout.dataOffset)
+            {
+                throw std::runtime_error(ftk::Format(
+                    "Cannot read file: \"{0}\"").arg(fileName).str());
+            }
+
+            // Each row goes from the mapped file to the image in one pass.
+            VideoData out;
+            out.time = time;
+            out.image = ftk::Image::create(layout.info);
+            out.image->setTags(layout.tags);
+            const uint8_t* in = data.p + layout.dataOffset;
+            uint8_t* outP = out.image->getData();
+            const size_t outRowByteCount = layout.imageRowByteCount > 0 ?
+                layout.imageRowByteCount :
+                layout.rowByteCount;
+            for (size_t y = 0; y < height; ++y)
+            {
+                const uint8_t* inRow = in + y * layout.rowStride;
+                uint8_t* outRow = outP + y * outRowByteCount;
+                switch (layout.convert)
+                {
+                case Convert::Copy:
+                    std::memcpy(outRow, inRow, layout.rowByteCount);
+                    break;
+                case Convert::Swap16:
+                    swap16(inRow, outRow, layout.rowByteCount / 2);
+                    break;
+                case Convert::Unpack10:
+                    unpack10(inRow, outRow, layout.rowByteCount / 4, layout.swap, layout.shift);
+                    break;
+                }
+            }
+            return out;
+        }
+    }
+}
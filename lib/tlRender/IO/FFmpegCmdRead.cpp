@@ -3,6 +3,8 @@
 
 #include <tlRender/IO/FFmpegCmdPrivate.h>
 
+#include <tlRender/IO/Completion.h>
+
 #include <ftk/Core/Format.h>
 #include <ftk/Core/LogSystem.h>
 
@@ -20,6 +22,7 @@ namespace tl
             struct InfoRequest
             {
                 std::promise<IOInfo> promise;
+                std::shared_ptr<Completion> completion = getCompletion();
             };
 
             struct VideoRequest
@@ -27,6 +30,7 @@ namespace tl
                 OTIO_NS::RationalTime time;
                 IOOptions options;
                 std::promise<VideoData> promise;
+                std::shared_ptr<Completion> completion = getCompletion();
             };
 
             struct Mutex
@@ -55,6 +59,7 @@ namespace tl
             struct InfoRequest
             {
                 std::promise<IOInfo> promise;
+                std::shared_ptr<Completion> completion = getCompletion();
             };
 
             struct AudioRequest
@@ -62,6 +67,7 @@ namespace tl
                 OTIO_NS::TimeRange timeRange;
                 IOOptions options;
                 std::promise<AudioData> promise;
+                std::shared_ptr<Completion> completion = getCompletion();
             };
 
             struct Mutex
@@ -120,10 +126,12 @@ namespace tl
             for (auto& request : p.mutex.infoRequests)
             {
                 request->promise.set_value(IOInfo());
+                notifyCompletion(request->completion);
             }
             for (auto& request : p.mutex.videoRequests)
             {
                 request->promise.set_value(VideoData());
+                notifyCompletion(request->completion);
             }
         }
 
@@ -189,10 +197,12 @@ namespace tl
             for (auto& request : infoRequests)
             {
                 request->promise.set_value(IOInfo());
+                notifyCompletion(request->completion);
             }
             for (auto& request : videoRequests)
             {
                 request->promise.set_value(VideoData());
+                notifyCompletion(request->completion);
             }
         }
 
@@ -233,10 +243,12 @@ namespace tl
             for (auto& request : p.mutex.infoRequests)
             {
                 request->promise.set_value(IOInfo());
+                notifyCompletion(request->completion);
             }
             for (auto& request : p.mutex.audioRequests)
             {
                 request->promise.set_value(AudioData());
+                notifyCompletion(request->completion);
             }
         }
 
@@ -302,10 +314,12 @@ namespace tl
             for (auto& request : infoRequests)
             {
                 request->promise.set_value(IOInfo());
+                notifyCompletion(request->completion);
             }
             for (auto& request : audioRequests)
             {
                 request->promise.set_value(AudioData());
+                notifyCompletion(request->completion);
             }
         }
 
@@ -684,6 +698,7 @@ namespace tl
                 for (auto& request : infoRequests)
                 {
                     request->promise.set_value(p.info);
+                    notifyCompletion(request->completion);
                 }
 
                 if (videoRequest &&
@@ -693,11 +708,14 @@ namespace tl
                     p.thread.pipe.reset();
                 }
 
+                // The access hint changes with every play, stop and reverse,
+                // and says nothing about what the subprocess decodes, so it
+                // does not restart it.
                 if (videoRequest &&
                     !p.info.video.empty() &&
-                    (!p.thread.pipe || videoRequest->options != ioOptions))
+                    (!p.thread.pipe || removeAccessHint(videoRequest->options) != ioOptions))
                 {
-                    ioOptions = videoRequest->options;
+                    ioOptions = removeAccessHint(videoRequest->options);
                     try
                     {
                         const Options options(merge(ioOptions, _options));
@@ -755,6 +773,7 @@ namespace tl
                         }
                     }
                     videoRequest->promise.set_value(video);
+                    notifyCompletion(videoRequest->completion);
                     p.thread.time += OTIO_NS::RationalTime(1.0, videoTime.duration().rate());
                 }
             }
@@ -799,6 +818,7 @@ namespace tl
                 for (auto& infoRequest : infoRequests)
                 {
                     infoRequest->promise.set_value(p.info);
+                    notifyCompletion(infoRequest->completion);
                 }
 
                 if (request &&
@@ -809,9 +829,9 @@ namespace tl
                 }
 
                 if (request &&
-                    (!p.thread.pipe || request->options != ioOptions))
+                    (!p.thread.pipe || removeAccessHint(request->options) != ioOptions))
                 {
-                    ioOptions = request->options;
+                    ioOptions = removeAccessHint(request->options);
                     try
                     {
                         const Options options(merge(ioOptions, _options));
@@ -864,6 +884,7 @@ namespace tl
                         }
                     }
                     request->promise.set_value(audio);
+                    notifyCompletion(request->completion);
                     p.thread.time += request->timeRange.duration();
                 }
             }
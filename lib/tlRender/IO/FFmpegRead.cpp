@@ -6,8 +6,11 @@
 #include <ftk/Core/Assert.h>
 #include <ftk/Core/Format.h>
 #include <ftk/Core/LogSystem.h>
+#include <ftk/Core/Memory.h>
 
 #include <algorithm>
+#include <cmath>
+#include <future>
 
 extern "C"
 {
@@ -122,6 +125,30 @@ namespace tl
                 std::stringstream ss(i->second);
                 ss >> out.videoBufferSize;
             }
+            if (auto i = options.find("FFmpeg/GOPCacheSize");
+                i != options.end())
+            {
+                std::stringstream ss(i->second);
+                ss >> out.gopCacheSize;
+            }
+            if (auto i = options.find("FFmpeg/GOPCacheMB");
+                i != options.end())
+            {
+                std::stringstream ss(i->second);
+                ss >> out.gopCacheMB;
+            }
+            if (auto i = options.find("FFmpeg/SegmentCount");
+                i != options.end())
+            {
+                std::stringstream ss(i->second);
+                ss >> out.segmentCount;
+            }
+            if (auto i = options.find("FFmpeg/SegmentSize");
+                i != options.end())
+            {
+                std::stringstream ss(i->second);
+                ss >> out.segmentSize;
+            }
             if (auto i = options.find("FFmpeg/AudioBufferSize");
                 i != options.end())
             {
@@ -130,6 +157,17 @@ namespace tl
             return out;
         }
 
+        size_t getGOPCacheSize(const ReadOptions& options, const ftk::ImageInfo& info)
+        {
+            size_t out = options.gopCacheSize;
+            const size_t byteCount = info.getByteCount();
+            if (byteCount > 0)
+            {
+                out = std::min(out, options.gopCacheMB * ftk::megabyte / 2 / byteCount);
+            }
+            return out;
+        }
+
         int findStream(AVFormatContext* avFormatContext, AVMediaType type)
         {
             int out = -1;
@@ -158,12 +196,105 @@ namespace tl
 
         namespace
         {
+            //! How much of a movie is asked for ahead of the reads, and how
+            //! far behind them it is let go. Behind is the larger, so that
+            //! stepping back a little does not go to the disk.
+            const int64_t adviseAheadSize = 32 * 1024 * 1024;
+            const int64_t adviseBehindSize = 256 * 1024 * 1024;
+
             //! The file name to hand to a worker; a path with a protocol is
             //! opened by FFmpeg itself.
             std::string getFileName(const ftk::Path& path)
             {
                 return path.hasProtocol() ? path.get() : path.getFileName(true);
             }
+
+            //! Seek if the time is not the next one, and decode the frame.
+            std::shared_ptr<ftk::Image> readFrame(
+                ReadVideo& readVideo,
+                OTIO_NS::RationalTime& currentTime,
+                const OTIO_NS::RationalTime& time,
+                const OTIO_NS::RationalTime& frame)
+            {
+                std::shared_ptr<ftk::Image> out;
+
+                // Seek.
+                if (!time.strictly_equal(currentTime))
+                {
+                    currentTime = time;
+                    readVideo.seek(currentTime);
+                }
+
+                // Process.
+                while (
+                    readVideo.isBufferEmpty() &&
+                    readVideo.isValid() &&
+                    readVideo.process(currentTime))
+                    ;
+
+                if (!readVideo.isBufferEmpty())
+                {
+                    out = readVideo.popBuffer();
+                }
+                currentTime += frame;
+                return out;
+            }
+
+            //! Record any new errors from a reader, logging the first one.
+            void recordErrors(
+                const ReadVideo& readVideo,
+                size_t& errorCount,
+                ErrorMutex& errorMutex,
+                const std::weak_ptr<ftk::LogSystem>& logSystemWeak,
+                const std::string& path)
+            {
+                if (readVideo.getErrorCount() != errorCount)
+                {
+                    const bool first = 0 == errorCount;
+                    {
+                        std::unique_lock<std::mutex> lock(errorMutex.mutex);
+                        errorMutex.count += readVideo.getErrorCount() - errorCount;
+                        if (errorMutex.error.empty())
+                        {
+                            errorMutex.error = readVideo.getErrorString();
+                        }
+                    }
+                    errorCount = readVideo.getErrorCount();
+                    if (first)
+                    {
+                        if (auto logSystem = logSystemWeak.lock())
+                        {
+                            logSystem->print(
+                                "tl::ffmpeg::VideoRead",
+                                ftk::Format("Errors reading video: \"{0}\": {1}").
+                                    arg(path).
+                                    arg(readVideo.getErrorString()),
+                                ftk::LogType::Error);
+                        }
+                    }
+                }
+            }
+
+            //! The number of requests in a row, each before the last, that
+            //! count as going backwards when there is no access hint.
+            const size_t backwardRequestCount = 4;
+
+            //! Trim the frames kept when going backwards: first those after
+            //! the time, which have been played, then the earliest.
+            void trimGOPCache(
+                std::map<OTIO_NS::RationalTime, std::shared_ptr<ftk::Image> >& cache,
+                const OTIO_NS::RationalTime& time,
+                size_t max)
+            {
+                while (cache.size() > max && cache.rbegin()->first > time)
+                {
+                    cache.erase(std::prev(cache.end()));
+                }
+                while (cache.size() > max)
+                {
+                    cache.erase(cache.begin());
+                }
+            }
         }
 
         void VideoRead::_init(
@@ -176,6 +307,14 @@ namespace tl
             FTK_P();
 
             p.options = getReadOptions(options);
+            p.fileName = getFileName(path);
+            if (_mem.empty() && !path.hasProtocol())
+            {
+                p.fileAdvice = std::make_unique<FileAdvice>(
+                    p.fileName,
+                    adviseAheadSize,
+                    adviseBehindSize);
+            }
 
             p.thread = std::thread(
                 [this, path]
@@ -189,6 +328,7 @@ namespace tl
                             p.options,
                             _logSystem.lock());
                         const auto& videoInfo = p.readVideo->getInfo();
+                        p.options.gopCacheSize = getGOPCacheSize(p.options, videoInfo);
                         if (videoInfo.isValid())
                         {
                             p.info.video.push_back(videoInfo);
@@ -236,6 +376,14 @@ namespace tl
             {
                 p.thread.join();
             }
+            for (const auto& segment : p.segments)
+            {
+                segment->condition.stop();
+                if (segment->thread.joinable())
+                {
+                    segment->thread.join();
+                }
+            }
         }
 
         std::shared_ptr<VideoRead> VideoRead::create(
@@ -281,6 +429,11 @@ namespace tl
             FTK_P();
             p.infoRequests.cancel();
             p.videoRequests.cancel();
+            std::unique_lock<std::mutex> lock(p.segmentsMutex);
+            for (const auto& segment : p.segments)
+            {
+                segment->requests.cancel();
+            }
         }
 
         std::string VideoRead::getError() const
@@ -308,73 +461,251 @@ namespace tl
             p.currentTime = videoTime.start_time();
             p.readVideo->start();
             size_t errorCount = 0;
+
+            // An intra-only movie can be read by several decoders at once,
+            // each given every segmentCount'th segment of frames, so that
+            // a single movie can use more cores than one decoder scales
+            // to. The decoders share the threads of one.
+            if (p.options.segmentCount > 1 &&
+                p.readVideo->isValid() &&
+                p.readVideo->isIntraOnly())
+            {
+                ReadOptions options = p.options;
+                const size_t threadCount = p.options.threadCount > 0 ?
+                    p.options.threadCount :
+                    std::max(std::thread::hardware_concurrency(), 1U);
+                options.threadCount = std::max(threadCount / p.options.segmentCount, size_t(1));
+                std::unique_lock<std::mutex> lock(p.segmentsMutex);
+                for (size_t i = 0; i < p.options.segmentCount; ++i)
+                {
+                    p.segments.push_back(std::make_unique<Private::Segment>());
+                }
+                for (const auto& segment : p.segments)
+                {
+                    Private::Segment* segmentP = segment.get();
+                    segment->thread = std::thread(
+                        [this, segmentP, options, videoTime]
+                        {
+                            FTK_P();
+                            try
+                            {
+                                auto readVideo = std::make_shared<ReadVideo>(
+                                    p.fileName,
+                                    _mem,
+                                    options,
+                                    _logSystem.lock());
+                                readVideo->start();
+                                const OTIO_NS::RationalTime frame(1.0, videoTime.duration().rate());
+                                OTIO_NS::RationalTime currentTime = videoTime.start_time();
+                                size_t errorCount = 0;
+                                while (segmentP->condition.wait())
+                                {
+                                    if (auto videoRequest = segmentP->requests.pop())
+                                    {
+                                        PromiseGuard<VideoData> guard(videoRequest->promise, videoRequest->completion);
+                                        VideoData data;
+                                        data.time = videoRequest->time;
+                                        data.image = readFrame(
+                                            *readVideo,
+                                            currentTime,
+                                            videoRequest->time,
+                                            frame);
+                                        guard.setValue(std::move(data));
+                                    }
+                                    recordErrors(
+                                        *readVideo,
+                                        errorCount,
+                                        p.errorMutex,
+                                        _logSystem,
+                                        _path.get());
+                                }
+                            }
+                            catch (const std::exception& e)
+                            {
+                                if (auto logSystem = _logSystem.lock())
+                                {
+                                    logSystem->print(
+                                        "tl::ffmpeg::VideoRead",
+                                        e.what(),
+                                        ftk::LogType::Error);
+                                }
+                                std::unique_lock<std::mutex> lock(p.errorMutex.mutex);
+                                ++p.errorMutex.count;
+                                if (p.errorMutex.error.empty())
+                                {
+                                    p.errorMutex.error = e.what();
+                                }
+                            }
+                            segmentP->condition.stopQueues();
+                        });
+                }
+
+                // The decoders open their own; this one was only needed for
+                // the information.
+                p.readVideo.reset();
+            }
+
             while (p.condition.wait())
             {
                 // Information requests.
-                for (const auto& request : p.infoRequests.popAll())
+                const auto infoRequests = p.infoRequests.popAll();
+                for (const auto& request : infoRequests)
                 {
                     request->promise.set_value(p.info);
+                    notifyCompletion(request->completion);
                 }
 
                 // Video request. The guard completes the promise if an
                 // exception escapes; see PromiseGuard.
-                if (auto videoRequest = p.videoRequests.pop())
+                auto videoRequest = p.videoRequests.pop();
+                if (videoRequest && !p.segments.empty())
                 {
-                    PromiseGuard<VideoData> guard(videoRequest->promise);
-
-                    // Seek.
-                    if (!videoRequest->time.strictly_equal(p.currentTime))
+                    // The frames come back in order of time however the
+                    // decoders finish, since each request has its own
+                    // promise.
+                    const int64_t index = std::max(
+                        static_cast<int64_t>(std::floor(
+                            (videoRequest->time - videoTime.start_time()).
+                                rescaled_to(videoTime.duration().rate()).value())),
+                        static_cast<int64_t>(0));
+                    const size_t segmentSize = std::max(p.options.segmentSize, size_t(1));
+                    p.segments[(index / segmentSize) % p.segments.size()]->requests.forward(videoRequest);
+                }
+                else if (videoRequest)
+                {
+                    PromiseGuard<VideoData> guard(videoRequest->promise, videoRequest->completion);
+                    const OTIO_NS::RationalTime& time = videoRequest->time;
+                    const OTIO_NS::RationalTime frame(1.0, videoTime.duration().rate());
+                    VideoData data;
+                    data.time = time;
+
+                    // Going backwards, each frame would be a seek to the key
+                    // frame before it and a decode forward, and over a long
+                    // GOP that is the same frames decoded again and again.
+                    // So the GOP is decoded once and kept, and the one before
+                    // it is decoded on a second reader while this one is
+                    // played.
+                    //
+                    // That is only worth it when the reads keep going
+                    // backwards: the player says so with the access hint, or
+                    // without one, several requests in a row have each been
+                    // before the last. A single step back -- a loop wrapping
+                    // around, a scrub, the player reading behind -- is read
+                    // the ordinary way.
+                    const auto hint = getAccessHint(videoRequest->options);
+                    p.backwardCount = time < p.requestTime ? p.backwardCount + 1 : 0;
+                    p.requestTime = time;
+                    const bool backward =
+                        p.options.gopCacheSize > 0 &&
+                        p.readVideo->isValid() &&
+                        time < p.currentTime &&
+                        (hint.has_value() ?
+                            AccessHint::Reverse == hint.value() :
+                            p.backwardCount >= backwardRequestCount);
+                    auto i = p.gopCache.find(time);
+                    if (p.gopCache.end() == i && p.prefetch.valid() &&
+                        (time <= p.prefetchTime ||
+                         p.prefetch.wait_for(std::chrono::seconds(0)) == std::future_status::ready))
                     {
-                        p.currentTime = videoRequest->time;
-                        p.readVideo->seek(p.currentTime);
+                        try
+                        {
+                            for (auto& j : p.prefetch.get())
+                            {
+                                p.gopCache[j.first] = j.second;
+                            }
+                        }
+                        catch (const std::exception&)
+                        {}
+                        i = p.gopCache.find(time);
                     }
-
-                    // Process.
-                    while (
-                        p.readVideo->isBufferEmpty() &&
-                        p.readVideo->isValid() &&
-                        p.readVideo->process(p.currentTime))
-                        ;
-
-                    // Handle the request.
-                    VideoData data;
-                    data.time = videoRequest->time;
-                    if (!p.readVideo->isBufferEmpty())
+                    if (i != p.gopCache.end())
                     {
-                        data.image = p.readVideo->popBuffer();
+                        data.image = i->second;
+                    }
+                    else if (backward)
+                    {
+                        for (auto& j : p.readVideo->readGOP(time))
+                        {
+                            p.gopCache[j.first] = j.second;
+                        }
+                        i = p.gopCache.find(time);
+                        if (i != p.gopCache.end())
+                        {
+                            data.image = i->second;
+                        }
+                        p.currentTime = time + frame;
+                    }
+                    else
+                    {
+                        data.image = readFrame(*p.readVideo, p.currentTime, time, frame);
                     }
                     guard.setValue(std::move(data));
 
-                    p.currentTime += OTIO_NS::RationalTime(1.0, videoTime.duration().rate());
-                }
-
-                // Record any new errors from the worker, logging the
-                // first one.
-                if (p.readVideo->getErrorCount() != errorCount)
-                {
-                    const bool first = 0 == errorCount;
-                    errorCount = p.readVideo->getErrorCount();
+                    // Decode the GOP before the frames kept.
+                    if (backward &&
+                        p.prefetchEnabled &&
+                        !p.prefetch.valid() &&
+                        !p.gopCache.empty())
                     {
-                        std::unique_lock<std::mutex> lock(p.errorMutex.mutex);
-                        p.errorMutex.count = errorCount;
-                        if (p.errorMutex.error.empty())
+                        const OTIO_NS::RationalTime prefetchTime = p.gopCache.begin()->first - frame;
+                        if (prefetchTime >= videoTime.start_time())
                         {
-                            p.errorMutex.error = p.readVideo->getErrorString();
+                            if (!p.prefetchVideo)
+                            {
+                                try
+                                {
+                                    p.prefetchVideo = std::make_shared<ReadVideo>(
+                                        p.fileName,
+                                        _mem,
+                                        p.options,
+                                        _logSystem.lock());
+                                    p.prefetchVideo->start();
+                                }
+                                catch (const std::exception&)
+                                {
+                                    // Without a second reader the GOPs are
+                                    // still only decoded once each.
+                                    p.prefetchEnabled = false;
+                                }
+                            }
+                            if (p.prefetchVideo)
+                            {
+                                auto prefetchVideo = p.prefetchVideo;
+                                p.prefetchTime = prefetchTime;
+                                p.prefetch = std::async(
+                                    std::launch::async,
+                                    [prefetchVideo, prefetchTime]
+                                    {
+                                        return prefetchVideo->readGOP(prefetchTime);
+                                    });
+                            }
                         }
                     }
-                    if (first)
+                    // Room for the GOP being played and the one before it.
+                    trimGOPCache(p.gopCache, time, p.options.gopCacheSize * 2);
+
+                    // Which way the player is going, for the read ahead.
+                    if (p.fileAdvice && p.readVideo)
                     {
-                        if (auto logSystem = _logSystem.lock())
+                        const int64_t position = p.readVideo->getPosition();
+                        if (hint.has_value() && position >= 0)
                         {
-                            logSystem->print(
-                                "tl::ffmpeg::VideoRead",
-                                ftk::Format("Errors reading video: \"{0}\": {1}").
-                                    arg(_path.get()).
-                                    arg(p.readVideo->getErrorString()),
-                                ftk::LogType::Error);
+                            p.fileAdvice->advise(position, hint.value());
                         }
                     }
                 }
+
+                // Record any new errors from the worker, logging the
+                // first one.
+                if (p.readVideo)
+                {
+                    recordErrors(
+                        *p.readVideo,
+                        errorCount,
+                        p.errorMutex,
+                        _logSystem,
+                        _path.get());
+                }
             }
         }
 
@@ -528,16 +859,18 @@ namespace tl
             while (p.condition.wait())
             {
                 // Information requests.
-                for (const auto& request : p.infoRequests.popAll())
+                const auto infoRequests = p.infoRequests.popAll();
+                for (const auto& request : infoRequests)
                 {
                     request->promise.set_value(p.info);
+                    notifyCompletion(request->completion);
                 }
 
                 // Audio request. The guard completes the promise if an
                 // exception escapes; see PromiseGuard.
                 if (auto request = p.audioRequests.pop())
                 {
-                    PromiseGuard<AudioData> guard(request->promise);
+                    PromiseGuard<AudioData> guard(request->promise, request->completion);
 
                     size_t requestSampleCount = 0;
                     bool seek = false;
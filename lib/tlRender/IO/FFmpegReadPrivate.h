@@ -18,6 +18,7 @@ extern "C"
 
 #include <atomic>
 #include <condition_variable>
+#include <future>
 #include <mutex>
 #include <thread>
 
@@ -47,12 +48,30 @@ namespace tl
             AudioInfo audioConvertInfo;
             size_t threadCount = Options().threadCount;
             size_t videoBufferSize = 4;
+            //! The number of frames of a GOP kept when going backwards; see
+            //! ReadVideo::readGOP(). The GOP before is decoded ahead, so up
+            //! to twice this many are held. Zero turns it off.
+            size_t gopCacheSize = 64;
+            //! The most memory the frames kept when going backwards take,
+            //! in megabytes, both GOPs together. It lowers the number of
+            //! frames for large images; see getGOPCacheSize().
+            size_t gopCacheMB = 256;
+            //! The number of decoders a movie of an intra-only codec is
+            //! read with, each given segments of segmentSize frames in
+            //! turn. The decoder threads are shared among them.
+            size_t segmentCount = 1;
+            size_t segmentSize = 8;
             OTIO_NS::RationalTime audioBufferSize = OTIO_NS::RationalTime(2.0, 1.0);
         };
 
         //! Parse the reader options.
         ReadOptions getReadOptions(const IOOptions&);
 
+        //! Get the number of frames of a GOP kept when going backwards, for
+        //! images of the given size: ReadOptions::gopCacheSize, lowered so
+        //! that two GOPs fit in ReadOptions::gopCacheMB.
+        size_t getGOPCacheSize(const ReadOptions&, const ftk::ImageInfo&);
+
         //! Find the stream of the given type to read, or -1. A stream
         //! marked as the default is preferred over the first one found.
         int findStream(AVFormatContext*, AVMediaType);
@@ -69,6 +88,11 @@ namespace tl
             ~ReadVideo();
 
             bool isValid() const;
+
+            //! Whether every frame is a key frame (ProRes, DNxHR, ...), so
+            //! that any frame can be decoded without those before it.
+            bool isIntraOnly() const;
+
             const ftk::ImageInfo& getInfo() const;
             const OTIO_NS::TimeRange& getTimeRange() const;
             const VideoSourceInfo& getSource() const;
@@ -86,8 +110,20 @@ namespace tl
             bool isBufferEmpty() const;
             std::shared_ptr<ftk::Image> popBuffer();
 
+            //! Where in the file the reads have got to, or -1 when the movie
+            //! is read from memory.
+            int64_t getPosition() const;
+
+            //! Decode from the key frame at or before the given time up to
+            //! the given time, and return the frames rather than dropping
+            //! those before it. At most ReadOptions::gopCacheSize frames are
+            //! returned, the latest. The decoder is left after the time.
+            std::map<OTIO_NS::RationalTime, std::shared_ptr<ftk::Image> > readGOP(
+                const OTIO_NS::RationalTime&);
+
         private:
             int _decode(const OTIO_NS::RationalTime& currentTime);
+            std::shared_ptr<ftk::Image> _createImage(AVFrame*);
             void _copy(const std::shared_ptr<ftk::Image>&, AVFrame* frame);
             void _setError(int);
             void _initHwAccel(const AVCodec*);
@@ -126,8 +162,10 @@ namespace tl
             AVFrame* _swFrame = nullptr;
             bool _hwAccel = false;
             bool _hwLogged = false;
+            bool _intraOnly = false;
             std::weak_ptr<ftk::LogSystem> _logSystem;
             std::list<std::shared_ptr<ftk::Image> > _buffer;
+            std::map<OTIO_NS::RationalTime, std::shared_ptr<ftk::Image> >* _gop = nullptr;
             bool _eof = false;
             size_t _errorCount = 0;
             std::string _errorString;
@@ -209,12 +247,14 @@ namespace tl
             struct InfoRequest
             {
                 std::promise<IOInfo> promise;
+                std::shared_ptr<Completion> completion = getCompletion();
             };
             struct VideoRequest
             {
                 OTIO_NS::RationalTime time;
                 IOOptions options;
                 std::promise<VideoData> promise;
+                std::shared_ptr<Completion> completion = getCompletion();
             };
             // The info and video queues share one condition so that the
             // thread can wait for a request on either.
@@ -226,6 +266,37 @@ namespace tl
             // Only accessed from the thread above.
             OTIO_NS::RationalTime currentTime;
 
+            // Frames kept when going backwards, and the GOP before them
+            // being decoded on a second reader. Only accessed from the
+            // thread above.
+            std::string fileName;
+            std::map<OTIO_NS::RationalTime, std::shared_ptr<ftk::Image> > gopCache;
+            OTIO_NS::RationalTime requestTime;
+            size_t backwardCount = 0;
+            bool prefetchEnabled = true;
+            std::shared_ptr<ReadVideo> prefetchVideo;
+            std::future<std::map<OTIO_NS::RationalTime, std::shared_ptr<ftk::Image> > > prefetch;
+            OTIO_NS::RationalTime prefetchTime;
+
+            // Advice for the operating system about the file, following the
+            // reads. Null for a movie in memory or behind a protocol. Only
+            // accessed from the thread above.
+            std::unique_ptr<FileAdvice> fileAdvice;
+
+            // The decoders of an intra-only movie read in segments; see
+            // ReadOptions::segmentCount. The thread above hands each video
+            // request on to the decoder of its segment, and each decoder
+            // has its own thread and queue. The list is filled once, by
+            // the thread above, under the mutex.
+            struct Segment
+            {
+                RequestCondition condition;
+                RequestQueue<VideoRequest, VideoData> requests{ condition };
+                std::thread thread;
+            };
+            std::vector<std::unique_ptr<Segment> > segments;
+            std::mutex segmentsMutex;
+
             ErrorMutex errorMutex;
         };
 
@@ -239,12 +310,14 @@ namespace tl
             struct InfoRequest
             {
                 std::promise<IOInfo> promise;
+                std::shared_ptr<Completion> completion = getCompletion();
             };
             struct AudioRequest
             {
                 OTIO_NS::TimeRange timeRange;
                 IOOptions options;
                 std::promise<AudioData> promise;
+                std::shared_ptr<Completion> completion = getCompletion();
             };
             RequestCondition condition;
             RequestQueue<InfoRequest, IOInfo> infoRequests{ condition };
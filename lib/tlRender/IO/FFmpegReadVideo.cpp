@@ -130,6 +130,10 @@ namespace tl
                     }
                     _avCodecContext[_avStream]->thread_count = options.threadCount;
                     _avCodecContext[_avStream]->thread_type = FF_THREAD_FRAME;
+                    if (auto descriptor = avcodec_descriptor_get(avVideoCodecParameters->codec_id))
+                    {
+                        _intraOnly = (descriptor->props & AV_CODEC_PROP_INTRA_ONLY) != 0;
+                    }
                     if (options.hwAccel)
                     {
                         // Attempt hardware decode. On any failure this is a no-op
@@ -441,6 +445,7 @@ namespace tl
                 _close();
                 throw;
             }
+            _options.gopCacheSize = getGOPCacheSize(_options, _info);
         }
 
         ReadVideo::~ReadVideo()
@@ -495,6 +500,11 @@ namespace tl
             return _avStream != -1;
         }
 
+        bool ReadVideo::isIntraOnly() const
+        {
+            return _intraOnly;
+        }
+
         const ftk::ImageInfo& ReadVideo::getInfo() const
         {
             return _info;
@@ -748,6 +758,13 @@ namespace tl
             _eof = false;
         }
 
+        int64_t ReadVideo::getPosition() const
+        {
+            return !_avIOContext && _avFormatContext && _avFormatContext->pb ?
+                avio_tell(_avFormatContext->pb) :
+                -1;
+        }
+
         size_t ReadVideo::getErrorCount() const
         {
             return _errorCount;
@@ -854,6 +871,22 @@ namespace tl
             return out;
         }
 
+        std::map<OTIO_NS::RationalTime, std::shared_ptr<ftk::Image> > ReadVideo::readGOP(
+            const OTIO_NS::RationalTime& time)
+        {
+            std::map<OTIO_NS::RationalTime, std::shared_ptr<ftk::Image> > out;
+            seek(time);
+            _gop = &out;
+            while (_buffer.empty() && isValid() && process(time))
+                ;
+            _gop = nullptr;
+            if (!_buffer.empty())
+            {
+                out[time] = popBuffer();
+            }
+            return out;
+        }
+
         int ReadVideo::_decode(const OTIO_NS::RationalTime& currentTime)
         {
             int out = 0;
@@ -900,28 +933,43 @@ namespace tl
 
                 if (time >= currentTime)
                 {
-                    auto image = ftk::Image::create(_info);
-                    
-                    auto tags = _tags;
-                    AVDictionaryEntry* tag = nullptr;
-                    while ((tag = av_dict_get(_avFrame->metadata, "", tag, AV_DICT_IGNORE_SUFFIX)))
-                    {
-                        tags[tag->key] = tag->value;
-                    }
-                    HDRData hdrData;
-                    toHDRData(_avFrame->side_data, _avFrame->nb_side_data, hdrData);
-                    tags["hdr"] = nlohmann::json(hdrData).dump();
-                    image->setTags(tags);
-
-                    _copy(image, frame);
-                    _buffer.push_back(image);
+                    _buffer.push_back(_createImage(frame));
                     out = 1;
                     break;
                 }
+                else if (_gop && _options.gopCacheSize > 0)
+                {
+                    // Keep the frames before the one asked for; see
+                    // readGOP().
+                    (*_gop)[time] = _createImage(frame);
+                    while (_gop->size() > _options.gopCacheSize)
+                    {
+                        _gop->erase(_gop->begin());
+                    }
+                }
             }
             return out;
         }
 
+        std::shared_ptr<ftk::Image> ReadVideo::_createImage(AVFrame* frame)
+        {
+            auto out = ftk::Image::create(_info);
+
+            auto tags = _tags;
+            AVDictionaryEntry* tag = nullptr;
+            while ((tag = av_dict_get(_avFrame->metadata, "", tag, AV_DICT_IGNORE_SUFFIX)))
+            {
+                tags[tag->key] = tag->value;
+            }
+            HDRData hdrData;
+            toHDRData(_avFrame->side_data, _avFrame->nb_side_data, hdrData);
+            tags["hdr"] = nlohmann::json(hdrData).dump();
+            out->setTags(tags);
+
+            _copy(out, frame);
+            return out;
+        }
+
         void ReadVideo::_copy(const std::shared_ptr<ftk::Image>& image, AVFrame* frame)
         {
             const auto& info = image->getInfo();
@@ -3,8 +3,16 @@
 
 #include <tlRender/IO/IO.h>
 
+#include <ftk/Core/Format.h>
+
+#include <algorithm>
 #include <sstream>
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif // __linux__
+
 namespace tl
 {
     ftk::ImageType getIntImageType(std::size_t channelCount, std::size_t bitDepth)
@@ -108,4 +116,139 @@ namespace tl
         }
         return out;
     }
+
+    FTK_ENUM_IMPL(
+        AccessHint,
+        "Forward",
+        "Reverse",
+        "Random",
+        "Scrub");
+
+    std::optional<AccessHint> getAccessHint(const IOOptions& options)
+    {
+        std::optional<AccessHint> out;
+        if (const auto i = options.find("IO/Access"); i != options.end())
+        {
+            AccessHint value = AccessHint::First;
+            from_string(i->second, value);
+            out = value;
+        }
+        return out;
+    }
+
+    IOOptions removeAccessHint(const IOOptions& options)
+    {
+        IOOptions out = options;
+        out.erase("IO/Access");
+        return out;
+    }
+
+    namespace
+    {
+#if defined(__linux__)
+        void advise(
+            const std::string& fileName,
+            int64_t offset,
+            int64_t size,
+            int advice)
+        {
+            // The page cache belongs to the file rather than to whoever has
+            // it open, so advice given through a descriptor of our own
+            // applies to the decoder's reads as well. The access pattern
+            // advice does not -- that belongs to one open file -- which is
+            // why only these two are used.
+            const int fd = ::open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd != -1)
+            {
+                ::posix_fadvise(fd, std::max(offset, int64_t(0)), std::max(size, int64_t(0)), advice);
+                ::close(fd);
+            }
+        }
+#endif // __linux__
+    }
+
+    void adviseWillNeed(const std::string& fileName, int64_t offset, int64_t size)
+    {
+#if defined(__linux__)
+        advise(fileName, offset, size, POSIX_FADV_WILLNEED);
+#endif // __linux__
+    }
+
+    void adviseDontNeed(const std::string& fileName, int64_t offset, int64_t size)
+    {
+#if defined(__linux__)
+        advise(fileName, offset, size, POSIX_FADV_DONTNEED);
+#endif // __linux__
+    }
+
+    FileAdvice::FileAdvice(
+        const std::string& fileName,
+        int64_t aheadSize,
+        int64_t behindSize) :
+        _fileName(fileName),
+        _aheadSize(std::max(aheadSize, int64_t(1))),
+        _behindSize(std::max(behindSize, int64_t(0)))
+    {}
+
+    void FileAdvice::advise(int64_t position, AccessHint hint)
+    {
+        // What is ahead, asked for again once the reads are half way into
+        // what was asked for last, or have left it.
+        int64_t min = -1;
+        int64_t max = -1;
+        switch (hint)
+        {
+        case AccessHint::Forward:
+            if (position < _aheadMin || position + _aheadSize / 2 > _aheadMax)
+            {
+                min = position;
+                max = position + _aheadSize;
+            }
+            break;
+        case AccessHint::Reverse:
+            if (position > _aheadMax || position - _aheadSize / 2 < _aheadMin)
+            {
+                min = std::max(position - _aheadSize, int64_t(0));
+                max = position;
+            }
+            break;
+        case AccessHint::Scrub:
+            if (position < _aheadMin || position > _aheadMax)
+            {
+                min = std::max(position - _aheadSize / 4, int64_t(0));
+                max = position + _aheadSize / 4;
+            }
+            break;
+        default: break;
+        }
+        if (max > min)
+        {
+            adviseWillNeed(_fileName, min, max - min);
+            _aheadMin = min;
+            _aheadMax = max;
+        }
+
+        // What has fallen behind since the last read. A jump the other way
+        // lets go of nothing: that is a loop or a seek, and what is behind
+        // it may be read again.
+        if (_behindSize > 0 && _position >= 0)
+        {
+            if (AccessHint::Forward == hint && position > _position)
+            {
+                const int64_t from = std::max(_position - _behindSize, int64_t(0));
+                const int64_t to = position - _behindSize;
+                if (to > from)
+                {
+                    adviseDontNeed(_fileName, from, to - from);
+                }
+            }
+            else if (AccessHint::Reverse == hint && position < _position)
+            {
+                const int64_t from = position + _behindSize;
+                const int64_t to = _position + _behindSize;
+                adviseDontNeed(_fileName, from, to - from);
+            }
+        }
+        _position = position;
+    }
 }
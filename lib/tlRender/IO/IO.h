@@ -7,6 +7,7 @@
 #include <tlRender/Core/Time.h>
 
 #include <ftk/Core/Image.h>
+#include <ftk/Core/Util.h>
 
 #include <optional>
 
@@ -108,6 +109,12 @@ namespace tl
         //! The frame repeated in place of it, when there was one to repeat.
         std::optional<int64_t>      heldFrom;
 
+        //! What the image was made from, when the reader made it up rather
+        //! than reading it: the fill and the image information. The same
+        //! for every frame it stands in for, so that they can share one
+        //! image. Empty otherwise.
+        std::string                 standIn;
+
         bool operator == (const VideoData&) const;
         bool operator != (const VideoData&) const;
         bool operator < (const VideoData&) const;
@@ -141,6 +148,75 @@ namespace tl
 
     //! Merge options.
     TL_API IOOptions merge(const IOOptions&, const IOOptions&);
+
+    //! How the frames of a file are about to be read.
+    //!
+    //! Given in the options as "IO/Access" by whoever knows, which is the
+    //! player: the read ahead the operating system does on its own assumes
+    //! a file is read forwards, which is wrong for reverse playback, and it
+    //! has no idea which of a sequence's files come next. A hint only; it
+    //! changes when data arrives, never what is read.
+    enum class TL_API_TYPE AccessHint
+    {
+        Forward, //!< Playing forwards
+        Reverse, //!< Playing backwards
+        Random,  //!< No pattern, so nothing is read ahead
+        Scrub,   //!< Moving back and forth around one place
+
+        Count,
+        First = Forward
+    };
+    FTK_ENUM(AccessHint);
+
+    //! Get the access hint from the options, if there is one.
+    TL_API std::optional<AccessHint> getAccessHint(const IOOptions&);
+
+    //! Get the options without the access hint, for comparing what is
+    //! decoded rather than how it is read.
+    TL_API IOOptions removeAccessHint(const IOOptions&);
+
+    //! Tell the operating system that a range of a file is needed soon, so
+    //! that it starts reading it now. A size of zero is the rest of the
+    //! file. Does nothing where there is no way to say so, or when the file
+    //! cannot be opened.
+    TL_API void adviseWillNeed(
+        const std::string& fileName,
+        int64_t offset = 0,
+        int64_t size = 0);
+
+    //! Tell the operating system that a range of a file is not needed
+    //! again, so that its pages go before the ones that still are.
+    TL_API void adviseDontNeed(
+        const std::string& fileName,
+        int64_t offset = 0,
+        int64_t size = 0);
+
+    //! Advice for a file read a range at a time, following where the reads
+    //! are and which way they are going.
+    //!
+    //! The range ahead of the reads is asked for as they approach the end
+    //! of what was asked for last, and the range that falls more than the
+    //! read behind size behind them is let go, a piece at a time as they
+    //! pass, so that each call costs at most a system call or two.
+    class TL_API_TYPE FileAdvice
+    {
+    public:
+        TL_API FileAdvice(
+            const std::string& fileName,
+            int64_t aheadSize,
+            int64_t behindSize);
+
+        //! Advise for a read at the given position.
+        TL_API void advise(int64_t position, AccessHint);
+
+    private:
+        std::string _fileName;
+        int64_t _aheadSize = 0;
+        int64_t _behindSize = 0;
+        int64_t _aheadMin = -1;
+        int64_t _aheadMax = -1;
+        int64_t _position = -1;
+    };
 }
 
 #include <tlRender/IO/IOInline.h>
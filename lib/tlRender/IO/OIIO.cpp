@@ -12,6 +12,28 @@ namespace tl
 {
     namespace oiio
     {
+        bool Options::operator == (const Options& other) const
+        {
+            return
+                imageCache == other.imageCache &&
+                imageCacheMB == other.imageCacheMB &&
+                displayWidth == other.displayWidth;
+        }
+
+        bool Options::operator != (const Options& other) const
+        {
+            return !(*this == other);
+        }
+
+        IOOptions getOptions(const Options& value)
+        {
+            IOOptions out;
+            out["OIIO/ImageCache"] = ftk::Format("{0}").arg(value.imageCache);
+            out["OIIO/ImageCacheMB"] = ftk::Format("{0}").arg(value.imageCacheMB);
+            out["OIIO/DisplayWidth"] = ftk::Format("{0}").arg(value.displayWidth);
+            return out;
+        }
+
         void ReadPlugin::_init(const std::shared_ptr<ftk::LogSystem>& logSystem)
         {
             std::map<std::string, FileType> exts;
@@ -48,11 +70,9 @@ namespace tl
             return out;
         }
 
-
-
-        std::shared_ptr<IDecode> ReadPlugin::decode(const IOOptions&)
+        std::shared_ptr<IDecode> ReadPlugin::decode(const IOOptions& options)
         {
-            return Decode::create();
+            return Decode::create(options);
         }
 
         std::string ReadPlugin::getPluginInfo(const IOOptions&) const
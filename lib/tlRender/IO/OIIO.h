@@ -10,17 +10,45 @@ namespace tl
     //! OpenImageIO image I/O.
     namespace oiio
     {
+        //! OpenImageIO options.
+        struct TL_API_TYPE Options
+        {
+            //! Read through the process-wide OpenImageIO image cache rather
+            //! than opening each file for each frame. Tiled files are read
+            //! by the tiles that are needed, and the tiles are kept for the
+            //! next frame or zoom level.
+            bool   imageCache   = false;
+
+            //! The memory the image cache may use, shared by every reader.
+            size_t imageCacheMB = 1024;
+
+            //! The width the image is displayed at. With the image cache,
+            //! MIP-mapped files are read at the smallest level that is at
+            //! least this wide, so a large plate seen small is read small.
+            //! Zero reads the full resolution.
+            int    displayWidth = 0;
+
+            TL_API bool operator == (const Options&) const;
+            TL_API bool operator != (const Options&) const;
+        };
+
+        //! Get OpenImageIO options.
+        TL_API IOOptions getOptions(const Options&);
+
         //! OpenImageIO decoder.
         class TL_API_TYPE Decode : public IDecode
         {
         protected:
+            void _init(const IOOptions&);
+
             Decode();
 
         public:
             TL_API virtual ~Decode();
 
             //! Create a new decoder.
-            TL_API static std::shared_ptr<Decode> create();
+            TL_API static std::shared_ptr<Decode> create(
+                const IOOptions& = IOOptions());
 
             TL_API IOInfo getInfo(
                 const std::string& fileName,
@@ -30,6 +58,9 @@ namespace tl
                 const ftk::MemFile*,
                 const OTIO_NS::RationalTime&,
                 const IOOptions& = IOOptions()) override;
+
+        private:
+            FTK_PRIVATE();
         };
 
         //! OpenImageIO writer.
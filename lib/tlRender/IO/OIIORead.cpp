@@ -11,6 +11,9 @@
 
 #include <OpenImageIO/filesystem.h>
 #include <OpenImageIO/imagebufalgo.h>
+#include <OpenImageIO/imagecache.h>
+
+#include <sstream>
 
 namespace tl
 {
@@ -94,21 +97,94 @@ namespace tl
             }
         }
 
-        Decode::Decode()
+        namespace
+        {
+            Options getDecodeOptions(const IOOptions& options)
+            {
+                Options out;
+                if (auto i = options.find("OIIO/ImageCache"); i != options.end())
+                {
+                    std::stringstream ss(i->second);
+                    ss >> out.imageCache;
+                }
+                if (auto i = options.find("OIIO/ImageCacheMB"); i != options.end())
+                {
+                    std::stringstream ss(i->second);
+                    ss >> out.imageCacheMB;
+                }
+                if (auto i = options.find("OIIO/DisplayWidth"); i != options.end())
+                {
+                    std::stringstream ss(i->second);
+                    ss >> out.displayWidth;
+                }
+                return out;
+            }
+
+            int getLayer(const IOOptions& options)
+            {
+                int out = 0;
+                if (const auto i = options.find("Layer"); i != options.end())
+                {
+                    out = std::atoi(i->second.c_str());
+                }
+                return out;
+            }
+        }
+
+        struct Decode::Private
+        {
+            //! The shared OpenImageIO cache, or null when each frame opens
+            //! its file. The cache is thread safe and keeps per-thread state
+            //! of its own, so one decoder serves every reader thread.
+            std::shared_ptr<OIIO::ImageCache> imageCache;
+
+            VideoData readCache(
+                const std::string& fileName,
+                const OTIO_NS::RationalTime&,
+                const IOOptions&);
+        };
+
+        void Decode::_init(const IOOptions& options)
+        {
+            FTK_P();
+            const Options decodeOptions = getDecodeOptions(options);
+            if (decodeOptions.imageCache)
+            {
+                // The cache is shared by the whole process, so the budget
+                // is too; the last decoder created sets it.
+                p.imageCache = OIIO::ImageCache::create(true);
+                p.imageCache->attribute(
+                    "max_memory_MB",
+                    static_cast<float>(decodeOptions.imageCacheMB));
+            }
+        }
+
+        Decode::Decode() :
+            _p(new Private)
         {}
 
         Decode::~Decode()
         {}
 
-        std::shared_ptr<Decode> Decode::create()
+        std::shared_ptr<Decode> Decode::create(const IOOptions& options)
         {
-            return std::shared_ptr<Decode>(new Decode);
+            auto out = std::shared_ptr<Decode>(new Decode);
+            out->_init(options);
+            return out;
         }
 
         IOInfo Decode::getInfo(
             const std::string& fileName,
             const ftk::MemFile* memory)
         {
+            // A file that has changed on disk since it was cached is read
+            // again; one that has not keeps its tiles.
+            FTK_P();
+            if (p.imageCache && !memory)
+            {
+                p.imageCache->invalidate(OIIO::ustring(fileName), false);
+            }
+
             // Open the file.
             std::unique_ptr<OIIO::Filesystem::IOMemReader> oiioMemReader;
             if (memory)
@@ -177,6 +253,14 @@ namespace tl
             const OTIO_NS::RationalTime& time,
             const IOOptions& options)
         {
+            // The image cache reads files, so memory still goes through an
+            // image input.
+            FTK_P();
+            if (p.imageCache && !memory)
+            {
+                return p.readCache(fileName, time, options);
+            }
+
             // Open the file.
             std::unique_ptr<OIIO::Filesystem::IOMemReader> oiioMemReader;
             if (memory)
@@ -205,11 +289,7 @@ namespace tl
             }
 
             // Find the layer.
-            int layer = 0;
-            if (const auto i = options.find("Layer"); i != options.end())
-            {
-                layer = std::atoi(i->second.c_str());
-            }
+            const int layer = getLayer(options);
             if (!oiioInput->seek_subimage(layer, 0))
             {
                 throw std::runtime_error(oiioError(
@@ -254,5 +334,98 @@ namespace tl
             return out;
         }
 
+        VideoData Decode::Private::readCache(
+            const std::string& fileName,
+            const OTIO_NS::RationalTime& time,
+            const IOOptions& options)
+        {
+            // Get file information.
+            const OIIO::ustring oiioFileName(fileName);
+            const int layer = getLayer(options);
+            OIIO::ImageSpec oiioSpec;
+            if (!imageCache->get_imagespec(oiioFileName, oiioSpec, layer))
+            {
+                const std::string error = imageCache->geterror();
+                if (!std::filesystem::exists(std::filesystem::u8path(fileName)))
+                {
+                    throw std::runtime_error(ftk::Format(
+                        "No such file or directory: \"{0}\"").arg(fileName).str());
+                }
+                throw std::runtime_error(error.empty() ?
+                    ftk::Format("Cannot open file: \"{0}\"").arg(fileName).str() :
+                    ftk::Format("Cannot open file: \"{0}\": {1}").arg(fileName).arg(error).str());
+            }
+            const ftk::ImageType imageType = fromOIIO(oiioSpec);
+            if (ftk::ImageType::None == imageType)
+            {
+                throw std::runtime_error(
+                    ftk::Format("Unsupported file: \"{0}\"").arg(fileName).str());
+            }
+
+            // Find the smallest MIP level that is still as wide as the
+            // display.
+            int mipLevel = 0;
+            OIIO::ImageSpec mipSpec = oiioSpec;
+            const int displayWidth = getDecodeOptions(options).displayWidth;
+            int mipLevels = 1;
+            if (displayWidth > 0 &&
+                imageCache->get_image_info(
+                    oiioFileName,
+                    layer,
+                    0,
+                    OIIO::ustring("miplevels"),
+                    OIIO::TypeInt,
+                    &mipLevels))
+            {
+                for (int level = 1; level < mipLevels; ++level)
+                {
+                    OIIO::ImageSpec levelSpec;
+                    if (!imageCache->get_cache_dimensions(oiioFileName, levelSpec, layer, level) ||
+                        levelSpec.width < displayWidth)
+                    {
+                        break;
+                    }
+                    mipLevel = level;
+                    mipSpec = levelSpec;
+                }
+            }
+
+            // Get the tags.
+            ftk::ImageInfo imageInfo(mipSpec.width, mipSpec.height, imageType);
+            imageInfo.layout.mirror.y = true;
+            ftk::ImageTags tags;
+            for (const auto& i : oiioSpec.extra_attribs)
+            {
+                tags[std::string(i.name())] = i.get_string();
+            }
+
+            // Read the pixels. Only the tiles that are not already cached
+            // are read from the file.
+            VideoData out;
+            out.time = time;
+            out.image = ftk::Image::create(imageInfo);
+            out.image->setTags(tags);
+            if (!imageCache->get_pixels(
+                oiioFileName,
+                layer,
+                mipLevel,
+                mipSpec.x,
+                mipSpec.x + mipSpec.width,
+                mipSpec.y,
+                mipSpec.y + mipSpec.height,
+                0,
+                1,
+                0,
+                ftk::getChannelCount(imageType),
+                oiioSpec.format,
+                out.image->getData()))
+            {
+                const std::string error = imageCache->geterror();
+                throw std::runtime_error(error.empty() ?
+                    ftk::Format("Cannot read file: \"{0}\"").arg(fileName).str() :
+                    ftk::Format("Cannot read file: \"{0}\": {1}").arg(fileName).arg(error).str());
+            }
+            return out;
+        }
     }
 }
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <tlRender/IO/Completion.h>
+
 #include <algorithm>
 #include <atomic>
 #include <chrono>
@@ -133,7 +135,10 @@ namespace tl
     };
 
     //! A queue of requests serviced by a worker thread. The Request type
-    //! provides a "promise" member of type std::promise<Result>.
+    //! provides a "promise" member of type std::promise<Result>, and a
+    //! "completion" member, a std::shared_ptr<Completion> that is notified
+    //! after the promise is set. Initializing it from getCompletion()
+    //! wakes whoever made the request.
     //!
     //! Requests pushed after the queue is stopped are completed
     //! immediately with a default constructed result, matching the
@@ -181,6 +186,7 @@ namespace tl
             if (stopped)
             {
                 request->promise.set_value(Result());
+                notifyCompletion(request->completion);
             }
             else
             {
@@ -189,6 +195,32 @@ namespace tl
             return future;
         }
 
+        //! Push a request whose future has already been taken, handing it
+        //! on from another queue. If the queue has been stopped the
+        //! request is completed immediately with a default constructed
+        //! result.
+        void forward(const std::shared_ptr<Request>& request)
+        {
+            bool stopped = false;
+            {
+                std::unique_lock<std::mutex> lock(_condition._mutex);
+                stopped = _stopped;
+                if (!stopped)
+                {
+                    _requests.push_back(request);
+                }
+            }
+            if (stopped)
+            {
+                request->promise.set_value(Result());
+                notifyCompletion(request->completion);
+            }
+            else
+            {
+                _condition._cv.notify_one();
+            }
+        }
+
         //! Pop one pending request, or return nullptr. Called by the
         //! worker thread.
         std::shared_ptr<Request> pop()
@@ -242,6 +274,7 @@ namespace tl
             for (const auto& request : requests)
             {
                 request->promise.set_value(Result());
+                notifyCompletion(request->completion);
             }
         }
 
@@ -267,6 +300,7 @@ namespace tl
             for (const auto& request : requests)
             {
                 request->promise.set_value(Result());
+                notifyCompletion(request->completion);
             }
         }
 
@@ -278,7 +312,8 @@ namespace tl
     };
 
     //! Completes a promise with a default constructed value when
-    //! destroyed, unless a value was set through the guard first. Used
+    //! destroyed, unless a value was set through the guard first. Either
+    //! way the request's completion is notified. Used
     //! by worker threads to guarantee that an in-flight request is
     //! never dropped with a broken promise, even if an exception is
     //! thrown while servicing it.
@@ -286,8 +321,11 @@ namespace tl
     class PromiseGuard
     {
     public:
-        explicit PromiseGuard(std::promise<T>& promise) :
-            _promise(&promise)
+        PromiseGuard(
+            std::promise<T>& promise,
+            const std::shared_ptr<Completion>& completion) :
+            _promise(&promise),
+            _completion(completion)
         {}
 
         PromiseGuard(const PromiseGuard&) = delete;
@@ -300,6 +338,7 @@ namespace tl
                 try
                 {
                     _promise->set_value(T());
+                    notifyCompletion(_completion);
                 }
                 catch (const std::future_error&)
                 {}
@@ -311,9 +350,11 @@ namespace tl
         {
             _promise->set_value(std::move(value));
             _promise = nullptr;
+            notifyCompletion(_completion);
         }
 
     private:
         std::promise<T>* _promise = nullptr;
+        std::shared_ptr<Completion> _completion;
     };
 }
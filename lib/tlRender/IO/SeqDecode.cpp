@@ -4,6 +4,7 @@
 #include <tlRender/IO/SeqDecode.h>
 
 #include <tlRender/IO/SeqIO.h>
+#include <tlRender/IO/SeqPrefetch.h>
 
 #include <ftk/Core/Format.h>
 #include <ftk/Core/Math.h>
@@ -15,16 +16,160 @@
 
 namespace tl
 {
+    namespace
+    {
+        const int64_t wordBits = 64;
+
+        //! How many frames ahead of the one being read the operating system
+        //! is asked to start reading, and how far behind frames are let go.
+        //! Ahead is past the frames the player already has in flight, which
+        //! are being read anyway.
+        const int64_t adviseAhead = 32;
+        const int64_t adviseBehind = 64;
+
+        //! How long the index of which frames are there stands before a read
+        //! of a frame it does not have looks in the directory again.
+        const std::chrono::seconds framesRefresh(1);
+
+        //! The highest bit set in a word that is not zero.
+        int highestBit(uint64_t value)
+        {
+            int out = 0;
+            for (int shift = 32; shift > 0; shift /= 2)
+            {
+                if (value >> shift)
+                {
+                    value >>= shift;
+                    out += shift;
+                }
+            }
+            return out;
+        }
+    }
+
+    SeqFrameIndex::SeqFrameIndex(
+        const ftk::RangeI64& range,
+        const std::vector<int64_t>& frames) :
+        _range(range)
+    {
+        if (range.max() >= range.min())
+        {
+            _bits.resize((range.max() - range.min()) / wordBits + 1, 0);
+        }
+        for (int64_t frame : frames)
+        {
+            if (frame >= range.min() && frame <= range.max())
+            {
+                const int64_t i = frame - range.min();
+                uint64_t& word = _bits[i / wordBits];
+                const uint64_t bit = uint64_t(1) << (i % wordBits);
+                if (!(word & bit))
+                {
+                    word |= bit;
+                    ++_count;
+                }
+            }
+        }
+    }
+
+    SeqFrameIndex SeqFrameIndex::scan(
+        const ftk::Path& path,
+        const ftk::RangeI64& range,
+        const ftk::PathOptions& pathOptions)
+    {
+        return SeqFrameIndex(
+            range,
+            ftk::toFrames(ftk::findSeq(path, pathOptions)));
+    }
+
+    const ftk::RangeI64& SeqFrameIndex::getRange() const
+    {
+        return _range;
+    }
+
+    size_t SeqFrameIndex::getCount() const
+    {
+        return _count;
+    }
+
+    bool SeqFrameIndex::contains(int64_t frame) const
+    {
+        if (frame < _range.min() || frame > _range.max() || _bits.empty())
+        {
+            return false;
+        }
+        const int64_t i = frame - _range.min();
+        return _bits[i / wordBits] & (uint64_t(1) << (i % wordBits));
+    }
+
+    int64_t SeqFrameIndex::getPrev(int64_t frame) const
+    {
+        if (_bits.empty() || frame <= _range.min())
+        {
+            return frame;
+        }
+        // A word at a time, so that a long gap is still quick.
+        const int64_t i = std::min(frame - 1, _range.max()) - _range.min();
+        int64_t word = i / wordBits;
+        const int bit = static_cast<int>(i % wordBits);
+        uint64_t value = _bits[word] &
+            (bit == wordBits - 1 ? ~uint64_t(0) : (uint64_t(1) << (bit + 1)) - 1);
+        while (!value && word > 0)
+        {
+            --word;
+            value = _bits[word];
+        }
+        return value ?
+            _range.min() + word * wordBits + highestBit(value) :
+            frame;
+    }
+
+    std::vector<ftk::RangeI64> SeqFrameIndex::getRuns() const
+    {
+        std::vector<ftk::RangeI64> out;
+        for (size_t word = 0; word < _bits.size(); ++word)
+        {
+            const uint64_t value = _bits[word];
+            if (!value)
+            {
+                continue;
+            }
+            for (int bit = 0; bit < wordBits; ++bit)
+            {
+                if (value & (uint64_t(1) << bit))
+                {
+                    const int64_t frame = _range.min() + word * wordBits + bit;
+                    if (!out.empty() && out.back().max() + 1 == frame)
+                    {
+                        out.back() = ftk::RangeI64(out.back().min(), frame);
+                    }
+                    else
+                    {
+                        out.push_back(ftk::RangeI64(frame, frame));
+                    }
+                }
+            }
+        }
+        return out;
+    }
+
     void SeqDecode::_init(
         const ftk::Path& path,
         const std::vector<ftk::MemFile>& mem,
         const std::shared_ptr<IDecode>& decode,
-        const IOOptions& options)
+        const IOOptions& options,
+        const std::shared_ptr<SeqPrefetch>& prefetch)
     {
         _path = path;
         _mem = mem;
         _decode = decode;
         _options = options;
+        // A bundle is already in memory, and a single file has nothing
+        // after it to read.
+        if (_mem.empty() && !path.getNum().empty())
+        {
+            _prefetch = prefetch;
+        }
 
         // Where the sequence starts and ends. Memory comes from a bundle,
         // which holds exactly the frames it holds; otherwise the path carries
@@ -66,7 +211,9 @@ namespace tl
             OTIO_NS::RationalTime(_endFrame, speed));
     }
 
-    SeqDecode::SeqDecode()
+    SeqDecode::SeqDecode() :
+        _prefetchLast(0),
+        _prefetchTrend(0)
     {}
 
     SeqDecode::~SeqDecode()
@@ -76,10 +223,11 @@ namespace tl
         const ftk::Path& path,
         const std::vector<ftk::MemFile>& mem,
         const std::shared_ptr<IDecode>& decode,
-        const IOOptions& options)
+        const IOOptions& options,
+        const std::shared_ptr<SeqPrefetch>& prefetch)
     {
         auto out = std::shared_ptr<SeqDecode>(new SeqDecode);
-        out->_init(path, mem, decode, options);
+        out->_init(path, mem, decode, options, prefetch);
         return out;
     }
 
@@ -105,7 +253,9 @@ namespace tl
         // The first frame that is actually there. Usually that is the frame
         // the path names, but it need not be: a bundle can be missing frames,
         // and a sequence can be opened over a range that begins before the
-        // frames rendered so far.
+        // frames rendered so far. The frame the path names is asked about on
+        // its own, and only when it is not there is the directory looked
+        // through for the others.
         std::exception_ptr error;
         for (int64_t frame = _startFrame; frame <= _endFrame; ++frame)
         {
@@ -119,8 +269,9 @@ namespace tl
                     continue;
                 }
             }
-            else if (!std::filesystem::exists(
-                std::filesystem::u8path(fileName)))
+            else if (frame == _startFrame ?
+                !std::filesystem::exists(std::filesystem::u8path(fileName)) :
+                !getFrames()->contains(frame))
             {
                 continue;
             }
@@ -162,24 +313,100 @@ namespace tl
 
     int64_t SeqDecode::_holdFrame(int64_t frame) const
     {
-        for (int64_t i = frame - 1; i >= _startFrame; --i)
-        {
-            const bool exists = !_mem.empty() ?
-                _memFile(i) != nullptr :
-                // Only reached once a frame has already failed to read, so
-                // this costs nothing while a sequence is complete, and while
-                // it is not it costs one test per frame of the gap. Asking
-                // the file system each time rather than caching what was
-                // there at open is deliberate: a render in progress gains
-                // frames while it is being watched.
-                std::filesystem::exists(
-                    std::filesystem::u8path(_path.getFrame(i, true)));
-            if (exists)
+        // Only reached once a frame is missing, so a complete sequence never
+        // makes the index. A render in progress gains frames while it is
+        // being watched, which readVideo() picks up as the index ages.
+        return getFrames()->getPrev(frame);
+    }
+
+    std::shared_ptr<const SeqFrameIndex> SeqDecode::getFrames() const
+    {
+        std::unique_lock<std::mutex> lock(_framesMutex);
+        if (!_frames)
+        {
+            // Made under the lock, so that reads which find frames missing
+            // at the same time look through the directory once between them.
+            _frames = _makeFrames();
+            _framesTime = std::chrono::steady_clock::now();
+        }
+        return _frames;
+    }
+
+    void SeqDecode::refreshFrames()
+    {
+        auto frames = _makeFrames();
+        std::unique_lock<std::mutex> lock(_framesMutex);
+        _frames = frames;
+        _framesTime = std::chrono::steady_clock::now();
+    }
+
+    std::shared_ptr<const SeqFrameIndex> SeqDecode::_getFramesIfMade() const
+    {
+        std::unique_lock<std::mutex> lock(_framesMutex);
+        return _frames;
+    }
+
+    std::shared_ptr<const SeqFrameIndex> SeqDecode::_getFramesIfMadeRecent() const
+    {
+        // One read looks in the directory again, outside the lock, and the
+        // others carry on with the index there is. A bundle holds what it
+        // holds, so its index never ages.
+        std::shared_ptr<const SeqFrameIndex> out;
+        {
+            std::unique_lock<std::mutex> lock(_framesMutex);
+            if (!_frames ||
+                !_mem.empty() ||
+                _framesMaking ||
+                std::chrono::steady_clock::now() - _framesTime < framesRefresh)
             {
-                return i;
+                return _frames;
             }
+            _framesMaking = true;
         }
-        return frame;
+        try
+        {
+            out = _makeFrames();
+        }
+        catch (const std::exception&)
+        {}
+        std::unique_lock<std::mutex> lock(_framesMutex);
+        if (out)
+        {
+            _frames = out;
+        }
+        _framesTime = std::chrono::steady_clock::now();
+        _framesMaking = false;
+        return _frames;
+    }
+
+    std::shared_ptr<const SeqFrameIndex> SeqDecode::_makeFrames() const
+    {
+        const ftk::RangeI64 range(_startFrame, _endFrame);
+        if (!_mem.empty())
+        {
+            // The bundle holds what it holds, so there is nothing to look at
+            // but the memory.
+            std::vector<int64_t> frames;
+            for (int64_t frame = _startFrame; frame <= _endFrame; ++frame)
+            {
+                if (_memFile(frame))
+                {
+                    frames.push_back(frame);
+                }
+            }
+            return std::make_shared<SeqFrameIndex>(range, frames);
+        }
+        if (_path.getNum().empty())
+        {
+            std::vector<int64_t> frames;
+            if (std::filesystem::exists(
+                std::filesystem::u8path(_path.getFileName(true))))
+            {
+                frames.push_back(_startFrame);
+            }
+            return std::make_shared<SeqFrameIndex>(range, frames);
+        }
+        return std::make_shared<SeqFrameIndex>(SeqFrameIndex::scan(_path, range));
     }
 
     VideoData SeqDecode::_missingVideo(
@@ -187,13 +414,25 @@ namespace tl
         MissingFrames missingFrames) const
     {
         std::shared_ptr<ftk::Image> image;
+        std::string standIn;
         if (MissingFrames::Black == missingFrames && !_info.video.empty())
         {
-            image = ftk::Image::create(_info.video[0]);
+            const ftk::ImageInfo& info = _info.video[0];
+            image = ftk::Image::create(info);
             image->zero();
+            // Starts with what a path cannot, so that it is not taken for
+            // the name of a frame that was read.
+            std::stringstream ss;
+            ss << "#" << missingFrames << '/' <<
+                info.size.w << 'x' << info.size.h << '/' <<
+                info.type << '/' <<
+                info.pixelAspectRatio << '/' <<
+                info.layout.mirror.x << info.layout.mirror.y;
+            standIn = ss.str();
         }
         VideoData out(time, 0, image);
         out.missing = true;
+        out.standIn = standIn;
         return out;
     }
 
@@ -267,10 +506,34 @@ namespace tl
                 _path.getFileName(true), nullptr, time, merged);
         }
 
+        const auto hint = getAccessHint(merged);
+        if (_prefetch)
+        {
+            _prefetchFrom(frame, hint);
+        }
+        if (hint.has_value())
+        {
+            _advise(frame, hint.value());
+        }
+
+        const bool fill =
+            MissingFrames::Hold == missingFrames ||
+            MissingFrames::Black == missingFrames;
+        if (fill)
+        {
+            // Once a frame has been found missing the index is there, and a
+            // frame it does not have is filled in without asking the file
+            // system about it. The index is made again as it ages, so frames
+            // written since are read.
+            const auto frames = _getFramesIfMadeRecent();
+            if (frames && !frames->contains(frame))
+            {
+                return _fillVideo(time, frame, merged, missingFrames);
+            }
+        }
         try
         {
-            return _decode->readVideo(
-                _path.getFrame(frame, true), nullptr, time, merged);
+            return _readFrame(time, frame, merged);
         }
         catch (const std::exception&)
         {
@@ -278,41 +541,156 @@ namespace tl
             // discovered by trying, so that a complete sequence pays nothing
             // for this. A frame that is there but half written counts as
             // missing too, which is the case while it is being rendered.
-            switch (missingFrames)
+            if (!fill)
             {
-            case MissingFrames::Hold:
+                throw;
+            }
+        }
+        return _fillVideo(time, frame, merged, missingFrames);
+    }
+
+    VideoData SeqDecode::_readFrame(
+        const OTIO_NS::RationalTime& time,
+        int64_t frame,
+        const IOOptions& options) const
+    {
+        const std::string fileName = _path.getFrame(frame, true);
+        if (_prefetch)
+        {
+            if (const auto data = _prefetch->take(fileName))
             {
-                // Walk back a frame at a time rather than holding whichever
-                // one is nearest: with several frames being written at once,
-                // more than one of them can fail to read.
-                for (int64_t i = frame; ; )
+                // Decoded from the bytes that were read ahead, the same way
+                // as a frame in a bundle. The buffer goes back to the
+                // prefetcher once the image is made.
+                const ftk::MemFile mem(nullptr, data->data(), data->size());
+                return _decode->readVideo(fileName, &mem, time, options);
+            }
+        }
+        return _decode->readVideo(fileName, nullptr, time, options);
+    }
+
+    void SeqDecode::_prefetchFrom(
+        int64_t frame,
+        const std::optional<AccessHint>& hint) const
+    {
+        // Which way the frames are being read. Several are decoded at once
+        // and finish in any order, so one frame behind the last is not a
+        // change of direction; the trend over the last few is. The player
+        // says which way it is going, which is better than a guess.
+        const int64_t last = _prefetchLast.exchange(frame);
+        int trend = _prefetchTrend;
+        if (frame > last)
+        {
+            trend = std::min(trend + 1, 4);
+        }
+        else if (frame < last)
+        {
+            trend = std::max(trend - 1, -4);
+        }
+        _prefetchTrend = trend;
+        int64_t step = trend < 0 ? -1 : 1;
+        if (hint.has_value())
+        {
+            switch (hint.value())
+            {
+            case AccessHint::Forward: step = 1; break;
+            case AccessHint::Reverse: step = -1; break;
+            case AccessHint::Random: return;
+            default: break;
+            }
+        }
+
+        // Frames already known to be missing are not asked for; otherwise a
+        // frame that is not there fails to read on a prefetch thread rather
+        // than on a decoding one, which costs nothing.
+        const auto frames = _getFramesIfMade();
+        const size_t count = _prefetch->getFrameMax();
+        std::vector<std::string> fileNames;
+        for (int64_t i = frame + step;
+            i >= _startFrame && i <= _endFrame && fileNames.size() < count;
+            i += step)
+        {
+            if (!frames || frames->contains(i))
+            {
+                fileNames.push_back(_path.getFrame(i, true));
+            }
+        }
+        _prefetch->request(fileNames);
+    }
+
+    void SeqDecode::_advise(int64_t frame, AccessHint hint) const
+    {
+        // One file each way per read: the frame coming into the window
+        // ahead and the one leaving it behind. Frames are read one after
+        // another, so that covers them all without keeping track; after a
+        // seek the player asks for the frames nearest first, which are
+        // being read already. Scrubbing and random reads have no ahead or
+        // behind to speak of.
+        int64_t step = 0;
+        switch (hint)
+        {
+        case AccessHint::Forward: step = 1; break;
+        case AccessHint::Reverse: step = -1; break;
+        default: break;
+        }
+        if (0 == step)
+        {
+            return;
+        }
+        const auto frames = _getFramesIfMade();
+        const auto there = [this, &frames](int64_t i)
+            {
+                return
+                    i >= _startFrame &&
+                    i <= _endFrame &&
+                    (!frames || frames->contains(i));
+            };
+        // The prefetcher reads ahead itself.
+        const int64_t ahead = frame + step * adviseAhead;
+        if (!_prefetch && there(ahead))
+        {
+            adviseWillNeed(_path.getFrame(ahead, true));
+        }
+        const int64_t behind = frame - step * adviseBehind;
+        if (there(behind))
+        {
+            adviseDontNeed(_path.getFrame(behind, true));
+        }
+    }
+
+    VideoData SeqDecode::_fillVideo(
+        const OTIO_NS::RationalTime& time,
+        int64_t frame,
+        const IOOptions& options,
+        MissingFrames missingFrames) const
+    {
+        if (MissingFrames::Hold == missingFrames)
+        {
+            // Walk back a frame at a time rather than holding whichever one
+            // is nearest: with several frames being written at once, more
+            // than one of them can fail to read.
+            for (int64_t i = frame; ; )
+            {
+                const int64_t prev = _holdFrame(i);
+                if (prev == i)
                 {
-                    const int64_t prev = _holdFrame(i);
-                    if (prev == i)
-                    {
-                        break;
-                    }
-                    try
-                    {
-                        VideoData out = _decode->readVideo(
-                            _path.getFrame(prev, true), nullptr, time, merged);
-                        // Which frame is being looked at rather than the one
-                        // asked for, so it can be said rather than guessed.
-                        out.missing = true;
-                        out.heldFrom = prev;
-                        return out;
-                    }
-                    catch (const std::exception&)
-                    {}
-                    i = prev;
+                    break;
                 }
-                return _missingVideo(time, missingFrames);
-            }
-            case MissingFrames::Black:
-                return _missingVideo(time, missingFrames);
-            default:
-                throw;
+                try
+                {
+                    VideoData out = _decode->readVideo(
+                        _path.getFrame(prev, true), nullptr, time, options);
+                    // Which frame is being looked at rather than the one
+                    // asked for, so it can be said rather than guessed.
+                    out.missing = true;
+                    out.heldFrom = prev;
+                    return out;
+                }
+                catch (const std::exception&)
+                {}
+                i = prev;
             }
         }
+        return _missingVideo(time, missingFrames);
     }
 }
@@ -8,17 +8,69 @@
 
 #include <ftk/Core/Path.h>
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
 namespace tl
 {
+    class SeqPrefetch;
+
+    //! Which frames of an image sequence are there.
+    //!
+    //! One bit per frame of the range, filled in from a single look at the
+    //! directory, so that asking about a frame costs nothing however slow
+    //! the file system is. It is a snapshot: frames written afterwards are
+    //! only seen by making a new one.
+    class TL_API_TYPE SeqFrameIndex
+    {
+    public:
+        SeqFrameIndex() = default;
+
+        //! Create an index over a range from the frames that are there.
+        //! Frames outside the range are left out.
+        TL_API SeqFrameIndex(
+            const ftk::RangeI64&,
+            const std::vector<int64_t>&);
+
+        //! Look in the directory for the frames of a sequence.
+        TL_API static SeqFrameIndex scan(
+            const ftk::Path&,
+            const ftk::RangeI64&,
+            const ftk::PathOptions& = ftk::PathOptions());
+
+        //! Get the range.
+        TL_API const ftk::RangeI64& getRange() const;
+
+        //! Get the number of frames that are there.
+        TL_API size_t getCount() const;
+
+        //! Get whether a frame is there.
+        TL_API bool contains(int64_t) const;
+
+        //! Get the nearest frame before the given one that is there, or
+        //! the frame itself when there is none.
+        TL_API int64_t getPrev(int64_t) const;
+
+        //! Get the frames that are there as runs of consecutive numbers.
+        TL_API std::vector<ftk::RangeI64> getRuns() const;
+
+    private:
+        ftk::RangeI64 _range = ftk::RangeI64(0, -1);
+        std::vector<uint64_t> _bits;
+        size_t _count = 0;
+    };
+
     //! An image sequence, decoded one frame at a time.
     //!
     //! This is all that reading an image sequence needs: which file, or which
     //! range of bytes in a bundle, holds a frame, and a decoder to turn it
     //! into an image.
     //!
-    //! It owns no thread and no request queue, and it is not written to after
-    //! it is created, so the caller decides where reads happen: on a worker,
-    //! on several at once, or in line.
+    //! It owns no thread and no request queue, and apart from the index of
+    //! which frames are there it is not written to after it is created, so
+    //! the caller decides where reads happen: on a worker, on several at
+    //! once, or in line.
     class TL_API_TYPE SeqDecode : public std::enable_shared_from_this<SeqDecode>
     {
         FTK_NON_COPYABLE(SeqDecode);
@@ -28,7 +80,8 @@ namespace tl
             const ftk::Path&,
             const std::vector<ftk::MemFile>&,
             const std::shared_ptr<IDecode>&,
-            const IOOptions&);
+            const IOOptions&,
+            const std::shared_ptr<SeqPrefetch>&);
 
         SeqDecode();
 
@@ -39,11 +92,15 @@ namespace tl
         //!
         //! This reads the first frame's header to find the image information,
         //! so it touches the file system once.
+        //!
+        //! A sequence on disk given a prefetcher reads ahead of the frames
+        //! that are decoded, in whichever direction they are being read.
         TL_API static std::shared_ptr<SeqDecode> create(
             const ftk::Path&,
             const std::vector<ftk::MemFile>&,
             const std::shared_ptr<IDecode>&,
-            const IOOptions& = IOOptions());
+            const IOOptions& = IOOptions(),
+            const std::shared_ptr<SeqPrefetch>& = nullptr);
 
         //! Get the path.
         TL_API const ftk::Path& getPath() const;
@@ -59,6 +116,17 @@ namespace tl
             const OTIO_NS::RationalTime&,
             const IOOptions& = IOOptions()) const;
 
+        //! Get the index of which frames are there. It is made the first
+        //! time a frame is found missing, or here if that has not happened
+        //! yet. Reading a frame the index does not have makes it again once
+        //! it is a second old, so that a sequence that is still being
+        //! written is followed while it is watched.
+        TL_API std::shared_ptr<const SeqFrameIndex> getFrames() const;
+
+        //! Look again for which frames are there, for a sequence that is
+        //! still being written. Safe to call while frames are being read.
+        TL_API void refreshFrames();
+
     private:
         //! Read the image information from the first frame that is there.
         IOInfo _probeInfo() const;
@@ -66,20 +134,57 @@ namespace tl
         //! The bytes for a frame, or null when the bundle does not hold it.
         const ftk::MemFile* _memFile(int64_t frame) const;
 
-        //! The nearest frame at or before the given one that can be read, or
-        //! the frame itself when there is none.
+        //! Decode a frame on disk, from the prefetcher when it has read it.
+        VideoData _readFrame(
+            const OTIO_NS::RationalTime&,
+            int64_t frame,
+            const IOOptions&) const;
+
+        //! Ask the prefetcher for the frames after the one being read.
+        void _prefetchFrom(int64_t frame, const std::optional<AccessHint>&) const;
+
+        //! Advise the operating system about the files around the one being
+        //! read.
+        void _advise(int64_t frame, AccessHint) const;
+
+        //! The nearest frame before the given one that is there, or the
+        //! frame itself when there is none.
         int64_t _holdFrame(int64_t frame) const;
 
+        //! The index if it has been made, or null.
+        std::shared_ptr<const SeqFrameIndex> _getFramesIfMade() const;
+
+        //! The index if it has been made, made again first when it is old
+        //! enough, or null.
+        std::shared_ptr<const SeqFrameIndex> _getFramesIfMadeRecent() const;
+
+        std::shared_ptr<const SeqFrameIndex> _makeFrames() const;
+
         VideoData _missingVideo(
             const OTIO_NS::RationalTime&,
             MissingFrames) const;
 
+        //! Fill in for a frame on disk that is missing, by holding or with
+        //! a blank frame.
+        VideoData _fillVideo(
+            const OTIO_NS::RationalTime&,
+            int64_t frame,
+            const IOOptions&,
+            MissingFrames) const;
+
         ftk::Path _path;
         std::vector<ftk::MemFile> _mem;
         std::shared_ptr<IDecode> _decode;
         IOOptions _options;
+        std::shared_ptr<SeqPrefetch> _prefetch;
+        mutable std::atomic<int64_t> _prefetchLast;
+        mutable std::atomic<int> _prefetchTrend;
         int64_t _startFrame = 0;
         int64_t _endFrame = 0;
         IOInfo _info;
+        mutable std::mutex _framesMutex;
+        mutable std::shared_ptr<const SeqFrameIndex> _frames;
+        mutable std::chrono::steady_clock::time_point _framesTime;
+        mutable bool _framesMaking = false;
     };
 }
@@ -0,0 +1,318 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/IO/SeqPrefetch.h>
+
+#include <ftk/Core/FileIO.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace tl
+{
+    namespace
+    {
+        //! Buffers that have been given back, for the next file to be read
+        //! into. Shared with the buffers handed out, so that one taken just
+        //! before the prefetcher goes away is freed rather than returned to
+        //! nothing.
+        struct BufferPool
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<std::vector<uint8_t> > > buffers;
+            size_t max = 0;
+        };
+
+        std::shared_ptr<std::vector<uint8_t> > getBuffer(
+            const std::shared_ptr<BufferPool>& pool,
+            size_t size)
+        {
+            std::unique_ptr<std::vector<uint8_t> > buffer;
+            {
+                std::unique_lock<std::mutex> lock(pool->mutex);
+                if (!pool->buffers.empty())
+                {
+                    buffer = std::move(pool->buffers.back());
+                    pool->buffers.pop_back();
+                }
+            }
+            if (!buffer)
+            {
+                buffer.reset(new std::vector<uint8_t>);
+            }
+            // The frames of a sequence are much the same size, so after the
+            // first few this neither allocates nor clears anything.
+            buffer->resize(size);
+            const std::weak_ptr<BufferPool> weak(pool);
+            return std::shared_ptr<std::vector<uint8_t> >(
+                buffer.release(),
+                [weak](std::vector<uint8_t>* p)
+                {
+                    if (auto pool = weak.lock())
+                    {
+                        std::unique_lock<std::mutex> lock(pool->mutex);
+                        if (pool->buffers.size() < pool->max)
+                        {
+                            pool->buffers.emplace_back(p);
+                            return;
+                        }
+                    }
+                    delete p;
+                });
+        }
+    }
+
+    struct SeqPrefetch::Private
+    {
+        size_t frameMax = 0;
+        std::shared_ptr<BufferPool> pool;
+
+        enum class State
+        {
+            Queued,
+            Reading,
+            Done,
+            Failed
+        };
+        struct File
+        {
+            State state = State::Queued;
+            std::shared_ptr<std::vector<uint8_t> > data;
+        };
+
+        // Every field below is guarded by the mutex. The files are kept in
+        // the order they were asked for, which is both the order they are
+        // read in and the order they make way in.
+        std::mutex mutex;
+        std::condition_variable readCV;
+        std::condition_variable doneCV;
+        std::map<std::string, File> files;
+        std::list<std::string> order;
+        size_t queued = 0;
+        bool stopped = false;
+
+        std::vector<std::thread> threads;
+
+        void erase(std::map<std::string, File>::iterator);
+        bool makeRoom();
+        void run();
+    };
+
+    void SeqPrefetch::Private::erase(std::map<std::string, File>::iterator i)
+    {
+        if (State::Queued == i->second.state)
+        {
+            --queued;
+        }
+        const auto j = std::find(order.begin(), order.end(), i->first);
+        if (j != order.end())
+        {
+            order.erase(j);
+        }
+        files.erase(i);
+    }
+
+    bool SeqPrefetch::Private::makeRoom()
+    {
+        if (files.size() < frameMax)
+        {
+            return true;
+        }
+        for (const auto& fileName : order)
+        {
+            const auto i = files.find(fileName);
+            if (State::Done == i->second.state || State::Failed == i->second.state)
+            {
+                erase(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void SeqPrefetch::Private::run()
+    {
+        while (true)
+        {
+            std::string fileName;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                readCV.wait(
+                    lock,
+                    [this]
+                    {
+                        return stopped || queued > 0;
+                    });
+                if (stopped)
+                {
+                    return;
+                }
+                for (const auto& i : order)
+                {
+                    auto& file = files[i];
+                    if (State::Queued == file.state)
+                    {
+                        file.state = State::Reading;
+                        --queued;
+                        fileName = i;
+                        break;
+                    }
+                }
+            }
+
+            // The whole file in one read, without mapping it: on a network
+            // share a mapped file is read a page fault at a time by whichever
+            // thread touches it, which is the wait this exists to take off
+            // the decoding threads.
+            std::shared_ptr<std::vector<uint8_t> > data;
+            try
+            {
+                auto io = ftk::FileIO::create(
+                    fileName,
+                    ftk::FileMode::Read,
+                    ftk::FileRead::Normal);
+                data = getBuffer(pool, io->getSize());
+                io->read(data->data(), data->size());
+            }
+            catch (const std::exception&)
+            {
+                // Not there, or not all there yet. The decoder finds that
+                // out for itself and says so properly.
+                data.reset();
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                // Gone if it was cancelled while it was being read.
+                const auto i = files.find(fileName);
+                if (i != files.end() && State::Reading == i->second.state)
+                {
+                    i->second.state = data ? State::Done : State::Failed;
+                    i->second.data = data;
+                }
+            }
+            doneCV.notify_all();
+        }
+    }
+
+    void SeqPrefetch::_init(size_t threadCount, size_t frameMax)
+    {
+        FTK_P();
+        p.frameMax = std::max(frameMax, size_t(1));
+        p.pool = std::make_shared<BufferPool>();
+        p.pool->max = p.frameMax;
+        for (size_t i = 0; i < std::max(threadCount, size_t(1)); ++i)
+        {
+            p.threads.push_back(std::thread(
+                [this]
+                {
+                    _p->run();
+                }));
+        }
+    }
+
+    SeqPrefetch::SeqPrefetch() :
+        _p(new Private)
+    {}
+
+    SeqPrefetch::~SeqPrefetch()
+    {
+        FTK_P();
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            p.stopped = true;
+        }
+        p.readCV.notify_all();
+        for (auto& thread : p.threads)
+        {
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+    }
+
+    std::shared_ptr<SeqPrefetch> SeqPrefetch::create(
+        size_t threadCount,
+        size_t frameMax)
+    {
+        auto out = std::shared_ptr<SeqPrefetch>(new SeqPrefetch);
+        out->_init(threadCount, frameMax);
+        return out;
+    }
+
+    size_t SeqPrefetch::getFrameMax() const
+    {
+        return _p->frameMax;
+    }
+
+    void SeqPrefetch::request(const std::vector<std::string>& fileNames)
+    {
+        FTK_P();
+        bool added = false;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            for (const auto& fileName : fileNames)
+            {
+                if (p.files.find(fileName) != p.files.end())
+                {
+                    continue;
+                }
+                if (!p.makeRoom())
+                {
+                    // Full of files being read or waiting to be, all of
+                    // them asked for before these and so needed sooner.
+                    break;
+                }
+                p.files[fileName] = Private::File();
+                p.order.push_back(fileName);
+                ++p.queued;
+                added = true;
+            }
+        }
+        if (added)
+        {
+            p.readCV.notify_all();
+        }
+    }
+
+    std::shared_ptr<const std::vector<uint8_t> > SeqPrefetch::take(
+        const std::string& fileName)
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        while (true)
+        {
+            const auto i = p.files.find(fileName);
+            if (i == p.files.end())
+            {
+                return nullptr;
+            }
+            if (Private::State::Reading == i->second.state)
+            {
+                p.doneCV.wait(lock);
+                continue;
+            }
+            const auto out = i->second.data;
+            p.erase(i);
+            return out;
+        }
+    }
+
+    void SeqPrefetch::cancel()
+    {
+        FTK_P();
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            p.files.clear();
+            p.order.clear();
+            p.queued = 0;
+        }
+        // Anything waiting on a file that was being read gives up on it.
+        p.doneCV.notify_all();
+    }
+}
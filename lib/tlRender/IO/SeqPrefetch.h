@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include <tlRender/Core/Export.h>
+
+#include <ftk/Core/Util.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tl
+{
+    //! Reads the files of an image sequence ahead of decoding them.
+    //!
+    //! A decoder reads its file itself, on the thread that decodes it, so
+    //! on storage where a read takes milliseconds to start the decoding
+    //! threads spend most of their time waiting. This reads whole files on
+    //! threads of its own, into buffers that are reused from frame to frame,
+    //! so that how many reads are in flight is set separately from how many
+    //! frames are decoded at once.
+    //!
+    //! Files are asked for by name, and taken by name once read. A file
+    //! that was never asked for, or that could not be read, is not here, and
+    //! the decoder reads it the way it would have anyway.
+    class TL_API_TYPE SeqPrefetch : public std::enable_shared_from_this<SeqPrefetch>
+    {
+        FTK_NON_COPYABLE(SeqPrefetch);
+
+    protected:
+        void _init(size_t threadCount, size_t frameMax);
+
+        SeqPrefetch();
+
+    public:
+        TL_API ~SeqPrefetch();
+
+        //! Create a new prefetcher, with the number of threads that read and
+        //! the number of files held, read or waiting to be, at once.
+        TL_API static std::shared_ptr<SeqPrefetch> create(
+            size_t threadCount,
+            size_t frameMax);
+
+        //! Get the number of files held at once.
+        TL_API size_t getFrameMax() const;
+
+        //! Ask for files to be read, in the order given. Files that are
+        //! already held are left as they are. When there is no room the
+        //! oldest files that have been read and not taken make way, since
+        //! whatever wanted them has moved on.
+        TL_API void request(const std::vector<std::string>& fileNames);
+
+        //! Take a file. A file that is being read is waited for; one that
+        //! is still waiting to be read is dropped, since the caller reading
+        //! it now is quicker than waiting behind the others. Null when the
+        //! file is not here.
+        TL_API std::shared_ptr<const std::vector<uint8_t> > take(
+            const std::string& fileName);
+
+        //! Drop the files that have not been taken, for a caller that is
+        //! about to look somewhere else.
+        TL_API void cancel();
+
+    private:
+        FTK_PRIVATE();
+    };
+}
@@ -3,6 +3,7 @@
 
 #include <tlRender/IO/System.h>
 
+#include <tlRender/IO/DPX.h>
 #if defined(TLRENDER_FFMPEG_PLUGIN)
 #include <tlRender/IO/FFmpeg.h>
 #endif // TLRENDER_FFMPEG_PLUGIN
@@ -51,8 +52,16 @@ namespace tl
 #if defined(TLRENDER_SVG)
             _plugins.push_back(svg::ReadPlugin::create(logSystem));
 #endif // TLRENDER_SVG
+            // Before OIIO as well, which would otherwise take .dpx and .cin.
+            // The layouts that are not read natively still go to OIIO.
+            std::shared_ptr<IReadPlugin> dpxFallback;
 #if defined(TLRENDER_OIIO)
-            _plugins.push_back(oiio::ReadPlugin::create(logSystem));
+            auto oiioPlugin = oiio::ReadPlugin::create(logSystem);
+            dpxFallback = oiioPlugin;
+#endif // TLRENDER_OIIO
+            _plugins.push_back(dpx::ReadPlugin::create(logSystem, dpxFallback));
+#if defined(TLRENDER_OIIO)
+            _plugins.push_back(oiioPlugin);
 #endif // TLRENDER_OIIO
             // After OIIO, which keeps .png where it is built, and before
             // FFmpeg, whose image demuxer would otherwise take it. So this
@@ -30,7 +30,8 @@ namespace tl
                 enableLighting == other.enableLighting &&
                 sRGB == other.sRGB &&
                 stageCacheCount == other.stageCacheCount &&
-                diskCacheGB == other.diskCacheGB;
+                diskCacheGB == other.diskCacheGB &&
+                renderThreadCount == other.renderThreadCount;
         }
 
         bool Options::operator != (const Options& other) const
@@ -48,6 +49,7 @@ namespace tl
             out["USD/sRGB"] = ftk::Format("{0}").arg(value.sRGB);
             out["USD/StageCacheCount"] = ftk::Format("{0}").arg(value.stageCacheCount);
             out["USD/DiskCacheGB"] = ftk::Format("{0}").arg(value.diskCacheGB);
+            out["USD/RenderThreadCount"] = ftk::Format("{0}").arg(value.renderThreadCount);
             return out;
         }
 
@@ -129,6 +131,7 @@ namespace tl
             json["sRGB"] = value.sRGB;
             json["StageCacheCount"] = value.stageCacheCount;
             json["DiskCacheGB"] = value.diskCacheGB;
+            json["RenderThreadCount"] = value.renderThreadCount;
         }
 
         void from_json(const nlohmann::json& json, Options& value)
@@ -140,6 +143,10 @@ namespace tl
             json.at("sRGB").get_to(value.sRGB);
             json.at("StageCacheCount").get_to(value.stageCacheCount);
             json.at("DiskCacheGB").get_to(value.diskCacheGB);
+            if (json.contains("RenderThreadCount"))
+            {
+                json.at("RenderThreadCount").get_to(value.renderThreadCount);
+            }
         }
     }
 }
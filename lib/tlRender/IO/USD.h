@@ -40,6 +40,12 @@ namespace tl
             size_t        stageCacheCount = 10;
             size_t        diskCacheGB     = 0;
 
+            //! How many frames are rendered at once. Each render thread has
+            //! an OpenGL context and stage cache of its own, and they share
+            //! the disk cache. Frames are still returned to the timeline by
+            //! time, so the order they finish in does not matter.
+            size_t        renderThreadCount = 1;
+
             TL_API bool operator == (const Options&) const;
             TL_API bool operator != (const Options&) const;
         };
@@ -52,7 +52,13 @@ namespace tl
                 const std::string&,
                 PXR_NS::UsdStageRefPtr&,
                 std::shared_ptr<PXR_NS::UsdImagingGLEngine>&);
-            void _run();
+            //! Add a render thread. The thread creates an OpenGL context of
+            //! its own, and this waits to hear whether it could. Called with
+            //! the threads mutex locked.
+            bool _addThread();
+            //! Start render threads up to the count in the options.
+            void _threadsUpdate(const IOOptions&);
+            void _run(size_t index);
             void _finish();
 
             FTK_PRIVATE();
@@ -3,6 +3,8 @@
 
 #include <tlRender/IO/USDPrivate.h>
 
+#include <tlRender/IO/Completion.h>
+
 #include <ftk/GL/GL.h>
 #include <ftk/GL/Init.h>
 #include <ftk/Core/FileIO.h>
@@ -61,15 +63,13 @@ namespace tl
         {
             std::weak_ptr<ftk::LogSystem> logSystem;
 
-            SDL_Window* sdlWindow = nullptr;
-            SDL_GLContext sdlGLContext = nullptr;
-            
             struct InfoRequest
             {
                 int64_t id = -1;
                 ftk::Path path;
                 IOOptions options;
                 std::promise<IOInfo> promise;
+                std::shared_ptr<Completion> completion = getCompletion();
             };
 
             struct Request
@@ -79,12 +79,17 @@ namespace tl
                 OTIO_NS::RationalTime time;
                 IOOptions options;
                 std::promise<VideoData> promise;
+                std::shared_ptr<Completion> completion = getCompletion();
             };
             
             struct Mutex
             {
                 std::list<std::shared_ptr<InfoRequest> > infoRequests;
                 std::list<std::shared_ptr<Request> > requests;
+                //! How many of the render threads take requests. Threads
+                //! are started as the count grows and left idle when it
+                //! shrinks, so that a stage they have open is not lost.
+                size_t threadCount = 1;
                 bool stopped = false;
                 std::mutex mutex;
             };
@@ -105,18 +110,33 @@ namespace tl
                 
                 std::string fileName;
             };
-            
+
+            //! Shared by the render threads, so that a frame one of them
+            //! rendered is not rendered again by another.
+            struct DiskCache
+            {
+                ftk::LRUCache<std::string, std::shared_ptr<DiskCacheItem> > cache;
+                std::unique_ptr<ftk::TmpDir> tmpDir;
+                std::mutex mutex;
+            };
+            DiskCache diskCache;
+
+            //! A render thread. Each has its own OpenGL context and its own
+            //! stages: neither a context nor a Hydra engine can be used from
+            //! two threads at once.
             struct Thread
             {
+                size_t index = 0;
+                SDL_Window* sdlWindow = nullptr;
+                SDL_GLContext sdlGLContext = nullptr;
                 ftk::LRUCache<std::string, StageCacheItem> stageCache;
-                ftk::LRUCache<std::string, std::shared_ptr<DiskCacheItem> > diskCache;
-                std::unique_ptr<ftk::TmpDir> tmpDir;
                 std::chrono::steady_clock::time_point logTimer;
-                std::condition_variable cv;
                 std::thread thread;
-                std::atomic<bool> running;
             };
-            Thread thread;
+            std::vector<std::unique_ptr<Thread> > threads;
+            std::mutex threadsMutex;
+            std::condition_variable cv;
+            std::atomic<bool> running;
         };
         
         void Render::_init(const std::shared_ptr<ftk::LogSystem>& logSystem)
@@ -124,52 +144,14 @@ namespace tl
             FTK_P();
 
             p.logSystem = logSystem;
+            p.running = true;
 
-            try
+            bool valid = false;
             {
-#if defined(__APPLE__)
-                const int glVersionMinor = 1;
-                const int glProfile = SDL_GL_CONTEXT_PROFILE_CORE;
-#else //__APPLE__
-                const int glVersionMinor = 5;
-                const int glProfile = SDL_GL_CONTEXT_PROFILE_COMPATIBILITY;
-#endif //__APPLE__
-                SDL_GL_SetAttribute(SDL_GL_ACCELERATED_VISUAL, 1);
-                SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 0);
-                SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
-                SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, glVersionMinor);
-                SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, glProfile);
-                p.sdlWindow = SDL_CreateWindow(
-                    "USD",
-                    SDL_WINDOWPOS_UNDEFINED,
-                    SDL_WINDOWPOS_UNDEFINED,
-                    100,
-                    100,
-                    SDL_WINDOW_OPENGL |
-                    SDL_WINDOW_RESIZABLE |
-                    SDL_WINDOW_HIDDEN);
-                if (!p.sdlWindow)
-                {
-                    throw std::runtime_error(ftk::Format("Cannot create window: {0}").
-                        arg(SDL_GetError()));
-                }
-
-                p.sdlGLContext = SDL_GL_CreateContext(p.sdlWindow);
-                if (!p.sdlGLContext)
-                {
-                    throw std::runtime_error(ftk::Format("Cannot create OpenGL context: {0}").
-                        arg(SDL_GetError()));
-                }
+                std::unique_lock<std::mutex> lock(p.threadsMutex);
+                valid = _addThread();
             }
-            catch (const std::exception&e)
-            {
-                logSystem->print(
-                    "tl::usd::Render",
-                    e.what(),
-                    ftk::LogType::Error);
-            }
-
-            if (!p.sdlWindow || !p.sdlGLContext)
+            if (!valid)
             {
                 logSystem->print(
                     "tl::usd::Render",
@@ -179,28 +161,6 @@ namespace tl
                 p.mutex.stopped = true;
                 return;
             }
-
-            SDL_GL_MakeCurrent(p.sdlWindow, nullptr);
-
-            p.thread.logTimer = std::chrono::steady_clock::now();
-            p.thread.running = true;
-            p.thread.thread = std::thread(
-                [this]
-                {
-                    FTK_P();
-                    if (p.sdlWindow && p.sdlGLContext)
-                    {
-                        SDL_GL_MakeCurrent(p.sdlWindow, p.sdlGLContext);
-                    }
-                    _run();
-                    p.thread.stageCache.clear();
-                    p.thread.diskCache.clear();
-                    _finish();
-                    if (p.sdlWindow && p.sdlGLContext)
-                    {
-                        SDL_GL_MakeCurrent(p.sdlWindow, nullptr);
-                    }
-                });
             
             try
             {
@@ -232,19 +192,25 @@ namespace tl
         Render::~Render()
         {
             FTK_P();
-            p.thread.running = false;
-            if (p.thread.thread.joinable())
-            {
-                p.thread.thread.join();
-            }
-            if (p.sdlGLContext)
+            p.running = false;
+            p.cv.notify_all();
+            for (const auto& thread : p.threads)
             {
-                SDL_GL_DeleteContext(p.sdlGLContext);
-            }
-            if (p.sdlWindow)
-            {
-                SDL_DestroyWindow(p.sdlWindow);
+                if (thread->thread.joinable())
+                {
+                    thread->thread.join();
+                }
+                if (thread->sdlGLContext)
+                {
+                    SDL_GL_DeleteContext(thread->sdlGLContext);
+                }
+                if (thread->sdlWindow)
+                {
+                    SDL_DestroyWindow(thread->sdlWindow);
+                }
             }
+            p.diskCache.cache.clear();
+            _finish();
         }
 
         std::shared_ptr<Render> Render::create(
@@ -254,6 +220,176 @@ namespace tl
             out->_init(logSystem);
             return out;
         }
+
+        namespace
+        {
+            // SDL_GL_SetAttribute() sets state for the whole process, which
+            // SDL_GL_CreateContext() then reads, so contexts are created one
+            // at a time.
+            std::mutex contextMutex;
+
+            //! Create a hidden window and an OpenGL context for a render
+            //! thread. The context is left current on the calling thread.
+            bool createContext(
+                SDL_Window*& sdlWindow,
+                SDL_GLContext& sdlGLContext,
+                const std::shared_ptr<ftk::LogSystem>& logSystem)
+            {
+                std::unique_lock<std::mutex> lock(contextMutex);
+                try
+                {
+#if defined(__APPLE__)
+                    const int glVersionMinor = 1;
+                    const int glProfile = SDL_GL_CONTEXT_PROFILE_CORE;
+#else //__APPLE__
+                    const int glVersionMinor = 5;
+                    const int glProfile = SDL_GL_CONTEXT_PROFILE_COMPATIBILITY;
+#endif //__APPLE__
+                    SDL_GL_SetAttribute(SDL_GL_ACCELERATED_VISUAL, 1);
+                    SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 0);
+                    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+                    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, glVersionMinor);
+                    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, glProfile);
+                    sdlWindow = SDL_CreateWindow(
+                        "USD",
+                        SDL_WINDOWPOS_UNDEFINED,
+                        SDL_WINDOWPOS_UNDEFINED,
+                        100,
+                        100,
+                        SDL_WINDOW_OPENGL |
+                        SDL_WINDOW_RESIZABLE |
+                        SDL_WINDOW_HIDDEN);
+                    if (!sdlWindow)
+                    {
+                        throw std::runtime_error(ftk::Format("Cannot create window: {0}").
+                            arg(SDL_GetError()));
+                    }
+
+                    sdlGLContext = SDL_GL_CreateContext(sdlWindow);
+                    if (!sdlGLContext)
+                    {
+                        throw std::runtime_error(ftk::Format("Cannot create OpenGL context: {0}").
+                            arg(SDL_GetError()));
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    if (logSystem)
+                    {
+                        logSystem->print(
+                            "tl::usd::Render",
+                            e.what(),
+                            ftk::LogType::Error);
+                    }
+                }
+
+                if (!sdlWindow || !sdlGLContext)
+                {
+                    if (sdlGLContext)
+                    {
+                        SDL_GL_DeleteContext(sdlGLContext);
+                        sdlGLContext = nullptr;
+                    }
+                    if (sdlWindow)
+                    {
+                        SDL_DestroyWindow(sdlWindow);
+                        sdlWindow = nullptr;
+                    }
+                    return false;
+                }
+                return true;
+            }
+        }
+
+        bool Render::_addThread()
+        {
+            FTK_P();
+            auto thread = std::make_unique<Private::Thread>();
+            thread->index = p.threads.size();
+            thread->logTimer = std::chrono::steady_clock::now();
+#if defined(__APPLE__)
+            // Windows can only be created on the main thread, so the one
+            // render thread there is gets its context from _init(). The
+            // context that was current here is put back.
+            SDL_Window* sdlWindow = SDL_GL_GetCurrentWindow();
+            SDL_GLContext sdlGLContext = SDL_GL_GetCurrentContext();
+            const bool valid = createContext(
+                thread->sdlWindow,
+                thread->sdlGLContext,
+                p.logSystem.lock());
+            SDL_GL_MakeCurrent(sdlWindow, sdlGLContext);
+            if (!valid)
+            {
+                return false;
+            }
+#endif // __APPLE__
+
+            // Elsewhere each thread creates its own context, so that nothing
+            // is created on, or made current on, the thread that asked.
+            std::promise<bool> created;
+            auto future = created.get_future();
+            Private::Thread* t = thread.get();
+            t->thread = std::thread(
+                [this, t, created = std::move(created)]() mutable
+                {
+                    FTK_P();
+#if defined(__APPLE__)
+                    SDL_GL_MakeCurrent(t->sdlWindow, t->sdlGLContext);
+                    created.set_value(true);
+#else // __APPLE__
+                    const bool valid = createContext(
+                        t->sdlWindow,
+                        t->sdlGLContext,
+                        p.logSystem.lock());
+                    created.set_value(valid);
+                    if (!valid)
+                    {
+                        return;
+                    }
+#endif // __APPLE__
+                    _run(t->index);
+                    t->stageCache.clear();
+                    SDL_GL_MakeCurrent(t->sdlWindow, nullptr);
+                });
+            if (!future.get())
+            {
+                t->thread.join();
+                return false;
+            }
+            p.threads.push_back(std::move(thread));
+            return true;
+        }
+
+        void Render::_threadsUpdate(const IOOptions& options)
+        {
+            FTK_P();
+            size_t threadCount = 1;
+            if (auto i = options.find("USD/RenderThreadCount");
+                i != options.end())
+            {
+                threadCount = std::max(1LL, std::atoll(i->second.c_str()));
+            }
+#if defined(__APPLE__)
+            // Windows can only be created on the main thread, which the
+            // requests do not come from.
+            threadCount = 1;
+#endif // __APPLE__
+            {
+                std::unique_lock<std::mutex> lock(p.mutex.mutex);
+                p.mutex.threadCount = threadCount;
+            }
+            std::unique_lock<std::mutex> lock(p.threadsMutex);
+            while (p.running && p.threads.size() < threadCount)
+            {
+                if (!_addThread())
+                {
+                    // Render with the threads there are.
+                    std::unique_lock<std::mutex> lock(p.mutex.mutex);
+                    p.mutex.threadCount = p.threads.size();
+                    break;
+                }
+            }
+        }
         
         std::future<IOInfo> Render::getInfo(
             int64_t id,
@@ -277,11 +413,13 @@ namespace tl
             }
             if (valid)
             {
-                p.thread.cv.notify_one();
+                _threadsUpdate(options);
+                p.cv.notify_all();
             }
             else
             {
                 request->promise.set_value(IOInfo());
+                notifyCompletion(request->completion);
             }
             return future;
         }
@@ -310,11 +448,13 @@ namespace tl
             }
             if (valid)
             {
-                p.thread.cv.notify_one();
+                _threadsUpdate(options);
+                p.cv.notify_all();
             }
             else
             {
                 request->promise.set_value(VideoData());
+                notifyCompletion(request->completion);
             }
             return future;
         }
@@ -356,10 +496,12 @@ namespace tl
             for (auto& request : infoRequests)
             {
                 request->promise.set_value(IOInfo());
+                notifyCompletion(request->completion);
             }
             for (auto& request : requests)
             {
                 request->promise.set_value(VideoData());
+                notifyCompletion(request->completion);
             }
         }
                         
@@ -500,9 +642,14 @@ namespace tl
             }
         }
         
-        void Render::_run()
+        void Render::_run(size_t index)
         {
             FTK_P();
+            Private::Thread* thread = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(p.threadsMutex);
+                thread = p.threads[index].get();
+            }
                         
             TfDiagnosticMgr::GetInstance().SetQuiet(true);
 
@@ -511,21 +658,23 @@ namespace tl
             size_t stageCacheCount = 10;
             size_t diskCacheByteCount = 0;
             int renderWidth = 1920;
-            while (p.thread.running)
+            while (p.running)
             {
-                // Check requests.
+                // Check requests. Threads past the current count stay idle
+                // rather than stopping, since they may be asked for again.
                 std::shared_ptr<Private::InfoRequest> infoRequest;
                 std::shared_ptr<Private::Request> request;
                 {
                     std::unique_lock<std::mutex> lock(p.mutex.mutex);
-                    if (p.thread.cv.wait_for(
+                    if (p.cv.wait_for(
                         lock,
                         std::chrono::milliseconds(5),
-                        [this]
+                        [this, index]
                         {
                             return
-                                !_p->mutex.infoRequests.empty() ||
-                                !_p->mutex.requests.empty();
+                                index < _p->mutex.threadCount &&
+                                (!_p->mutex.infoRequests.empty() ||
+                                !_p->mutex.requests.empty());
                         }))
                     {
                         if (!p.mutex.infoRequests.empty())
@@ -561,43 +710,48 @@ namespace tl
                 {
                     diskCacheByteCount = std::atoi(i->second.c_str()) * ftk::gigabyte;
                 }
-                p.thread.stageCache.setMax(stageCacheCount);
-                p.thread.diskCache.setMax(diskCacheByteCount);
-                if (diskCacheByteCount > 0 && !p.thread.tmpDir)
+                thread->stageCache.setMax(stageCacheCount);
                 {
-                    try
+                    std::unique_lock<std::mutex> lock(p.diskCache.mutex);
+                    p.diskCache.cache.setMax(diskCacheByteCount);
+                    if (diskCacheByteCount > 0 && !p.diskCache.tmpDir)
                     {
-                        p.thread.tmpDir.reset(new ftk::TmpDir);
-                        if (auto logSystem = p.logSystem.lock())
+                        try
                         {
-                            logSystem->print(
-                                "tl::usd::Render",
-                                ftk::Format(
-                                    "\n"
-                                    "    * Temp directory: {0}\n"
-                                    "    * Disk cache: {1}GB").
-                                arg(p.thread.tmpDir->getPath()).
-                                arg(diskCacheByteCount / ftk::gigabyte));
+                            p.diskCache.tmpDir.reset(new ftk::TmpDir);
+                            if (auto logSystem = p.logSystem.lock())
+                            {
+                                logSystem->print(
+                                    "tl::usd::Render",
+                                    ftk::Format(
+                                        "\n"
+                                        "    * Temp directory: {0}\n"
+                                        "    * Disk cache: {1}GB").
+                                    arg(p.diskCache.tmpDir->getPath()).
+                                    arg(diskCacheByteCount / ftk::gigabyte));
+                            }
                         }
-                    }
-                    catch (const std::exception& e)
-                    {
-                        // Couldn't create the temp dir: disable the disk cache
-                        // for this run rather than letting it escape the thread.
-                        diskCacheByteCount = 0;
-                        p.thread.diskCache.setMax(0);
-                        if (auto logSystem = p.logSystem.lock())
+                        catch (const std::exception& e)
                         {
-                            logSystem->print(
-                                "tl::usd::Render",
-                                e.what(),
-                                ftk::LogType::Error);
+                            // Couldn't create the temp dir: disable the disk
+                            // cache for this run rather than letting it escape
+                            // the thread.
+                            diskCacheByteCount = 0;
+                            p.diskCache.cache.setMax(0);
+                            if (auto logSystem = p.logSystem.lock())
+                            {
+                                logSystem->print(
+                                    "tl::usd::Render",
+                                    e.what(),
+                                    ftk::LogType::Error);
+                            }
                         }
                     }
-                }
-                else if (0 == diskCacheByteCount && p.thread.tmpDir)
-                {
-                    p.thread.tmpDir.reset();
+                    else if (0 == diskCacheByteCount && p.diskCache.tmpDir)
+                    {
+                        p.diskCache.cache.clear();
+                        p.diskCache.tmpDir.reset();
+                    }
                 }
 
                 // Handle information requests.
@@ -619,10 +773,10 @@ namespace tl
                     {
                         const std::string fileName = infoRequest->path.getFileName(true);
                         Private::StageCacheItem stageCacheItem;
-                        if (!p.thread.stageCache.get(fileName, stageCacheItem))
+                        if (!thread->stageCache.get(fileName, stageCacheItem))
                         {
                             _open(fileName, stageCacheItem.stage, stageCacheItem.engine);
-                            p.thread.stageCache.add(fileName, stageCacheItem);
+                            thread->stageCache.add(fileName, stageCacheItem);
                         }
                         if (stageCacheItem.stage)
                         {
@@ -666,6 +820,7 @@ namespace tl
                     // Always fulfil the promise so the caller never hangs, even
                     // when _open()/camera framing throws on a malformed stage.
                     infoRequest->promise.set_value(info);
+                    notifyCompletion(infoRequest->completion);
                 }
 
                 // Check the disk cache.
@@ -676,8 +831,13 @@ namespace tl
                         request->path,
                         request->time,
                         ioOptions);
-                    if (diskCacheByteCount > 0 &&
-                        p.thread.diskCache.get(cacheKey, diskCacheItem))
+                    bool cached = false;
+                    if (diskCacheByteCount > 0)
+                    {
+                        std::unique_lock<std::mutex> lock(p.diskCache.mutex);
+                        cached = p.diskCache.cache.get(cacheKey, diskCacheItem);
+                    }
+                    if (cached)
                     {
                         std::shared_ptr<ftk::Image> image;
                         try
@@ -707,6 +867,7 @@ namespace tl
                         videoData.time = request->time;
                         videoData.image = image;
                         request->promise.set_value(videoData);
+                        notifyCompletion(request->completion);
                         request.reset();
                     }
                 }
@@ -724,10 +885,10 @@ namespace tl
                         // Check the stage cache for a previously opened stage.
                         const std::string fileName = request->path.getFileName(true);
                         Private::StageCacheItem stageCacheItem;
-                        if (!p.thread.stageCache.get(fileName, stageCacheItem))
+                        if (!thread->stageCache.get(fileName, stageCacheItem))
                         {
                             _open(fileName, stageCacheItem.stage, stageCacheItem.engine);
-                            p.thread.stageCache.add(fileName, stageCacheItem);
+                            thread->stageCache.add(fileName, stageCacheItem);
                         }
                         if (stageCacheItem.stage && stageCacheItem.engine)
                         {
@@ -827,7 +988,7 @@ namespace tl
                                 HdxColorCorrectionTokens->disabled;
                             const UsdPrim& pseudoRoot = stageCacheItem.stage->GetPseudoRoot();
                             unsigned int sleepTime = 10;
-                            while (p.thread.running)
+                            while (p.running)
                             {
                                 stageCacheItem.engine->Render(pseudoRoot, renderParams);
                                 if (stageCacheItem.engine->IsConverged())
@@ -886,20 +1047,36 @@ namespace tl
                                 }
                             }
 
-                            // Add the rendered frame to the disk cache.
-                            if (diskCacheByteCount > 0 && p.thread.tmpDir && image)
+                            // Add the rendered frame to the disk cache. The file
+                            // is written outside of the lock so that the other
+                            // threads are not held up by it.
+                            std::string tmpDir;
+                            if (diskCacheByteCount > 0 && image)
+                            {
+                                std::unique_lock<std::mutex> lock(p.diskCache.mutex);
+                                if (p.diskCache.tmpDir)
+                                {
+                                    tmpDir = p.diskCache.tmpDir->getPath().u8string();
+                                }
+                            }
+                            if (!tmpDir.empty())
                             {
                                 auto diskCacheItem = std::make_shared<Private::DiskCacheItem>();
                                 diskCacheItem->fileName = ftk::Format("{0}/{1}.img").
-                                    arg(p.thread.tmpDir->getPath().u8string()).
+                                    arg(tmpDir).
                                     arg(diskCacheItem);
-                                auto tempFile = ftk::FileIO::create(diskCacheItem->fileName, ftk::FileMode::Write);
-                                tempFile->writeU16(image->getWidth());
-                                tempFile->writeU16(image->getHeight());
-                                tempFile->writeU32(static_cast<uint32_t>(image->getType()));
-                                const size_t byteCount = image->getInfo().getByteCount();
-                                tempFile->write(image->getData(), byteCount);
-                                p.thread.diskCache.add(cacheKey, diskCacheItem, byteCount);
+                                {
+                                    auto tempFile = ftk::FileIO::create(diskCacheItem->fileName, ftk::FileMode::Write);
+                                    tempFile->writeU16(image->getWidth());
+                                    tempFile->writeU16(image->getHeight());
+                                    tempFile->writeU32(static_cast<uint32_t>(image->getType()));
+                                    tempFile->write(image->getData(), image->getInfo().getByteCount());
+                                }
+                                std::unique_lock<std::mutex> lock(p.diskCache.mutex);
+                                p.diskCache.cache.add(
+                                    cacheKey,
+                                    diskCacheItem,
+                                    image->getInfo().getByteCount());
                             }
                         }
                     }
@@ -918,34 +1095,47 @@ namespace tl
                     videoData.time = request->time;
                     videoData.image = image;
                     request->promise.set_value(videoData);
+                    notifyCompletion(request->completion);
                 }
 
-                // Logging.
+                // Logging, from the first thread only.
+                if (0 == index)
                 {
                     const auto now = std::chrono::steady_clock::now();
-                    const std::chrono::duration<float> diff = now - p.thread.logTimer;
+                    const std::chrono::duration<float> diff = now - thread->logTimer;
                     if (diff.count() > 10.F)
                     {
-                        p.thread.logTimer = now;
+                        thread->logTimer = now;
                         if (auto logSystem = p.logSystem.lock())
                         {
                             size_t requestsSize = 0;
+                            size_t threadCount = 0;
                             {
                                 std::unique_lock<std::mutex> lock(p.mutex.mutex);
                                 requestsSize = p.mutex.requests.size();
+                                threadCount = p.mutex.threadCount;
+                            }
+                            size_t diskCacheSize = 0;
+                            size_t diskCacheMax = 0;
+                            {
+                                std::unique_lock<std::mutex> lock(p.diskCache.mutex);
+                                diskCacheSize = p.diskCache.cache.getSize();
+                                diskCacheMax = p.diskCache.cache.getMax();
                             }
                             logSystem->print(
                                 "tl::usd::Render",
                                 ftk::Format(
                                     "\n"
                                     "    * Requests: {0}\n"
-                                    "    * Stage cache: {1}/{2}\n"
-                                    "    * Disk cache: {3}/{4}GB").
+                                    "    * Render threads: {1}\n"
+                                    "    * Stage cache: {2}/{3}\n"
+                                    "    * Disk cache: {4}/{5}GB").
                                 arg(requestsSize).
-                                arg(p.thread.stageCache.getSize()).
-                                arg(p.thread.stageCache.getMax()).
-                                arg(p.thread.diskCache.getSize() / ftk::gigabyte).
-                                arg(p.thread.diskCache.getMax() / ftk::gigabyte));
+                                arg(threadCount).
+                                arg(thread->stageCache.getSize()).
+                                arg(thread->stageCache.getMax()).
+                                arg(diskCacheSize / ftk::gigabyte).
+                                arg(diskCacheMax / ftk::gigabyte));
                         }
                     }
                 }
@@ -966,10 +1156,12 @@ namespace tl
             for (auto& request : infoRequests)
             {
                 request->promise.set_value(IOInfo());
+                notifyCompletion(request->completion);
             }
             for (auto& request : requests)
             {
                 request->promise.set_value(VideoData());
+                notifyCompletion(request->completion);
             }
         }
     }
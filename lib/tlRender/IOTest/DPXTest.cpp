@@ -0,0 +1,317 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/IOTest/DPXTest.h>
+
+#include <tlRender/IO/DPX.h>
+#include <tlRender/IO/System.h>
+#if defined(TLRENDER_OIIO)
+#include <tlRender/IO/OIIO.h>
+#endif // TLRENDER_OIIO
+
+#include <ftk/Core/Assert.h>
+#include <ftk/Core/Context.h>
+#include <ftk/Core/FileIO.h>
+#include <ftk/Core/Format.h>
+
+#include <chrono>
+#include <cstring>
+
+namespace tl
+{
+    namespace io_tests
+    {
+        DPXTest::DPXTest(const std::shared_ptr<ftk::Context>& context) :
+            ITest(context, "io_tests::DPXTest")
+        {}
+
+        std::shared_ptr<DPXTest> DPXTest::create(const std::shared_ptr<ftk::Context>& context)
+        {
+            return std::shared_ptr<DPXTest>(new DPXTest(context));
+        }
+
+        namespace
+        {
+            void put16(std::vector<uint8_t>& data, size_t offset, uint16_t value, bool msb)
+            {
+                data[offset + (msb ? 0 : 1)] = value >> 8;
+                data[offset + (msb ? 1 : 0)] = value & 0xff;
+            }
+
+            void put32(std::vector<uint8_t>& data, size_t offset, uint32_t value, bool msb)
+            {
+                for (size_t i = 0; i < 4; ++i)
+                {
+                    data[offset + (msb ? i : 3 - i)] = (value >> (24 - i * 8)) & 0xff;
+                }
+            }
+
+            //! A DPX file with one image element and the given pixel data.
+            std::vector<uint8_t> dpx(
+                const ftk::Size2I& size,
+                int descriptor,
+                int bitDepth,
+                int packing,
+                bool msb,
+                const std::vector<uint8_t>& pixels)
+            {
+                std::vector<uint8_t> out(2048, 0);
+                put32(out, 0, 0x53445058, msb);
+                put32(out, 4, 2048, msb);
+                std::memcpy(out.data() + 8, "V2.0", 4);
+                put32(out, 16, 2048 + pixels.size(), msb);
+                put32(out, 24, 1664, msb);
+                put32(out, 28, 384, msb);
+                std::memcpy(out.data() + 160, "DPXTest", 7);
+                put16(out, 768, 0, msb);
+                put16(out, 770, 1, msb);
+                put32(out, 772, size.w, msb);
+                put32(out, 776, size.h, msb);
+                out[800] = descriptor;
+                out[801] = 1;
+                out[802] = 1;
+                out[803] = bitDepth;
+                put16(out, 804, packing, msb);
+                put16(out, 806, 0, msb);
+                put32(out, 808, 2048, msb);
+                put32(out, 812, 0, msb);
+                put32(out, 816, 0, msb);
+                out.insert(out.end(), pixels.begin(), pixels.end());
+                return out;
+            }
+
+            //! A 10-bit RGB Cineon file with the given pixel data.
+            std::vector<uint8_t> cineon(
+                const ftk::Size2I& size,
+                const std::vector<uint8_t>& pixels)
+            {
+                std::vector<uint8_t> out(1024, 0);
+                put32(out, 0, 0x802a5fd7, true);
+                put32(out, 4, 1024, true);
+                put32(out, 20, 1024 + pixels.size(), true);
+                out[192] = 0;
+                out[193] = 3;
+                for (size_t c = 0; c < 3; ++c)
+                {
+                    out[196 + c * 28 + 1] = c + 1;
+                    out[198 + c * 28] = 10;
+                    put32(out, 200 + c * 28, size.w, true);
+                    put32(out, 204 + c * 28, size.h, true);
+                }
+                out[680] = 0;
+                out[681] = 5;
+                out.insert(out.end(), pixels.begin(), pixels.end());
+                return out;
+            }
+
+            uint32_t red(size_t i) { return (i * 7) & 1023; }
+            uint32_t green(size_t i) { return (i * 13 + 100) & 1023; }
+            uint32_t blue(size_t i) { return (i * 29 + 500) & 1023; }
+
+            //! 10-bit RGB words as a file holds them.
+            std::vector<uint8_t> words(size_t count, bool methodB, bool msb)
+            {
+                std::vector<uint8_t> out(count * 4);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const uint32_t value = methodB ?
+                        (red(i) << 20 | green(i) << 10 | blue(i)) :
+                        (red(i) << 22 | green(i) << 12 | blue(i) << 2);
+                    put32(out, i * 4, value, msb);
+                }
+                return out;
+            }
+
+            uint16_t to16(uint32_t value) { return value << 6 | value >> 4; }
+
+            //! Check that an image holds the words above, unpacked to 16-bit
+            //! RGB.
+            bool isWords(const std::shared_ptr<ftk::Image>& image)
+            {
+                bool out = image && ftk::ImageType::RGB_U16 == image->getType();
+                const size_t count = out ? image->getWidth() * image->getHeight() : 0;
+                const uint16_t* p = out ?
+                    reinterpret_cast<const uint16_t*>(image->getData()) :
+                    nullptr;
+                for (size_t i = 0; i < count && out; ++i, p += 3)
+                {
+                    out =
+                        p[0] == to16(red(i)) &&
+                        p[1] == to16(green(i)) &&
+                        p[2] == to16(blue(i));
+                }
+                return out;
+            }
+        }
+
+        void DPXTest::run()
+        {
+            _words();
+            _layouts();
+            _errors();
+            _benchmark();
+        }
+
+        ftk::Path DPXTest::_write(
+            const std::string& fileName,
+            const std::vector<uint8_t>& data)
+        {
+            const ftk::Path out((_getTempDir() / fileName).u8string());
+            auto fileIO = ftk::FileIO::create(out.get(), ftk::FileMode::Write);
+            fileIO->write(data.data(), data.size());
+            return out;
+        }
+
+        void DPXTest::_words()
+        {
+            auto readSystem = _context->getSystem<ReadSystem>();
+            auto plugin = readSystem->getPlugin<dpx::ReadPlugin>();
+            FTK_CHECK(plugin);
+            FTK_CHECK(readSystem->getPlugin(ftk::Path("test.dpx")) == plugin);
+            FTK_CHECK(readSystem->getPlugin(ftk::Path("test.cin")) == plugin);
+            auto decode = plugin->decode();
+
+            // An odd width, so the rows end part way through a vector, in
+            // both byte orders and both methods.
+            const ftk::Size2I size(7, 3);
+            const size_t count = size.w * size.h;
+            for (const bool msb : { true, false })
+            {
+                for (const bool methodB : { false, true })
+                {
+                    const auto data = dpx(size, 50, 10, methodB ? 2 : 1, msb, words(count, methodB, msb));
+                    const ftk::Path path = _write(ftk::Format("DPXTest {0} {1}.0.dpx").
+                        arg(msb ? "MSB" : "LSB").
+                        arg(methodB ? "B" : "A"), data);
+                    const auto info = decode->getInfo(path.get());
+                    FTK_CHECK(1 == info.video.size());
+                    FTK_CHECK(size == info.video[0].size);
+                    FTK_CHECK(ftk::ImageType::RGB_U16 == info.video[0].type);
+                    FTK_CHECK(info.video[0].layout.mirror.y);
+                    FTK_CHECK("DPXTest" == info.tags.at("Creator"));
+                    const auto videoData = decode->readVideo(
+                        path.get(), nullptr, OTIO_NS::RationalTime(0.0, 24.0));
+                    FTK_CHECK(isWords(videoData.image));
+
+                    // From memory as well as from the mapped file.
+                    const ftk::MemFile memory(nullptr, data.data(), data.size());
+                    FTK_CHECK(isWords(decode->readVideo(
+                        path.get(), &memory, OTIO_NS::RationalTime(0.0, 24.0)).image));
+                }
+            }
+
+            // Cineon.
+            const ftk::Path path = _write("DPXTest.0.cin", cineon(size, words(count, false, true)));
+            const auto videoData = decode->readVideo(
+                path.get(), nullptr, OTIO_NS::RationalTime(0.0, 24.0));
+            FTK_CHECK(isWords(videoData.image));
+        }
+
+        void DPXTest::_layouts()
+        {
+            auto readSystem = _context->getSystem<ReadSystem>();
+            auto decode = readSystem->getPlugin<dpx::ReadPlugin>()->decode();
+
+            // 16-bit RGB, stored in the other byte order from the machine
+            // half the time.
+            const ftk::Size2I size(5, 2);
+            for (const bool msb : { true, false })
+            {
+                std::vector<uint8_t> pixels(size.w * size.h * 3 * 2);
+                for (size_t i = 0; i < pixels.size() / 2; ++i)
+                {
+                    put16(pixels, i * 2, i * 257, msb);
+                }
+                const ftk::Path path = _write(
+                    ftk::Format("DPXTest 16 {0}.0.dpx").arg(msb ? "MSB" : "LSB"),
+                    dpx(size, 50, 16, 1, msb, pixels));
+                const auto image = decode->readVideo(
+                    path.get(), nullptr, OTIO_NS::RationalTime(0.0, 24.0)).image;
+                FTK_CHECK(ftk::ImageType::RGB_U16 == image->getType());
+                const uint16_t* p = reinterpret_cast<const uint16_t*>(image->getData());
+                for (size_t i = 0; i < pixels.size() / 2; ++i)
+                {
+                    FTK_CHECK(p[i] == static_cast<uint16_t>(i * 257));
+                }
+            }
+
+            // 8-bit RGBA.
+            {
+                std::vector<uint8_t> pixels(size.w * size.h * 4);
+                for (size_t i = 0; i < pixels.size(); ++i)
+                {
+                    pixels[i] = i;
+                }
+                const ftk::Path path = _write("DPXTest 8.0.dpx", dpx(size, 51, 8, 1, true, pixels));
+                const auto image = decode->readVideo(
+                    path.get(), nullptr, OTIO_NS::RationalTime(0.0, 24.0)).image;
+                FTK_CHECK(ftk::ImageType::RGBA_U8 == image->getType());
+                FTK_CHECK(0 == std::memcmp(image->getData(), pixels.data(), pixels.size()));
+            }
+        }
+
+        void DPXTest::_errors()
+        {
+            // Without a fallback, a layout that is not read natively is an
+            // error, as are a truncated file and a missing one.
+            auto decode = dpx::Decode::create();
+            const ftk::Size2I size(4, 4);
+            const std::vector<ftk::Path> paths =
+            {
+                _write("DPXTest 12.0.dpx", dpx(size, 50, 12, 1, true, std::vector<uint8_t>(size.w * size.h * 6))),
+                _write("DPXTest Truncated.0.dpx", dpx(size, 50, 10, 1, true, words(size.w, false, true))),
+                _write("DPXTest Header.0.dpx", std::vector<uint8_t>({ 'S', 'D', 'P', 'X', 0, 0, 0, 0 })),
+                ftk::Path((_getTempDir() / "DPXTest Missing.0.dpx").u8string())
+            };
+            for (const auto& path : paths)
+            {
+                try
+                {
+                    decode->readVideo(path.get(), nullptr, OTIO_NS::RationalTime(0.0, 24.0));
+                    FTK_CHECK(false);
+                }
+                catch (const std::exception& e)
+                {
+                    _print(e.what());
+                }
+            }
+        }
+
+        void DPXTest::_benchmark()
+        {
+            // A 2K full aperture scan, read the native way and, when it is
+            // built, through OIIO.
+            const ftk::Size2I size(2048, 1556);
+            const ftk::Path path = _write(
+                "DPXTest Benchmark.0.dpx",
+                dpx(size, 50, 10, 1, true, words(size.w * size.h, false, true)));
+            const size_t count = 24;
+            std::vector<std::pair<std::string, std::shared_ptr<IDecode> > > decodes;
+            decodes.push_back({ "Native", dpx::Decode::create() });
+#if defined(TLRENDER_OIIO)
+            decodes.push_back({ "OIIO", oiio::Decode::create() });
+#endif // TLRENDER_OIIO
+            for (const auto& decode : decodes)
+            {
+                try
+                {
+                    const auto t0 = std::chrono::steady_clock::now();
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        decode.second->readVideo(
+                            path.get(), nullptr, OTIO_NS::RationalTime(i, 24.0));
+                    }
+                    const std::chrono::duration<float> diff =
+                        std::chrono::steady_clock::now() - t0;
+                    _print(ftk::Format("{0}: {1} frames/sec").
+                        arg(decode.first).
+                        arg(count / diff.count(), 2));
+                }
+                catch (const std::exception& e)
+                {
+                    _error(ftk::Format("{0}: {1}").arg(decode.first).arg(e.what()));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include <tlRender/IO/Read.h>
+
+#include <ftk/TestLib/ITest.h>
+
+namespace tl
+{
+    namespace io_tests
+    {
+        class DPXTest : public ftk::test::ITest
+        {
+        protected:
+            DPXTest(const std::shared_ptr<ftk::Context>&);
+
+        public:
+            static std::shared_ptr<DPXTest> create(const std::shared_ptr<ftk::Context>&);
+
+            void run() override;
+
+        private:
+            //! Write the given bytes to a file in the temporary directory.
+            ftk::Path _write(const std::string& fileName, const std::vector<uint8_t>&);
+
+            void _words();
+            void _layouts();
+            void _errors();
+            void _benchmark();
+        };
+    }
+}
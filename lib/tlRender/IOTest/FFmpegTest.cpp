@@ -17,6 +17,7 @@
 #include <array>
 #include <chrono>
 #include <cmath>
+#include <cstring>
 #include <future>
 #include <sstream>
 
@@ -39,6 +40,8 @@ namespace tl
             _io();
             _audio();
             _split();
+            _reverse();
+            _segments();
             _commandLine();
             _pixelAspectRatio();
         }
@@ -1093,5 +1096,201 @@ namespace tl
                 _error(e.what());
             }
         }
-    }
+    
+        namespace
+        {
+            // Write frames of a flat level each, a different one for each
+            // frame, so that a frame read back can be told from the others.
+            void writeLevels(
+                const std::shared_ptr<ffmpeg::WritePlugin>& writePlugin,
+                const ftk::Path& path,
+                const ftk::ImageInfo& imageInfo,
+                size_t frameCount,
+                const IOOptions& options)
+            {
+                IOInfo info;
+                info.video.push_back(imageInfo);
+                info.videoTime = OTIO_NS::TimeRange(
+                    OTIO_NS::RationalTime(0.0, 24.0),
+                    OTIO_NS::RationalTime(static_cast<double>(frameCount), 24.0));
+                auto write = writePlugin->write(path, info, options);
+                for (size_t i = 0; i < frameCount; ++i)
+                {
+                    auto image = ftk::Image::create(imageInfo);
+                    memset(image->getData(), static_cast<int>(i * 5), image->getByteCount());
+                    write->writeVideo(OTIO_NS::RationalTime(static_cast<double>(i), 24.0), image);
+                }
+                write->finish();
+            }
+        }
+
+        void FFmpegTest::_reverse()
+        {
+            // Reading a long GOP backwards is served from the frames kept
+            // of each GOP, and has to give the same frames as reading it
+            // forwards: a frame from the wrong place in the GOP is the bug
+            // to look for. MPEG-4 puts a key frame every 12 frames.
+            auto readSystem = _context->getSystem<ReadSystem>();
+            auto readPlugin = readSystem->getPlugin<ffmpeg::ReadPlugin>();
+            auto writeSystem = _context->getSystem<WriteSystem>();
+            auto writePlugin = writeSystem->getPlugin<ffmpeg::WritePlugin>();
+
+            const size_t frameCount = 48;
+            const auto imageInfo = writePlugin->getInfo(
+                ftk::ImageInfo(ftk::Size2I(80, 60), ftk::ImageType::RGB_U8));
+            const ftk::Path path((_getTempDir() / "FFmpegReverse.mp4").u8string());
+            IOOptions options;
+            options["FFmpeg/Codec"] = "mpeg4";
+            try
+            {
+                writeLevels(writePlugin, path, imageInfo, frameCount, options);
+            }
+            catch (const std::exception& e)
+            {
+                _print(ftk::Format("_reverse: skipped: {0}").arg(e.what()));
+                return;
+            }
+
+            try
+            {
+                std::vector<uint8_t> forward;
+                {
+                    auto read = readPlugin->videoRead(path, options);
+                    const auto info = read->getInfo().get();
+                    FTK_CHECK(info.videoTime.has_value());
+                    for (size_t i = 0; i < frameCount; ++i)
+                    {
+                        const auto data = read->readVideo(
+                            info.videoTime->start_time() +
+                            OTIO_NS::RationalTime(static_cast<double>(i), 24.0)).get();
+                        FTK_CHECK(data.image);
+                        forward.push_back(data.image ? data.image->getData()[0] : 0);
+                    }
+                }
+                for (size_t i = 1; i < frameCount; ++i)
+                {
+                    FTK_CHECK(forward[i] != forward[i - 1]);
+                }
+
+                // Going backwards is recognized from the access hint, or
+                // without one from the requests; a cache too small in bytes
+                // for a frame is the same as none.
+                for (const auto& gopCache : std::vector<std::pair<std::string, std::string> >({
+                    { "64", "256" },
+                    { "4", "256" },
+                    { "0", "256" },
+                    { "64", "0" } }))
+                {
+                    for (const bool hint : { false, true })
+                    {
+                        _print(ftk::Format("_reverse: GOP cache size: {0}, {1}MB, hint: {2}").
+                            arg(gopCache.first).
+                            arg(gopCache.second).
+                            arg(hint ? "Reverse" : "none"));
+                        IOOptions readOptions = options;
+                        readOptions["FFmpeg/GOPCacheSize"] = gopCache.first;
+                        readOptions["FFmpeg/GOPCacheMB"] = gopCache.second;
+                        IOOptions requestOptions;
+                        if (hint)
+                        {
+                            requestOptions["IO/Access"] = to_string(AccessHint::Reverse);
+                        }
+                        auto read = readPlugin->videoRead(path, readOptions);
+                        const auto info = read->getInfo().get();
+                        std::vector<uint8_t> reverse(frameCount, 0);
+                        for (size_t i = frameCount; i > 0; --i)
+                        {
+                            const auto data = read->readVideo(
+                                info.videoTime->start_time() +
+                                OTIO_NS::RationalTime(static_cast<double>(i - 1), 24.0),
+                                requestOptions).get();
+                            FTK_CHECK(data.image);
+                            reverse[i - 1] = data.image ? data.image->getData()[0] : 0;
+                        }
+                        FTK_CHECK(forward == reverse);
+
+                        // And forwards again from the middle.
+                        const auto data = read->readVideo(
+                            info.videoTime->start_time() +
+                            OTIO_NS::RationalTime(static_cast<double>(frameCount / 2), 24.0)).get();
+                        FTK_CHECK(data.image && forward[frameCount / 2] == data.image->getData()[0]);
+                    }
+                }
+            }
+            catch (const std::exception& e)
+            {
+                _error(e.what());
+            }
+        }
+
+        void FFmpegTest::_segments()
+        {
+            // An intra-only movie read by several decoders, with all of the
+            // requests made at once as the player does, has to give the same
+            // frames as one decoder. MJPEG is intra-only.
+            auto readSystem = _context->getSystem<ReadSystem>();
+            auto readPlugin = readSystem->getPlugin<ffmpeg::ReadPlugin>();
+            auto writeSystem = _context->getSystem<WriteSystem>();
+            auto writePlugin = writeSystem->getPlugin<ffmpeg::WritePlugin>();
+
+            const size_t frameCount = 30;
+            const auto imageInfo = writePlugin->getInfo(
+                ftk::ImageInfo(ftk::Size2I(80, 60), ftk::ImageType::RGB_U8));
+            const ftk::Path path((_getTempDir() / "FFmpegSegments.mov").u8string());
+            IOOptions options;
+            options["FFmpeg/Codec"] = "mjpeg";
+            try
+            {
+                writeLevels(writePlugin, path, imageInfo, frameCount, options);
+            }
+            catch (const std::exception& e)
+            {
+                _print(ftk::Format("_segments: skipped: {0}").arg(e.what()));
+                return;
+            }
+
+            try
+            {
+                std::vector<uint8_t> levels[2];
+                for (size_t segmentCount : { 1, 3 })
+                {
+                    IOOptions readOptions = options;
+                    readOptions["FFmpeg/SegmentCount"] = ftk::Format("{0}").arg(segmentCount);
+                    readOptions["FFmpeg/SegmentSize"] = "4";
+                    auto read = readPlugin->videoRead(path, readOptions);
+                    const auto info = read->getInfo().get();
+                    FTK_CHECK(info.videoTime.has_value());
+                    std::vector<std::future<VideoData> > futures;
+                    for (size_t i = 0; i < frameCount; ++i)
+                    {
+                        futures.push_back(read->readVideo(
+                            info.videoTime->start_time() +
+                            OTIO_NS::RationalTime(static_cast<double>(i), 24.0)));
+                    }
+                    // And one out of order, as after a seek.
+                    futures.push_back(read->readVideo(
+                        info.videoTime->start_time() +
+                        OTIO_NS::RationalTime(static_cast<double>(frameCount / 2), 24.0)));
+                    auto& out = levels[segmentCount > 1 ? 1 : 0];
+                    for (size_t i = 0; i < futures.size(); ++i)
+                    {
+                        const auto data = futures[i].get();
+                        FTK_CHECK(data.image);
+                        out.push_back(data.image ? data.image->getData()[0] : 0);
+                    }
+                    FTK_CHECK(0 == read->getErrorCount());
+                }
+                FTK_CHECK(levels[0] == levels[1]);
+                FTK_CHECK(levels[0][frameCount / 2] == levels[0][frameCount]);
+                for (size_t i = 1; i < frameCount; ++i)
+                {
+                    FTK_CHECK(levels[0][i] != levels[0][i - 1]);
+                }
+            }
+            catch (const std::exception& e)
+            {
+                _error(e.what());
+            }
+        }
+}
 }
@@ -54,6 +54,8 @@ namespace tl
             void _io();
             void _audio();
             void _split();
+            void _reverse();
+            void _segments();
         };
     }
 }
@@ -4,15 +4,18 @@
 #include <tlRender/IOTest/IOTest.h>
 
 #include <tlRender/IO/SeqDecode.h>
+#include <tlRender/IO/SeqPrefetch.h>
 #include <tlRender/IO/System.h>
 
 #include <ftk/Core/Assert.h>
 #include <ftk/Core/Context.h>
+#include <ftk/Core/FileIO.h>
 #include <ftk/Core/Format.h>
 #include <ftk/Core/Image.h>
 #include <ftk/Core/String.h>
 
 #include <atomic>
+#include <chrono>
 #include <cstring>
 #include <map>
 #include <sstream>
@@ -40,6 +43,9 @@ namespace tl
             _missingFrames();
             _seqRange();
             _structural();
+            _frameIndex();
+            _seqPrefetch();
+            _accessHint();
         }
 
         void IOTest::_videoData()
@@ -398,6 +404,7 @@ namespace tl
                 FTK_CHECK(v.missing);
                 FTK_CHECK(v.heldFrom.has_value());
                 FTK_CHECK(2 == v.heldFrom.value());
+                FTK_CHECK(v.standIn.empty());
             }
 
             // A frame that is there says nothing of the sort.
@@ -420,6 +427,11 @@ namespace tl
                 std::vector<uint8_t> zero(v.image->getByteCount(), 0);
                 FTK_CHECK(0 == memcmp(
                     v.image->getData(), zero.data(), zero.size()));
+
+                // Named by what it was made from, the same for every frame
+                // it stands in for.
+                FTK_CHECK(!v.standIn.empty());
+                FTK_CHECK(v.standIn == readFrame(MissingFrames::Black, 4).standIn);
             }
 
             // A frame that is there but half written is missing as far as
@@ -622,5 +634,275 @@ namespace tl
 
             _print("a structural policy leaves the sequence its own length");
         }
+
+        void IOTest::_frameIndex()
+        {
+            {
+                // Frames on either side of a word boundary and far apart,
+                // so that looking back crosses several words.
+                const SeqFrameIndex index(
+                    ftk::RangeI64(10, 300),
+                    { 5, 10, 11, 12, 73, 74, 290, 1000 });
+                FTK_CHECK(6 == index.getCount());
+                FTK_CHECK(!index.contains(5));
+                FTK_CHECK(index.contains(10));
+                FTK_CHECK(index.contains(74));
+                FTK_CHECK(!index.contains(75));
+                FTK_CHECK(!index.contains(1000));
+                FTK_CHECK(10 == index.getPrev(10));
+                FTK_CHECK(10 == index.getPrev(11));
+                FTK_CHECK(12 == index.getPrev(50));
+                FTK_CHECK(73 == index.getPrev(74));
+                FTK_CHECK(74 == index.getPrev(290));
+                FTK_CHECK(290 == index.getPrev(400));
+                const std::vector<ftk::RangeI64> runs =
+                {
+                    ftk::RangeI64(10, 12),
+                    ftk::RangeI64(73, 74),
+                    ftk::RangeI64(290, 290)
+                };
+                FTK_CHECK(runs == index.getRuns());
+                FTK_CHECK(0 == SeqFrameIndex().getCount());
+                FTK_CHECK(7 == SeqFrameIndex().getPrev(7));
+            }
+
+            // A sequence being rendered: the frame held for a gap stays the
+            // same until the frames are looked for again.
+            auto readSystem = _context->getSystem<ReadSystem>();
+            auto writeSystem = _context->getSystem<WriteSystem>();
+            const ftk::Path path(
+                (_getTempDir() / "IOTestIndex.0001.png").u8string());
+            auto writePlugin = writeSystem->getPlugin(path);
+            auto readPlugin = readSystem->getPlugin(path);
+            if (!writePlugin || !readPlugin)
+            {
+                return;
+            }
+            auto decode = readPlugin->decode();
+            FTK_CHECK(decode);
+            IOInfo writeInfo;
+            writeInfo.video.push_back(writePlugin->getInfo(
+                ftk::ImageInfo(ftk::Size2I(16, 16), ftk::ImageType::RGB_U8)));
+            const auto writeFrames = [&](const std::vector<int64_t>& frames)
+                {
+                    auto write = writeSystem->write(path, writeInfo);
+                    for (int64_t frame : frames)
+                    {
+                        write->writeVideo(
+                            OTIO_NS::RationalTime(static_cast<double>(frame), 24.0),
+                            ftk::Image::create(writeInfo.video[0]));
+                    }
+                };
+            writeFrames({ 1, 2 });
+
+            ftk::Path seqPath(path);
+            seqPath.setFrames(ftk::RangeI64(1, 4));
+            IOOptions options;
+            options["SeqIO/DefaultSpeed"] = "24";
+            options["SeqIO/MissingFrames"] = to_string(MissingFrames::Hold);
+            auto seq = SeqDecode::create(seqPath, {}, decode, options);
+            const OTIO_NS::RationalTime time(4.0, 24.0);
+            VideoData v = seq->readVideo(time);
+            FTK_CHECK(v.heldFrom.has_value() && 2 == v.heldFrom.value());
+            FTK_CHECK(2 == seq->getFrames()->getCount());
+
+            writeFrames({ 4 });
+            v = seq->readVideo(time);
+            FTK_CHECK(v.heldFrom.has_value() && 2 == v.heldFrom.value());
+
+            seq->refreshFrames();
+            FTK_CHECK(3 == seq->getFrames()->getCount());
+            v = seq->readVideo(time);
+            FTK_CHECK(v.image);
+            FTK_CHECK(!v.missing);
+
+            // Without being asked to, once the index has stood for a while.
+            writeFrames({ 3 });
+            std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+            v = seq->readVideo(OTIO_NS::RationalTime(3.0, 24.0));
+            FTK_CHECK(v.image);
+            FTK_CHECK(!v.missing);
+            FTK_CHECK(4 == seq->getFrames()->getCount());
+
+            _print("the frame index answers for missing frames");
+        }
+
+        void IOTest::_seqPrefetch()
+        {
+            auto readSystem = _context->getSystem<ReadSystem>();
+            auto writeSystem = _context->getSystem<WriteSystem>();
+            const ftk::Path path(
+                (_getTempDir() / "IOTestPrefetch.0001.png").u8string());
+            auto writePlugin = writeSystem->getPlugin(path);
+            auto readPlugin = readSystem->getPlugin(path);
+            if (!writePlugin || !readPlugin)
+            {
+                return;
+            }
+            auto decode = readPlugin->decode();
+            FTK_CHECK(decode);
+
+            // Each frame filled differently, so that a frame read ahead and
+            // handed to the wrong read shows up.
+            const size_t frameCount = 12;
+            IOInfo writeInfo;
+            writeInfo.video.push_back(writePlugin->getInfo(
+                ftk::ImageInfo(ftk::Size2I(16, 16), ftk::ImageType::RGB_U8)));
+            std::vector<std::shared_ptr<ftk::Image> > images;
+            {
+                auto write = writeSystem->write(path, writeInfo);
+                for (size_t i = 0; i < frameCount; ++i)
+                {
+                    auto image = ftk::Image::create(writeInfo.video[0]);
+                    memset(image->getData(), static_cast<int>(10 + i * 20), image->getByteCount());
+                    write->writeVideo(
+                        OTIO_NS::RationalTime(static_cast<double>(1 + i), 24.0),
+                        image);
+                    images.push_back(image);
+                }
+            }
+
+            // Files come back as they are on disk; one that was not asked
+            // for, or is not there, does not come back at all.
+            {
+                auto prefetch = SeqPrefetch::create(2, 4);
+                const std::string fileName = path.getFrame(1, true);
+                const std::string missing = path.getFrame(100, true);
+                // Taking a file that has not started to be read drops it,
+                // so give the threads a moment to start.
+                std::shared_ptr<const std::vector<uint8_t> > data;
+                for (size_t i = 0; i < 100 && !data; ++i)
+                {
+                    prefetch->request({ fileName, missing });
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    data = prefetch->take(fileName);
+                }
+                FTK_CHECK(data);
+                auto fileIO = ftk::FileIO::create(fileName, ftk::FileMode::Read);
+                std::vector<uint8_t> bytes(fileIO->getSize());
+                fileIO->read(bytes.data(), bytes.size());
+                FTK_CHECK(bytes == *data);
+                FTK_CHECK(!prefetch->take(fileName));
+                FTK_CHECK(!prefetch->take(missing));
+                FTK_CHECK(!prefetch->take(path.getFrame(2, true)));
+
+                // No more are held than asked for, and a cancel drops them.
+                std::vector<std::string> fileNames;
+                for (size_t i = 0; i < frameCount; ++i)
+                {
+                    fileNames.push_back(path.getFrame(1 + i, true));
+                }
+                prefetch->request(fileNames);
+                prefetch->cancel();
+                for (const auto& i : fileNames)
+                {
+                    FTK_CHECK(!prefetch->take(i));
+                }
+            }
+
+            // Reading through the sequence forwards, then backwards, and
+            // from several threads at once gives the same frames as without.
+            ftk::Path seqPath(path);
+            seqPath.setFrames(ftk::RangeI64(1, frameCount));
+            IOOptions options;
+            options["SeqIO/DefaultSpeed"] = "24";
+            auto seq = SeqDecode::create(
+                seqPath, {}, decode, options, SeqPrefetch::create(2, 4));
+            const auto check = [&](size_t i, AccessHint hint = AccessHint::Forward)
+                {
+                    IOOptions readOptions;
+                    readOptions["IO/Access"] = to_string(hint);
+                    const VideoData v = seq->readVideo(
+                        OTIO_NS::RationalTime(static_cast<double>(1 + i), 24.0),
+                        readOptions);
+                    return v.image && 0 == memcmp(
+                        v.image->getData(),
+                        images[i]->getData(),
+                        images[i]->getByteCount());
+                };
+            for (size_t i = 0; i < frameCount; ++i)
+            {
+                FTK_CHECK(check(i));
+            }
+            for (size_t i = frameCount; i > 0; --i)
+            {
+                FTK_CHECK(check(i - 1, AccessHint::Reverse));
+            }
+            std::atomic<bool> ok(true);
+            std::vector<std::thread> threads;
+            for (size_t i = 0; i < 4; ++i)
+            {
+                threads.push_back(std::thread(
+                    [&check, &ok, i, frameCount]
+                    {
+                        for (size_t j = 0; j < frameCount; ++j)
+                        {
+                            if (!check((i * 3 + j) % frameCount, AccessHint::Random))
+                            {
+                                ok = false;
+                            }
+                        }
+                    }));
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+            FTK_CHECK(ok);
+
+            _print("frames read ahead decode the same as frames read in line");
+        }
+
+        void IOTest::_accessHint()
+        {
+            for (auto hint : getAccessHintEnums())
+            {
+                AccessHint value = AccessHint::First;
+                from_string(to_string(hint), value);
+                FTK_CHECK(hint == value);
+                FTK_CHECK(hint == getAccessHint({ { "IO/Access", to_string(hint) } }).value());
+            }
+            FTK_CHECK(!getAccessHint(IOOptions()).has_value());
+            {
+                const IOOptions options =
+                {
+                    { "IO/Access", to_string(AccessHint::Reverse) },
+                    { "Layer", "1" }
+                };
+                const IOOptions expected = { { "Layer", "1" } };
+                FTK_CHECK(expected == removeAccessHint(options));
+                FTK_CHECK(expected == removeAccessHint(expected));
+            }
+
+            // Advice changes nothing that can be seen, so all there is to
+            // check is that it is safe: on a file, walking it both ways and
+            // jumping about, and on a file that is not there.
+            const std::string fileName = (_getTempDir() / "IOTestAdvice.bin").u8string();
+            {
+                auto fileIO = ftk::FileIO::create(fileName, ftk::FileMode::Write);
+                const std::vector<uint8_t> data(1024 * 1024, 1);
+                fileIO->write(data.data(), data.size());
+            }
+            FileAdvice advice(fileName, 64 * 1024, 256 * 1024);
+            for (int64_t i = 0; i < 1024 * 1024; i += 16 * 1024)
+            {
+                advice.advise(i, AccessHint::Forward);
+            }
+            for (int64_t i = 1024 * 1024; i >= 0; i -= 16 * 1024)
+            {
+                advice.advise(i, AccessHint::Reverse);
+            }
+            advice.advise(512 * 1024, AccessHint::Scrub);
+            advice.advise(0, AccessHint::Random);
+            adviseWillNeed(fileName);
+            adviseDontNeed(fileName, 4096, 4096);
+            const std::string missing = (_getTempDir() / "IOTestAdviceMissing.bin").u8string();
+            adviseWillNeed(missing);
+            FileAdvice(missing, 1024, 1024).advise(0, AccessHint::Forward);
+            auto fileIO = ftk::FileIO::create(fileName, ftk::FileMode::Read);
+            FTK_CHECK(1024 * 1024 == fileIO->getSize());
+
+            _print("access hints are read from the options and safe to give");
+        }
     }
 }
@@ -27,6 +27,9 @@ namespace tl
             void _missingFrames();
             void _seqRange();
             void _structural();
+            void _frameIndex();
+            void _seqPrefetch();
+            void _accessHint();
         };
     }
 }
@@ -9,6 +9,7 @@
 #include <ftk/Core/Assert.h>
 #include <ftk/Core/Context.h>
 
+#include <cstring>
 #include <sstream>
 
 namespace tl
@@ -194,6 +195,77 @@ namespace tl
                     }
                 }
             }
+
+            _imageCache();
+        }
+
+        void OIIOTest::_imageCache()
+        {
+            auto readSystem = _context->getSystem<ReadSystem>();
+            auto readPlugin = readSystem->getPlugin<oiio::ReadPlugin>();
+            auto writeSystem = _context->getSystem<WriteSystem>();
+            auto writePlugin = writeSystem->getPlugin<oiio::WritePlugin>();
+
+            // Write an image with a pattern so the two reads can be
+            // compared.
+            const ftk::ImageInfo imageInfo(16, 16, ftk::ImageType::RGBA_U8);
+            const auto image = ftk::Image::create(imageInfo);
+            for (size_t i = 0; i < image->getByteCount(); ++i)
+            {
+                image->getData()[i] = static_cast<uint8_t>(i);
+            }
+            const ftk::Path path((_getTempDir() / "OIIOTest ImageCache.0.png").u8string());
+            write(writePlugin, image, path, imageInfo, IOOptions());
+
+            oiio::Options options;
+            options.imageCache = true;
+            options.imageCacheMB = 16;
+            FTK_CHECK(options != oiio::Options());
+            const IOOptions ioOptions = oiio::getOptions(options);
+            auto decode = readPlugin->decode();
+            auto cacheDecode = readPlugin->decode(ioOptions);
+            FTK_CHECK(!cacheDecode->getInfo(path.get()).video.empty());
+            const auto videoData = decode->readVideo(
+                path.get(), nullptr, OTIO_NS::RationalTime(0.0, 24.0));
+            for (size_t i = 0; i < 2; ++i)
+            {
+                // The second read comes from the cache.
+                const auto cacheData = cacheDecode->readVideo(
+                    path.get(), nullptr, OTIO_NS::RationalTime(0.0, 24.0), ioOptions);
+                FTK_CHECK(cacheData.image);
+                FTK_CHECK(cacheData.image->getInfo() == videoData.image->getInfo());
+                FTK_CHECK(0 == memcmp(
+                    cacheData.image->getData(),
+                    videoData.image->getData(),
+                    videoData.image->getByteCount()));
+            }
+
+            // A file with no MIP levels is read at full resolution whatever
+            // the display width.
+            {
+                options.displayWidth = 4;
+                const auto cacheData = cacheDecode->readVideo(
+                    path.get(),
+                    nullptr,
+                    OTIO_NS::RationalTime(0.0, 24.0),
+                    oiio::getOptions(options));
+                FTK_CHECK(cacheData.image->getSize() == imageInfo.size);
+            }
+
+            // A missing file is an error.
+            try
+            {
+                cacheDecode->readVideo(
+                    (_getTempDir() / "OIIOTest Missing.0.png").u8string(),
+                    nullptr,
+                    OTIO_NS::RationalTime(0.0, 24.0),
+                    ioOptions);
+                FTK_CHECK(false);
+            }
+            catch (const std::exception& e)
+            {
+                _print(e.what());
+            }
         }
     }
 }
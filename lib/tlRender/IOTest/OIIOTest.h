@@ -43,6 +43,8 @@ namespace tl
                 const ftk::Path& path,
                 bool memoryIO,
                 const IOOptions& options);
+
+            void _imageCache();
         };
     }
 }
@@ -22,11 +22,13 @@ namespace tl
             {
                 int in = 0;
                 std::promise<int> promise;
+                std::shared_ptr<Completion> completion = getCompletion();
             };
 
             struct StringRequest
             {
                 std::promise<std::string> promise;
+                std::shared_ptr<Completion> completion = getCompletion();
             };
         }
 
@@ -47,6 +49,7 @@ namespace tl
             _stopQueue();
             _cancel();
             _promiseGuard();
+            _completion();
         }
 
         void RequestQueueTest::_roundTrip()
@@ -68,7 +71,7 @@ namespace tl
                         }
                         if (auto request = ints.pop())
                         {
-                            PromiseGuard<int> guard(request->promise);
+                            PromiseGuard<int> guard(request->promise, request->completion);
                             guard.setValue(request->in * 2);
                         }
                     }
@@ -206,7 +209,7 @@ namespace tl
             auto future = promise.get_future();
             try
             {
-                PromiseGuard<int> guard(promise);
+                PromiseGuard<int> guard(promise, nullptr);
                 throw std::runtime_error("boom");
             }
             catch (const std::exception&)
@@ -216,10 +219,86 @@ namespace tl
             std::promise<int> promise2;
             auto future2 = promise2.get_future();
             {
-                PromiseGuard<int> guard(promise2);
+                PromiseGuard<int> guard(promise2, nullptr);
                 guard.setValue(9);
             }
             FTK_CHECK(9 == future2.get());
         }
+
+        void RequestQueueTest::_completion()
+        {
+            _print("Completion");
+            // Completing a request through the queue or the guard notifies
+            // the completion the request was made with, and no other.
+            size_t count = 0;
+            size_t otherCount = 0;
+            auto completion = Completion::create([&count] { ++count; });
+            auto other = Completion::create([&otherCount] { ++otherCount; });
+            {
+                std::promise<int> promise;
+                auto future = promise.get_future();
+                PromiseGuard<int> guard(promise, completion);
+                guard.setValue(1);
+                FTK_CHECK(1 == count);
+            }
+            {
+                RequestCondition condition;
+                RequestQueue<IntRequest, int> queue(condition);
+                std::future<int> future;
+                std::future<int> otherFuture;
+                {
+                    CompletionScope scope(completion);
+                    future = queue.push(std::make_shared<IntRequest>());
+                    {
+                        CompletionScope otherScope(other);
+                        otherFuture = queue.push(std::make_shared<IntRequest>());
+                    }
+                    FTK_CHECK(completion == getCompletion());
+                }
+                FTK_CHECK(!getCompletion());
+                queue.cancel();
+                FTK_CHECK(0 == future.get());
+                FTK_CHECK(0 == otherFuture.get());
+                FTK_CHECK(2 == count);
+                FTK_CHECK(1 == otherCount);
+            }
+            {
+                // A worker completing a request wakes the thread that made
+                // it.
+                std::mutex mutex;
+                std::condition_variable cv;
+                bool completed = false;
+                auto waiter = Completion::create(
+                    [&mutex, &cv, &completed]
+                    {
+                        {
+                            std::unique_lock<std::mutex> lock(mutex);
+                            completed = true;
+                        }
+                        cv.notify_one();
+                    });
+                std::promise<int> promise;
+                auto future = promise.get_future();
+                std::thread worker(
+                    [&promise, waiter]
+                    {
+                        PromiseGuard<int> guard(promise, waiter);
+                        guard.setValue(2);
+                    });
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    FTK_CHECK(cv.wait_for(
+                        lock,
+                        std::chrono::seconds(10),
+                        [&completed] { return completed; }));
+                }
+                worker.join();
+                FTK_CHECK(2 == future.get());
+            }
+            // A closed completion is not called.
+            completion->close();
+            completion->notify();
+            FTK_CHECK(2 == count);
+        }
     }
 }
@@ -26,6 +26,7 @@ namespace tl
             void _stopQueue();
             void _cancel();
             void _promiseGuard();
+            void _completion();
         };
     }
 }
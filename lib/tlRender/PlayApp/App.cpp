@@ -192,6 +192,19 @@ namespace tl
                 _context,
                 std::dynamic_pointer_cast<App>(shared_from_this()));
 
+            // Files are opened in the background, so their errors arrive
+            // later.
+            _errorObserver = ftk::Observer<std::string>::create(
+                _filesModel->observeError(),
+                [this](const std::string& value)
+                {
+                    if (!value.empty())
+                    {
+                        auto dialogSystem = _context->getSystem<ftk::DialogSystem>();
+                        dialogSystem->message("ERROR", value, _window);
+                    }
+                });
+
             for (const auto& input : _cmdLine.inputs->getList())
             {
                 ftk::Path path(input);
@@ -68,6 +68,7 @@ namespace tl
             std::shared_ptr<MainWindow> _window;
 
             std::shared_ptr<ftk::Observer<std::shared_ptr<Player> > > _playerObserver;
+            std::shared_ptr<ftk::Observer<std::string> > _errorObserver;
 
             std::shared_ptr<ftk::Timer> _debugTimer;
             int _debugInput = 0;
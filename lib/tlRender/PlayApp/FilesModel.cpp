@@ -5,6 +5,10 @@
 
 #include "SettingsModel.h"
 
+#include <tlRender/Timeline/FrameCache.h>
+#include <tlRender/Timeline/MemoryBudget.h>
+
+#include <ftk/Core/Context.h>
 #include <ftk/Core/Format.h>
 #include <ftk/Core/Memory.h>
 
@@ -17,6 +21,8 @@ namespace tl
             const std::shared_ptr<SettingsModel>& settingsModel)
         {
             _context = context;
+            _opens = ftk::ObservableList<std::shared_ptr<TimelineOpen> >::create();
+            _error = ftk::Observable<std::string>::create();
             _players = ftk::ObservableList<std::shared_ptr<Player> >::create();
             _player = ftk::Observable<std::shared_ptr<Player> >::create();
             _playerIndex = ftk::Observable<int>::create(-1);
@@ -33,6 +39,30 @@ namespace tl
                     {
                         player->setCacheOptions(value);
                     }
+
+                    // The frames the players share have the same budget as
+                    // one player's cache.
+                    if (auto context = _context.lock())
+                    {
+                        if (auto frameCache = context->getSystem<FrameCache>())
+                        {
+                            frameCache->setMax(value.videoGB * ftk::gigabyte);
+                        }
+                    }
+                });
+
+            _playerObserver = ftk::Observer<std::shared_ptr<Player> >::create(
+                _player,
+                [this](const std::shared_ptr<Player>&)
+                {
+                    _setMemoryPriorities();
+                });
+
+            _bPlayerObserver = ftk::Observer<std::shared_ptr<Player> >::create(
+                _bPlayer,
+                [this](const std::shared_ptr<Player>&)
+                {
+                    _setMemoryPriorities();
                 });
         }
 
@@ -56,16 +86,45 @@ namespace tl
 #if defined(TLRENDER_USD)
                 //options.ioOptions["USD/DiskCacheGB"] = ftk::Format("{0}").arg(16);
 #endif // TLRENDER_USD
-                auto timeline = Timeline::create(context, path, options);
-                auto player = Player::create(context, timeline);
-                player->setCacheOptions(_cacheOptions);
-                const int index = static_cast<int>(_players->getSize());
-                _players->pushBack(player);
-                _player->setIfChanged(player);
-                _playerIndex->setIfChanged(index);
+                for (auto i = _openObservers.begin(); i != _openObservers.end();)
+                {
+                    i = _opens->indexOf(i->first) != ftk::ObservableListInvalidIndex ?
+                        std::next(i) :
+                        _openObservers.erase(i);
+                }
+                auto open = TimelineOpen::create(context, path, options);
+                _opens->pushBack(open);
+                std::weak_ptr<TimelineOpen> openWeak(open);
+                _openObservers[open] = ftk::Observer<TimelineOpenStage>::create(
+                    open->observeStage(),
+                    [this, openWeak](TimelineOpenStage value)
+                    {
+                        if (auto open = openWeak.lock())
+                        {
+                            _opened(open, value);
+                        }
+                    });
+            }
+        }
+
+        void FilesModel::cancel(int index)
+        {
+            if (index >= 0 && index < static_cast<int>(_opens->getSize()))
+            {
+                _opens->getItem(index)->cancel();
             }
         }
 
+        std::shared_ptr<ftk::IObservableList<std::shared_ptr<TimelineOpen> > > FilesModel::observeOpens() const
+        {
+            return _opens;
+        }
+
+        std::shared_ptr<ftk::IObservable<std::string> > FilesModel::observeError() const
+        {
+            return _error;
+        }
+
         void FilesModel::close()
         {
             close(static_cast<int>(_players->indexOf(_player->get())));
@@ -115,6 +174,10 @@ namespace tl
 
         void FilesModel::closeAll()
         {
+            for (const auto& open : _opens->get())
+            {
+                open->cancel();
+            }
             _players->clear();
             _player->setIfChanged(nullptr);
             _playerIndex->setIfChanged(-1);
@@ -130,6 +193,12 @@ namespace tl
             {
                 const std::size_t index = _players->indexOf(player);
                 const ftk::Path path = player->getPath();
+                // Frames read before the reload are what it is meant to
+                // replace.
+                if (auto frameCache = context->getSystem<FrameCache>())
+                {
+                    frameCache->clear();
+                }
                 auto timeline = Timeline::create(context, path);
                 player = Player::create(context, timeline);
                 _players->setItem(index, player);
@@ -245,6 +314,62 @@ namespace tl
         {
             return _compare;
         }
+
+        void FilesModel::_opened(
+            const std::shared_ptr<TimelineOpen>& open,
+            TimelineOpenStage stage)
+        {
+            switch (stage)
+            {
+            case TimelineOpenStage::Ready:
+                if (auto context = _context.lock())
+                {
+                    // The first file ready is shown at once, and the last
+                    // one, as when the files were opened one after another.
+                    // Those between wait in their tabs rather than each
+                    // taking over the view as it arrives.
+                    auto player = Player::create(context, open->getTimeline());
+                    player->setCacheOptions(_cacheOptions);
+                    const int index = static_cast<int>(_players->getSize());
+                    _players->pushBack(player);
+                    if (!_player->get() || _opens->getSize() == 1)
+                    {
+                        _player->setIfChanged(player);
+                        _playerIndex->setIfChanged(index);
+                    }
+                }
+                break;
+            case TimelineOpenStage::Error:
+                _error->setAlways(open->getError());
+                break;
+            default: break;
+            }
+            switch (stage)
+            {
+            case TimelineOpenStage::Ready:
+            case TimelineOpenStage::Canceled:
+            case TimelineOpenStage::Error:
+                // The observer is calling this, so it is removed with the
+                // next file opened.
+                _opens->removeItem(_opens->indexOf(open));
+                break;
+            default: break;
+            }
+        }
+
+        void FilesModel::_setMemoryPriorities()
+        {
+            // The players being viewed keep their caches when the memory
+            // budget runs short.
+            const auto player = _player->get();
+            const auto bPlayer = _bPlayer->get();
+            for (const auto& i : _players->get())
+            {
+                i->setMemoryPriority(
+                    i == player || i == bPlayer ?
+                    MemoryPriority::High :
+                    MemoryPriority::Normal);
+            }
+        }
     }
 }
-
@@ -4,6 +4,11 @@
 #pragma once
 
 #include <tlRender/Timeline/Player.h>
+#include <tlRender/Timeline/TimelineOpen.h>
+
+#include <ftk/Core/ObservableList.h>
+
+#include <map>
 
 namespace tl
 {
@@ -31,6 +36,8 @@ namespace tl
                 const std::shared_ptr<ftk::Context>&,
                 const std::shared_ptr<SettingsModel>&);
 
+            //! Open a file. The file is opened in the background, and a
+            //! player is added once it is ready.
             void open(const ftk::Path&);
             void open();
             void close();
@@ -41,6 +48,15 @@ namespace tl
             void next();
             void prev();
 
+            //! Cancel opening a file.
+            void cancel(int);
+
+            //! Observe the files being opened.
+            std::shared_ptr<ftk::IObservableList<std::shared_ptr<TimelineOpen> > > observeOpens() const;
+
+            //! Observe the errors opening files.
+            std::shared_ptr<ftk::IObservable<std::string> > observeError() const;
+
             std::shared_ptr<ftk::IObservableList<std::shared_ptr<Player> > > observePlayers() const;
             std::shared_ptr<ftk::IObservable<std::shared_ptr<Player> > > observePlayer() const;
             std::shared_ptr<ftk::IObservable<int> > observePlayerIndex() const;
@@ -53,7 +69,13 @@ namespace tl
             std::shared_ptr<ftk::IObservable<Compare> > observeCompare() const;
 
         private:
+            void _opened(const std::shared_ptr<TimelineOpen>&, TimelineOpenStage);
+            void _setMemoryPriorities();
+
             std::weak_ptr<ftk::Context> _context;
+            std::shared_ptr<ftk::ObservableList<std::shared_ptr<TimelineOpen> > > _opens;
+            std::map<std::shared_ptr<TimelineOpen>, std::shared_ptr<ftk::Observer<TimelineOpenStage> > > _openObservers;
+            std::shared_ptr<ftk::Observable<std::string> > _error;
             std::shared_ptr<ftk::ObservableList<std::shared_ptr<Player> > > _players;
             std::shared_ptr<ftk::Observable<std::shared_ptr<Player> > > _player;
             std::shared_ptr<ftk::Observable<int> > _playerIndex;
@@ -62,6 +84,8 @@ namespace tl
             std::shared_ptr<ftk::Observable<Compare> > _compare;
             PlayerCacheOptions _cacheOptions;
             std::shared_ptr<ftk::Observer<PlayerCacheOptions> > _cacheObserver;
+            std::shared_ptr<ftk::Observer<std::shared_ptr<Player> > > _playerObserver;
+            std::shared_ptr<ftk::Observer<std::shared_ptr<Player> > > _bPlayerObserver;
         };
     }
 }
@@ -3,6 +3,8 @@
 
 #include "SettingsModel.h"
 
+#include <ftk/Core/Memory.h>
+
 namespace tl
 {
     namespace play
@@ -22,6 +24,28 @@ namespace tl
             fileBrowserSystem->setNativeFileDialog(nativeFileDialog);
             _fileBrowserSystem = fileBrowserSystem;
 
+            // Restore disk cache settings. The cache is shared by every
+            // timeline, so they go to it rather than to the players.
+            if (auto diskCache = context->getSystem<DiskCache>())
+            {
+                std::string directory;
+                _settings->get("/DiskCache/Directory", directory);
+                float gb = 0.F;
+                _settings->getT("/DiskCache/GB", gb);
+                diskCache->setDirectory(directory);
+                diskCache->setMax(gb * ftk::gigabyte);
+                _diskCache = diskCache;
+            }
+
+            // Restore the memory budget, which is also one for the process.
+            if (auto memoryBudget = context->getSystem<MemoryBudget>())
+            {
+                float gb = 0.F;
+                _settings->getT("/MemoryBudget/GB", gb);
+                memoryBudget->setMax(gb * ftk::gigabyte);
+                _memoryBudget = memoryBudget;
+            }
+
             // Restore timeline player cache settings.
             PlayerCacheOptions cache;
             _settings->getT("/Cache", cache);
@@ -37,6 +61,23 @@ namespace tl
                 _settings->set("/NativeFileDialog", fileBrowserSystem->isNativeFileDialog());
             }
 
+            // Save disk cache settings.
+            if (auto diskCache = _diskCache.lock())
+            {
+                _settings->set("/DiskCache/Directory", diskCache->getDirectory());
+                _settings->setT(
+                    "/DiskCache/GB",
+                    static_cast<float>(diskCache->getMax()) / ftk::gigabyte);
+            }
+
+            // Save the memory budget.
+            if (auto memoryBudget = _memoryBudget.lock())
+            {
+                _settings->setT(
+                    "/MemoryBudget/GB",
+                    static_cast<float>(memoryBudget->getMax()) / ftk::gigabyte);
+            }
+
             // Save timeline player cache settings.
             _settings->setT("/Cache", _cache->get());
         }
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <tlRender/Timeline/DiskCache.h>
+#include <tlRender/Timeline/MemoryBudget.h>
 #include <tlRender/Timeline/Player.h>
 
 #include <ftk/UI/FileBrowser.h>
@@ -46,6 +48,8 @@ namespace tl
         private:
             std::shared_ptr<ftk::Settings> _settings;
             std::weak_ptr<ftk::FileBrowserSystem> _fileBrowserSystem;
+            std::weak_ptr<DiskCache> _diskCache;
+            std::weak_ptr<MemoryBudget> _memoryBudget;
             std::shared_ptr<ftk::Observable<PlayerCacheOptions> > _cache;
         };
     }
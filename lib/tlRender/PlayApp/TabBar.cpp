@@ -6,6 +6,8 @@
 #include "App.h"
 #include "FilesModel.h"
 
+#include <ftk/Core/Format.h>
+
 namespace tl
 {
     namespace play
@@ -22,19 +24,36 @@ namespace tl
 
             std::weak_ptr<App> appWeak(app);
             _tabBar->setCallback(
-                [appWeak](int value)
+                [this, appWeak](int value)
                 {
                     if (auto app = appWeak.lock())
                     {
-                        app->getFilesModel()->setCurrent(value);
+                        // The tabs of the files being opened come after the
+                        // players, and have nothing to show yet.
+                        if (value < static_cast<int>(_players.size()))
+                        {
+                            app->getFilesModel()->setCurrent(value);
+                        }
+                        else
+                        {
+                            _tabBar->setCurrent(app->getFilesModel()->observePlayerIndex()->get());
+                        }
                     }
                 });
             _tabBar->setCloseCallback(
-                [appWeak](int index)
+                [this, appWeak](int index)
                 {
                     if (auto app = appWeak.lock())
                     {
-                        app->getFilesModel()->close(index);
+                        const int size = static_cast<int>(_players.size());
+                        if (index < size)
+                        {
+                            app->getFilesModel()->close(index);
+                        }
+                        else
+                        {
+                            app->getFilesModel()->cancel(index - size);
+                        }
                     }
                 });
 
@@ -42,15 +61,16 @@ namespace tl
                 app->getFilesModel()->observePlayers(),
                 [this](const std::vector<std::shared_ptr<Player> >& value)
                 {
-                    const int index = _tabBar->getCurrent();
-                    _tabBar->clear();
-                    for (const auto& player : value)
-                    {
-                        _tabBar->addTab(
-                            player->getPath().getFileName(),
-                            player->getPath().get());
-                    }
-                    _tabBar->setCurrent(index);
+                    _players = value;
+                    _tabsUpdate();
+                });
+
+            _opensObserver = ftk::ListObserver<std::shared_ptr<TimelineOpen> >::create(
+                app->getFilesModel()->observeOpens(),
+                [this](const std::vector<std::shared_ptr<TimelineOpen> >& value)
+                {
+                    _opens = value;
+                    _tabsUpdate();
                 });
 
             _playerIndexObserver = ftk::Observer<int>::create(
@@ -84,5 +104,24 @@ namespace tl
             IWidget::setGeometry(value);
             _tabBar->setGeometry(value);
         }
+
+        void TabBar::_tabsUpdate()
+        {
+            const int index = _tabBar->getCurrent();
+            _tabBar->clear();
+            for (const auto& player : _players)
+            {
+                _tabBar->addTab(
+                    player->getPath().getFileName(),
+                    player->getPath().get());
+            }
+            for (const auto& open : _opens)
+            {
+                _tabBar->addTab(
+                    ftk::Format("{0} (Opening)").arg(open->getPath().getFileName()),
+                    open->getPath().get());
+            }
+            _tabBar->setCurrent(index);
+        }
     }
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <tlRender/UI/TimeLabel.h>
 
 #include <tlRender/Timeline/Player.h>
+#include <tlRender/Timeline/TimelineOpen.h>
 
 #include <ftk/UI/TabBar.h>
 
@@ -41,8 +42,13 @@ namespace tl
             void setGeometry(const ftk::Box2I&) override;
 
         private:
+            void _tabsUpdate();
+
+            std::vector<std::shared_ptr<Player> > _players;
+            std::vector<std::shared_ptr<TimelineOpen> > _opens;
             std::shared_ptr<ftk::TabBar> _tabBar;
             std::shared_ptr<ftk::ListObserver<std::shared_ptr<Player> > > _playersObserver;
+            std::shared_ptr<ftk::ListObserver<std::shared_ptr<TimelineOpen> > > _opensObserver;
             std::shared_ptr<ftk::Observer<int> > _playerIndexObserver;
         };
     }
@@ -12,6 +12,7 @@
 #include <array>
 #include <cmath>
 #include <cstdlib>
+#include <limits>
 #include <sstream>
 
 namespace tl
@@ -83,6 +84,8 @@ namespace tl
             wipeRotation == other.wipeRotation &&
             overlay == other.overlay &&
             differenceGain == other.differenceGain &&
+            differenceStats == other.differenceStats &&
+            differenceThreshold == other.differenceThreshold &&
             sameSize == other.sameSize;
     }
 
@@ -91,6 +94,23 @@ namespace tl
         return !(*this == other);
     }
 
+    bool CompareStats::operator == (const CompareStats& other) const
+    {
+        return
+            valid == other.valid &&
+            pixelCount == other.pixelCount &&
+            maxError == other.maxError &&
+            meanError == other.meanError &&
+            psnr == other.psnr &&
+            thresholdCount == other.thresholdCount &&
+            thresholdBox == other.thresholdBox;
+    }
+
+    bool CompareStats::operator != (const CompareStats& other) const
+    {
+        return !(*this == other);
+    }
+
     std::vector<ftk::Box2I> getBounds(
         const CompareOptions& options,
         const AspectRatioOptions& aspectRatioOptions,
@@ -304,9 +324,30 @@ namespace tl
         json["WipeRotation"] = in.wipeRotation;
         json["Overlay"] = in.overlay;
         json["DifferenceGain"] = in.differenceGain;
+        json["DifferenceStats"] = in.differenceStats;
+        json["DifferenceThreshold"] = in.differenceThreshold;
         json["SameSize"] = in.sameSize;
     }
 
+    void to_json(nlohmann::json& json, const CompareStats& in)
+    {
+        json["Valid"] = in.valid;
+        json["PixelCount"] = in.pixelCount;
+        json["MaxError"] = in.maxError;
+        json["MeanError"] = in.meanError;
+        // JSON has no infinity; the two being the same is written as null.
+        if (std::isfinite(in.psnr))
+        {
+            json["PSNR"] = in.psnr;
+        }
+        else
+        {
+            json["PSNR"] = nullptr;
+        }
+        json["ThresholdCount"] = in.thresholdCount;
+        json["ThresholdBox"] = in.thresholdBox;
+    }
+
     void from_json(const nlohmann::json& json, CompareOptions& out)
     {
         from_string(json.at("Compare").get<std::string>(), out.compare);
@@ -320,6 +361,28 @@ namespace tl
         {
             json.at("DifferenceGain").get_to(out.differenceGain);
         }
+        if (json.contains("DifferenceStats"))
+        {
+            json.at("DifferenceStats").get_to(out.differenceStats);
+        }
+        if (json.contains("DifferenceThreshold"))
+        {
+            json.at("DifferenceThreshold").get_to(out.differenceThreshold);
+        }
         json.at("SameSize").get_to(out.sameSize);
     }
+
+    void from_json(const nlohmann::json& json, CompareStats& out)
+    {
+        json.at("Valid").get_to(out.valid);
+        json.at("PixelCount").get_to(out.pixelCount);
+        json.at("MaxError").get_to(out.maxError);
+        json.at("MeanError").get_to(out.meanError);
+        const auto& psnr = json.at("PSNR");
+        out.psnr = psnr.is_null() ?
+            std::numeric_limits<float>::infinity() :
+            psnr.get<float>();
+        json.at("ThresholdCount").get_to(out.thresholdCount);
+        json.at("ThresholdBox").get_to(out.thresholdBox);
+    }
 }
@@ -62,12 +62,47 @@ namespace tl
         //! their own size they are indistinguishable from black.
         float    differenceGain = 1.F;
 
+        //! Measure the difference as well as showing it; see CompareStats.
+        //! Off unless asked for, since the measurement is read back from
+        //! the GPU and waits for it.
+        bool     differenceStats = false;
+
+        //! The error a pixel has to exceed to be counted as different.
+        float    differenceThreshold = 0.F;
+
         bool     sameSize     = true;
 
         TL_API bool operator == (const CompareOptions&) const;
         TL_API bool operator != (const CompareOptions&) const;
     };
 
+    //! Statistics of the difference between two files, measured from the
+    //! same pixels the difference comparison shows.
+    //!
+    //! The error of a pixel is taken over its color channels, and is in
+    //! the units of the display pipeline's output: a full scale step is
+    //! one. The peak signal to noise ratio is measured against that full
+    //! scale, and is infinite when the two are the same.
+    struct TL_API_TYPE CompareStats
+    {
+        //! Whether there was a pair to measure.
+        bool        valid      = false;
+
+        size_t      pixelCount = 0;
+        float       maxError   = 0.F;
+        float       meanError  = 0.F;
+        float       psnr       = 0.F;
+
+        //! How many pixels differ by more than the threshold, and the box
+        //! around them in the comparison's pixels, top to bottom. The box
+        //! is empty when none do.
+        size_t      thresholdCount = 0;
+        ftk::Box2I  thresholdBox;
+
+        TL_API bool operator == (const CompareStats&) const;
+        TL_API bool operator != (const CompareStats&) const;
+    };
+
     //! Get the bounds for the given compare mode.
     TL_API std::vector<ftk::Box2I> getBounds(
         const CompareOptions&,
@@ -110,7 +145,11 @@ namespace tl
 
     TL_API void to_json(nlohmann::json&, const CompareOptions&);
 
+    TL_API void to_json(nlohmann::json&, const CompareStats&);
+
     TL_API void from_json(const nlohmann::json&, CompareOptions&);
 
+    TL_API void from_json(const nlohmann::json&, CompareStats&);
+
     ///@}
 }
@@ -0,0 +1,679 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/Timeline/DiskCache.h>
+
+#include <ftk/Core/Context.h>
+#include <ftk/Core/FileIO.h>
+#include <ftk/Core/Memory.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace tl
+{
+    namespace
+    {
+        // Written in the byte order of the machine, which is the only one
+        // that reads it: a file from another is not recognized.
+        const uint32_t magic = 0x74634446;
+        const uint32_t version = 1;
+        const size_t pageSize = 4096;
+        const std::string extension = ".tlframe";
+
+        // The most read to find the header when the file cannot be memory
+        // mapped.
+        const size_t headerMax = 16 * pageSize;
+
+        // How much may wait to be written. More than this and the drive is
+        // not keeping up, and holding on to more frames would only take
+        // the memory the frame cache has just given back.
+        const size_t pendingMax = ftk::gigabyte;
+
+        std::string getFileName(const std::string& directory, const std::string& key)
+        {
+            std::stringstream ss;
+            ss << std::hex << std::setfill('0') << std::setw(16) <<
+                static_cast<uint64_t>(std::hash<std::string>()(key)) << extension;
+            return (std::filesystem::u8path(directory) / ss.str()).u8string();
+        }
+
+        class Writer
+        {
+        public:
+            template<typename T>
+            void put(T value)
+            {
+                const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+                data.insert(data.end(), p, p + sizeof(T));
+            }
+
+            void putString(const std::string& value)
+            {
+                put(static_cast<uint32_t>(value.size()));
+                data.insert(data.end(), value.begin(), value.end());
+            }
+
+            std::vector<uint8_t> data;
+        };
+
+        class Reader
+        {
+        public:
+            Reader(const uint8_t* p, size_t size) :
+                _p(p),
+                _end(p + size)
+            {}
+
+            template<typename T>
+            T get()
+            {
+                _check(sizeof(T));
+                T out;
+                std::memcpy(&out, _p, sizeof(T));
+                _p += sizeof(T);
+                return out;
+            }
+
+            std::string getString()
+            {
+                const uint32_t size = get<uint32_t>();
+                _check(size);
+                std::string out(reinterpret_cast<const char*>(_p), size);
+                _p += size;
+                return out;
+            }
+
+        private:
+            void _check(size_t size)
+            {
+                if (size > static_cast<size_t>(_end - _p))
+                {
+                    throw std::runtime_error("Invalid frame header");
+                }
+            }
+
+            const uint8_t* _p = nullptr;
+            const uint8_t* _end = nullptr;
+        };
+
+        // The header holds the key, so that a file is known without the
+        // index, and is padded to a page so that the pixels start on one.
+        std::vector<uint8_t> writeHeader(const std::string& key, const VideoData& data)
+        {
+            const ftk::ImageInfo& info = data.image->getInfo();
+            Writer w;
+            w.put(magic);
+            w.put(version);
+            w.put(static_cast<uint32_t>(0));
+            w.putString(key);
+            w.put(static_cast<int32_t>(info.size.w));
+            w.put(static_cast<int32_t>(info.size.h));
+            w.put(static_cast<uint32_t>(info.type));
+            w.put(static_cast<float>(info.pixelAspectRatio));
+            w.put(static_cast<uint32_t>(info.videoLevels));
+            w.put(static_cast<uint32_t>(info.yuvCoefficients));
+            w.put(static_cast<uint8_t>(info.layout.mirror.x));
+            w.put(static_cast<uint8_t>(info.layout.mirror.y));
+            w.put(static_cast<int32_t>(info.layout.alignment));
+            w.put(static_cast<uint32_t>(info.layout.endian));
+            w.put(data.time.value());
+            w.put(data.time.rate());
+            w.put(data.layer);
+            const auto& tags = data.image->getTags();
+            w.put(static_cast<uint32_t>(tags.size()));
+            for (const auto& i : tags)
+            {
+                w.putString(i.first);
+                w.putString(i.second);
+            }
+            const size_t size = (w.data.size() + pageSize - 1) / pageSize * pageSize;
+            w.data.resize(size, 0);
+            const uint32_t offset = static_cast<uint32_t>(size);
+            std::memcpy(w.data.data() + sizeof(uint32_t) * 2, &offset, sizeof(uint32_t));
+            return w.data;
+        }
+
+        struct Header
+        {
+            size_t offset = 0;
+            std::string key;
+            ftk::ImageInfo info;
+            ftk::ImageTags tags;
+            OTIO_NS::RationalTime time;
+            uint16_t layer = 0;
+        };
+
+        Header readHeader(const uint8_t* p, size_t size)
+        {
+            Header out;
+            Reader r(p, size);
+            if (r.get<uint32_t>() != magic || r.get<uint32_t>() != version)
+            {
+                throw std::runtime_error("Invalid frame header");
+            }
+            out.offset = r.get<uint32_t>();
+            out.key = r.getString();
+            out.info.size.w = r.get<int32_t>();
+            out.info.size.h = r.get<int32_t>();
+            out.info.type = static_cast<ftk::ImageType>(r.get<uint32_t>());
+            out.info.pixelAspectRatio = r.get<float>();
+            out.info.videoLevels = static_cast<ftk::VideoLevels>(r.get<uint32_t>());
+            out.info.yuvCoefficients = static_cast<ftk::YUVCoefficients>(r.get<uint32_t>());
+            out.info.layout.mirror.x = r.get<uint8_t>();
+            out.info.layout.mirror.y = r.get<uint8_t>();
+            out.info.layout.alignment = r.get<int32_t>();
+            out.info.layout.endian = static_cast<ftk::Endian>(r.get<uint32_t>());
+            const double value = r.get<double>();
+            const double rate = r.get<double>();
+            out.time = OTIO_NS::RationalTime(value, rate);
+            out.layer = r.get<uint16_t>();
+            const uint32_t tagCount = r.get<uint32_t>();
+            for (uint32_t i = 0; i < tagCount; ++i)
+            {
+                const std::string key = r.getString();
+                out.tags[key] = r.getString();
+            }
+            return out;
+        }
+
+        // Read the header of a file, without touching the pixels.
+        Header readHeader(ftk::FileIO& io)
+        {
+            if (const uint8_t* p = io.getMemP())
+            {
+                return readHeader(p, io.getSize());
+            }
+            std::vector<uint8_t> buf(std::min(static_cast<size_t>(io.getSize()), headerMax));
+            io.read(buf.data(), buf.size());
+            return readHeader(buf.data(), buf.size());
+        }
+
+        void writeFrame(
+            const std::string& fileName,
+            const std::string& key,
+            const VideoData& data)
+        {
+            // Written under another name and renamed when it is complete, so
+            // that a session that ends part way through leaves no partial
+            // frame behind to be found by the next.
+            const std::string tmpFileName = fileName + ".tmp";
+            {
+                const auto header = writeHeader(key, data);
+                auto io = ftk::FileIO::create(tmpFileName, ftk::FileMode::Write);
+                io->write(header.data(), header.size());
+                io->write(data.image->getData(), data.image->getByteCount());
+            }
+            std::error_code ec;
+            std::filesystem::rename(
+                std::filesystem::u8path(tmpFileName),
+                std::filesystem::u8path(fileName),
+                ec);
+            if (ec)
+            {
+                std::filesystem::remove(std::filesystem::u8path(tmpFileName), ec);
+                throw std::runtime_error("Cannot write frame");
+            }
+        }
+
+        bool readFrame(
+            const std::string& fileName,
+            const std::string& key,
+            VideoData& out)
+        {
+            auto io = ftk::FileIO::create(fileName, ftk::FileMode::Read);
+            const Header header = readHeader(*io);
+            if (header.key != key)
+            {
+                return false;
+            }
+            auto image = ftk::Image::create(header.info);
+            const size_t byteCount = image->getByteCount();
+            if (header.offset + byteCount > io->getSize())
+            {
+                return false;
+            }
+            if (const uint8_t* p = io->getMemP())
+            {
+                std::memcpy(image->getData(), p + header.offset, byteCount);
+            }
+            else
+            {
+                io->seek(header.offset, ftk::SeekMode::Set);
+                io->read(image->getData(), byteCount);
+            }
+            image->setTags(header.tags);
+            out = VideoData(header.time, header.layer, image);
+            return true;
+        }
+    }
+
+    struct DiskCache::Private
+    {
+        std::string directory;
+        size_t max = 0;
+
+        // Most recently used first.
+        std::list<std::string> order;
+        struct Entry
+        {
+            std::string fileName;
+            size_t byteCount = 0;
+            std::list<std::string>::iterator order;
+        };
+        std::unordered_map<std::string, Entry> entries;
+        size_t byteCount = 0;
+
+        // Frames waiting to be written, oldest first. They are kept until
+        // they are on disk so that asking for one in the meantime finds it.
+        std::list<std::string> queue;
+        std::unordered_map<std::string, VideoData> pending;
+        size_t pendingByteCount = 0;
+
+        bool scan = false;
+        bool running = true;
+        mutable std::mutex mutex;
+        std::condition_variable cv;
+        std::thread thread;
+    };
+
+    DiskCache::DiskCache(const std::shared_ptr<ftk::Context>& context) :
+        ISystem(context, "tl::DiskCache"),
+        _p(new Private)
+    {
+        FTK_P();
+        p.thread = std::thread(
+            [this]
+            {
+                _run();
+            });
+    }
+
+    DiskCache::~DiskCache()
+    {
+        FTK_P();
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            p.running = false;
+        }
+        p.cv.notify_one();
+        if (p.thread.joinable())
+        {
+            p.thread.join();
+        }
+    }
+
+    std::shared_ptr<DiskCache> DiskCache::create(const std::shared_ptr<ftk::Context>& context)
+    {
+        auto out = context->getSystem<DiskCache>();
+        if (!out)
+        {
+            out = std::shared_ptr<DiskCache>(new DiskCache(context));
+            context->addSystem(out);
+        }
+        return out;
+    }
+
+    std::string DiskCache::getDirectory() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        return p.directory;
+    }
+
+    void DiskCache::setDirectory(const std::string& value)
+    {
+        FTK_P();
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            if (value == p.directory)
+                return;
+            p.directory = value;
+            p.order.clear();
+            p.entries.clear();
+            p.byteCount = 0;
+            p.queue.clear();
+            p.pending.clear();
+            p.pendingByteCount = 0;
+            p.scan = !value.empty();
+        }
+        p.cv.notify_one();
+    }
+
+    size_t DiskCache::getMax() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        return p.max;
+    }
+
+    void DiskCache::setMax(size_t value)
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        p.max = value;
+        _evict();
+    }
+
+    bool DiskCache::isEnabled() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        return !p.directory.empty() && p.max > 0;
+    }
+
+    size_t DiskCache::getByteCount() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        return p.byteCount;
+    }
+
+    size_t DiskCache::getCount() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        return p.entries.size();
+    }
+
+    bool DiskCache::contains(const std::string& key) const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        return p.pending.find(key) != p.pending.end() ||
+            p.entries.find(key) != p.entries.end();
+    }
+
+    bool DiskCache::get(const std::string& key, VideoData& out)
+    {
+        FTK_P();
+        std::string fileName;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            const auto i = p.pending.find(key);
+            if (i != p.pending.end())
+            {
+                out = i->second;
+                return true;
+            }
+            const auto j = p.entries.find(key);
+            if (j == p.entries.end())
+            {
+                return false;
+            }
+            p.order.splice(p.order.begin(), p.order, j->second.order);
+            fileName = j->second.fileName;
+        }
+
+        // Read outside of the lock, so that other frames can be read and
+        // written at the same time.
+        bool ok = false;
+        try
+        {
+            ok = readFrame(fileName, key, out);
+        }
+        catch (const std::exception&)
+        {}
+        if (!ok)
+        {
+            // Removed from under us, or damaged; either way it is no use.
+            std::unique_lock<std::mutex> lock(p.mutex);
+            const auto j = p.entries.find(key);
+            if (j != p.entries.end() && j->second.fileName == fileName)
+            {
+                std::error_code ec;
+                std::filesystem::remove(std::filesystem::u8path(fileName), ec);
+                p.byteCount -= j->second.byteCount;
+                p.order.erase(j->second.order);
+                p.entries.erase(j);
+            }
+        }
+        return ok;
+    }
+
+    void DiskCache::add(const std::string& key, const VideoData& data)
+    {
+        FTK_P();
+        if (!data.image || data.missing)
+        {
+            return;
+        }
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            if (p.directory.empty() || 0 == p.max)
+            {
+                return;
+            }
+            const auto i = p.entries.find(key);
+            if (i != p.entries.end())
+            {
+                p.order.splice(p.order.begin(), p.order, i->second.order);
+                return;
+            }
+            const size_t byteCount = data.image->getByteCount();
+            if (p.pending.find(key) != p.pending.end() ||
+                p.pendingByteCount + byteCount > pendingMax)
+            {
+                return;
+            }
+            p.queue.push_back(key);
+            p.pending[key] = data;
+            p.pendingByteCount += byteCount;
+        }
+        p.cv.notify_one();
+    }
+
+    void DiskCache::clear()
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        for (const auto& i : p.entries)
+        {
+            std::error_code ec;
+            std::filesystem::remove(std::filesystem::u8path(i.second.fileName), ec);
+        }
+        p.order.clear();
+        p.entries.clear();
+        p.byteCount = 0;
+        p.queue.clear();
+        p.pending.clear();
+        p.pendingByteCount = 0;
+    }
+
+    void DiskCache::_run()
+    {
+        FTK_P();
+        while (true)
+        {
+            std::string directory;
+            bool scan = false;
+            std::string key;
+            VideoData data;
+            {
+                std::unique_lock<std::mutex> lock(p.mutex);
+                p.cv.wait(
+                    lock,
+                    [&p]
+                    {
+                        return !p.running || p.scan || !p.queue.empty();
+                    });
+                if (!p.running)
+                {
+                    break;
+                }
+                directory = p.directory;
+                if (p.scan)
+                {
+                    p.scan = false;
+                    scan = true;
+                }
+                else
+                {
+                    key = p.queue.front();
+                    p.queue.pop_front();
+                    data = p.pending[key];
+                }
+            }
+
+            if (scan)
+            {
+                _scan(directory);
+                continue;
+            }
+
+            const std::string fileName = getFileName(directory, key);
+            bool ok = false;
+            try
+            {
+                std::error_code ec;
+                std::filesystem::create_directories(std::filesystem::u8path(directory), ec);
+                writeFrame(fileName, key, data);
+                ok = true;
+            }
+            catch (const std::exception&)
+            {}
+
+            std::unique_lock<std::mutex> lock(p.mutex);
+            const auto i = p.pending.find(key);
+            const bool wanted = i != p.pending.end();
+            if (wanted)
+            {
+                p.pendingByteCount -= i->second.image->getByteCount();
+                p.pending.erase(i);
+            }
+            if (ok && wanted)
+            {
+                // Another key with the same file name is replaced by this.
+                for (auto j = p.entries.begin(); j != p.entries.end(); ++j)
+                {
+                    if (j->second.fileName == fileName)
+                    {
+                        p.byteCount -= j->second.byteCount;
+                        p.order.erase(j->second.order);
+                        p.entries.erase(j);
+                        break;
+                    }
+                }
+                Private::Entry entry;
+                entry.fileName = fileName;
+                entry.byteCount = data.image->getByteCount();
+                p.order.push_front(key);
+                entry.order = p.order.begin();
+                p.entries[key] = entry;
+                p.byteCount += entry.byteCount;
+                _evict();
+            }
+            else if (ok)
+            {
+                // The directory changed, or the cache was cleared, while it
+                // was being written.
+                std::error_code ec;
+                std::filesystem::remove(std::filesystem::u8path(fileName), ec);
+            }
+        }
+    }
+
+    void DiskCache::_scan(const std::string& directory)
+    {
+        FTK_P();
+
+        // Find the frames left by an earlier session. Only the headers are
+        // read; the most recently written are the first to be kept.
+        struct Found
+        {
+            std::string key;
+            std::string fileName;
+            size_t byteCount = 0;
+            std::filesystem::file_time_type time;
+        };
+        std::vector<Found> found;
+        std::error_code ec;
+        for (const auto& i : std::filesystem::directory_iterator(
+            std::filesystem::u8path(directory), ec))
+        {
+            const std::filesystem::path& path = i.path();
+            if (path.extension() == ".tmp")
+            {
+                std::filesystem::remove(path, ec);
+                continue;
+            }
+            if (path.extension() != extension)
+            {
+                continue;
+            }
+            try
+            {
+                const std::string fileName = path.u8string();
+                auto io = ftk::FileIO::create(fileName, ftk::FileMode::Read);
+                const Header header = readHeader(*io);
+                Found f;
+                f.key = header.key;
+                f.fileName = fileName;
+                f.byteCount = header.info.getByteCount();
+                f.time = std::filesystem::last_write_time(path, ec);
+                found.push_back(f);
+            }
+            catch (const std::exception&)
+            {
+                std::filesystem::remove(path, ec);
+            }
+        }
+        std::sort(
+            found.begin(),
+            found.end(),
+            [](const Found& a, const Found& b)
+            {
+                return a.time > b.time;
+            });
+
+        std::unique_lock<std::mutex> lock(p.mutex);
+        if (directory != p.directory)
+        {
+            return;
+        }
+        for (const auto& f : found)
+        {
+            if (p.entries.find(f.key) == p.entries.end())
+            {
+                Private::Entry entry;
+                entry.fileName = f.fileName;
+                entry.byteCount = f.byteCount;
+                p.order.push_back(f.key);
+                entry.order = std::prev(p.order.end());
+                p.entries[f.key] = entry;
+                p.byteCount += entry.byteCount;
+            }
+        }
+        _evict();
+    }
+
+    void DiskCache::_evict()
+    {
+        FTK_P();
+        // No maximum means the cache is off, not that it is to be emptied:
+        // the frames are kept for when it is turned on again.
+        if (0 == p.max)
+        {
+            return;
+        }
+        while (p.byteCount > p.max && !p.order.empty())
+        {
+            const auto i = p.entries.find(p.order.back());
+            std::error_code ec;
+            std::filesystem::remove(std::filesystem::u8path(i->second.fileName), ec);
+            p.byteCount -= i->second.byteCount;
+            p.entries.erase(i);
+            p.order.pop_back();
+        }
+    }
+}
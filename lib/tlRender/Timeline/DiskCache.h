@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include <tlRender/IO/IO.h>
+
+#include <ftk/Core/ISystem.h>
+
+namespace tl
+{
+    //! Decoded frame cache on disk, shared by every timeline in the
+    //! process.
+    //!
+    //! Frames that the frame cache lets go of are written here, so that a
+    //! range too long to hold in memory is read back from a local drive
+    //! instead of being decoded again on every loop. Each frame is a file
+    //! with the pixels starting on a page boundary, written by a thread of
+    //! its own and memory mapped when it is read.
+    //!
+    //! Frames only arrive from the frame cache, so nothing is written here
+    //! unless that is on too. The directory and size are set on the cache
+    //! itself, once for the process, rather than per player.
+    //!
+    //! The files stay in the directory between sessions and are picked up
+    //! again when the directory is set. The keys carry the modification time
+    //! of the media, so frames of media that has since changed are not used.
+    class TL_API_TYPE DiskCache : public ftk::ISystem
+    {
+        FTK_NON_COPYABLE(DiskCache);
+
+    protected:
+        DiskCache(const std::shared_ptr<ftk::Context>&);
+
+    public:
+        TL_API virtual ~DiskCache();
+
+        //! Create a new system.
+        TL_API static std::shared_ptr<DiskCache> create(const std::shared_ptr<ftk::Context>&);
+
+        //! Get the directory.
+        TL_API std::string getDirectory() const;
+
+        //! Set the directory. It should be on a fast local drive. An empty
+        //! directory turns the cache off.
+        TL_API void setDirectory(const std::string&);
+
+        //! Get the maximum size in bytes. Zero turns the cache off.
+        TL_API size_t getMax() const;
+
+        //! Set the maximum size in bytes.
+        TL_API void setMax(size_t);
+
+        //! Get whether the cache is on.
+        TL_API bool isEnabled() const;
+
+        //! Get the size in bytes of the frames on disk.
+        TL_API size_t getByteCount() const;
+
+        //! Get the number of frames on disk.
+        TL_API size_t getCount() const;
+
+        //! Get whether there is a frame, on disk or waiting to be written.
+        TL_API bool contains(const std::string& key) const;
+
+        //! Get a frame. Safe to call from any thread.
+        TL_API bool get(const std::string& key, VideoData&);
+
+        //! Add a frame. It is written in the background; frames arriving
+        //! faster than the drive takes them are dropped. Safe to call from
+        //! any thread.
+        TL_API void add(const std::string& key, const VideoData&);
+
+        //! Remove the frames from the disk.
+        TL_API void clear();
+
+    private:
+        void _run();
+        void _scan(const std::string& directory);
+        void _evict();
+
+        FTK_PRIVATE();
+    };
+}
@@ -0,0 +1,270 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/Timeline/Flatten.h>
+
+#include <tlRender/Timeline/PixelPrivate.h>
+
+#include <algorithm>
+#include <sstream>
+
+namespace tl
+{
+    namespace
+    {
+        //! An image to composite, with the alpha it is drawn at.
+        struct Source
+        {
+            std::shared_ptr<ftk::Image> image;
+            std::shared_ptr<ftk::Image> imageB;
+            float dissolve = 0.F;
+            float alpha = 1.F;
+        };
+
+        //! Get the images the renderer draws for each layer, in order. This
+        //! follows the cases of the renderer: a dissolve with both images
+        //! mixes them, a dissolve with one fades it, and anything else
+        //! draws the first image alone.
+        std::vector<Source> getSources(const VideoFrame& frame)
+        {
+            std::vector<Source> out;
+            for (const auto& layer : frame.layers)
+            {
+                Source source;
+                switch (layer.transition)
+                {
+                case Transition::Dissolve:
+                    if (layer.image && layer.imageB)
+                    {
+                        source.image = layer.image;
+                        source.imageB = layer.imageB;
+                        source.dissolve = layer.transitionValue;
+                    }
+                    else if (layer.image)
+                    {
+                        source.image = layer.image;
+                        source.alpha = 1.F - layer.transitionValue;
+                    }
+                    else if (layer.imageB)
+                    {
+                        source.image = layer.imageB;
+                        source.alpha = layer.transitionValue;
+                    }
+                    break;
+                default:
+                    source.image = layer.image;
+                    break;
+                }
+                if (source.image)
+                {
+                    out.push_back(source);
+                }
+            }
+            return out;
+        }
+
+        //! Get the image type with four channels of the given component.
+        ftk::ImageType getRGBAType(pixel::Component component)
+        {
+            ftk::ImageType out = ftk::ImageType::RGBA_U8;
+            switch (component)
+            {
+            case pixel::Component::U16: out = ftk::ImageType::RGBA_U16; break;
+            case pixel::Component::F16: out = ftk::ImageType::RGBA_F16; break;
+            case pixel::Component::F32: out = ftk::ImageType::RGBA_F32; break;
+            default: break;
+            }
+            return out;
+        }
+    }
+
+    bool canFlatten(const VideoFrame& frame)
+    {
+        std::shared_ptr<ftk::Image> first;
+        ftk::ImageOptions firstOptions;
+        size_t count = 0;
+        const auto check = [&first, &firstOptions, &count](
+            const std::shared_ptr<ftk::Image>& image,
+            const ftk::ImageOptions& options,
+            const std::optional<ftk::Box2F>& bounds,
+            const std::string& ocioInput)
+        {
+            // Only the images that are drawn have to agree.
+            if (!image)
+            {
+                return true;
+            }
+            if (bounds.has_value() || !ocioInput.empty())
+            {
+                return false;
+            }
+            if (!first)
+            {
+                int channels = 0;
+                pixel::Component component = pixel::Component::U8;
+                if (!pixel::getLayout(image->getInfo().type, channels, component))
+                {
+                    return false;
+                }
+                first = image;
+                firstOptions = options;
+            }
+            else if (image->getInfo() != first->getInfo() || options != firstOptions)
+            {
+                return false;
+            }
+            ++count;
+            return true;
+        };
+        bool transition = false;
+        for (const auto& layer : frame.layers)
+        {
+            if (!check(layer.image, layer.imageOptions, layer.bounds, layer.ocioInput))
+            {
+                return false;
+            }
+            if (Transition::Dissolve == layer.transition)
+            {
+                transition = true;
+                if (!check(layer.imageB, layer.imageOptionsB, layer.boundsB, layer.ocioInputB))
+                {
+                    return false;
+                }
+            }
+        }
+        return count > 1 || (count > 0 && transition);
+    }
+
+    std::shared_ptr<ftk::Image> flattenImage(const VideoFrame& frame)
+    {
+        if (!canFlatten(frame))
+        {
+            return nullptr;
+        }
+        const auto sources = getSources(frame);
+        const ftk::ImageInfo& inInfo = sources.front().image->getInfo();
+        int inChannels = 0;
+        pixel::Component component = pixel::Component::U8;
+        pixel::getLayout(inInfo.type, inChannels, component);
+        ftk::ImageInfo outInfo = inInfo;
+        outInfo.type = getRGBAType(component);
+        auto out = ftk::Image::create(outInfo);
+        out->setTags(sources.front().image->getTags());
+
+        const int w = inInfo.size.w;
+        const int h = inInfo.size.h;
+        if (w <= 0 || h <= 0)
+        {
+            return out;
+        }
+        // Rows may be padded out to the alignment.
+        const size_t inStride = sources.front().image->getByteCount() / h;
+        const size_t outStride = out->getByteCount() / h;
+        const size_t inPixel = inChannels * pixel::getSize(component);
+        const size_t outPixel = 4 * pixel::getSize(component);
+
+        std::vector<float> row(w * 4);
+        float a[4];
+        float b[4];
+        for (int y = 0; y < h; ++y)
+        {
+            // The buffer the renderer draws into starts out clear.
+            std::fill(row.begin(), row.end(), 0.F);
+            for (const auto& source : sources)
+            {
+                const uint8_t* inRow = source.image->getData() + y * inStride;
+                const uint8_t* inRowB = source.imageB ?
+                    source.imageB->getData() + y * inStride :
+                    nullptr;
+                for (int x = 0; x < w; ++x)
+                {
+                    pixel::readPixel(inRow + x * inPixel, inChannels, component, a);
+                    if (inRowB)
+                    {
+                        pixel::readPixel(inRowB + x * inPixel, inChannels, component, b);
+                        for (int c = 0; c < 4; ++c)
+                        {
+                            a[c] = a[c] * (1.F - source.dissolve) + b[c] * source.dissolve;
+                        }
+                    }
+                    a[3] *= source.alpha;
+
+                    // Straight alpha: the color is weighted by the alpha as
+                    // it is drawn, and the alpha accumulates.
+                    float* d = row.data() + x * 4;
+                    const float ia = 1.F - a[3];
+                    d[0] = a[0] * a[3] + d[0] * ia;
+                    d[1] = a[1] * a[3] + d[1] * ia;
+                    d[2] = a[2] * a[3] + d[2] * ia;
+                    d[3] = a[3] + d[3] * ia;
+                }
+            }
+            uint8_t* outRow = out->getData() + y * outStride;
+            for (int x = 0; x < w; ++x)
+            {
+                // The flattened image is drawn with straight alpha as well,
+                // which weights the color by the alpha again, so it is stored
+                // with that taken back out.
+                float* d = row.data() + x * 4;
+                if (d[3] > 0.F && d[3] < 1.F)
+                {
+                    d[0] /= d[3];
+                    d[1] /= d[3];
+                    d[2] /= d[3];
+                }
+                pixel::writePixel(d, 4, component, outRow + x * outPixel);
+            }
+        }
+        return out;
+    }
+
+    VideoFrame flattenFrame(
+        const VideoFrame& frame,
+        const std::shared_ptr<ftk::Image>& image)
+    {
+        VideoFrame out;
+        out.size = frame.size;
+        out.canvasSize = frame.canvasSize;
+        out.time = frame.time;
+        VideoLayer layer;
+        layer.image = image;
+        bool first = true;
+        // Named by what went into it, so that a stack of frames that show
+        // the same pictures is one image as well.
+        std::stringstream identity;
+        bool known = true;
+        for (const auto& i : frame.layers)
+        {
+            const bool dissolve = Transition::Dissolve == i.transition;
+            if ((i.image && i.identity.empty()) ||
+                (dissolve && i.imageB && i.identityB.empty()))
+            {
+                known = false;
+            }
+            identity << '[' << (i.image ? i.identity : std::string());
+            if (dissolve)
+            {
+                identity << '|' << (i.imageB ? i.identityB : std::string()) <<
+                    '|' << i.transitionValue;
+            }
+            identity << ']';
+            if (first && (i.image || i.imageB))
+            {
+                layer.imageOptions = i.image ? i.imageOptions : i.imageOptionsB;
+                layer.path = i.image ? i.path : i.pathB;
+                first = false;
+            }
+            layer.missing |= i.missing;
+            if (!layer.heldFrom.has_value())
+            {
+                layer.heldFrom = i.heldFrom;
+            }
+        }
+        if (known)
+        {
+            layer.identity = identity.str();
+        }
+        out.layers.push_back(layer);
+        return out;
+    }
+}
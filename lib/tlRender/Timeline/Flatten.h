@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include <tlRender/Timeline/Video.h>
+
+namespace tl
+{
+    //! Whether the layers of a video frame can be composited into one image
+    //! ahead of drawing: there is more than one image, or a transition, to
+    //! composite, and the images share a size and pixel type, use the same
+    //! image options, and fill the frame rather than being placed within
+    //! the canvas.
+    TL_API bool canFlatten(const VideoFrame&);
+
+    //! Composite the layers of a video frame into one image, the way the
+    //! renderer composites them: each layer over the ones before it with
+    //! straight alpha, and a dissolve as a mix of its two images.
+    //!
+    //! This happens in the color space of the source, so it matches what
+    //! is drawn when the layers share an input color space, which is not
+    //! something the frame can say. The image always has an alpha channel.
+    //! Null when the frame cannot be flattened.
+    TL_API std::shared_ptr<ftk::Image> flattenImage(const VideoFrame&);
+
+    //! Replace the layers of a video frame with one layer that holds a
+    //! flattened image. The layer takes the path and image options of the
+    //! first image, is missing when any of the layers was, and has an
+    //! identity made from theirs when they all have one.
+    TL_API VideoFrame flattenFrame(
+        const VideoFrame&,
+        const std::shared_ptr<ftk::Image>&);
+}
@@ -0,0 +1,235 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/Timeline/FrameCache.h>
+
+#include <tlRender/Timeline/DiskCache.h>
+#include <tlRender/Timeline/MemoryBudget.h>
+
+#include <ftk/Core/Context.h>
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace tl
+{
+    struct FrameCache::Private
+    {
+        size_t max = 0;
+
+        // The share of the memory budget.
+        size_t limit = std::numeric_limits<size_t>::max();
+        std::weak_ptr<MemoryBudget> memoryBudget;
+        uint64_t memoryID = 0;
+
+        // Where evicted frames go, when there is somewhere.
+        std::weak_ptr<DiskCache> diskCache;
+
+        // Most recently used first.
+        std::list<std::string> order;
+        struct Entry
+        {
+            VideoData data;
+            size_t byteCount = 0;
+            std::list<std::string>::iterator order;
+        };
+        std::unordered_map<std::string, Entry> entries;
+        size_t byteCount = 0;
+        mutable std::mutex mutex;
+    };
+
+    FrameCache::FrameCache(const std::shared_ptr<ftk::Context>& context) :
+        ISystem(context, "tl::FrameCache"),
+        _p(new Private)
+    {
+        FTK_P();
+        p.diskCache = context->getSystem<DiskCache>();
+        if (auto memoryBudget = context->getSystem<MemoryBudget>())
+        {
+            p.memoryBudget = memoryBudget;
+            MemoryConsumer consumer;
+            consumer.name = "Frame cache";
+            consumer.request = p.max;
+            consumer.getByteCount = [this]
+                {
+                    return getByteCount();
+                };
+            consumer.setLimit = [this](size_t value)
+                {
+                    FTK_P();
+                    std::unique_lock<std::mutex> lock(p.mutex);
+                    p.limit = value;
+                    _evict();
+                };
+            p.memoryID = memoryBudget->addConsumer(consumer);
+        }
+    }
+
+    FrameCache::~FrameCache()
+    {
+        FTK_P();
+        if (auto memoryBudget = p.memoryBudget.lock())
+        {
+            memoryBudget->removeConsumer(p.memoryID);
+        }
+    }
+
+    std::shared_ptr<FrameCache> FrameCache::create(const std::shared_ptr<ftk::Context>& context)
+    {
+        auto out = context->getSystem<FrameCache>();
+        if (!out)
+        {
+            out = std::shared_ptr<FrameCache>(new FrameCache(context));
+            context->addSystem(out);
+        }
+        return out;
+    }
+
+    std::string FrameCache::getKey(
+        const std::string& path,
+        const OTIO_NS::RationalTime& time,
+        const IOOptions& options)
+    {
+        // The layer is one of the options, but it is the one that most
+        // often differs, so it goes first where it is easy to read.
+        std::stringstream ss;
+        ss << path << '@' << time.value() << '/' << time.rate();
+        const auto i = options.find("Layer");
+        ss << '#' << (i != options.end() ? i->second : std::string());
+        for (const auto& j : options)
+        {
+            // How the file is being read says nothing about the frame, and
+            // the same frame is read playing forwards and backwards.
+            if (j.first != "IO/Access")
+            {
+                ss << ';' << j.first << '=' << j.second;
+            }
+        }
+        return ss.str();
+    }
+
+    size_t FrameCache::getMax() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        return p.max;
+    }
+
+    void FrameCache::setMax(size_t value)
+    {
+        FTK_P();
+        if (auto memoryBudget = p.memoryBudget.lock())
+        {
+            memoryBudget->setRequest(p.memoryID, value);
+        }
+        std::unique_lock<std::mutex> lock(p.mutex);
+        p.max = value;
+        _evict();
+    }
+
+    size_t FrameCache::getByteCount() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        return p.byteCount;
+    }
+
+    size_t FrameCache::getCount() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        return p.entries.size();
+    }
+
+    bool FrameCache::get(const std::string& key, VideoData& out)
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        const auto i = p.entries.find(key);
+        if (i != p.entries.end())
+        {
+            p.order.splice(p.order.begin(), p.order, i->second.order);
+            out = i->second.data;
+            return true;
+        }
+        return false;
+    }
+
+    void FrameCache::add(const std::string& key, const VideoData& data)
+    {
+        FTK_P();
+        if (!data.image || data.missing)
+        {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(p.mutex);
+        if (0 == std::min(p.max, p.limit))
+        {
+            return;
+        }
+        const size_t byteCount = data.image->getByteCount();
+        auto i = p.entries.find(key);
+        if (i != p.entries.end())
+        {
+            p.order.splice(p.order.begin(), p.order, i->second.order);
+            p.byteCount -= i->second.byteCount;
+            i->second.data = data;
+            i->second.byteCount = byteCount;
+        }
+        else
+        {
+            Private::Entry entry;
+            entry.data = data;
+            entry.byteCount = byteCount;
+            p.order.push_front(key);
+            entry.order = p.order.begin();
+            p.entries[key] = std::move(entry);
+        }
+        p.byteCount += byteCount;
+        _evict();
+    }
+
+    void FrameCache::clear()
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        p.order.clear();
+        p.entries.clear();
+        p.byteCount = 0;
+    }
+
+    void FrameCache::_evict()
+    {
+        FTK_P();
+        // Frames are evicted least recently used first, and handed to the
+        // disk cache on the way out, which only queues them. A frame that
+        // somebody else still holds is in use, so it moves to the front
+        // instead; each frame is looked at no more than once.
+        auto diskCache = p.diskCache.lock();
+        const size_t max = std::min(p.max, p.limit);
+        for (size_t count = p.order.size(); p.byteCount > max && count > 0; --count)
+        {
+            const auto i = std::prev(p.order.end());
+            const auto j = p.entries.find(*i);
+            if (j->second.data.image.use_count() > 1)
+            {
+                p.order.splice(p.order.begin(), p.order, i);
+            }
+            else
+            {
+                p.byteCount -= j->second.byteCount;
+                if (diskCache)
+                {
+                    diskCache->add(*i, j->second.data);
+                }
+                p.entries.erase(j);
+                p.order.erase(i);
+            }
+        }
+    }
+}
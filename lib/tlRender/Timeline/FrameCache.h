@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include <tlRender/IO/IO.h>
+
+#include <ftk/Core/ISystem.h>
+
+namespace tl
+{
+    //! Decoded frame cache shared by every timeline in the process.
+    //!
+    //! Timelines look here before asking a reader for a frame, so media that
+    //! is open in several players -- tabs, or the same plate compared in two
+    //! timelines -- is decoded and held in memory once.
+    //!
+    //! The cache is off until an application gives it a maximum, since
+    //! only an application that opens the same media more than once gains
+    //! from it. The maximum is one budget for the whole process. A frame
+    //! that a player's own cache still holds is pinned by it: it counts
+    //! against the budget, but evicting it would free nothing, so it is
+    //! passed over until the player lets it go.
+    //!
+    //! Frames evicted from the cache are passed on to the DiskCache, when
+    //! it was created first. The maximum is lowered to the share of the
+    //! MemoryBudget, when it was created first.
+    class TL_API_TYPE FrameCache : public ftk::ISystem
+    {
+        FTK_NON_COPYABLE(FrameCache);
+
+    protected:
+        FrameCache(const std::shared_ptr<ftk::Context>&);
+
+    public:
+        TL_API virtual ~FrameCache();
+
+        //! Create a new system.
+        TL_API static std::shared_ptr<FrameCache> create(const std::shared_ptr<ftk::Context>&);
+
+        //! Get the key for a frame: the normalized media path, the media
+        //! time, the layer, and the I/O options it was read with other than
+        //! the access hint.
+        TL_API static std::string getKey(
+            const std::string& path,
+            const OTIO_NS::RationalTime&,
+            const IOOptions&);
+
+        //! Get the maximum size in bytes. Zero, the default, turns the
+        //! cache off.
+        TL_API size_t getMax() const;
+
+        //! Set the maximum size in bytes.
+        TL_API void setMax(size_t);
+
+        //! Get the size in bytes.
+        TL_API size_t getByteCount() const;
+
+        //! Get the number of frames.
+        TL_API size_t getCount() const;
+
+        //! Get a frame. Safe to call from any thread.
+        TL_API bool get(const std::string& key, VideoData&);
+
+        //! Add a frame. Frames that stand in for missing ones are not
+        //! added, since the real frame may turn up later. Safe to call from
+        //! any thread.
+        TL_API void add(const std::string& key, const VideoData&);
+
+        //! Clear the cache.
+        TL_API void clear();
+
+    private:
+        void _evict();
+
+        FTK_PRIVATE();
+    };
+}
@@ -16,6 +16,21 @@
 
 namespace tl
 {
+    //! Renderers.
+    enum class TL_API_TYPE RenderType
+    {
+        //! Draw with OpenGL.
+        GL,
+
+        //! Draw in memory on the CPU, for machines without a display or a
+        //! GPU.
+        CPU,
+
+        Count,
+        First = GL
+    };
+    TL_ENUM(RenderType);
+
     //! Base class for renderers.
     class TL_API_TYPE IRender : public ftk::IRender
     {
@@ -39,12 +54,14 @@ namespace tl
         //! Set the LUT options.
         TL_API virtual void setLUTOptions(const LUTOptions&) = 0;
 
-        //! Draw the background.
+        //! Draw the background. The default draws it with the primitives,
+        //! which is all it needs; renderers override it to set up the
+        //! blending around them.
         TL_API virtual void drawBackground(
             const std::vector<ftk::Box2I>&,
             const ftk::M44F& vm,
             const BackgroundOptions&,
-            const CompareOptions&) = 0;
+            const CompareOptions&);
 
         //! Draw timeline video data.
         TL_API virtual void drawVideo(
@@ -55,11 +72,17 @@ namespace tl
             const CompareOptions& = CompareOptions(),
             ftk::gl::TextureType colorBuffer = ftk::gl::offscreenColorDefault) = 0;
 
-        //! Draw the foreground.
+        //! Get the statistics of the most recent difference comparison
+        //! drawn with CompareOptions::differenceStats on. They are invalid
+        //! when the last video drawn was not one.
+        TL_API virtual CompareStats getCompareStats() const = 0;
+
+        //! Draw the foreground. The default draws it with the primitives,
+        //! as the background.
         TL_API virtual void drawForeground(
             const std::vector<ftk::Box2I>&,
             const ftk::M44F& vm,
             const ForegroundOptions&,
-            const CompareOptions&) = 0;
+            const CompareOptions&);
     };
 }
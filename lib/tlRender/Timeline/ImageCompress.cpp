@@ -0,0 +1,202 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/Timeline/ImageCompress.h>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+namespace tl
+{
+    size_t CompressedImage::getByteCount() const
+    {
+        size_t out = 0;
+        for (const auto& band : bands)
+        {
+            out += band.size();
+        }
+        return out;
+    }
+
+    namespace
+    {
+        // Enough rows that a band compresses well, and few enough that a
+        // large image splits into a band for each thread.
+        const int bandRowsMax = 64;
+
+        //! Run a function over the bands on up to the given number of
+        //! threads.
+        template<typename F>
+        void forBands(size_t bandCount, size_t threadCount, F&& fn)
+        {
+            const size_t count = std::max(
+                static_cast<size_t>(1),
+                std::min(threadCount, bandCount));
+            if (count <= 1)
+            {
+                for (size_t i = 0; i < bandCount; ++i)
+                {
+                    fn(i);
+                }
+                return;
+            }
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < count; ++t)
+            {
+                threads.push_back(std::thread(
+                    [&fn, t, count, bandCount]
+                    {
+                        for (size_t i = t; i < bandCount; i += count)
+                        {
+                            fn(i);
+                        }
+                    }));
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+        }
+
+        //! The size of a pixel in bytes. The transform only has to be
+        //! undone exactly, so planar Y'CbCr, where this is not the size of
+        //! what is stored together, compresses less well but no less
+        //! correctly.
+        size_t getPixelByteCount(const ftk::ImageInfo& info)
+        {
+            return std::max(1, ftk::getChannelCount(info.type)) *
+                std::max(1, ftk::getBitDepth(info.type) / 8);
+        }
+    }
+
+    std::shared_ptr<CompressedImage> compressImage(
+        const std::shared_ptr<ftk::Image>& image,
+        size_t threadCount)
+    {
+        auto out = std::make_shared<CompressedImage>();
+        out->info = image->getInfo();
+        out->tags = image->getTags();
+        const int h = std::max(1, out->info.size.h);
+        const size_t byteCount = image->getByteCount();
+        // The last band takes whatever the rows leave over, such as
+        // alignment padding.
+        const size_t stride = byteCount / h;
+        out->bandRows = std::min(h, bandRowsMax);
+        const size_t bandCount = (h + out->bandRows - 1) / out->bandRows;
+        out->bands.resize(bandCount);
+        const size_t pixel = getPixelByteCount(out->info);
+        const uint8_t* data = image->getData();
+        forBands(
+            bandCount,
+            threadCount,
+            [&](size_t band)
+            {
+                const size_t offset = band * out->bandRows * stride;
+                const size_t size = band + 1 < bandCount ?
+                    out->bandRows * stride :
+                    byteCount - offset;
+                const uint8_t* in = data + offset;
+
+                // Gather each byte of a component into its own plane, and
+                // store the difference from the pixel before.
+                std::vector<uint8_t> planes(size);
+                const size_t pixels = size / pixel;
+                uint8_t* p = planes.data();
+                for (size_t b = 0; b < pixel; ++b)
+                {
+                    uint8_t prev = 0;
+                    for (size_t i = 0; i < pixels; ++i)
+                    {
+                        const uint8_t v = in[i * pixel + b];
+                        *p++ = v - prev;
+                        prev = v;
+                    }
+                }
+                // Padding that is not a whole pixel is kept as is.
+                std::copy(in + pixels * pixel, in + size, p);
+
+                uLongf compressedSize = compressBound(static_cast<uLong>(size));
+                std::vector<uint8_t>& compressed = out->bands[band];
+                compressed.resize(compressedSize);
+                if (compress2(
+                    compressed.data(),
+                    &compressedSize,
+                    planes.data(),
+                    static_cast<uLong>(size),
+                    Z_BEST_SPEED) != Z_OK)
+                {
+                    compressed.clear();
+                    return;
+                }
+                compressed.resize(compressedSize);
+                compressed.shrink_to_fit();
+            });
+        for (const auto& band : out->bands)
+        {
+            if (band.empty() && byteCount > 0)
+            {
+                throw std::runtime_error("Cannot compress the image");
+            }
+        }
+        return out;
+    }
+
+    std::shared_ptr<ftk::Image> decompressImage(
+        const std::shared_ptr<CompressedImage>& compressed,
+        size_t threadCount)
+    {
+        auto out = ftk::Image::create(compressed->info);
+        out->setTags(compressed->tags);
+        const int h = std::max(1, compressed->info.size.h);
+        const size_t byteCount = out->getByteCount();
+        const size_t stride = byteCount / h;
+        const size_t pixel = getPixelByteCount(compressed->info);
+        uint8_t* data = out->getData();
+        std::atomic<bool> error(false);
+        forBands(
+            compressed->bands.size(),
+            threadCount,
+            [&](size_t band)
+            {
+                const size_t offset = band * compressed->bandRows * stride;
+                const size_t size = band + 1 < compressed->bands.size() ?
+                    compressed->bandRows * stride :
+                    byteCount - offset;
+                std::vector<uint8_t> planes(size);
+                uLongf planesSize = static_cast<uLongf>(size);
+                const auto& in = compressed->bands[band];
+                if (uncompress(
+                    planes.data(),
+                    &planesSize,
+                    in.data(),
+                    static_cast<uLong>(in.size())) != Z_OK ||
+                    planesSize != size)
+                {
+                    error = true;
+                    return;
+                }
+                uint8_t* o = data + offset;
+                const size_t pixels = size / pixel;
+                const uint8_t* p = planes.data();
+                for (size_t b = 0; b < pixel; ++b)
+                {
+                    uint8_t prev = 0;
+                    for (size_t i = 0; i < pixels; ++i)
+                    {
+                        prev += *p++;
+                        o[i * pixel + b] = prev;
+                    }
+                }
+                std::copy(p, planes.data() + size, o + pixels * pixel);
+            });
+        if (error)
+        {
+            throw std::runtime_error("Cannot decompress the image");
+        }
+        return out;
+    }
+}
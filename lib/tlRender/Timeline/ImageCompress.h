@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include <tlRender/Core/Export.h>
+
+#include <ftk/Core/Image.h>
+
+#include <memory>
+#include <vector>
+
+namespace tl
+{
+    //! An image compressed without loss.
+    //!
+    //! The rows are compressed in bands so that the bands can be compressed
+    //! and decompressed on separate threads. Within a band the bytes of each
+    //! component are gathered into planes and stored as the difference from
+    //! the same byte of the pixel before, which turns the smooth gradients
+    //! of float and half float images into runs the compressor can find.
+    struct TL_API_TYPE CompressedImage
+    {
+        ftk::ImageInfo info;
+        ftk::ImageTags tags;
+        int bandRows = 0;
+        std::vector<std::vector<uint8_t> > bands;
+
+        //! Get the compressed size in bytes.
+        TL_API size_t getByteCount() const;
+    };
+
+    //! Compress an image.
+    TL_API std::shared_ptr<CompressedImage> compressImage(
+        const std::shared_ptr<ftk::Image>&,
+        size_t threadCount = 1);
+
+    //! Decompress an image.
+    TL_API std::shared_ptr<ftk::Image> decompressImage(
+        const std::shared_ptr<CompressedImage>&,
+        size_t threadCount = 1);
+}
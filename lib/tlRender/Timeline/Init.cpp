@@ -4,6 +4,9 @@
 #include <tlRender/Timeline/Init.h>
 
 #include <tlRender/Timeline/AudioSystem.h>
+#include <tlRender/Timeline/DiskCache.h>
+#include <tlRender/Timeline/FrameCache.h>
+#include <tlRender/Timeline/MemoryBudget.h>
 #include <tlRender/Timeline/Player.h>
 #include <tlRender/Timeline/System.h>
 
@@ -50,6 +53,18 @@ namespace tl
         ReadSystem::create(context);
         WriteSystem::create(context);
 
+        // The caches register with the memory budget when they are made,
+        // so it comes first.
+        std::weak_ptr<MemoryBudget> memoryBudget = MemoryBudget::create(context);
+        diagSystem->addSampler(
+            "tl Memory/Budget: {0}MB",
+            [memoryBudget]
+            {
+                auto budget = memoryBudget.lock();
+                return budget ? budget->getEffectiveMax() / ftk::megabyte : 0;
+            });
+        DiskCache::create(context);
+        FrameCache::create(context);
         System::create(context);
     }
 }
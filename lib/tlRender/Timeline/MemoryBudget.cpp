@@ -0,0 +1,411 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/Timeline/MemoryBudget.h>
+
+#include <ftk/Core/Context.h>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+namespace tl
+{
+    TL_ENUM_IMPL(
+        MemoryPriority,
+        "Low",
+        "Normal",
+        "High");
+
+    bool MemoryUsage::operator == (const MemoryUsage& other) const
+    {
+        return
+            name == other.name &&
+            priority == other.priority &&
+            request == other.request &&
+            limit == other.limit &&
+            byteCount == other.byteCount;
+    }
+
+    bool MemoryUsage::operator != (const MemoryUsage& other) const
+    {
+        return !(*this == other);
+    }
+
+    namespace
+    {
+        // How often the kernel is asked about memory.
+        const std::chrono::seconds pollInterval(1);
+
+        // The share of a cgroup limit left to the caches. The rest is for
+        // everything else: decoders, textures, the application.
+        const float cgroupShare = .75F;
+
+        // Pressure, as the percentage of time tasks were stalled waiting for
+        // memory, above which the budget shrinks and below which it grows
+        // back, and how quickly.
+        const float pressureHigh = 10.F;
+        const float pressureLow = 1.F;
+        const float pressureShrink = .75F;
+        const float pressureGrow = .05F;
+        const float pressureScaleMin = .25F;
+
+        std::string readFile(const std::string& fileName)
+        {
+            std::ifstream f(fileName);
+            std::stringstream ss;
+            ss << f.rdbuf();
+            return ss.str();
+        }
+    }
+
+    struct MemoryBudget::Private
+    {
+        size_t max = 0;
+        std::optional<size_t> cgroupMax;
+        float pressureScale = 1.F;
+        size_t effectiveMax = 0;
+
+        struct Consumer
+        {
+            MemoryConsumer consumer;
+            std::optional<size_t> limit;
+        };
+        uint64_t id = 0;
+        std::map<uint64_t, Consumer> consumers;
+        bool changed = true;
+
+        std::string cgroupDir;
+        std::chrono::steady_clock::time_point pollTimer;
+        mutable std::mutex mutex;
+    };
+
+    MemoryBudget::MemoryBudget(const std::shared_ptr<ftk::Context>& context) :
+        ISystem(context, "tl::MemoryBudget"),
+        _p(new Private)
+    {
+#if defined(__linux__)
+        // With cgroup v2 the process belongs to one group, named on the
+        // line that starts "0::".
+        FTK_P();
+        std::stringstream ss(readFile("/proc/self/cgroup"));
+        std::string line;
+        while (std::getline(ss, line))
+        {
+            if (0 == line.compare(0, 3, "0::"))
+            {
+                p.cgroupDir = "/sys/fs/cgroup" + line.substr(3);
+                break;
+            }
+        }
+#endif // __linux__
+    }
+
+    MemoryBudget::~MemoryBudget()
+    {}
+
+    std::shared_ptr<MemoryBudget> MemoryBudget::create(const std::shared_ptr<ftk::Context>& context)
+    {
+        auto out = context->getSystem<MemoryBudget>();
+        if (!out)
+        {
+            out = std::shared_ptr<MemoryBudget>(new MemoryBudget(context));
+            context->addSystem(out);
+        }
+        return out;
+    }
+
+    size_t MemoryBudget::getMax() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        return p.max;
+    }
+
+    void MemoryBudget::setMax(size_t value)
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        p.max = value;
+        p.changed = true;
+    }
+
+    size_t MemoryBudget::getEffectiveMax() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        return p.effectiveMax;
+    }
+
+    uint64_t MemoryBudget::addConsumer(const MemoryConsumer& consumer)
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        const uint64_t id = ++p.id;
+        p.consumers[id].consumer = consumer;
+        p.changed = true;
+        return id;
+    }
+
+    void MemoryBudget::removeConsumer(uint64_t id)
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        p.consumers.erase(id);
+        p.changed = true;
+    }
+
+    void MemoryBudget::setRequest(uint64_t id, size_t value)
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        const auto i = p.consumers.find(id);
+        if (i != p.consumers.end() && value != i->second.consumer.request)
+        {
+            i->second.consumer.request = value;
+            p.changed = true;
+        }
+    }
+
+    void MemoryBudget::setPriority(uint64_t id, MemoryPriority value)
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex);
+        const auto i = p.consumers.find(id);
+        if (i != p.consumers.end() && value != i->second.consumer.priority)
+        {
+            i->second.consumer.priority = value;
+            p.changed = true;
+        }
+    }
+
+    std::vector<MemoryUsage> MemoryBudget::getUsage() const
+    {
+        FTK_P();
+        std::vector<MemoryUsage> out;
+        std::vector<std::function<size_t()> > getByteCount;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            for (const auto& i : p.consumers)
+            {
+                MemoryUsage usage;
+                usage.name = i.second.consumer.name;
+                usage.priority = i.second.consumer.priority;
+                usage.request = i.second.consumer.request;
+                usage.limit = i.second.limit.value_or(usage.request);
+                out.push_back(usage);
+                getByteCount.push_back(i.second.consumer.getByteCount);
+            }
+        }
+
+        // Asked outside of the lock: a consumer may be holding its own lock
+        // while it sets its request.
+        for (size_t i = 0; i < out.size(); ++i)
+        {
+            if (getByteCount[i])
+            {
+                out[i].byteCount = getByteCount[i]();
+            }
+        }
+        return out;
+    }
+
+    void MemoryBudget::update()
+    {
+        FTK_P();
+        std::vector<std::pair<std::function<void(size_t)>, size_t> > limits;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            std::vector<std::pair<MemoryPriority, size_t> > requests;
+            size_t requestTotal = 0;
+            for (const auto& i : p.consumers)
+            {
+                requests.push_back({ i.second.consumer.priority, i.second.consumer.request });
+                requestTotal += i.second.consumer.request;
+            }
+
+            size_t max = p.max;
+            if (p.cgroupMax.has_value())
+            {
+                const size_t cgroupMax = p.cgroupMax.value() * cgroupShare;
+                max = max > 0 ? std::min(max, cgroupMax) : cgroupMax;
+            }
+            if (p.pressureScale < 1.F)
+            {
+                // Under pressure with no budget of its own, what is asked
+                // for is what shrinks.
+                max = (max > 0 ? std::min(max, requestTotal) : requestTotal) * p.pressureScale;
+            }
+            p.effectiveMax = max;
+
+            const auto shares = shareMemoryBudget(max, requests);
+            size_t j = 0;
+            for (auto& i : p.consumers)
+            {
+                const size_t share = shares[j++];
+                if (!i.second.limit.has_value() || share != i.second.limit.value())
+                {
+                    i.second.limit = share;
+                    limits.push_back({ i.second.consumer.setLimit, share });
+                }
+            }
+            p.changed = false;
+        }
+
+        // Called outside of the lock, since a consumer applying its limit
+        // may set its request.
+        for (const auto& i : limits)
+        {
+            if (i.first)
+            {
+                i.first(i.second);
+            }
+        }
+    }
+
+    void MemoryBudget::tick()
+    {
+        FTK_P();
+        bool changed = false;
+        const auto now = std::chrono::steady_clock::now();
+        if (now - p.pollTimer >= pollInterval)
+        {
+            p.pollTimer = now;
+#if defined(__linux__)
+            std::optional<size_t> cgroupMax;
+            std::optional<float> pressure;
+            if (!p.cgroupDir.empty())
+            {
+                cgroupMax = parseCgroupMemoryMax(readFile(p.cgroupDir + "/memory.max"));
+
+                // The group's own pressure, so that a container is not
+                // shrunk by what the rest of the machine is doing.
+                pressure = parseMemoryPressure(readFile(p.cgroupDir + "/memory.pressure"));
+            }
+            if (!pressure.has_value())
+            {
+                pressure = parseMemoryPressure(readFile("/proc/pressure/memory"));
+            }
+            std::unique_lock<std::mutex> lock(p.mutex);
+            if (cgroupMax != p.cgroupMax)
+            {
+                p.cgroupMax = cgroupMax;
+                changed = true;
+            }
+            if (pressure.has_value())
+            {
+                float scale = p.pressureScale;
+                if (pressure.value() > pressureHigh)
+                {
+                    scale = std::max(scale * pressureShrink, pressureScaleMin);
+                }
+                else if (pressure.value() < pressureLow)
+                {
+                    scale = std::min(scale + pressureGrow, 1.F);
+                }
+                if (scale != p.pressureScale)
+                {
+                    p.pressureScale = scale;
+                    changed = true;
+                }
+            }
+#endif // __linux__
+        }
+        {
+            std::unique_lock<std::mutex> lock(p.mutex);
+            changed |= p.changed;
+        }
+        if (changed)
+        {
+            update();
+        }
+    }
+
+    std::chrono::milliseconds MemoryBudget::getTickTime() const
+    {
+        return std::chrono::milliseconds(100);
+    }
+
+    std::vector<size_t> shareMemoryBudget(
+        size_t max,
+        const std::vector<std::pair<MemoryPriority, size_t> >& requests)
+    {
+        std::vector<size_t> out(requests.size(), 0);
+        if (0 == max)
+        {
+            for (size_t i = 0; i < requests.size(); ++i)
+            {
+                out[i] = requests[i].second;
+            }
+            return out;
+        }
+        size_t remaining = max;
+        for (int priority = static_cast<int>(MemoryPriority::Count) - 1; priority >= 0; --priority)
+        {
+            size_t total = 0;
+            for (const auto& request : requests)
+            {
+                if (static_cast<int>(request.first) == priority)
+                {
+                    total += request.second;
+                }
+            }
+            const double scale = total > remaining ?
+                (remaining / static_cast<double>(total)) :
+                1.0;
+            for (size_t i = 0; i < requests.size(); ++i)
+            {
+                if (static_cast<int>(requests[i].first) == priority)
+                {
+                    out[i] = requests[i].second * scale;
+                }
+            }
+            remaining -= std::min(total, remaining);
+        }
+        return out;
+    }
+
+    std::optional<float> parseMemoryPressure(const std::string& value)
+    {
+        // some avg10=0.00 avg60=0.00 avg300=0.00 total=0
+        // full avg10=0.00 avg60=0.00 avg300=0.00 total=0
+        std::stringstream ss(value);
+        std::string line;
+        while (std::getline(ss, line))
+        {
+            if (0 == line.compare(0, 5, "some "))
+            {
+                const auto i = line.find("avg10=");
+                if (i != std::string::npos)
+                {
+                    try
+                    {
+                        return std::stof(line.substr(i + 6));
+                    }
+                    catch (const std::exception&)
+                    {}
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<size_t> parseCgroupMemoryMax(const std::string& value)
+    {
+        std::stringstream ss(value);
+        std::string word;
+        ss >> word;
+        if (!word.empty() && word != "max")
+        {
+            try
+            {
+                return static_cast<size_t>(std::stoull(word));
+            }
+            catch (const std::exception&)
+            {}
+        }
+        return std::nullopt;
+    }
+}
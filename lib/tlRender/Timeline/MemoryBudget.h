@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include <tlRender/Core/Util.h>
+
+#include <ftk/Core/ISystem.h>
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace tl
+{
+    //! Memory priorities. When the budget runs short the lowest give up
+    //! their memory first.
+    enum class TL_API_TYPE MemoryPriority
+    {
+        Low,
+        Normal,
+        High,
+
+        Count,
+        First = Low
+    };
+    TL_ENUM(MemoryPriority);
+
+    //! A cache that takes part in the memory budget.
+    struct TL_API_TYPE MemoryConsumer
+    {
+        std::string name;
+        MemoryPriority priority = MemoryPriority::Normal;
+
+        //! The size in bytes the consumer would like to use.
+        size_t request = 0;
+
+        //! Get the size in bytes the consumer uses.
+        std::function<size_t()> getByteCount;
+
+        //! Set the size in bytes the consumer may use. It is called on the
+        //! main thread.
+        std::function<void(size_t)> setLimit;
+    };
+
+    //! Memory use of a consumer.
+    struct TL_API_TYPE MemoryUsage
+    {
+        std::string name;
+        MemoryPriority priority = MemoryPriority::Normal;
+        size_t request = 0;
+        size_t limit = 0;
+        size_t byteCount = 0;
+
+        TL_API bool operator == (const MemoryUsage&) const;
+        TL_API bool operator != (const MemoryUsage&) const;
+    };
+
+    //! One memory budget for the caches of the whole process.
+    //!
+    //! Each cache is sized on its own, so with enough timelines open they
+    //! add up to more than the machine has. The caches register here with
+    //! the size they would like and a priority, and are told how much they
+    //! may have: the highest priorities get what they ask for first, and
+    //! what is left is shared by the rest. The budget is set here, once for
+    //! the process, rather than by any one player.
+    //!
+    //! On Linux the budget also follows the memory limit of the cgroup the
+    //! process runs in, and shrinks while the kernel reports memory
+    //! pressure, growing back once it has passed.
+    class TL_API_TYPE MemoryBudget : public ftk::ISystem
+    {
+        FTK_NON_COPYABLE(MemoryBudget);
+
+    protected:
+        MemoryBudget(const std::shared_ptr<ftk::Context>&);
+
+    public:
+        TL_API virtual ~MemoryBudget();
+
+        //! Create a new system.
+        TL_API static std::shared_ptr<MemoryBudget> create(const std::shared_ptr<ftk::Context>&);
+
+        //! Get the budget in bytes.
+        TL_API size_t getMax() const;
+
+        //! Set the budget in bytes. Zero gives the consumers what they ask
+        //! for, unless the cgroup limit or memory pressure says otherwise.
+        TL_API void setMax(size_t);
+
+        //! Get the budget in effect, after the cgroup limit and memory
+        //! pressure. Zero is no budget.
+        TL_API size_t getEffectiveMax() const;
+
+        //! Add a consumer. Returns an ID for the functions below.
+        TL_API uint64_t addConsumer(const MemoryConsumer&);
+
+        //! Remove a consumer.
+        TL_API void removeConsumer(uint64_t);
+
+        //! Set the size a consumer would like to use.
+        TL_API void setRequest(uint64_t, size_t);
+
+        //! Set the priority of a consumer.
+        TL_API void setPriority(uint64_t, MemoryPriority);
+
+        //! Get the memory use of the consumers.
+        TL_API std::vector<MemoryUsage> getUsage() const;
+
+        //! Share out the budget now, rather than on the next tick.
+        TL_API void update();
+
+        TL_API void tick() override;
+        TL_API std::chrono::milliseconds getTickTime() const override;
+
+    private:
+        FTK_PRIVATE();
+    };
+
+    //! Share a budget in bytes among requests by priority. Each priority
+    //! gets what it asks for while there is enough, and what is left is
+    //! shared in proportion to the requests of the priority where it runs
+    //! out. A budget of zero grants every request.
+    TL_API std::vector<size_t> shareMemoryBudget(
+        size_t max,
+        const std::vector<std::pair<MemoryPriority, size_t> >& requests);
+
+    //! Parse the ten second average of memory pressure, as a percentage,
+    //! from the contents of a cgroup's memory.pressure or of
+    //! /proc/pressure/memory, which share a format.
+    TL_API std::optional<float> parseMemoryPressure(const std::string&);
+
+    //! Parse the contents of a cgroup memory.max file. There is no limit
+    //! when it says "max".
+    TL_API std::optional<size_t> parseCgroupMemoryMax(const std::string&);
+}
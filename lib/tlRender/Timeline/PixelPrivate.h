@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include <ftk/Core/Image.h>
+
+#include <Imath/half.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace tl
+{
+    //! Reading and writing the pixels of the packed image types as RGBA
+    //! floats, for the few places that work on images on the CPU.
+    namespace pixel
+    {
+        enum class Component
+        {
+            U8,
+            U16,
+            F16,
+            F32
+        };
+
+        inline bool getLayout(ftk::ImageType type, int& channels, Component& component)
+        {
+            bool out = true;
+            switch (type)
+            {
+            case ftk::ImageType::L_U8: channels = 1; component = Component::U8; break;
+            case ftk::ImageType::L_U16: channels = 1; component = Component::U16; break;
+            case ftk::ImageType::L_F16: channels = 1; component = Component::F16; break;
+            case ftk::ImageType::L_F32: channels = 1; component = Component::F32; break;
+            case ftk::ImageType::LA_U8: channels = 2; component = Component::U8; break;
+            case ftk::ImageType::LA_U16: channels = 2; component = Component::U16; break;
+            case ftk::ImageType::LA_F16: channels = 2; component = Component::F16; break;
+            case ftk::ImageType::LA_F32: channels = 2; component = Component::F32; break;
+            case ftk::ImageType::RGB_U8: channels = 3; component = Component::U8; break;
+            case ftk::ImageType::RGB_U16: channels = 3; component = Component::U16; break;
+            case ftk::ImageType::RGB_F16: channels = 3; component = Component::F16; break;
+            case ftk::ImageType::RGB_F32: channels = 3; component = Component::F32; break;
+            case ftk::ImageType::RGBA_U8: channels = 4; component = Component::U8; break;
+            case ftk::ImageType::RGBA_U16: channels = 4; component = Component::U16; break;
+            case ftk::ImageType::RGBA_F16: channels = 4; component = Component::F16; break;
+            case ftk::ImageType::RGBA_F32: channels = 4; component = Component::F32; break;
+            default: out = false; break;
+            }
+            return out;
+        }
+
+        inline float getValue(const uint8_t* p, Component component)
+        {
+            float out = 0.F;
+            switch (component)
+            {
+            case Component::U8: out = *p / 255.F; break;
+            case Component::U16:
+            {
+                uint16_t v = 0;
+                std::memcpy(&v, p, sizeof(uint16_t));
+                out = v / 65535.F;
+                break;
+            }
+            case Component::F16:
+            {
+                uint16_t v = 0;
+                std::memcpy(&v, p, sizeof(uint16_t));
+                Imath::half h;
+                h.setBits(v);
+                out = h;
+                break;
+            }
+            case Component::F32: std::memcpy(&out, p, sizeof(float)); break;
+            default: break;
+            }
+            return out;
+        }
+
+        inline void setValue(float value, Component component, uint8_t* p)
+        {
+            switch (component)
+            {
+            case Component::U8:
+                *p = static_cast<uint8_t>(std::min(std::max(value, 0.F), 1.F) * 255.F + .5F);
+                break;
+            case Component::U16:
+            {
+                const uint16_t v = static_cast<uint16_t>(
+                    std::min(std::max(value, 0.F), 1.F) * 65535.F + .5F);
+                std::memcpy(p, &v, sizeof(uint16_t));
+                break;
+            }
+            case Component::F16:
+            {
+                const uint16_t v = Imath::half(value).bits();
+                std::memcpy(p, &v, sizeof(uint16_t));
+                break;
+            }
+            case Component::F32: std::memcpy(p, &value, sizeof(float)); break;
+            default: break;
+            }
+        }
+
+        inline size_t getSize(Component component)
+        {
+            size_t out = 1;
+            switch (component)
+            {
+            case Component::U16:
+            case Component::F16: out = 2; break;
+            case Component::F32: out = 4; break;
+            default: break;
+            }
+            return out;
+        }
+
+        //! Read a pixel as RGBA.
+        inline void readPixel(const uint8_t* p, int channels, Component component, float* out)
+        {
+            const size_t size = getSize(component);
+            switch (channels)
+            {
+            case 1:
+                out[0] = out[1] = out[2] = getValue(p, component);
+                out[3] = 1.F;
+                break;
+            case 2:
+                out[0] = out[1] = out[2] = getValue(p, component);
+                out[3] = getValue(p + size, component);
+                break;
+            case 3:
+                out[0] = getValue(p, component);
+                out[1] = getValue(p + size, component);
+                out[2] = getValue(p + size * 2, component);
+                out[3] = 1.F;
+                break;
+            case 4:
+                for (int c = 0; c < 4; ++c)
+                {
+                    out[c] = getValue(p + size * c, component);
+                }
+                break;
+            default: break;
+            }
+        }
+
+        //! Write an RGBA pixel.
+        inline void writePixel(const float* in, int channels, Component component, uint8_t* p)
+        {
+            const size_t size = getSize(component);
+            switch (channels)
+            {
+            case 1:
+                setValue(in[0], component, p);
+                break;
+            case 2:
+                setValue(in[0], component, p);
+                setValue(in[3], component, p + size);
+                break;
+            case 3:
+                for (int c = 0; c < 3; ++c)
+                {
+                    setValue(in[c], component, p + size * c);
+                }
+                break;
+            case 4:
+                for (int c = 0; c < 4; ++c)
+                {
+                    setValue(in[c], component, p + size * c);
+                }
+                break;
+            default: break;
+            }
+        }
+    }
+}
@@ -6,12 +6,16 @@
 #include <tlRender/Timeline/System.h>
 #include <tlRender/Timeline/Util.h>
 
+#include <tlRender/IO/Completion.h>
+
 #include <ftk/Core/Context.h>
 #include <ftk/Core/Error.h>
 #include <ftk/Core/Format.h>
 #include <ftk/Core/String.h>
 #include <ftk/Core/Time.h>
 
+#include <algorithm>
+
 namespace tl
 {
     bool PlayerCacheInfo::operator == (const PlayerCacheInfo& other) const
@@ -20,7 +24,11 @@ namespace tl
             videoPercentage == other.videoPercentage &&
             audioPercentage == other.audioPercentage &&
             video == other.video &&
-            audio == other.audio;
+            audio == other.audio &&
+            compressedPercentage == other.compressedPercentage &&
+            compressed == other.compressed &&
+            videoByteCount == other.videoByteCount &&
+            videoSharedByteCount == other.videoSharedByteCount;
     }
 
     bool PlayerCacheInfo::operator != (const PlayerCacheInfo& other) const
@@ -81,7 +89,7 @@ namespace tl
                 arg(playerOptions.audioBufferFrameCount));
             lines.push_back(ftk::Format("    * Mute timeout: {0}ms").
                 arg(playerOptions.muteTimeout.count()));
-            lines.push_back(ftk::Format("    * Sleep timeout: {0}ms").
+            lines.push_back(ftk::Format("    * Request timeout: {0}ms").
                 arg(playerOptions.sleepTimeout.count()));
             logSystem->print(
                 ftk::Format("tl::Player {0}").arg(this),
@@ -116,6 +124,8 @@ namespace tl
         p.ioOptions = ftk::Observable<IOOptions>::create();
         p.mediaReferenceKey = ftk::Observable<std::string>::create(
             timeline->getMediaReferenceKey());
+        p.proxyKey = ftk::Observable<std::string>::create();
+        p.decodeRate = ftk::Observable<double>::create(0.0);
         p.videoLayer = ftk::Observable<int>::create(0);
         p.compareVideoLayers = ftk::ObservableList<int>::create();
         p.currentVideoFrame = ftk::ObservableList<VideoFrame>::create();
@@ -165,6 +175,27 @@ namespace tl
         // Initialize the audio.
         p.audioInit(context);
 
+        // Take part in the memory budget.
+        p.memoryShare = std::make_shared<Private::MemoryShare>();
+        if (auto memoryBudget = context->getSystem<MemoryBudget>())
+        {
+            p.memoryBudget = memoryBudget;
+            MemoryConsumer consumer;
+            consumer.name = "Player: " + timeline->getPath().get();
+            consumer.priority = p.memoryPriority;
+            consumer.request = Private::getRequest(p.cacheOptions->get());
+            auto memoryShare = p.memoryShare;
+            consumer.getByteCount = [memoryShare]
+                {
+                    return memoryShare->byteCount.load();
+                };
+            consumer.setLimit = [memoryShare](size_t value)
+                {
+                    memoryShare->limit = value;
+                };
+            p.memoryID = memoryBudget->addConsumer(consumer);
+        }
+
         // Create a new thread.
         p.mutex.state.currentTime = p.currentTime->get();
         p.mutex.state.inOutRange = p.inOutRange->get();
@@ -172,6 +203,16 @@ namespace tl
         p.mutex.state.cacheOptions = p.cacheOptions->get();
         p.audioMutex.state.speed = p.speed->get() * p.speedMult->get();
         p.log();
+        p.completion = Completion::create(
+            [this]
+            {
+                FTK_P();
+                {
+                    std::unique_lock<std::mutex> lock(p.mutex.mutex);
+                    p.mutex.completed = true;
+                }
+                p.thread.cv.notify_one();
+            });
         p.running = true;
         p.thread.thread = std::thread(
             [this]
@@ -183,6 +224,23 @@ namespace tl
     namespace
     {
         std::atomic<size_t> objectCount = 0;
+
+        // How long the cache thread sleeps with nothing in flight; the
+        // cache information is refreshed at about this interval.
+        const std::chrono::milliseconds idleTimeout(500);
+
+        // The number of frames ahead of the current time handed to
+        // present().
+        const int presentVideoFrames = 4;
+
+        // How long the reason to switch to the proxies, or back, has to
+        // last before the switch is made, so that one slow second does not
+        // flip the media back and forth.
+        const std::chrono::milliseconds proxyHold(1000);
+
+        // How far the playback speed has to drop below the rate the media
+        // was decoded at before the player goes back to it.
+        const double proxyRestoreRatio = 1.25;
     }
 
     Player::Player() :
@@ -201,11 +259,21 @@ namespace tl
                 p.timeline->getPath().get());
         }
 
-        p.running = false;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            p.running = false;
+        }
+        p.thread.cv.notify_one();
         if (p.thread.thread.joinable())
         {
             p.thread.thread.join();
         }
+        p.stopCompressPool();
+        p.completion->close();
+        if (auto memoryBudget = p.memoryBudget.lock())
+        {
+            memoryBudget->removeConsumer(p.memoryID);
+        }
 
 #if defined(FTK_SDL2)
         if (p.sdlID > 0)
@@ -807,6 +875,37 @@ namespace tl
         return std::vector<std::string>(keys.begin(), keys.end());
     }
 
+    const std::string& Player::getProxyKey() const
+    {
+        return _p->proxyKey->get();
+    }
+
+    std::shared_ptr<ftk::IObservable<std::string> > Player::observeProxyKey() const
+    {
+        return _p->proxyKey;
+    }
+
+    void Player::setProxyKey(const std::string& value)
+    {
+        FTK_P();
+        if (p.proxyKey->setIfChanged(value) && p.proxySwitch.restoreKey.has_value())
+        {
+            const std::string key = p.proxySwitch.restoreKey.value();
+            p.proxySwitch = Private::ProxySwitch();
+            setMediaReferenceKey(key);
+        }
+    }
+
+    double Player::getDecodeRate() const
+    {
+        return _p->decodeRate->get();
+    }
+
+    std::shared_ptr<ftk::IObservable<double> > Player::observeDecodeRate() const
+    {
+        return _p->decodeRate;
+    }
+
     int Player::getVideoLayer() const
     {
         return _p->videoLayer->get();
@@ -876,8 +975,12 @@ namespace tl
         FTK_P();
         if (p.cacheOptions->setIfChanged(value))
         {
+            if (auto memoryBudget = p.memoryBudget.lock())
+            {
+                memoryBudget->setRequest(p.memoryID, Private::getRequest(value));
+            }
             std::unique_lock<std::mutex> lock(p.mutex.mutex);
-            p.mutex.state.cacheOptions = value;
+            p.mutex.state.cacheOptions = p.getBudgetCacheOptions();
         }
     }
 
@@ -894,6 +997,24 @@ namespace tl
         p.mutex.clearCache = true;
     }
 
+    MemoryPriority Player::getMemoryPriority() const
+    {
+        return _p->memoryPriority;
+    }
+
+    void Player::setMemoryPriority(MemoryPriority value)
+    {
+        FTK_P();
+        if (value != p.memoryPriority)
+        {
+            p.memoryPriority = value;
+            if (auto memoryBudget = p.memoryBudget.lock())
+            {
+                memoryBudget->setPriority(p.memoryID, value);
+            }
+        }
+    }
+
     void Player::_setSpeedMult(double value)
     {
         FTK_P();
@@ -910,14 +1031,97 @@ namespace tl
         }
     }
 
+    void Player::present(const std::chrono::steady_clock::time_point& value)
+    {
+        FTK_P();
+
+        // With audio the audio device is the clock.
+        const double timelineSpeed = p.timeRange.duration().rate();
+        const auto playback = p.playback->get();
+        if (Playback::Stop == playback || timelineSpeed <= 0.0 || p.hasAudio())
+        {
+            return;
+        }
+
+        // Number the refresh, and get the frame for the next one: what is
+        // drawn now is shown then.
+        bool locked = false;
+        bool wasLocked = false;
+        OTIO_NS::RationalTime start;
+        int64_t frames = 0;
+        {
+            std::unique_lock<std::mutex> lock(p.noAudio.mutex);
+            const int64_t refresh = p.noAudio.presentClock.addRefresh(value);
+            locked = p.noAudio.presentClock.isLocked(value);
+            wasLocked = p.noAudio.presentLocked;
+            p.noAudio.presentLocked = locked;
+            start = p.noAudio.start;
+            frames = p.noAudio.presentClock.getFrames(
+                refresh + 1,
+                p.speed->get() * p.speedMult->get());
+        }
+        if (!locked)
+        {
+            return;
+        }
+        if (!wasLocked)
+        {
+            // Take over from where the wall clock got to.
+            p.playbackReset(p.currentTime->get());
+            return;
+        }
+
+        // Count the dropped frames from the frame that is on the display.
+        if (!p.timeline->getIOInfo().video.empty())
+        {
+            const auto& videoFrame = p.currentVideoFrame->get();
+            p.droppedFramesTick(
+                !videoFrame.empty() ?
+                    std::optional<OTIO_NS::RationalTime>(videoFrame[0].time) :
+                    std::nullopt,
+                playback,
+                timelineSpeed);
+        }
+
+        p.setPlaybackTime(start + OTIO_NS::RationalTime(
+            Playback::Reverse == playback ? -frames : frames,
+            timelineSpeed));
+
+        // Take the frame from the cache rather than waiting for the thread.
+        std::vector<VideoFrame> videoFrame;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            p.mutex.state.currentTime = p.currentTime->get();
+            const auto i = p.mutex.presentVideo.find(p.currentTime->get());
+            if (i != p.mutex.presentVideo.end())
+            {
+                videoFrame = i->second;
+            }
+        }
+        p.thread.cv.notify_one();
+        if (!videoFrame.empty())
+        {
+            p.currentVideoFrame->setIfChanged(videoFrame);
+        }
+    }
+
     void Player::_tick()
     {
         FTK_P();
 
+        // Whether the display refreshes are pacing playback; see present().
+        bool presentLocked = false;
+        {
+            std::unique_lock<std::mutex> lock(p.noAudio.mutex);
+            presentLocked =
+                p.noAudio.presentLocked &&
+                p.noAudio.presentClock.isLocked(std::chrono::steady_clock::now());
+        }
+
         // Calculate the current time.
         const double timelineSpeed = p.timeRange.duration().rate();
         const auto playback = p.playback->get();
-        if (playback != Playback::Stop && timelineSpeed > 0.0)
+        if (playback != Playback::Stop && timelineSpeed > 0.0 && !presentLocked)
         {
             OTIO_NS::RationalTime start;
             double t = 0.0;
@@ -943,39 +1147,118 @@ namespace tl
             {
                 t = -t;
             }
-            bool looped = false;
-            const OTIO_NS::RationalTime currentTime = p.loopPlayback(
+            p.setPlaybackTime(
                 start +
-                OTIO_NS::RationalTime(t, 1.0).rescaled_to(timelineSpeed).floor(),
-                looped);
-            //const double currentTimeDiff = abs(currentTime.value() - p.currentTime->get().value());
-            if (p.currentTime->setIfChanged(currentTime))
-            {
-                if (looped)
-                {
-                    p.seek->setAlways(currentTime);
-                }
-            }
+                OTIO_NS::RationalTime(t, 1.0).rescaled_to(timelineSpeed).floor());
+        }
+
+        // Follow the share of the memory budget.
+        const size_t request = Private::getRequest(p.cacheOptions->get());
+        const size_t limit = p.memoryShare->limit;
+        const float memoryScale = request > 0 && limit < request ?
+            (limit / static_cast<float>(request)) :
+            1.F;
+        if (memoryScale != p.memoryScale)
+        {
+            p.memoryScale = memoryScale;
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            p.mutex.state.cacheOptions = p.getBudgetCacheOptions();
         }
 
         // Sync with the thread.
         std::vector<VideoFrame> currentVideoFrame;
         std::vector<AudioFrame> currentAudioFrame;
         PlayerCacheInfo cacheInfo;
+        double decodeRate = 0.0;
         {
             std::unique_lock<std::mutex> lock(p.mutex.mutex);
             p.mutex.state.currentTime = p.currentTime->get();
             currentVideoFrame = p.mutex.currentVideoFrame;
             currentAudioFrame = p.mutex.currentAudioFrame;
             cacheInfo = p.mutex.cacheInfo;
+            decodeRate = p.mutex.decodeRate;
+        }
+        // The setters only write the state, so this also hands them to the
+        // thread; it goes back to sleep if nothing has changed.
+        p.thread.cv.notify_one();
+        if (!presentLocked ||
+            (!currentVideoFrame.empty() && currentVideoFrame[0].time == p.currentTime->get()))
+        {
+            // While present() picks the frames the thread may still have an
+            // older one.
+            p.currentVideoFrame->setIfChanged(currentVideoFrame);
         }
-        p.currentVideoFrame->setIfChanged(currentVideoFrame);
         p.currentAudioFrame->setIfChanged(currentAudioFrame);
         p.cacheInfo->setIfChanged(cacheInfo);
+        p.decodeRate->setIfChanged(decodeRate);
+
+        // Switch to the proxies when frames are not decoded as fast as they
+        // are played, and back when playback stops or slows to what the
+        // media was decoded at. The proxies are what is measured once they
+        // are in use, so the rate that sent the player to them is what
+        // decides when to go back. A key set by hand in the meantime is
+        // left alone.
+        const std::string& proxyKey = p.proxyKey->get();
+        const std::string mediaReferenceKey = p.mediaReferenceKey->get();
+        if (p.proxySwitch.restoreKey.has_value() && mediaReferenceKey != proxyKey)
+        {
+            p.proxySwitch = Private::ProxySwitch();
+        }
+        const double playbackSpeed = p.speed->get() * p.speedMult->get();
+        const auto now = std::chrono::steady_clock::now();
+        if (!p.proxySwitch.restoreKey.has_value())
+        {
+            if (!proxyKey.empty() &&
+                proxyKey != mediaReferenceKey &&
+                playback != Playback::Stop &&
+                decodeRate > 0.0 &&
+                decodeRate < playbackSpeed)
+            {
+                if (!p.proxySwitch.since.has_value())
+                {
+                    p.proxySwitch.since = now;
+                }
+                const auto keys = getMediaReferenceKeys();
+                if (now - p.proxySwitch.since.value() >= proxyHold &&
+                    std::find(keys.begin(), keys.end(), proxyKey) != keys.end())
+                {
+                    p.proxySwitch.restoreKey = mediaReferenceKey;
+                    p.proxySwitch.decodeRate = decodeRate;
+                    p.proxySwitch.since.reset();
+                    setMediaReferenceKey(proxyKey);
+                }
+            }
+            else
+            {
+                p.proxySwitch.since.reset();
+            }
+        }
+        else if (Playback::Stop == playback ||
+            p.proxySwitch.decodeRate >= playbackSpeed * proxyRestoreRatio)
+        {
+            if (!p.proxySwitch.since.has_value())
+            {
+                p.proxySwitch.since = now;
+            }
+            // Stopped, the frame on the display is looked at rather than
+            // played, so it goes back straight away.
+            if (Playback::Stop == playback ||
+                now - p.proxySwitch.since.value() >= proxyHold)
+            {
+                const std::string key = p.proxySwitch.restoreKey.value();
+                p.proxySwitch = Private::ProxySwitch();
+                setMediaReferenceKey(key);
+            }
+        }
+        else
+        {
+            p.proxySwitch.since.reset();
+        }
 
         // A timeline with no video has nothing to drop; without this its
         // "frames" are audio samples, and every tick misses tens of them.
-        if (playback != Playback::Stop && timelineSpeed > 0.0 &&
+        // While present() paces playback it counts them instead.
+        if (playback != Playback::Stop && timelineSpeed > 0.0 && !presentLocked &&
             !p.timeline->getIOInfo().video.empty())
         {
             p.droppedFramesTick(
@@ -990,19 +1273,43 @@ namespace tl
     void Player::_thread()
     {
         FTK_P();
+        CompletionScope completionScope(p.completion);
         p.thread.cacheTimer = std::chrono::steady_clock::now();
         p.thread.logTimer = std::chrono::steady_clock::now();
+        p.thread.decodeTimer = std::chrono::steady_clock::now();
+        bool first = true;
         while (p.running)
         {
-            const auto t0 = std::chrono::steady_clock::now();
-
-            // Get mutex protected values.
+            // Wait for the main thread to change something or for a
+            // request to complete. The timeout is a backstop while requests
+            // are in flight, and otherwise lets the cache information
+            // catch up.
             Private::PlaybackState state;
             bool clearRequests = false;
             bool clearCache = false;
             CacheDir cacheDir = CacheDir::First;
             {
                 std::unique_lock<std::mutex> lock(p.mutex.mutex);
+                const bool inProgress =
+                    !p.thread.videoRequests.empty() ||
+                    !p.thread.audioRequests.empty();
+                p.thread.cv.wait_for(
+                    lock,
+                    inProgress ? p.playerOptions.sleepTimeout : idleTimeout,
+                    [this, first]
+                    {
+                        FTK_P();
+                        return
+                            first ||
+                            !p.running ||
+                            p.mutex.completed ||
+                            p.mutex.clearRequests ||
+                            p.mutex.clearCache ||
+                            p.mutex.cacheDir != p.thread.cacheDir ||
+                            p.mutex.state != p.thread.state;
+                    });
+                first = false;
+                p.mutex.completed = false;
                 state = p.mutex.state;
                 clearRequests = p.mutex.clearRequests;
                 p.mutex.clearRequests = false;
@@ -1065,6 +1372,26 @@ namespace tl
                 }
             }
 
+            // Hand the frames just ahead to present().
+            if (p.hasVideo())
+            {
+                std::map<OTIO_NS::RationalTime, std::vector<VideoFrame> > presentVideo;
+                const double rate = p.timeRange.duration().rate();
+                const double dir = Playback::Reverse == p.thread.state.playback ? -1.0 : 1.0;
+                for (int i = 0; i < presentVideoFrames; ++i)
+                {
+                    const OTIO_NS::RationalTime time =
+                        p.thread.state.currentTime + OTIO_NS::RationalTime(i * dir, rate);
+                    const auto j = p.thread.videoCache.find(time);
+                    if (j != p.thread.videoCache.end())
+                    {
+                        presentVideo[time] = j->second;
+                    }
+                }
+                std::unique_lock<std::mutex> lock(p.mutex.mutex);
+                p.mutex.presentVideo = std::move(presentVideo);
+            }
+
             // Update the current audio frames.
             if (p.sourceAudioInfo.isValid())
             {
@@ -1090,7 +1417,7 @@ namespace tl
             }
 
             // Logging.
-            auto t1 = std::chrono::steady_clock::now();
+            const auto t1 = std::chrono::steady_clock::now();
             const std::chrono::duration<double> diff = t1 - p.thread.logTimer;
             if (diff.count() > 10.0)
             {
@@ -1099,11 +1426,7 @@ namespace tl
                 {
                     p.log();
                 }
-                t1 = std::chrono::steady_clock::now();
             }
-
-            // Sleep for a bit.
-            ftk::sleep(p.playerOptions.sleepTimeout, t0, t1);
         }
 
         // Finished.
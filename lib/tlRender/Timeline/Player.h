@@ -4,6 +4,7 @@
 #pragma once
 
 #include <tlRender/Timeline/CompareOptions.h>
+#include <tlRender/Timeline/MemoryBudget.h>
 #include <tlRender/Timeline/PlayerOptions.h>
 #include <tlRender/Timeline/Timeline.h>
 
@@ -28,6 +29,20 @@ namespace tl
         //! Cached audio.
         std::vector<OTIO_NS::TimeRange> audio;
 
+        //! Percentage used of the compressed video cache.
+        float compressedPercentage = 0.F;
+
+        //! Compressed video.
+        std::vector<OTIO_NS::TimeRange> compressed;
+
+        //! Size in bytes of the images in the video cache.
+        size_t videoByteCount = 0;
+
+        //! Size in bytes the video cache does not take up because frames
+        //! that show the same picture share one image; see
+        //! VideoLayer::identity.
+        size_t videoSharedByteCount = 0;
+
         TL_API bool operator == (const PlayerCacheInfo&) const;
         TL_API bool operator != (const PlayerCacheInfo&) const;
     };
@@ -204,6 +219,15 @@ namespace tl
         //! Set the playback loop mode.
         TL_API void setLoop(Loop);
 
+        //! Report a refresh of the display, once per refresh while playing,
+        //! including the refreshes that show the same frame again. Without
+        //! audio the refreshes then pace playback: the frame for each
+        //! refresh is worked out from the refresh rate and taken from the
+        //! cache straight away, and dropped frames are counted from what was
+        //! shown. Until they arrive steadily, or if they stop, the clock is
+        //! sampled when the player ticks.
+        TL_API void present(const std::chrono::steady_clock::time_point&);
+
         ///@}
 
         //! \name Time
@@ -325,6 +349,28 @@ namespace tl
         //! comparison timelines, sorted and without duplicates.
         TL_API std::vector<std::string> getMediaReferenceKeys() const;
 
+        //! Get the proxy media reference key.
+        TL_API const std::string& getProxyKey() const;
+
+        //! Observe the proxy media reference key.
+        TL_API std::shared_ptr<ftk::IObservable<std::string> > observeProxyKey() const;
+
+        //! Set the proxy media reference key. When it is set, and frames are
+        //! decoded slower than they are played for a second, the player
+        //! switches to it with setMediaReferenceKey(). It switches back to
+        //! the key it was on when playback stops, or when the playback speed
+        //! drops far enough below the rate that media was decoded at. An
+        //! empty key, the default, never switches; setting one while the
+        //! proxies are in use switches back first.
+        TL_API void setProxyKey(const std::string&);
+
+        //! Get the measured decode rate in frames per second. It is zero
+        //! until there has been a second of decoding to measure.
+        TL_API double getDecodeRate() const;
+
+        //! Observe the measured decode rate.
+        TL_API std::shared_ptr<ftk::IObservable<double> > observeDecodeRate() const;
+
         ///@}
 
         //! \name Video
@@ -430,6 +476,14 @@ namespace tl
         //! Clear the cache.
         TL_API void clearCache();
 
+        //! Get the priority of the cache in the memory budget.
+        TL_API MemoryPriority getMemoryPriority() const;
+
+        //! Set the priority of the cache in the memory budget. The player
+        //! being watched should be higher than the others, so that when
+        //! memory runs short the others give theirs up first.
+        TL_API void setMemoryPriority(MemoryPriority);
+
         ///@}
 
         //! Get the number of objects currenty instantiated.
@@ -10,7 +10,8 @@ namespace tl
         return
             videoGB == other.videoGB &&
             audioGB == other.audioGB &&
-            readBehind == other.readBehind;;
+            readBehind == other.readBehind &&
+            compressedGB == other.compressedGB;
     }
 
     bool PlayerCacheOptions::operator != (const PlayerCacheOptions& other) const
@@ -25,6 +26,7 @@ namespace tl
             cache == other.cache &&
             videoRequestMax == other.videoRequestMax &&
             audioRequestMax == other.audioRequestMax &&
+            compressThreadCount == other.compressThreadCount &&
             audioBufferFrameCount == other.audioBufferFrameCount &&
             muteTimeout == other.muteTimeout &&
             sleepTimeout == other.sleepTimeout &&
@@ -41,6 +43,7 @@ namespace tl
         json["VideoGB"] = value.videoGB;
         json["AudioGB"] = value.audioGB;
         json["ReadBehind"] = value.readBehind;
+        json["CompressedGB"] = value.compressedGB;
     }
 
     void from_json(const nlohmann::json& json, PlayerCacheOptions& value)
@@ -48,5 +51,9 @@ namespace tl
         json.at("VideoGB").get_to(value.videoGB);
         json.at("AudioGB").get_to(value.audioGB);
         json.at("ReadBehind").get_to(value.readBehind);
+        if (json.contains("CompressedGB"))
+        {
+            json.at("CompressedGB").get_to(value.compressedGB);
+        }
     }
 }
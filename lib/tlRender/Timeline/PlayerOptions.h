@@ -22,6 +22,11 @@ namespace tl
         //! Number of seconds to read behind the current frame.
         float readBehind = .5F;
 
+        //! Compressed video cache size in gigabytes. Frames that leave the
+        //! video cache are kept here compressed, and decompressing them is
+        //! quicker than reading them again. Zero turns it off.
+        float compressedGB = 0.F;
+
         TL_API bool operator == (const PlayerCacheOptions&) const;
         TL_API bool operator != (const PlayerCacheOptions&) const;
     };
@@ -50,14 +55,22 @@ namespace tl
         //! timeline decides how much of it is in flight.
         size_t audioRequestMax = 16;
 
+        //! Number of threads compressing and decompressing frames for the
+        //! compressed cache. They are started the first time a frame is
+        //! compressed.
+        size_t compressThreadCount = 4;
+
         //! Audio buffer frame count.
         size_t audioBufferFrameCount = 500;
 
         //! Timeout for muting the audio when playback stutters.
         std::chrono::milliseconds muteTimeout = std::chrono::milliseconds(500);
 
-        //! Timeout to sleep each tick.
-        std::chrono::milliseconds sleepTimeout = std::chrono::milliseconds(5);
+        //! How long the cache thread waits for a request to complete before
+        //! checking on it anyway. Completed requests normally wake the
+        //! thread, so this only matters for a reader that does not say when
+        //! it has finished.
+        std::chrono::milliseconds sleepTimeout = std::chrono::milliseconds(100);
 
         //! Current time to start at. Unset starts at the beginning.
         std::optional<OTIO_NS::RationalTime> currentTime;
@@ -5,6 +5,8 @@
 
 #include <tlRender/Timeline/Util.h>
 
+#include <tlRender/IO/Completion.h>
+
 #include <ftk/Core/Context.h>
 #include <ftk/Core/Format.h>
 #include <ftk/Core/String.h>
@@ -110,6 +112,16 @@ namespace tl
         return out;
     }
 
+    void Player::Private::setPlaybackTime(const OTIO_NS::RationalTime& value)
+    {
+        bool looped = false;
+        const OTIO_NS::RationalTime time = loopPlayback(value, looped);
+        if (currentTime->setIfChanged(time) && looped)
+        {
+            seek->setAlways(time);
+        }
+    }
+
     void Player::Private::clearRequests()
     {
         std::vector<std::vector<uint64_t> > ids(1 + thread.state.compare.size());
@@ -136,6 +148,18 @@ namespace tl
     void Player::Private::clearCache()
     {
         thread.videoCache.clear();
+        thread.videoImages.clear();
+        thread.videoImageCounts.clear();
+        thread.videoByteCount = 0;
+        thread.videoSharedByteCount = 0;
+        // The compression in flight is told to stop and left to finish on
+        // its own; nothing waits for it.
+        thread.compressCancel->store(true);
+        thread.compressCancel = std::make_shared<std::atomic<bool> >(false);
+        thread.compressRequests.clear();
+        thread.compressPendingByteCount = 0;
+        thread.compressedCache.clear();
+        thread.compressedByteCount = 0;
         {
             std::unique_lock<std::mutex> lock(mutex.mutex);
             mutex.cacheInfo = PlayerCacheInfo();
@@ -146,6 +170,20 @@ namespace tl
         }
     }
 
+    PlayerCacheOptions Player::Private::getBudgetCacheOptions() const
+    {
+        PlayerCacheOptions out = cacheOptions->get();
+        out.videoGB *= memoryScale;
+        out.audioGB *= memoryScale;
+        out.compressedGB *= memoryScale;
+        return out;
+    }
+
+    size_t Player::Private::getRequest(const PlayerCacheOptions& value)
+    {
+        return (value.videoGB + value.audioGB + value.compressedGB) * ftk::gigabyte;
+    }
+
     bool Player::Private::hasVideo() const
     {
         // Asked of the timeline so that it follows the media reference key;
@@ -185,6 +223,243 @@ namespace tl
             0;
     }
 
+    size_t Player::Private::getCompressedCacheMax(size_t videoCacheMax) const
+    {
+        // This function returns the approximate number of video frames
+        // that can fit in the compressed cache. How well frames compress is
+        // only known once some have been, so until then guess at half.
+        const size_t max = thread.state.cacheOptions.compressedGB * ftk::gigabyte;
+        if (0 == max || 0 == videoCacheMax)
+        {
+            return 0;
+        }
+        const double byteCount = thread.compressedCache.empty() ?
+            (thread.state.cacheOptions.videoGB * ftk::gigabyte / videoCacheMax / 2.0) :
+            (thread.compressedByteCount / static_cast<double>(thread.compressedCache.size()));
+        return byteCount > 0.0 ? (max / byteCount) : 0;
+    }
+
+    std::shared_ptr<Player::Private::CompressedFrame> Player::Private::compressFrame(
+        const std::vector<VideoFrame>& frames,
+        const std::atomic<bool>& cancel)
+    {
+        auto out = std::make_shared<CompressedFrame>();
+        for (const auto& frame : frames)
+        {
+            VideoFrame tmp = frame;
+            for (auto& layer : tmp.layers)
+            {
+                for (auto image : { &layer.image, &layer.imageB })
+                {
+                    if (cancel)
+                    {
+                        return nullptr;
+                    }
+                    // One thread an image: the pool keeps the other
+                    // threads busy with other frames.
+                    std::shared_ptr<CompressedImage> compressed;
+                    if (*image)
+                    {
+                        compressed = compressImage(*image);
+                        out->byteCount += compressed->getByteCount();
+                        image->reset();
+                    }
+                    out->images.push_back(compressed);
+                }
+            }
+            out->frames.push_back(tmp);
+        }
+        return out;
+    }
+
+    VideoFrame Player::Private::decompressFrame(
+        const CompressedFrame& compressed,
+        size_t index)
+    {
+        size_t image = 0;
+        for (size_t i = 0; i < index; ++i)
+        {
+            image += compressed.frames[i].layers.size() * 2;
+        }
+        VideoFrame out = compressed.frames[index];
+        for (auto& layer : out.layers)
+        {
+            if (auto& c = compressed.images[image++])
+            {
+                layer.image = decompressImage(c);
+            }
+            if (auto& c = compressed.images[image++])
+            {
+                layer.imageB = decompressImage(c);
+            }
+        }
+        return out;
+    }
+
+    void Player::Private::submitCompress(std::function<void()> f)
+    {
+        if (compressPool.threads.empty())
+        {
+            for (size_t i = 0; i < std::max(playerOptions.compressThreadCount, size_t(1)); ++i)
+            {
+                compressPool.threads.push_back(std::thread(
+                    [this]
+                    {
+                        while (true)
+                        {
+                            std::function<void()> task;
+                            {
+                                std::unique_lock<std::mutex> lock(compressPool.mutex);
+                                compressPool.cv.wait(
+                                    lock,
+                                    [this]
+                                    {
+                                        return compressPool.stopped || !compressPool.tasks.empty();
+                                    });
+                                if (compressPool.stopped)
+                                {
+                                    return;
+                                }
+                                task = std::move(compressPool.tasks.front());
+                                compressPool.tasks.pop_front();
+                            }
+                            task();
+                        }
+                    }));
+            }
+        }
+        {
+            std::unique_lock<std::mutex> lock(compressPool.mutex);
+            compressPool.tasks.push_back(std::move(f));
+        }
+        compressPool.cv.notify_one();
+    }
+
+    void Player::Private::stopCompressPool()
+    {
+        // What has not started is dropped, and what has stops at the next
+        // image. Nothing is left to look at the results.
+        thread.compressCancel->store(true);
+        {
+            std::unique_lock<std::mutex> lock(compressPool.mutex);
+            compressPool.stopped = true;
+            compressPool.tasks.clear();
+        }
+        compressPool.cv.notify_all();
+        for (auto& thread : compressPool.threads)
+        {
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+        compressPool.threads.clear();
+    }
+
+    void Player::Private::shareImages(std::vector<VideoFrame>& frames)
+    {
+        const auto share = [this](
+            std::shared_ptr<ftk::Image>& image,
+            const std::string& identity)
+        {
+            if (!image || identity.empty())
+            {
+                return;
+            }
+            auto& held = thread.videoImages[identity];
+            const auto other = held.lock();
+            if (other && other->getInfo() == image->getInfo())
+            {
+                image = other;
+            }
+            else
+            {
+                held = image;
+            }
+        };
+        for (auto& frame : frames)
+        {
+            for (auto& layer : frame.layers)
+            {
+                share(layer.image, layer.identity);
+                share(layer.imageB, layer.identityB);
+            }
+        }
+    }
+
+    void Player::Private::holdVideoImages(const std::vector<VideoFrame>& frames)
+    {
+        const auto hold = [this](
+            const std::shared_ptr<ftk::Image>& image,
+            const std::string& identity)
+        {
+            if (!image)
+            {
+                return;
+            }
+            auto& count = thread.videoImageCounts[image.get()];
+            if (0 == count.count++)
+            {
+                thread.videoByteCount += image->getByteCount();
+            }
+            else
+            {
+                thread.videoSharedByteCount += image->getByteCount();
+            }
+            if (count.identity.empty())
+            {
+                count.identity = identity;
+            }
+        };
+        for (const auto& frame : frames)
+        {
+            for (const auto& layer : frame.layers)
+            {
+                hold(layer.image, layer.identity);
+                hold(layer.imageB, layer.identityB);
+            }
+        }
+    }
+
+    void Player::Private::releaseVideoImages(const std::vector<VideoFrame>& frames)
+    {
+        const auto release = [this](const std::shared_ptr<ftk::Image>& image)
+        {
+            if (!image)
+            {
+                return;
+            }
+            const auto i = thread.videoImageCounts.find(image.get());
+            if (i == thread.videoImageCounts.end())
+            {
+                return;
+            }
+            if (--i->second.count > 0)
+            {
+                thread.videoSharedByteCount -= image->getByteCount();
+                return;
+            }
+            thread.videoByteCount -= image->getByteCount();
+            if (!i->second.identity.empty())
+            {
+                const auto j = thread.videoImages.find(i->second.identity);
+                if (j != thread.videoImages.end() && j->second.lock() == image)
+                {
+                    thread.videoImages.erase(j);
+                }
+            }
+            thread.videoImageCounts.erase(i);
+        };
+        for (const auto& frame : frames)
+        {
+            for (const auto& layer : frame.layers)
+            {
+                release(layer.image);
+                release(layer.imageB);
+            }
+        }
+    }
+
     size_t Player::Private::getAudioCacheMax() const
     {
         // This function returns the approximate number seconds of audio
@@ -295,7 +570,22 @@ namespace tl
         const OTIO_NS::TimeRange videoCacheRange = getVideoCacheRange(videoCacheMax);
         const ftk::Range<int64_t> audioCacheRange = getAudioCacheRange(audioCacheMax);
 
-        // Remove frames from the video cache.
+        // The compressed cache reaches past the video cache in both
+        // directions, so it keeps what has just been played as well as
+        // what is further ahead.
+        const size_t compressedCacheMax = getCompressedCacheMax(videoCacheMax);
+        std::vector<OTIO_NS::TimeRange> compressedLooped;
+        if (compressedCacheMax > 0)
+        {
+            compressedLooped = tl::loop(
+                getVideoCacheRange(videoCacheMax + compressedCacheMax),
+                thread.state.inOutRange);
+        }
+        const size_t compressedByteMax =
+            thread.state.cacheOptions.compressedGB * ftk::gigabyte;
+
+        // Remove frames from the video cache. Those still within the range
+        // of the compressed cache are compressed on the way out.
         {
             const auto looped = tl::loop(
                 videoCacheRange,
@@ -315,6 +605,51 @@ namespace tl
                 }
                 if (!found)
                 {
+                    releaseVideoImages(i->second);
+                    bool compress = false;
+                    if (thread.compressedByteCount + thread.compressPendingByteCount < compressedByteMax &&
+                        thread.compressedCache.find(t) == thread.compressedCache.end() &&
+                        thread.compressRequests.find(t) == thread.compressRequests.end())
+                    {
+                        for (const auto& range : compressedLooped)
+                        {
+                            if (range.contains(t))
+                            {
+                                compress = true;
+                                break;
+                            }
+                        }
+                    }
+                    if (compress)
+                    {
+                        size_t byteCount = 0;
+                        for (const auto& frame : i->second)
+                        {
+                            for (const auto& layer : frame.layers)
+                            {
+                                byteCount += layer.image ? layer.image->getByteCount() : 0;
+                                byteCount += layer.imageB ? layer.imageB->getByteCount() : 0;
+                            }
+                        }
+                        auto promise = std::make_shared<std::promise<std::shared_ptr<CompressedFrame> > >();
+                        auto& request = thread.compressRequests[t];
+                        request.future = promise->get_future();
+                        request.byteCount = byteCount;
+                        thread.compressPendingByteCount += byteCount;
+                        submitCompress(
+                            [promise, frames = std::move(i->second), cancel = thread.compressCancel, completion = completion]
+                            {
+                                std::shared_ptr<CompressedFrame> out;
+                                try
+                                {
+                                    out = compressFrame(frames, *cancel);
+                                }
+                                catch (const std::exception&)
+                                {}
+                                promise->set_value(out);
+                                completion->notify();
+                            });
+                    }
                     i = thread.videoCache.erase(i);
                 }
                 else
@@ -324,6 +659,32 @@ namespace tl
             }
         }
 
+        // Remove frames from the compressed cache.
+        {
+            auto i = thread.compressedCache.begin();
+            while (i != thread.compressedCache.end())
+            {
+                bool found = false;
+                for (const auto& range : compressedLooped)
+                {
+                    if (range.contains(i->first))
+                    {
+                        found = true;
+                        break;
+                    }
+                }
+                if (!found)
+                {
+                    thread.compressedByteCount -= i->second->byteCount;
+                    i = thread.compressedCache.erase(i);
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+        }
+
         // Remove frames from the audio cache.
         {
             const auto looped = tl::loop(
@@ -359,6 +720,16 @@ namespace tl
         // Fill the video cache.
         if (hasVideo())
         {
+            // Which way the frames are going to be read, for the read ahead
+            // below the decoders. Stopped, the cache is filled around a
+            // playhead that is moved by hand.
+            AccessHint accessHint = AccessHint::Scrub;
+            switch (thread.state.playback)
+            {
+            case Playback::Forward: accessHint = AccessHint::Forward; break;
+            case Playback::Reverse: accessHint = AccessHint::Reverse; break;
+            default: break;
+            }
             const OTIO_NS::RationalTime inc(1.0, thread.state.currentTime.rate());
             for (OTIO_NS::RationalTime time = videoCacheRange.start_time();
                 time <= videoCacheRange.end_time_inclusive() &&
@@ -370,11 +741,42 @@ namespace tl
                 if (j == thread.videoCache.end())
                 {
                     const auto k = thread.videoRequests.find(timeLooped);
-                    if (k == thread.videoRequests.end())
+                    const auto c = thread.compressedCache.find(timeLooped);
+                    if (k == thread.videoRequests.end() &&
+                        c != thread.compressedCache.end() &&
+                        c->second->frames.size() == 1 + thread.state.compare.size())
+                    {
+                        // The compressed frame is kept, so that it is still
+                        // there the next time around the loop.
+                        auto& requests = thread.videoRequests[timeLooped];
+                        const auto compressed = c->second;
+                        for (size_t l = 0; l < compressed->frames.size(); ++l)
+                        {
+                            auto promise = std::make_shared<std::promise<VideoFrame> >();
+                            VideoRequest request;
+                            request.future = promise->get_future();
+                            submitCompress(
+                                [promise, compressed, l, completion = completion]
+                                {
+                                    VideoFrame out;
+                                    try
+                                    {
+                                        out = decompressFrame(*compressed, l);
+                                    }
+                                    catch (const std::exception&)
+                                    {}
+                                    promise->set_value(out);
+                                    completion->notify();
+                                });
+                            requests.push_back(std::move(request));
+                        }
+                    }
+                    else if (k == thread.videoRequests.end())
                     {
                         auto& requests = thread.videoRequests[timeLooped];
                         IOOptions ioOptions2 = thread.state.ioOptions;
                         ioOptions2["Layer"] = ftk::Format("{0}").arg(thread.state.videoLayer);
+                        ioOptions2["IO/Access"] = to_string(accessHint);
                         const IOOptions ioOptionsA = ioOptions2;
                         requests.clear();
                         requests.push_back(timeline->getVideo(timeLooped, ioOptions2));
@@ -467,6 +869,7 @@ namespace tl
             !thread.cacheKeyValid ||
             thread.cacheKey.cacheDir != thread.cacheDir ||
             thread.cacheKey.videoCacheSize != thread.videoCache.size() ||
+            thread.cacheKey.compressedCacheSize != thread.compressedCache.size() ||
             thread.cacheKey.audioCacheSize != audioCacheSize ||
             thread.cacheKey.videoRequestsSize != thread.videoRequests.size() ||
             thread.cacheKey.audioRequestsSize != thread.audioRequests.size() ||
@@ -478,6 +881,7 @@ namespace tl
             thread.cacheKey.state = thread.state;
             thread.cacheKey.cacheDir = thread.cacheDir;
             thread.cacheKey.videoCacheSize = thread.videoCache.size();
+            thread.cacheKey.compressedCacheSize = thread.compressedCache.size();
             {
                 std::unique_lock<std::mutex> lock(audioMutex.mutex);
                 thread.cacheKey.audioCacheSize = audioMutex.cache.size();
@@ -488,6 +892,12 @@ namespace tl
         }
 
         // Check for finished video.
+        const auto decodeNow = std::chrono::steady_clock::now();
+        if (!thread.videoRequests.empty())
+        {
+            thread.decodeBusy += decodeNow - thread.decodeTimer;
+        }
+        thread.decodeTimer = decodeNow;
         auto videoRequestsIt = thread.videoRequests.begin();
         while (videoRequestsIt != thread.videoRequests.end())
         {
@@ -525,8 +935,13 @@ namespace tl
                     videoFrame.time = time;
                     videoFrameList.emplace_back(videoFrame);
                 }
-                thread.videoCache[time] = videoFrameList;
+                shareImages(videoFrameList);
+                auto& cached = thread.videoCache[time];
+                releaseVideoImages(cached);
+                holdVideoImages(videoFrameList);
+                cached = videoFrameList;
                 videoRequestsIt = thread.videoRequests.erase(videoRequestsIt);
+                ++thread.decodeFrames;
             }
             else
             {
@@ -534,6 +949,37 @@ namespace tl
             }
         }
 
+        if (thread.decodeBusy >= std::chrono::seconds(1))
+        {
+            const double decodeRate = thread.decodeFrames / thread.decodeBusy.count();
+            thread.decodeBusy = std::chrono::duration<double>::zero();
+            thread.decodeFrames = 0;
+            std::unique_lock<std::mutex> lock(mutex.mutex);
+            mutex.decodeRate = decodeRate;
+        }
+
+        // Check for finished compression. A frame that failed to compress
+        // is read again when it is wanted.
+        auto compressRequestsIt = thread.compressRequests.begin();
+        while (compressRequestsIt != thread.compressRequests.end())
+        {
+            if (compressRequestsIt->second.future.wait_for(std::chrono::seconds(0)) ==
+                std::future_status::ready)
+            {
+                thread.compressPendingByteCount -= compressRequestsIt->second.byteCount;
+                if (auto compressed = compressRequestsIt->second.future.get())
+                {
+                    thread.compressedByteCount += compressed->byteCount;
+                    thread.compressedCache[compressRequestsIt->first] = compressed;
+                }
+                compressRequestsIt = thread.compressRequests.erase(compressRequestsIt);
+            }
+            else
+            {
+                ++compressRequestsIt;
+            }
+        }
+
         // Check for finished audio.
         auto audioRequestsIt = thread.audioRequests.begin();
         while (audioRequestsIt != thread.audioRequests.end())
@@ -592,7 +1038,26 @@ namespace tl
                 (audioCacheKeys.size() / static_cast<float>(audioCacheMax) * 100.F) :
                 0.F;
 
+            // What the cache holds, for the memory budget. An image shared
+            // between frames, by identity or because the reader handed out
+            // the same one, is only held once.
+            memoryShare->byteCount = thread.compressedByteCount +
+                audioCacheKeys.size() * sourceAudioInfo.sampleRate * sourceAudioInfo.getByteCount() +
+                thread.videoByteCount;
+
+            std::vector<OTIO_NS::RationalTime> compressedCacheFrames;
+            for (const auto& i : thread.compressedCache)
+            {
+                compressedCacheFrames.push_back(i.first);
+            }
+            const size_t compressedByteMax =
+                thread.state.cacheOptions.compressedGB * ftk::gigabyte;
+            const float compressedCachePercentage = compressedByteMax > 0 ?
+                (thread.compressedByteCount / static_cast<float>(compressedByteMax) * 100.F) :
+                0.F;
+
             auto videoCacheRanges = toRanges(videoCacheFrames);
+            auto compressedCacheRanges = toRanges(compressedCacheFrames);
             auto audioCacheRanges = toRanges(audioCacheFrames);
             for (auto& i : audioCacheRanges)
             {
@@ -606,6 +1071,10 @@ namespace tl
                 mutex.cacheInfo.audioPercentage = audioCachePercentage;
                 mutex.cacheInfo.video = videoCacheRanges;
                 mutex.cacheInfo.audio = audioCacheRanges;
+                mutex.cacheInfo.compressedPercentage = compressedCachePercentage;
+                mutex.cacheInfo.compressed = compressedCacheRanges;
+                mutex.cacheInfo.videoByteCount = thread.videoByteCount;
+                mutex.cacheInfo.videoSharedByteCount = thread.videoSharedByteCount;
             }
         }
     }
@@ -615,6 +1084,7 @@ namespace tl
         std::unique_lock<std::mutex> lock(noAudio.mutex);
         noAudio.playbackTimer = std::chrono::steady_clock::now();
         noAudio.start = time;
+        noAudio.presentClock.reset();
     }
 
     void Player::Private::resetPlaybackTime(const OTIO_NS::RationalTime& time)
@@ -5,6 +5,8 @@
 
 #include <tlRender/Timeline/Player.h>
 
+#include <tlRender/Timeline/ImageCompress.h>
+#include <tlRender/Timeline/PresentClock.h>
 #include <tlRender/Timeline/Util.h>
 
 #include <tlRender/Core/AudioResample.h>
@@ -17,15 +19,24 @@
 #endif // FTK_SDL3
 
 #include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <limits>
+#include <list>
 #include <mutex>
 #include <optional>
 #include <thread>
+#include <unordered_map>
 
 namespace tl
 {
+    class Completion;
+
     struct Player::Private
     {
         OTIO_NS::RationalTime loopPlayback(const OTIO_NS::RationalTime&, bool& looped);
+        void setPlaybackTime(const OTIO_NS::RationalTime&);
 
         void clearRequests();
         void clearCache();
@@ -36,6 +47,56 @@ namespace tl
         void cacheUpdate();
         void cacheEvictAndFill();
 
+        // A frame in the compressed cache: the frames of the timeline and
+        // those being compared with their images taken out, and the images
+        // compressed, A then B for each layer.
+        struct CompressedFrame
+        {
+            std::vector<VideoFrame> frames;
+            std::vector<std::shared_ptr<CompressedImage> > images;
+            size_t byteCount = 0;
+        };
+        // Compress the frames, or give up and return null when cancel is
+        // set part way.
+        static std::shared_ptr<CompressedFrame> compressFrame(
+            const std::vector<VideoFrame>&,
+            const std::atomic<bool>& cancel);
+        static VideoFrame decompressFrame(const CompressedFrame&, size_t index);
+        size_t getCompressedCacheMax(size_t videoCacheMax) const;
+
+        // A frame on its way into the compressed cache. The byte count is
+        // the frame's size before compression, which is as large as it can
+        // get, and is held against the cache's maximum until it finishes.
+        struct CompressRequest
+        {
+            std::future<std::shared_ptr<CompressedFrame> > future;
+            size_t byteCount = 0;
+        };
+
+        // Where frames are compressed and decompressed: a fixed number of
+        // threads rather than one for each frame, so that a burst of frames
+        // leaving the video cache does not start a burst of threads.
+        // Started by the cache thread the first time it is given work, and
+        // stopped by the destructor once the cache thread has finished.
+        struct CompressPool
+        {
+            std::vector<std::thread> threads;
+            std::list<std::function<void()> > tasks;
+            std::condition_variable cv;
+            std::mutex mutex;
+            bool stopped = false;
+        };
+        CompressPool compressPool;
+        void submitCompress(std::function<void()>);
+        void stopCompressPool();
+        // Swap the images of frames coming into the video cache for those
+        // already there with the same identity; see VideoLayer::identity.
+        void shareImages(std::vector<VideoFrame>&);
+        // Count the images of frames coming into and going out of the video
+        // cache; see Thread::videoImageCounts.
+        void holdVideoImages(const std::vector<VideoFrame>&);
+        void releaseVideoImages(const std::vector<VideoFrame>&);
+
         bool hasVideo() const;
         bool hasAudio() const;
         void playbackReset(const OTIO_NS::RationalTime&);
@@ -57,6 +118,11 @@ namespace tl
 
         void log();
 
+        // The cache options with the sizes scaled to the share of the
+        // memory budget. This is what the cache thread is given.
+        PlayerCacheOptions getBudgetCacheOptions() const;
+        static size_t getRequest(const PlayerCacheOptions&);
+
         std::weak_ptr<ftk::LogSystem> logSystem;
         PlayerOptions playerOptions;
         std::shared_ptr<Timeline> timeline;
@@ -81,6 +147,20 @@ namespace tl
         std::shared_ptr<ftk::Observable<CompareTime> > compareTime;
         std::shared_ptr<ftk::Observable<IOOptions> > ioOptions;
         std::shared_ptr<ftk::Observable<std::string> > mediaReferenceKey;
+        std::shared_ptr<ftk::Observable<std::string> > proxyKey;
+        std::shared_ptr<ftk::Observable<double> > decodeRate;
+
+        // The switch to the proxies and back; see _tick. Set while the
+        // proxies are in use because of the decode rate: the key to go back
+        // to, and the rate that was measured on it. The time is when the
+        // reason to switch, one way or the other, was first seen.
+        struct ProxySwitch
+        {
+            std::optional<std::string> restoreKey;
+            double decodeRate = 0.0;
+            std::optional<std::chrono::steady_clock::time_point> since;
+        };
+        ProxySwitch proxySwitch;
         std::shared_ptr<ftk::Observable<int> > videoLayer;
         std::shared_ptr<ftk::ObservableList<int> > compareVideoLayers;
         std::shared_ptr<ftk::ObservableList<VideoFrame> > currentVideoFrame;
@@ -96,6 +176,21 @@ namespace tl
         std::shared_ptr<ftk::ListObserver<AudioDeviceInfo> > audioDevicesObserver;
         std::shared_ptr<ftk::Observer<AudioDeviceInfo> > defaultAudioDeviceObserver;
 
+        // The player's part of the memory budget. Shared with the budget's
+        // callbacks, so that it is still there for them whatever order the
+        // player and the budget go in. The cache thread writes the byte
+        // count; the main thread reads the limit in _tick.
+        struct MemoryShare
+        {
+            std::atomic<size_t> byteCount{ 0 };
+            std::atomic<size_t> limit{ std::numeric_limits<size_t>::max() };
+        };
+        std::shared_ptr<MemoryShare> memoryShare;
+        std::weak_ptr<MemoryBudget> memoryBudget;
+        uint64_t memoryID = 0;
+        MemoryPriority memoryPriority = MemoryPriority::Normal;
+        float memoryScale = 1.F;
+
         int accelerate = 0;
         tl::Playback toggle = tl::Playback::Forward;
 
@@ -157,6 +252,7 @@ namespace tl
             PlaybackState state;
             CacheDir cacheDir = CacheDir::Forward;
             size_t videoCacheSize = 0;
+            size_t compressedCacheSize = 0;
             size_t audioCacheSize = 0;
             size_t videoRequestsSize = 0;
             size_t audioRequestsSize = 0;
@@ -176,6 +272,12 @@ namespace tl
             std::vector<VideoFrame> currentVideoFrame;
             std::vector<AudioFrame> currentAudioFrame;
             PlayerCacheInfo cacheInfo;
+            double decodeRate = 0.0;
+            // The cached frames just ahead of the current time, which
+            // present() picks from without waiting for the cache thread.
+            std::map<OTIO_NS::RationalTime, std::vector<VideoFrame> > presentVideo;
+            // Set when a request completes, to wake the cache thread.
+            bool completed = false;
             std::mutex mutex;
         };
         Mutex mutex;
@@ -192,12 +294,54 @@ namespace tl
             bool cacheKeyValid = false;
             std::map<OTIO_NS::RationalTime, std::vector<VideoRequest> > videoRequests;
             std::map<OTIO_NS::RationalTime, std::vector<VideoFrame> > videoCache;
+            // Frames that left the video cache while still near enough to be
+            // wanted again, kept compressed. Going back over them decompresses
+            // them instead of reading them again.
+            std::map<OTIO_NS::RationalTime, std::shared_ptr<CompressedFrame> > compressedCache;
+            std::map<OTIO_NS::RationalTime, CompressRequest> compressRequests;
+            size_t compressedByteCount = 0;
+            size_t compressPendingByteCount = 0;
+            // Set when the cache is cleared, so that the compression in
+            // flight stops without being waited for; a new flag is made for
+            // what comes after.
+            std::shared_ptr<std::atomic<bool> > compressCancel =
+                std::make_shared<std::atomic<bool> >(false);
+            // The images in the video cache by identity, so that the frames
+            // that show the same picture hold one image between them. Weak,
+            // so that an image goes when the last frame holding it does; the
+            // entry goes then as well, see videoImageCounts.
+            std::map<std::string, std::weak_ptr<ftk::Image> > videoImages;
+            // How many frames in the video cache hold each image, kept up as
+            // frames come and go so that the byte counts need no walk over
+            // the cache. An image held more than once counts toward
+            // videoByteCount once and toward videoSharedByteCount for the
+            // rest. The identity is the one it is shared under, taken out of
+            // videoImages when the last frame holding it goes.
+            struct VideoImageCount
+            {
+                size_t count = 0;
+                std::string identity;
+            };
+            std::unordered_map<const ftk::Image*, VideoImageCount> videoImageCounts;
+            size_t videoByteCount = 0;
+            size_t videoSharedByteCount = 0;
             std::map<int64_t, AudioRequest> audioRequests;
             std::chrono::steady_clock::time_point cacheTimer;
             std::chrono::steady_clock::time_point logTimer;
+            // The decode rate is the video frames finished over the time
+            // there were video requests in flight, which leaves out the time
+            // spent waiting with a full cache.
+            std::chrono::steady_clock::time_point decodeTimer;
+            std::chrono::duration<double> decodeBusy = std::chrono::duration<double>::zero();
+            size_t decodeFrames = 0;
+            // Wakes the thread when Mutex changes or a request completes.
+            std::condition_variable cv;
             std::thread thread;
         };
         Thread thread;
+        // Carried by the requests the cache thread makes, so that only
+        // their completion wakes it.
+        std::shared_ptr<Completion> completion;
 
         // The audio parameters the main thread publishes to the audio callback
         // thread; copied wholesale into AudioMutex::state under the lock.
@@ -247,11 +391,15 @@ namespace tl
         // mutex because the cache thread also resets it from the stall re-sync
         // path in _thread (the no-audio counterpart of audioReset, which guards
         // the audio clock with audioMutex). Writes are rare, so the per-tick
-        // read lock is effectively uncontended.
+        // read lock is effectively uncontended. presentClock numbers the
+        // display refreshes reported by present(), and once they arrive
+        // steadily (presentLocked) they take over from the wall clock.
         struct NoAudio
         {
             std::chrono::steady_clock::time_point playbackTimer;
             OTIO_NS::RationalTime start;
+            PresentClock presentClock;
+            bool presentLocked = false;
             std::mutex mutex;
         };
         NoAudio noAudio;
@@ -0,0 +1,234 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/Timeline/PresentClock.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace tl
+{
+    namespace
+    {
+        // The number of refreshes fitted, about four seconds at 60Hz.
+        const size_t sampleMax = 240;
+
+        // The number of refreshes before the period is trusted, and before
+        // it is compared with the standard rates.
+        const size_t lockCount = 8;
+        const size_t snapCount = 60;
+
+        // How close the period has to be to a standard rate to be taken as
+        // exactly that rate. The NTSC rates are 0.1% away from their whole
+        // number neighbours.
+        const double snapTolerance = .0002;
+
+        // A gap longer than this between refreshes starts again: the window
+        // was hidden, or the application was busy.
+        const double gapMax = .25;
+
+        const std::pair<int64_t, int64_t> standardRates[] =
+        {
+            { 24000, 1001 }, { 24, 1 }, { 25, 1 }, { 30000, 1001 }, { 30, 1 },
+            { 48000, 1001 }, { 48, 1 }, { 50, 1 }, { 60000, 1001 }, { 60, 1 },
+            { 72, 1 }, { 75, 1 }, { 90, 1 }, { 100, 1 }, { 120000, 1001 },
+            { 120, 1 }, { 144, 1 }, { 165, 1 }, { 240, 1 }
+        };
+
+        double getSeconds(
+            const std::chrono::steady_clock::time_point& a,
+            const std::chrono::steady_clock::time_point& b)
+        {
+            return std::chrono::duration<double>(a - b).count();
+        }
+    }
+
+    PresentClock::PresentClock()
+    {}
+
+    void PresentClock::reset()
+    {
+        _anchorPending = true;
+    }
+
+    int64_t PresentClock::addRefresh(const std::chrono::steady_clock::time_point& time)
+    {
+        if (!_samples.empty())
+        {
+            const double dt = getSeconds(time, _samples.back().time);
+            if (dt < 0.0 || dt > gapMax)
+            {
+                _samples.clear();
+                _period = 0.0;
+                _intercept = 0.0;
+                _rate = std::make_pair(0, 0);
+                _anchorPending = true;
+            }
+        }
+
+        int64_t index = 0;
+        if (!_samples.empty())
+        {
+            // Number the refresh from the fitted line, so that the jitter of
+            // the time does not matter and a missed refresh is counted.
+            const Sample& front = _samples.front();
+            const Sample& back = _samples.back();
+            if (_period > 0.0)
+            {
+                const double x = (getSeconds(time, front.time) - _intercept) / _period;
+                index = front.index + static_cast<int64_t>(std::llround(x));
+            }
+            else
+            {
+                index = back.index + 1;
+            }
+            if (index <= back.index)
+            {
+                // Called twice for the same refresh.
+                return back.index - _anchor;
+            }
+        }
+
+        Sample sample;
+        sample.index = index;
+        sample.time = time;
+        _samples.push_back(sample);
+        while (_samples.size() > sampleMax)
+        {
+            _samples.pop_front();
+        }
+        _fit();
+
+        if (_anchorPending)
+        {
+            _anchorPending = false;
+            _anchor = index;
+        }
+        return index - _anchor;
+    }
+
+    bool PresentClock::isLocked(const std::chrono::steady_clock::time_point& time) const
+    {
+        return
+            _samples.size() >= lockCount &&
+            _period > 0.0 &&
+            getSeconds(time, _samples.back().time) <= std::max(4.0 * _period, .1);
+    }
+
+    double PresentClock::getPeriod() const
+    {
+        return _period;
+    }
+
+    std::pair<int64_t, int64_t> PresentClock::getRate() const
+    {
+        return _rate;
+    }
+
+    std::chrono::steady_clock::time_point PresentClock::predict(
+        const std::chrono::steady_clock::time_point& time) const
+    {
+        std::chrono::steady_clock::time_point out = time;
+        if (!_samples.empty() && _period > 0.0)
+        {
+            const Sample& front = _samples.front();
+            const double x = std::floor((getSeconds(time, front.time) - _intercept) / _period) + 1.0;
+            out = front.time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(_intercept + x * _period));
+        }
+        return out;
+    }
+
+    int64_t PresentClock::getFrames(int64_t refresh, double speed) const
+    {
+        int64_t out = 0;
+        if (refresh > 0 && speed > 0.0)
+        {
+            const auto speedRate = getRateFraction(speed);
+            if (_rate.first > 0 && speedRate.first > 0)
+            {
+                // Whole numbers, so the cadence does not drift.
+                out = refresh * speedRate.first * _rate.second /
+                    (speedRate.second * _rate.first);
+            }
+            else if (_period > 0.0)
+            {
+                out = static_cast<int64_t>(std::floor(refresh * _period * speed + 1.0e-9));
+            }
+        }
+        return out;
+    }
+
+    void PresentClock::_fit()
+    {
+        _period = 0.0;
+        _intercept = 0.0;
+        _rate = std::make_pair(0, 0);
+        const size_t size = _samples.size();
+        if (size < 2)
+        {
+            return;
+        }
+
+        // Least squares, relative to the first sample to keep the numbers
+        // small.
+        const Sample& front = _samples.front();
+        double meanX = 0.0;
+        double meanY = 0.0;
+        for (const auto& sample : _samples)
+        {
+            meanX += sample.index - front.index;
+            meanY += getSeconds(sample.time, front.time);
+        }
+        meanX /= size;
+        meanY /= size;
+        double sxx = 0.0;
+        double sxy = 0.0;
+        for (const auto& sample : _samples)
+        {
+            const double x = (sample.index - front.index) - meanX;
+            const double y = getSeconds(sample.time, front.time) - meanY;
+            sxx += x * x;
+            sxy += x * y;
+        }
+        if (sxx > 0.0 && sxy > 0.0)
+        {
+            _period = sxy / sxx;
+            _intercept = meanY - _period * meanX;
+        }
+
+        if (_period > 0.0 && size >= snapCount)
+        {
+            const double rate = 1.0 / _period;
+            for (const auto& i : standardRates)
+            {
+                const double standard = i.first / static_cast<double>(i.second);
+                if (std::abs(rate - standard) / standard < snapTolerance)
+                {
+                    _rate = i;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::pair<int64_t, int64_t> getRateFraction(double value)
+    {
+        std::pair<int64_t, int64_t> out(0, 0);
+        if (value > 0.0)
+        {
+            const double tolerance = 1.0e-6 * value;
+            const int64_t whole = std::llround(value);
+            const int64_t ntsc = std::llround(value * 1.001);
+            if (std::abs(value - whole) < tolerance)
+            {
+                out = std::make_pair(whole, 1);
+            }
+            else if (std::abs(value - ntsc * 1000 / 1001.0) < tolerance)
+            {
+                out = std::make_pair(ntsc * 1000, 1001);
+            }
+        }
+        return out;
+    }
+}
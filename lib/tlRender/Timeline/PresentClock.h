@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include <tlRender/Core/Export.h>
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <utility>
+
+namespace tl
+{
+    //! Presentation clock, paced by the refreshes of the display.
+    //!
+    //! The times of the display refreshes are fitted to a line, which gives
+    //! the refresh period and predicts the next refresh without the jitter
+    //! of the individual times. Each refresh is numbered from the last
+    //! reset, and the frame to show on a refresh is worked out from its
+    //! number rather than from when it happened to be sampled. When the
+    //! period is close to a standard rate (60, 59.94, 50, ...) the rate and
+    //! the playback speed are taken as exact fractions, so that 24 frames
+    //! per second on a 60Hz display comes out as an exact 3:2 cadence
+    //! however long it plays.
+    class TL_API_TYPE PresentClock
+    {
+    public:
+        TL_API PresentClock();
+
+        //! Restart the frame count. The next refresh shows frame zero.
+        TL_API void reset();
+
+        //! Add the time of a display refresh. Returns the number of the
+        //! refresh since the last reset, counting any that were missed.
+        TL_API int64_t addRefresh(const std::chrono::steady_clock::time_point&);
+
+        //! Get whether there are enough refreshes to know the rate, and the
+        //! last one is recent.
+        TL_API bool isLocked(const std::chrono::steady_clock::time_point&) const;
+
+        //! Get the refresh period in seconds, or zero when it is not known.
+        TL_API double getPeriod() const;
+
+        //! Get the refresh rate as a fraction, when it is a standard rate.
+        //! Zeros otherwise.
+        TL_API std::pair<int64_t, int64_t> getRate() const;
+
+        //! Predict the time of the first refresh after the given time.
+        TL_API std::chrono::steady_clock::time_point predict(
+            const std::chrono::steady_clock::time_point&) const;
+
+        //! Get the number of whole frames that have started by the given
+        //! refresh, playing at the given speed in frames per second.
+        TL_API int64_t getFrames(int64_t refresh, double speed) const;
+
+    private:
+        void _fit();
+
+        struct Sample
+        {
+            int64_t index = 0;
+            std::chrono::steady_clock::time_point time;
+        };
+        std::deque<Sample> _samples;
+        double _period = 0.0;
+        double _intercept = 0.0;
+        std::pair<int64_t, int64_t> _rate = std::make_pair(0, 0);
+        int64_t _anchor = 0;
+        bool _anchorPending = true;
+    };
+
+    //! Get a rate as a fraction when it is a whole number or an NTSC rate
+    //! (a whole number times 1000/1001). Zeros otherwise.
+    TL_API std::pair<int64_t, int64_t> getRateFraction(double);
+}
@@ -0,0 +1,494 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/Timeline/Proxy.h>
+
+#include <tlRender/Timeline/PixelPrivate.h>
+#include <tlRender/Timeline/Util.h>
+
+#include <tlRender/IO/SeqDecode.h>
+#include <tlRender/IO/System.h>
+
+#include <ftk/Core/Context.h>
+#include <ftk/Core/Format.h>
+#include <ftk/Core/LogSystem.h>
+
+#include <opentimelineio/clip.h>
+#include <opentimelineio/imageSequenceReference.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <iomanip>
+#include <list>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#if defined(_WINDOWS)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // NOMINMAX
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#include <pthread/qos.h>
+#else // _WINDOWS
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // _WINDOWS
+
+namespace tl
+{
+    bool ProxyOptions::operator == (const ProxyOptions& other) const
+    {
+        return
+            key == other.key &&
+            scale == other.scale &&
+            directory == other.directory &&
+            extension == other.extension &&
+            writeOptions == other.writeOptions &&
+            threadCount == other.threadCount;
+    }
+
+    bool ProxyOptions::operator != (const ProxyOptions& other) const
+    {
+        return !(*this == other);
+    }
+
+    bool ProxyProgress::operator == (const ProxyProgress& other) const
+    {
+        return
+            mediaCount == other.mediaCount &&
+            mediaDone == other.mediaDone &&
+            frameCount == other.frameCount &&
+            frameDone == other.frameDone &&
+            errors == other.errors &&
+            finished == other.finished;
+    }
+
+    bool ProxyProgress::operator != (const ProxyProgress& other) const
+    {
+        return !(*this == other);
+    }
+
+    namespace
+    {
+        //! Run the calling thread at a low priority.
+        void setLowPriority()
+        {
+#if defined(_WINDOWS)
+            SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#elif defined(__APPLE__)
+            pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+#else // _WINDOWS
+            // On Linux the nice value belongs to the thread rather than the
+            // process.
+            setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 10);
+#endif // _WINDOWS
+        }
+    }
+
+    void proxyResize(
+        const std::shared_ptr<ftk::Image>& in,
+        const std::shared_ptr<ftk::Image>& out)
+    {
+        const ftk::ImageInfo& inInfo = in->getInfo();
+        const ftk::ImageInfo& outInfo = out->getInfo();
+        int inChannels = 0;
+        pixel::Component inComponent = pixel::Component::U8;
+        int outChannels = 0;
+        pixel::Component outComponent = pixel::Component::U8;
+        if (!pixel::getLayout(inInfo.type, inChannels, inComponent) ||
+            !pixel::getLayout(outInfo.type, outChannels, outComponent))
+        {
+            throw std::runtime_error(ftk::Format("Cannot convert {0} to {1}").
+                arg(inInfo.type).
+                arg(outInfo.type));
+        }
+        const int iw = inInfo.size.w;
+        const int ih = inInfo.size.h;
+        const int ow = outInfo.size.w;
+        const int oh = outInfo.size.h;
+        if (iw <= 0 || ih <= 0 || ow <= 0 || oh <= 0)
+        {
+            return;
+        }
+
+        // Rows may be padded out to the alignment.
+        const size_t inStride = in->getByteCount() / ih;
+        const size_t outStride = out->getByteCount() / oh;
+        const size_t inPixel = inChannels * pixel::getSize(inComponent);
+        const size_t outPixel = outChannels * pixel::getSize(outComponent);
+
+        // The columns of the input that each column of the output covers.
+        std::vector<int> x0(ow);
+        std::vector<int> x1(ow);
+        for (int x = 0; x < ow; ++x)
+        {
+            x0[x] = static_cast<int>(static_cast<int64_t>(x) * iw / ow);
+            x1[x] = std::max(
+                x0[x] + 1,
+                static_cast<int>(static_cast<int64_t>(x + 1) * iw / ow));
+        }
+
+        std::vector<float> sum(ow * 4);
+        float rgba[4];
+        for (int y = 0; y < oh; ++y)
+        {
+            const int y0 = static_cast<int>(static_cast<int64_t>(y) * ih / oh);
+            const int y1 = std::max(
+                y0 + 1,
+                static_cast<int>(static_cast<int64_t>(y + 1) * ih / oh));
+            std::fill(sum.begin(), sum.end(), 0.F);
+            for (int yy = y0; yy < y1; ++yy)
+            {
+                const uint8_t* row = in->getData() + yy * inStride;
+                for (int x = 0; x < ow; ++x)
+                {
+                    float* s = sum.data() + x * 4;
+                    for (int xx = x0[x]; xx < x1[x]; ++xx)
+                    {
+                        pixel::readPixel(row + xx * inPixel, inChannels, inComponent, rgba);
+                        s[0] += rgba[0];
+                        s[1] += rgba[1];
+                        s[2] += rgba[2];
+                        s[3] += rgba[3];
+                    }
+                }
+            }
+            uint8_t* row = out->getData() + y * outStride;
+            for (int x = 0; x < ow; ++x)
+            {
+                const float n = static_cast<float>((x1[x] - x0[x]) * (y1 - y0));
+                float* s = sum.data() + x * 4;
+                for (int c = 0; c < 4; ++c)
+                {
+                    s[c] /= n;
+                }
+                pixel::writePixel(s, outChannels, outComponent, row + x * outPixel);
+            }
+        }
+    }
+
+    struct ProxyGenerator::Private
+    {
+        std::weak_ptr<ftk::Context> context;
+        std::shared_ptr<Timeline> timeline;
+        ProxyOptions options;
+
+        //! The clips that share a media.
+        struct Media
+        {
+            ftk::Path path;
+            const OTIO_NS::MediaReference* ref = nullptr;
+            std::vector<const OTIO_NS::Clip*> clips;
+        };
+
+        struct Mutex
+        {
+            std::list<Media> media;
+            ProxyProgress progress;
+            std::mutex mutex;
+        };
+        Mutex mutex;
+
+        std::atomic<bool> running;
+        std::vector<std::thread> threads;
+
+        //! Make the proxy of a media and add it to the clips. Returns false
+        //! when the media does not need one.
+        bool make(const Media&);
+    };
+
+    void ProxyGenerator::_init(
+        const std::shared_ptr<ftk::Context>& context,
+        const std::shared_ptr<Timeline>& timeline,
+        const ProxyOptions& options)
+    {
+        FTK_P();
+        p.context = context;
+        p.timeline = timeline;
+        p.options = options;
+
+        // Each media is made once however many clips use it.
+        const auto& timelineOptions = timeline->getOptions();
+        const std::string dir = timeline->getPath().getDir();
+        std::map<std::string, std::list<Private::Media>::iterator> byPath;
+        for (const auto& clip :
+            timeline->getTimeline().value->find_children<OTIO_NS::Clip>())
+        {
+            const OTIO_NS::MediaReference* ref = clip->media_reference();
+            if (!ref ||
+                (!dynamic_cast<const OTIO_NS::ExternalReference*>(ref) &&
+                !dynamic_cast<const OTIO_NS::ImageSequenceReference*>(ref)))
+            {
+                continue;
+            }
+            const ftk::Path path = getPath(ref, dir, timelineOptions.pathOptions);
+            const auto i = byPath.find(path.get());
+            if (i != byPath.end())
+            {
+                i->second->clips.push_back(clip.value);
+            }
+            else
+            {
+                Private::Media media;
+                media.path = path;
+                media.ref = ref;
+                media.clips.push_back(clip.value);
+                byPath[path.get()] = p.mutex.media.insert(p.mutex.media.end(), media);
+            }
+        }
+        p.mutex.progress.mediaCount = p.mutex.media.size();
+        p.mutex.progress.finished = p.mutex.media.empty();
+
+        p.running = true;
+        const size_t threadCount = std::min(
+            std::max(options.threadCount, static_cast<size_t>(1)),
+            std::max(p.mutex.media.size(), static_cast<size_t>(1)));
+        for (size_t i = 0; i < threadCount; ++i)
+        {
+            p.threads.push_back(std::thread(
+                [this]
+                {
+                    _run();
+                }));
+        }
+    }
+
+    ProxyGenerator::ProxyGenerator() :
+        _p(new Private)
+    {}
+
+    ProxyGenerator::~ProxyGenerator()
+    {
+        FTK_P();
+        p.running = false;
+        for (auto& thread : p.threads)
+        {
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+    }
+
+    std::shared_ptr<ProxyGenerator> ProxyGenerator::create(
+        const std::shared_ptr<ftk::Context>& context,
+        const std::shared_ptr<Timeline>& timeline,
+        const ProxyOptions& options)
+    {
+        auto out = std::shared_ptr<ProxyGenerator>(new ProxyGenerator);
+        out->_init(context, timeline, options);
+        return out;
+    }
+
+    const std::shared_ptr<Timeline>& ProxyGenerator::getTimeline() const
+    {
+        return _p->timeline;
+    }
+
+    const ProxyOptions& ProxyGenerator::getOptions() const
+    {
+        return _p->options;
+    }
+
+    ProxyProgress ProxyGenerator::getProgress() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        return p.mutex.progress;
+    }
+
+    void ProxyGenerator::cancel()
+    {
+        _p->running = false;
+    }
+
+    void ProxyGenerator::_run()
+    {
+        FTK_P();
+        setLowPriority();
+        while (p.running)
+        {
+            Private::Media media;
+            {
+                std::unique_lock<std::mutex> lock(p.mutex.mutex);
+                if (p.mutex.media.empty())
+                {
+                    break;
+                }
+                media = p.mutex.media.front();
+                p.mutex.media.pop_front();
+            }
+            std::string error;
+            try
+            {
+                p.make(media);
+            }
+            catch (const std::exception& e)
+            {
+                error = ftk::Format("Cannot make a proxy of \"{0}\": {1}").
+                    arg(media.path.get()).
+                    arg(e.what());
+                if (auto context = p.context.lock())
+                {
+                    context->getLogSystem()->print(
+                        "tl::ProxyGenerator",
+                        error,
+                        ftk::LogType::Error);
+                }
+            }
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            ++p.mutex.progress.mediaDone;
+            if (!error.empty())
+            {
+                p.mutex.progress.errors.push_back(error);
+            }
+            p.mutex.progress.finished =
+                p.mutex.progress.mediaDone == p.mutex.progress.mediaCount;
+        }
+    }
+
+    bool ProxyGenerator::Private::make(const Media& media)
+    {
+        auto context = this->context.lock();
+        if (!context)
+        {
+            return false;
+        }
+
+        // Open the media the way the timeline does: a sequence is decoded a
+        // frame at a time, anything else goes through a reader. A movie is
+        // asked for RGB, which is what the writers take.
+        IOOptions readOptions = timeline->getOptions().ioOptions;
+        readOptions["FFmpeg/YUVToRGB"] = "1";
+        auto readSystem = context->getSystem<ReadSystem>();
+        std::shared_ptr<SeqDecode> seq;
+        std::shared_ptr<IVideoRead> read;
+        IOInfo info;
+        if (auto plugin = readSystem->getPlugin(media.path))
+        {
+            if (auto decode = plugin->decode(readOptions))
+            {
+                seq = SeqDecode::create(media.path, {}, decode, readOptions);
+                info = seq->getInfo();
+            }
+        }
+        if (!seq)
+        {
+            read = readSystem->videoRead(media.path, readOptions);
+            if (!read)
+            {
+                throw std::runtime_error("Cannot open the media");
+            }
+            info = read->getInfo().get();
+        }
+        if (info.video.empty() || !info.videoTime.has_value())
+        {
+            return false;
+        }
+        const ftk::ImageInfo& inInfo = info.video.front();
+        const ftk::Size2I size(
+            std::max(1, static_cast<int>(inInfo.size.w * options.scale + .5F)),
+            std::max(1, static_cast<int>(inInfo.size.h * options.scale + .5F)));
+        if (size.w >= inInfo.size.w && size.h >= inInfo.size.h)
+        {
+            return false;
+        }
+
+        // Name the proxy after the media, with a hash of the full path so
+        // that media with the same name in different directories do not
+        // collide.
+        std::string dir = options.directory;
+        if (dir.empty())
+        {
+            dir = ftk::appendSeparator(timeline->getPath().getDir()) + "proxy";
+        }
+        dir = ftk::appendSeparator(dir);
+        std::filesystem::create_directories(std::filesystem::u8path(dir));
+        std::string base = media.path.getBase();
+        while (!base.empty() && ('.' == base.back() || '_' == base.back()))
+        {
+            base.pop_back();
+        }
+        std::stringstream ss;
+        ss << base << "_" << std::hex << std::hash<std::string>()(media.path.get()) << "_proxy.";
+        const std::string prefix = ss.str();
+        const int pad = 4;
+        const OTIO_NS::TimeRange& timeRange = *info.videoTime;
+        const int64_t startFrame = static_cast<int64_t>(timeRange.start_time().value());
+        ss.str(std::string());
+        ss << dir << prefix << std::dec << std::setfill('0') << std::setw(pad) <<
+            startFrame << options.extension;
+        const ftk::Path path(ss.str());
+
+        auto writePlugin = context->getSystem<WriteSystem>()->getPlugin(path);
+        if (!writePlugin)
+        {
+            throw std::runtime_error(ftk::Format("Cannot write: \"{0}\"").arg(path.get()));
+        }
+        ftk::ImageInfo outInfo(size, inInfo.type);
+        outInfo = writePlugin->getInfo(outInfo);
+        IOInfo writeInfo;
+        writeInfo.video.push_back(outInfo);
+        writeInfo.videoTime = timeRange;
+        auto write = writePlugin->write(path, writeInfo, options.writeOptions);
+        if (!write)
+        {
+            throw std::runtime_error(ftk::Format("Cannot write: \"{0}\"").arg(path.get()));
+        }
+
+        const int64_t frameCount = static_cast<int64_t>(timeRange.duration().value());
+        {
+            std::unique_lock<std::mutex> lock(mutex.mutex);
+            mutex.progress.frameCount += frameCount;
+        }
+        auto image = ftk::Image::create(outInfo);
+        for (int64_t i = 0; i < frameCount && running; ++i)
+        {
+            const OTIO_NS::RationalTime time(
+                timeRange.start_time().value() + i,
+                timeRange.duration().rate());
+            const VideoData data = seq ?
+                seq->readVideo(time, readOptions) :
+                read->readVideo(time, readOptions).get();
+            // A missing frame is left missing, and the proxy holds the one
+            // before it as the original would.
+            if (data.image && !data.missing)
+            {
+                proxyResize(data.image, image);
+                write->writeVideo(time, image);
+            }
+            std::unique_lock<std::mutex> lock(mutex.mutex);
+            ++mutex.progress.frameDone;
+        }
+        if (!running)
+        {
+            return false;
+        }
+        write->finish();
+
+        // A layer without bounds fills the frame whatever its size, so only
+        // bounds the original has need copying.
+        OTIO_NS::SerializableObject::Retainer<OTIO_NS::ImageSequenceReference> ref(
+            new OTIO_NS::ImageSequenceReference(
+                dir,
+                prefix,
+                options.extension,
+                startFrame,
+                1,
+                timeRange.duration().rate(),
+                pad,
+                OTIO_NS::ImageSequenceReference::MissingFramePolicy::hold,
+                timeRange));
+        ref->set_available_image_bounds(media.ref->available_image_bounds());
+        for (const auto& clip : media.clips)
+        {
+            timeline->addMediaReference(clip, options.key, ref.value);
+        }
+        return true;
+    }
+}
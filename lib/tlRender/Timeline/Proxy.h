@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include <tlRender/Timeline/Timeline.h>
+
+namespace tl
+{
+    //! Proxy options.
+    struct TL_API_TYPE ProxyOptions
+    {
+        //! The media reference key the proxies are added under.
+        std::string key = "proxy";
+
+        //! The size of the proxies as a fraction of the original.
+        float scale = .5F;
+
+        //! The directory the proxies are written to. Empty writes them to a
+        //! "proxy" directory next to the timeline.
+        std::string directory;
+
+        //! The file extension, which picks the writer. Each proxy is an
+        //! image sequence, so that any frame can be decoded on its own.
+        std::string extension = ".exr";
+
+        //! Options for the writer.
+        IOOptions writeOptions =
+        {
+            { "OpenEXR/Compression", "DWAA" }
+        };
+
+        //! The number of threads making proxies. They run at a low priority
+        //! so that playback comes first.
+        size_t threadCount = 1;
+
+        TL_API bool operator == (const ProxyOptions&) const;
+        TL_API bool operator != (const ProxyOptions&) const;
+    };
+
+    //! Proxy progress.
+    struct TL_API_TYPE ProxyProgress
+    {
+        //! The number of media to make proxies of.
+        size_t mediaCount = 0;
+
+        //! The number of media finished, including those that failed or did
+        //! not need a proxy.
+        size_t mediaDone = 0;
+
+        //! The number of frames to write. It grows as each media is opened.
+        int64_t frameCount = 0;
+
+        //! The number of frames written.
+        int64_t frameDone = 0;
+
+        //! Errors, one for each media that failed.
+        std::vector<std::string> errors;
+
+        //! Whether every media has been finished.
+        bool finished = false;
+
+        TL_API bool operator == (const ProxyProgress&) const;
+        TL_API bool operator != (const ProxyProgress&) const;
+    };
+
+    //! Makes proxies of a timeline's media in the background.
+    //!
+    //! The media of each clip is read, shrunk, and written as an image
+    //! sequence. When a media is finished its proxy is added to the clips
+    //! that use it with Timeline::addMediaReference(), so it can be chosen
+    //! with Timeline::setMediaReferenceKey() or Player::setProxyKey() while
+    //! the rest are still being made.
+    class TL_API_TYPE ProxyGenerator : public std::enable_shared_from_this<ProxyGenerator>
+    {
+        FTK_NON_COPYABLE(ProxyGenerator);
+
+    protected:
+        void _init(
+            const std::shared_ptr<ftk::Context>&,
+            const std::shared_ptr<Timeline>&,
+            const ProxyOptions&);
+
+        ProxyGenerator();
+
+    public:
+        //! The destructor cancels what has not been written and waits for
+        //! the threads to finish.
+        TL_API ~ProxyGenerator();
+
+        //! Create a new proxy generator. It starts right away.
+        TL_API static std::shared_ptr<ProxyGenerator> create(
+            const std::shared_ptr<ftk::Context>&,
+            const std::shared_ptr<Timeline>&,
+            const ProxyOptions& = ProxyOptions());
+
+        //! Get the timeline.
+        TL_API const std::shared_ptr<Timeline>& getTimeline() const;
+
+        //! Get the options.
+        TL_API const ProxyOptions& getOptions() const;
+
+        //! Get the progress. Safe to call from any thread.
+        TL_API ProxyProgress getProgress() const;
+
+        //! Cancel. The media being written are abandoned and not added to
+        //! the timeline.
+        TL_API void cancel();
+
+    private:
+        void _run();
+
+        FTK_PRIVATE();
+    };
+
+    //! Shrink an image with a box filter, converting it to the type of the
+    //! output. The images must be RGB, RGBA, L, or LA.
+    TL_API void proxyResize(
+        const std::shared_ptr<ftk::Image>& in,
+        const std::shared_ptr<ftk::Image>& out);
+}
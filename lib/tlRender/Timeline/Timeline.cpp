@@ -5,10 +5,15 @@
 
 #include <filesystem>
 
+#include <tlRender/Timeline/DiskCache.h>
+#include <tlRender/Timeline/Flatten.h>
+#include <tlRender/Timeline/FrameCache.h>
 #include <tlRender/Timeline/Util.h>
 #include <tlRender/Timeline/ZipPrivate.h>
 
+#include <tlRender/IO/Completion.h>
 #include <tlRender/IO/SeqIO.h>
+#include <tlRender/IO/SeqPrefetch.h>
 #include <tlRender/IO/System.h>
 
 #include <tlRender/Core/URL.h>
@@ -53,11 +58,25 @@ namespace tl
             return std::filesystem::u8path(absoluteFileName(path.get())).
                 lexically_normal().u8string();
         }
+
+        //! The modification time of a file as text, or nothing when there is
+        //! no file to ask.
+        std::string fileTimeStamp(const std::string& fileName)
+        {
+            std::error_code ec;
+            const auto time = std::filesystem::last_write_time(
+                std::filesystem::u8path(fileName), ec);
+            return ec ? std::string() : std::to_string(time.time_since_epoch().count());
+        }
     }
 
     namespace
     {
-        const std::chrono::milliseconds timeout(5);
+        // How long the request thread waits for a completion notification
+        // while requests are in progress, before looking at their futures
+        // anyway. Every reader here notifies when it completes a request,
+        // so this only matters for one that does not.
+        const std::chrono::milliseconds inFlightTimeout(100);
 
         // How often an otherwise idle timeline wakes to log itself, and so
         // how long it will wait for a request before looking again.
@@ -96,41 +115,6 @@ namespace tl
             return getMediaReferenceBounds(otioClip->media_reference());
         }
 
-        //! Look on disk for the frames a sequence has and group them into runs
-        //! of consecutive numbers, one per clip.
-        //!
-        //! This is the one place that goes looking, and it is a snapshot:
-        //! frames written after it are picked up by opening the sequence again,
-        //! not while it is being watched. The other policies need no such thing
-        //! because they answer for a missing frame as they meet it.
-        std::vector<ftk::RangeI64> getRuns(
-            const ftk::Path& path,
-            const ftk::RangeI64& within,
-            const ftk::PathOptions& pathOptions)
-        {
-            std::vector<ftk::RangeI64> out;
-            auto frames = ftk::toFrames(ftk::findSeq(path, pathOptions));
-            std::sort(frames.begin(), frames.end());
-            for (int64_t frame : frames)
-            {
-                if (frame < within.min() || frame > within.max())
-                {
-                    // Outside the range asked for, so not this sequence's
-                    // business even though it sits beside it on disk.
-                    continue;
-                }
-                if (!out.empty() && out.back().max() + 1 == frame)
-                {
-                    out.back() = ftk::RangeI64(out.back().min(), frame);
-                }
-                else
-                {
-                    out.push_back(ftk::RangeI64(frame, frame));
-                }
-            }
-            return out;
-        }
-
         //! Get the union of the OTIO spatial coordinates of every media
         //! reference on a clip. The canvas is built from this rather than from
         //! the active reference, so that changing the active media reference
@@ -176,12 +160,15 @@ namespace tl
         //! Resolve which media reference a clip should be read from.
         //!
         //! A key set for the clip alone takes precedence over the timeline
-        //! wide key. Clips that do not have the requested key fall back to the
-        //! default media key, and then to the media reference OTIO has active.
+        //! wide key. A media reference added with the key comes before one
+        //! the clip has of its own. Clips that do not have the requested key
+        //! fall back to the default media key, and then to the media
+        //! reference OTIO has active.
         OTIO_NS::MediaReference* resolveMediaReference(
             const OTIO_NS::Clip* otioClip,
             const std::string& key,
-            const std::map<const OTIO_NS::Clip*, std::string>& clipKeys)
+            const std::map<const OTIO_NS::Clip*, std::string>& clipKeys,
+            const AddedMediaReferences* added)
         {
             std::string clipKey = key;
             const auto i = clipKeys.find(otioClip);
@@ -195,6 +182,18 @@ namespace tl
                 // that the media reference map is not copied.
                 return otioClip->media_reference();
             }
+            if (added)
+            {
+                const auto k = added->find(otioClip);
+                if (k != added->end())
+                {
+                    const auto l = k->second.find(clipKey);
+                    if (l != k->second.end())
+                    {
+                        return l->second.value;
+                    }
+                }
+            }
             const auto mediaReferences = otioClip->media_references();
             auto j = mediaReferences.find(clipKey);
             if (j == mediaReferences.end())
@@ -399,6 +398,8 @@ namespace tl
             }
         }
 
+        p.setOpenStage(TimelineOpenStage::Probing);
+
         // Read the file. A sequence is read by a decoder, which holds no
         // thread; only a format that has to be read statefully still needs a
         // reader here.
@@ -531,10 +532,13 @@ namespace tl
                     isStructural(missingFrames) &&
                     path.getFrames().has_value())
                 {
-                    runs = getRuns(
+                    // This is a snapshot: frames written after it are picked
+                    // up by opening the sequence again.
+                    p.setOpenStage(TimelineOpenStage::Indexing);
+                    runs = SeqFrameIndex::scan(
                         path,
                         path.getFrames().value(),
-                        options.pathOptions);
+                        options.pathOptions).getRuns();
                 }
 
                 videoTrack = new OTIO_NS::Track(
@@ -657,6 +661,7 @@ namespace tl
         // Is the input an OTIO file?
         if (!otioTimeline)
         {
+            p.setOpenStage(TimelineOpenStage::Parsing);
             const std::string fileName = path.get();
             const std::string ext = ftk::toLower(path.getExt());
             OTIO_NS::ErrorStatus otioError;
@@ -693,7 +698,10 @@ namespace tl
 
                 p.zipReader = std::make_shared<ZipReader>(logSystem);
                 auto& zipReader = *p.zipReader;
-                zipReader.open(fileName, p.fileIO->getSize());
+                zipReader.open(
+                    fileName,
+                    p.fileIO->getSize(),
+                    options.bundleIndex ? fileName + ".tlindex" : std::string());
 
                 std::string json = zipReader.readText("content.otio");
                 otioTimeline = dynamic_cast<OTIO_NS::Timeline*>(
@@ -784,6 +792,7 @@ namespace tl
                 // Map every media reference, not only the active one, so that
                 // the active reference can be changed without re-reading the
                 // bundle.
+                p.setOpenStage(TimelineOpenStage::Indexing);
                 for (auto clip : otioTimeline->find_children<OTIO_NS::Clip>())
                 {
                     const auto* activeReference = clip->media_reference();
@@ -837,6 +846,8 @@ namespace tl
         p.context = context;
         auto logSystem = context->getLogSystem();
         p.logSystem = logSystem;
+        p.frameCache = context->getSystem<FrameCache>();
+        p.diskCache = context->getSystem<DiskCache>();
         {
             std::vector<std::string> lines;
             lines.push_back(std::string());
@@ -850,8 +861,16 @@ namespace tl
                 arg(options.compat));
             lines.push_back(ftk::Format("    * Read thread count: {0}").
                 arg(options.readThreadCount));
+            lines.push_back(ftk::Format("    * Prefetch thread count: {0}").
+                arg(options.prefetchThreadCount));
+            lines.push_back(ftk::Format("    * Prefetch frames: {0}").
+                arg(options.prefetchFrames));
             lines.push_back(ftk::Format("    * Audio request max: {0}").
                 arg(options.audioRequestMax));
+            lines.push_back(ftk::Format("    * Bundle index: {0}").
+                arg(options.bundleIndex));
+            lines.push_back(ftk::Format("    * Flatten cache max: {0}").
+                arg(options.flattenCacheMax));
             for (const auto& i : options.ioOptions)
             {
                 lines.push_back(ftk::Format("    * AV I/O {0}: {1}").
@@ -894,14 +913,36 @@ namespace tl
         p.videoReadCache.setMax(p.options.readCacheMax);
         p.audioReadCache.setMax(p.options.readCacheMax);
         p.seqCache.setMax(p.options.seqCacheMax);
+        p.thread.flattenCache.setMax(p.options.flattenCacheMax);
+
+        // Wake the request thread when one of its reads completes, rather
+        // than having it poll the futures.
+        p.completion = Completion::create(
+            [this]
+            {
+                FTK_P();
+                {
+                    std::unique_lock<std::mutex> lock(p.mutex.mutex);
+                    p.mutex.completed = true;
+                }
+                p.thread.cv.notify_one();
+            });
+
         if (p.options.threaded)
         {
             p.startReadPool(p.options.readThreadCount);
+            if (p.options.prefetchThreadCount > 0)
+            {
+                p.seqPrefetch = SeqPrefetch::create(
+                    p.options.prefetchThreadCount,
+                    p.options.prefetchFrames);
+            }
         }
 
         // Get information about the timeline. A timeline whose tracks have
         // no duration is zero length rather than unset, so that everything
         // downstream has a range to work in.
+        p.setOpenStage(TimelineOpenStage::Indexing);
         p.timeRange = tl::getTimeRange(p.otioTimeline.value).
             value_or(OTIO_NS::TimeRange());
         for (const auto& otioTrack :
@@ -949,6 +990,7 @@ namespace tl
                 }
             }
         }
+        p.setOpenStage(TimelineOpenStage::Probing);
         for (const auto& i : p.otioTimeline.value->tracks()->children())
         {
             if (auto otioTrack = dynamic_cast<const OTIO_NS::Track*>(i.value))
@@ -1083,6 +1125,12 @@ namespace tl
             p.thread.thread.join();
         }
         p.stopReadPool();
+        p.seqPrefetch.reset();
+        // Readers can still be holding requests made here.
+        if (p.completion)
+        {
+            p.completion->close();
+        }
 
         --objectCount;
     }
@@ -1295,7 +1343,18 @@ namespace tl
         return resolveMediaReference(
             otioClip,
             thread.mediaReferenceKey,
-            thread.clipMediaReferenceKeys);
+            thread.clipMediaReferenceKeys,
+            &thread.addedMediaReferences);
+    }
+
+    OTIO_NS::MediaReference* Timeline::Private::audioMediaReference(
+        const OTIO_NS::Clip* otioClip) const
+    {
+        return resolveMediaReference(
+            otioClip,
+            thread.mediaReferenceKey,
+            thread.clipMediaReferenceKeys,
+            nullptr);
     }
 
     std::optional<OTIO_NS::TimeRange>
@@ -1768,6 +1827,16 @@ namespace tl
                 keys.insert(i.first);
             }
         }
+        {
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            for (const auto& i : p.mutex.addedMediaReferences)
+            {
+                for (const auto& j : i.second)
+                {
+                    keys.insert(j.first);
+                }
+            }
+        }
         return std::vector<std::string>(keys.begin(), keys.end());
     }
 
@@ -1832,7 +1901,20 @@ namespace tl
         return resolveMediaReference(
             otioClip,
             p.mutex.mediaReferenceKey,
-            p.mutex.clipMediaReferenceKeys);
+            p.mutex.clipMediaReferenceKeys,
+            &p.mutex.addedMediaReferences);
+    }
+
+    void Timeline::addMediaReference(
+        const OTIO_NS::Clip* otioClip,
+        const std::string& key,
+        OTIO_NS::MediaReference* mediaReference)
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        p.mutex.addedMediaReferences[otioClip][key] =
+            OTIO_NS::SerializableObject::Retainer<OTIO_NS::MediaReference>(mediaReference);
+        p.mutex.mediaReferenceKeysChanged = true;
     }
 
     const OTIO_NS::TimeRange& Timeline::getTimeRange() const
@@ -1886,6 +1968,7 @@ namespace tl
         request->id = p.requestId;
         request->time = time;
         request->options = options;
+        request->completion = getCompletion();
         VideoRequest out;
         out.id = p.requestId;
         out.future = request->promise.get_future();
@@ -1905,6 +1988,7 @@ namespace tl
         else
         {
             request->promise.set_value(VideoFrame());
+            notifyCompletion(request->completion);
         }
         if (!p.options.threaded)
         {
@@ -1939,6 +2023,7 @@ namespace tl
         request->id = p.requestId;
         request->seconds = seconds;
         request->options = options;
+        request->completion = getCompletion();
         AudioRequest out;
         out.id = p.requestId;
         out.future = request->promise.get_future();
@@ -1958,6 +2043,7 @@ namespace tl
         else
         {
             request->promise.set_value(AudioFrame());
+            notifyCompletion(request->completion);
         }
         if (!p.options.threaded)
         {
@@ -2000,9 +2086,38 @@ namespace tl
                 }
             }
         };
-        std::unique_lock<std::mutex> lock(p.mutex.mutex);
-        cancel(p.mutex.videoRequests);
-        cancel(p.mutex.audioRequests);
+        {
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            cancel(p.mutex.videoRequests);
+            cancel(p.mutex.audioRequests);
+        }
+        // What was read ahead of the cancelled requests is for frames that
+        // are no longer wanted.
+        if (p.seqPrefetch)
+        {
+            p.seqPrefetch->cancel();
+        }
+    }
+
+    void Timeline::refreshFrames()
+    {
+        FTK_P();
+        std::vector<std::shared_ptr<SeqDecode> > seqs;
+        {
+            std::unique_lock<std::mutex> lock(p.readCacheMutex);
+            seqs = p.seqCache.getValues();
+        }
+        for (const auto& seq : seqs)
+        {
+            if (seq)
+            {
+                seq->refreshFrames();
+            }
+        }
+        {
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            p.mutex.flattenCacheClear = true;
+        }
     }
 
     size_t Timeline::getObjectCount()
@@ -2104,11 +2219,12 @@ namespace tl
         const IOOptions& ioOptions)
     {
         FTK_P();
+        const auto prefetch = p.seqPrefetch;
         return p.getCached<SeqDecode>(
             p.seqCache,
             mediaReference,
             ioOptions,
-            [](const std::shared_ptr<ftk::Context>& context,
+            [prefetch](const std::shared_ptr<ftk::Context>& context,
                 const ftk::Path& path,
                 const std::vector<ftk::MemFile>& mem,
                 const IOOptions& options)
@@ -2121,7 +2237,7 @@ namespace tl
                     // which leaves the caller to fall back to a reader.
                     if (const auto decode = plugin->decode(options))
                     {
-                        out = SeqDecode::create(path, mem, decode, options);
+                        out = SeqDecode::create(path, mem, decode, options, prefetch);
                     }
                 }
                 return out;
@@ -2234,7 +2350,7 @@ namespace tl
         const IOOptions& ioOptions)
     {
         FTK_P();
-        return _getAudioRead(p.mediaReference(clip), ioOptions);
+        return _getAudioRead(p.audioMediaReference(clip), ioOptions);
     }
 
     std::shared_ptr<IAudioRead> Timeline::_getAudioRead(
@@ -2260,7 +2376,9 @@ namespace tl
         const OTIO_NS::Clip* clip,
         const OTIO_NS::RationalTime& time,
         const IOOptions& options,
-        std::string* path)
+        std::string* path,
+        std::string* cacheKey,
+        std::function<std::string(const std::optional<int64_t>&)>* identity)
     {
         FTK_P();
         std::future<VideoData> out;
@@ -2311,6 +2429,86 @@ namespace tl
                 timeRangeOpt.value(),
                 trimmedRange,
                 ioInfo.videoTime->duration().rate());
+
+            // Media inside a bundle is named relative to it, so the bundle is
+            // part of the name.
+            const ftk::Path& mediaPath = seq ? seq->getPath() : read->getPath();
+            std::string cachePath = normalMediaPath(mediaPath);
+            const bool bundle = p.bundleMediaReferences.find(mediaReference) !=
+                p.bundleMediaReferences.end();
+            if (bundle)
+            {
+                cachePath = normalMediaPath(p.path) + "!" + cachePath;
+            }
+            if (identity)
+            {
+                *identity = [cachePath, mediaTime, optionsMerged](
+                    const std::optional<int64_t>& heldFrom)
+                {
+                    return FrameCache::getKey(
+                        cachePath,
+                        heldFrom.has_value() ?
+                            OTIO_NS::RationalTime(heldFrom.value(), mediaTime.rate()) :
+                            mediaTime,
+                        optionsMerged);
+                };
+            }
+
+            // A frame another timeline has already read.
+            std::string key;
+            if (p.frameCache)
+            {
+                // Frames on disk can outlive the media they were read from,
+                // so with a disk cache the key says which version of the
+                // file they came from.
+                const bool disk = p.diskCache && p.diskCache->isEnabled();
+                if (disk)
+                {
+                    const std::string stamp = fileTimeStamp(
+                        bundle ? p.path.get() :
+                        (seq && !mediaPath.getNum().empty()) ?
+                            mediaPath.getFrame(static_cast<int>(mediaTime.value()), true) :
+                            mediaPath.getFileName(true));
+                    if (!stamp.empty())
+                    {
+                        cachePath += "|" + stamp;
+                    }
+                }
+                key = FrameCache::getKey(cachePath, mediaTime, optionsMerged);
+                VideoData data;
+                if (p.frameCache->get(key, data))
+                {
+                    std::promise<VideoData> promise;
+                    out = promise.get_future();
+                    promise.set_value(data);
+                    return out;
+                }
+                if (cacheKey)
+                {
+                    *cacheKey = key;
+                }
+
+                // Read back from disk on the pool, like a frame of a
+                // sequence. It may have been evicted by the time it is read,
+                // so it falls back to decoding.
+                if (disk && p.diskCache->contains(key))
+                {
+                    auto diskCache = p.diskCache;
+                    return p.submitRead(
+                        [diskCache, key, seq, read, mediaTime, optionsMerged]
+                        {
+                            VideoData data;
+                            if (diskCache->get(key, data))
+                            {
+                                return data;
+                            }
+                            return seq ?
+                                seq->readVideo(mediaTime, optionsMerged) :
+                                read->readVideo(mediaTime, optionsMerged).get();
+                        });
+                }
+            }
+
             out = seq ?
                 p.submitRead(
                     [seq, mediaTime, optionsMerged]
@@ -2526,7 +2724,7 @@ namespace tl
                 // The first audio clip defines the audio information for the timeline.
                 IOInfo ioInfo;
                 if (_getAudioIOInfo(
-                    p.mediaReference(clip), p.options.ioOptions, ioInfo))
+                    p.audioMediaReference(clip), p.options.ioOptions, ioInfo))
                 {
                     p.ioInfo.audio = ioInfo.audio;
                     p.ioInfo.audioTime = ioInfo.audioTime;
@@ -2558,12 +2756,13 @@ namespace tl
     {
         FTK_P();
 
-        const auto t0 = std::chrono::steady_clock::now();
-
+        // The reads made here wake this timeline, and nobody else, when
+        // they complete.
+        CompletionScope completionScope(p.completion);
         _requests();
 
         // Logging.
-        auto t1 = std::chrono::steady_clock::now();
+        const auto t1 = std::chrono::steady_clock::now();
         const std::chrono::duration<float> diff = t1 - p.thread.logTimer;
         if (diff > logInterval)
         {
@@ -2592,14 +2791,6 @@ namespace tl
                     arg(p.thread.audioRequestsInProgress.size()).
                     arg(p.options.audioRequestMax));
             }
-            t1 = std::chrono::steady_clock::now();
-        }
-
-        // Sleep for a bit, unless the caller is driving this itself and is
-        // waiting on the very request that just finished.
-        if (p.options.threaded)
-        {
-            ftk::sleep(timeout, t0, t1);
         }
     }
 
@@ -2611,19 +2802,27 @@ namespace tl
         std::list<std::shared_ptr<Private::PendingVideoRequest> > newVideoRequests;
         std::list<std::shared_ptr<Private::PendingAudioRequest> > newAudioRequests;
         {
+            // Wait until there is a request that can be started or one of
+            // the reads has completed. Requests beyond the maximum stay
+            // queued until a read in progress completes.
             std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            const bool inProgress =
+                !p.thread.videoRequestsInProgress.empty() ||
+                !p.thread.audioRequestsInProgress.empty();
             p.thread.cv.wait_for(
                 lock,
-                logInterval,
+                inProgress ? inFlightTimeout : std::chrono::milliseconds(logInterval),
                 [this]
                 {
                     return
                         !_p->thread.running ||
-                        !_p->mutex.videoRequests.empty() ||
-                        !_p->thread.videoRequestsInProgress.empty() ||
-                        !_p->mutex.audioRequests.empty() ||
-                        !_p->thread.audioRequestsInProgress.empty();
+                        _p->mutex.completed ||
+                        (!_p->mutex.videoRequests.empty() &&
+                            _p->thread.videoRequestsInProgress.size() < getVideoRequestMax()) ||
+                        (!_p->mutex.audioRequests.empty() &&
+                            _p->thread.audioRequestsInProgress.size() < _p->options.audioRequestMax);
                 });
+            p.mutex.completed = false;
             while (!p.mutex.videoRequests.empty() &&
                 (p.thread.videoRequestsInProgress.size() + newVideoRequests.size()) <
                     getVideoRequestMax())
@@ -2643,13 +2842,38 @@ namespace tl
             {
                 p.thread.mediaReferenceKey = p.mutex.mediaReferenceKey;
                 p.thread.clipMediaReferenceKeys = p.mutex.clipMediaReferenceKeys;
+                p.thread.addedMediaReferences = p.mutex.addedMediaReferences;
+                p.mutex.flattenCacheClear = true;
                 p.mutex.mediaReferenceKeysChanged = false;
             }
+            // Flattened frames show whichever media was read for them.
+            if (p.mutex.flattenCacheClear)
+            {
+                p.thread.flattenCache.clear();
+                ++p.thread.flattenGeneration;
+                p.mutex.flattenCacheClear = false;
+            }
         }
 
         // Traverse the timeline for new video requests.
         for (auto& request : newVideoRequests)
         {
+            if (p.options.flattenCacheMax > 0)
+            {
+                request->flattenKey = FrameCache::getKey(
+                    p.path.get(),
+                    request->time,
+                    request->options);
+                request->flattenGeneration = p.thread.flattenGeneration;
+                VideoFrame frame;
+                if (p.thread.flattenCache.get(request->flattenKey, frame))
+                {
+                    request->promise.set_value(frame);
+                    notifyCompletion(request->completion);
+                    continue;
+                }
+            }
+
             for (const auto& otioTrack : p.otioTimeline->video_tracks())
             {
                 if (otioTrack->enabled())
@@ -2672,7 +2896,7 @@ namespace tl
                                 {
                                     if (auto otioClip = dynamic_cast<const OTIO_NS::Clip*>(otioItem))
                                     {
-                                        videoLayerData.image = _readVideo(otioClip, requestTime, request->options, &videoLayerData.path);
+                                        videoLayerData.image = _readVideo(otioClip, requestTime, request->options, &videoLayerData.path, &videoLayerData.cacheKey, &videoLayerData.identity);
                                         videoLayerData.bounds = getCanvasBox(
                                             getMediaReferenceBounds(p.mediaReference(otioClip)),
                                             p.options.spatial,
@@ -2693,7 +2917,7 @@ namespace tl
                                             const auto transitionNeighbors = otioTrack->neighbors_of(otioTransition, &errorStatus);
                                             if (const auto otioClipB = dynamic_cast<OTIO_NS::Clip*>(transitionNeighbors.second.value))
                                             {
-                                                videoLayerData.imageB = _readVideo(otioClipB, requestTime, request->options, &videoLayerData.pathB);
+                                                videoLayerData.imageB = _readVideo(otioClipB, requestTime, request->options, &videoLayerData.pathB, &videoLayerData.cacheKeyB, &videoLayerData.identityB);
                                                 videoLayerData.boundsB = getCanvasBox(
                                                     getMediaReferenceBounds(p.mediaReference(otioClipB)),
                                                     p.options.spatial,
@@ -2710,6 +2934,8 @@ namespace tl
                                             std::swap(videoLayerData.image, videoLayerData.imageB);
                                             std::swap(videoLayerData.bounds, videoLayerData.boundsB);
                                             std::swap(videoLayerData.path, videoLayerData.pathB);
+                                            std::swap(videoLayerData.cacheKey, videoLayerData.cacheKeyB);
+                                            std::swap(videoLayerData.identity, videoLayerData.identityB);
                                             videoLayerData.transition = toTransition(otioTransition->transition_type());
                                             videoLayerData.transitionValue = _transitionValue(
                                                 requestTime.value(),
@@ -2718,7 +2944,7 @@ namespace tl
                                             const auto transitionNeighbors = otioTrack->neighbors_of(otioTransition, &errorStatus);
                                             if (const auto otioClipB = dynamic_cast<OTIO_NS::Clip*>(transitionNeighbors.first.value))
                                             {
-                                                videoLayerData.image = _readVideo(otioClipB, requestTime, request->options, &videoLayerData.path);
+                                                videoLayerData.image = _readVideo(otioClipB, requestTime, request->options, &videoLayerData.path, &videoLayerData.cacheKey, &videoLayerData.identity);
                                                 videoLayerData.bounds = getCanvasBox(
                                                     getMediaReferenceBounds(p.mediaReference(otioClipB)),
                                                     p.options.spatial,
@@ -2827,11 +3053,57 @@ namespace tl
                     valid &= i.imageB.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
                 }
             }
-            if (valid)
+            if (valid && !(*videoRequestIt)->frame.has_value())
             {
-                const auto frame = p.videoFrame(**videoRequestIt);
+                auto& request = **videoRequestIt;
+                const auto frame = p.videoFrame(request);
                 p.updateReadErrors();
-                (*videoRequestIt)->promise.set_value(frame);
+                if (p.options.flattenCacheMax > 0 && canFlatten(frame))
+                {
+                    // Back around once the pool has composited it.
+                    request.frame = frame;
+                    request.flattened = p.submitRead(
+                        [frame]
+                        {
+                            VideoData out;
+                            out.image = flattenImage(frame);
+                            return out;
+                        });
+                }
+                else
+                {
+                    request.promise.set_value(frame);
+                    notifyCompletion(request.completion);
+                    videoRequestIt = p.thread.videoRequestsInProgress.erase(videoRequestIt);
+                    continue;
+                }
+            }
+            if (valid && (*videoRequestIt)->flattened.valid() &&
+                (*videoRequestIt)->flattened.wait_for(std::chrono::seconds(0)) ==
+                    std::future_status::ready)
+            {
+                auto& request = **videoRequestIt;
+                VideoFrame frame = request.frame.value();
+                std::shared_ptr<ftk::Image> image;
+                try
+                {
+                    image = request.flattened.get().image;
+                }
+                catch (const std::exception&)
+                {}
+                // Without an image, because the pool was stopped for one,
+                // the frame goes out as it was built.
+                if (image)
+                {
+                    frame = flattenFrame(frame, image);
+                    if (request.flattenGeneration == p.thread.flattenGeneration &&
+                        !frame.layers.front().missing)
+                    {
+                        p.thread.flattenCache.add(request.flattenKey, frame);
+                    }
+                }
+                request.promise.set_value(frame);
+                notifyCompletion(request.completion);
                 videoRequestIt = p.thread.videoRequestsInProgress.erase(videoRequestIt);
                 continue;
             }
@@ -2855,6 +3127,7 @@ namespace tl
                 const auto frame = p.audioFrame(**audioRequestIt);
                 p.updateReadErrors();
                 (*audioRequestIt)->promise.set_value(frame);
+                notifyCompletion((*audioRequestIt)->completion);
                 audioRequestIt = p.thread.audioRequestsInProgress.erase(audioRequestIt);
                 continue;
             }
@@ -2886,19 +3159,33 @@ namespace tl
             p.thread.audioRequestsInProgress.clear();
             for (auto& request : videoRequests)
             {
-                const auto frame = p.videoFrame(*request);
+                // One on its way to being flattened has given up its layers
+                // already; it goes out as it was built rather than waiting.
+                const auto frame = request->frame.has_value() ?
+                    request->frame.value() :
+                    p.videoFrame(*request);
                 p.updateReadErrors();
                 request->promise.set_value(frame);
+                notifyCompletion(request->completion);
             }
             for (auto& request : audioRequests)
             {
                 const auto frame = p.audioFrame(*request);
                 p.updateReadErrors();
                 request->promise.set_value(frame);
+                notifyCompletion(request->completion);
             }
         }
     }
 
+    void Timeline::Private::setOpenStage(TimelineOpenStage value)
+    {
+        if (openStage)
+        {
+            openStage(value);
+        }
+    }
+
     void Timeline::Private::startReadPool(size_t threadCount)
     {
         readPool.stopped = false;
@@ -2938,6 +3225,7 @@ namespace tl
                             // and logged instead of going by in silence.
                             task.promise.set_exception(std::current_exception());
                         }
+                        completion->notify();
                     }
                 }));
         }
@@ -2959,6 +3247,10 @@ namespace tl
         {
             task.promise.set_value(VideoData());
         }
+        if (!dropped.empty())
+        {
+            completion->notify();
+        }
         readPool.cv.notify_all();
         for (auto& thread : readPool.threads)
         {
@@ -3005,6 +3297,7 @@ namespace tl
         else
         {
             task.promise.set_value(VideoData());
+            completion->notify();
         }
         return out;
     }
@@ -3049,6 +3342,7 @@ namespace tl
         }
         eraseRequest(thread.videoRequestsInProgress, request.get());
         request->promise.set_value(VideoFrame());
+        notifyCompletion(request->completion);
     }
 
     void Timeline::Private::abandon(
@@ -3067,6 +3361,7 @@ namespace tl
         }
         eraseRequest(thread.audioRequestsInProgress, request.get());
         request->promise.set_value(AudioFrame());
+        notifyCompletion(request->completion);
     }
 
     void Timeline::Private::updateReadErrors()
@@ -3101,6 +3396,46 @@ namespace tl
         }
     }
 
+    std::string Timeline::Private::videoIdentity(
+        const VideoData& data,
+        const std::function<std::string(const std::optional<int64_t>&)>& identity,
+        std::shared_ptr<ftk::Image>& image)
+    {
+        std::string out;
+        if (!image)
+        {
+            return out;
+        }
+        if (data.missing && !data.heldFrom.has_value())
+        {
+            // Made up by the reader, and named by what it was made from
+            // rather than by its pixels.
+            out = data.standIn;
+        }
+        else if (identity)
+        {
+            out = identity(data.heldFrom);
+
+            // A held frame is decoded again each time it is held. When the
+            // frame it holds is still in the frame cache, that image is
+            // used instead, so the two are one image wherever they go. Not
+            // when the disk cache is on, since its keys name the version of
+            // the file as well.
+            if (data.heldFrom.has_value() && frameCache &&
+                !(diskCache && diskCache->isEnabled()))
+            {
+                VideoData held;
+                if (frameCache->get(out, held) &&
+                    held.image &&
+                    held.image->getInfo() == image->getInfo())
+                {
+                    image = held.image;
+                }
+            }
+        }
+        return out;
+    }
+
     VideoFrame Timeline::Private::videoFrame(PendingVideoRequest& request)
     {
         VideoFrame frame;
@@ -3121,10 +3456,21 @@ namespace tl
                     layer.image = data.image;
                     layer.missing = data.missing;
                     layer.heldFrom = data.heldFrom;
+                    layer.identity = videoIdentity(data, i.identity, layer.image);
+                    if (frameCache && !i.cacheKey.empty())
+                    {
+                        frameCache->add(i.cacheKey, data);
+                    }
                 }
                 if (i.imageB.valid())
                 {
-                    layer.imageB = i.imageB.get().image;
+                    const VideoData data = i.imageB.get();
+                    layer.imageB = data.image;
+                    layer.identityB = videoIdentity(data, i.identityB, layer.imageB);
+                    if (frameCache && !i.cacheKeyB.empty())
+                    {
+                        frameCache->add(i.cacheKeyB, data);
+                    }
                 }
             }
             catch (const std::exception& e)
@@ -16,6 +16,7 @@
 #include <opentimelineio/timeline.h>
 #include <opentimelineio/mediaReference.h>
 
+#include <functional>
 #include <future>
 #include <optional>
 
@@ -248,6 +249,18 @@ namespace tl
         TL_API OTIO_NS::MediaReference* getMediaReference(
             const OTIO_NS::Clip*) const;
 
+        //! Add a media reference to a clip under a key, for example a proxy
+        //! made after the timeline was opened. Like the keys it is kept here
+        //! rather than written to the OTIO clip, and it comes before a media
+        //! reference the clip already has with the same key.
+        //!
+        //! It only stands in for the clip's video. Audio is still read from
+        //! the media reference the clip would have without it.
+        TL_API void addMediaReference(
+            const OTIO_NS::Clip*,
+            const std::string& key,
+            OTIO_NS::MediaReference*);
+
         ///@}
 
         //! \name Information
@@ -294,6 +307,12 @@ namespace tl
         //! Cancel requests.
         TL_API void cancelRequests(const std::vector<uint64_t>&);
 
+        //! Look again for which frames the open image sequences have, so
+        //! that frames rendered since they were opened are read rather than
+        //! held or left blank. Frames a player has already cached are not
+        //! read again; flattened frames are let go.
+        TL_API void refreshFrames();
+
         ///@}
 
         //! Get the number of objects currenty instantiated.
@@ -362,7 +381,9 @@ namespace tl
             const OTIO_NS::Clip*,
             const OTIO_NS::RationalTime&,
             const IOOptions&,
-            std::string* path = nullptr);
+            std::string* path = nullptr,
+            std::string* cacheKey = nullptr,
+            std::function<std::string(const std::optional<int64_t>&)>* identity = nullptr);
         std::future<AudioData> _readAudio(
             const OTIO_NS::Clip*,
             const OTIO_NS::TimeRange&,
@@ -378,6 +399,8 @@ namespace tl
         void _requests();
         void _finishRequests();
 
+        friend class TimelineOpen;
+
         FTK_PRIVATE();
     };
 }
@@ -0,0 +1,221 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/Timeline/TimelineOpen.h>
+
+#include <tlRender/Timeline/TimelinePrivate.h>
+
+#include <ftk/Core/Error.h>
+#include <ftk/Core/String.h>
+#include <ftk/Core/Timer.h>
+
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace tl
+{
+    TL_ENUM_IMPL(
+        TimelineOpenStage,
+        "Queued",
+        "Probing",
+        "Indexing",
+        "Parsing",
+        "Ready",
+        "Canceled",
+        "Error");
+
+    namespace
+    {
+        const std::chrono::milliseconds timeout(50);
+
+        //! Thrown from the stage callback to stop the timeline being opened.
+        class CanceledError : public std::runtime_error
+        {
+        public:
+            CanceledError() :
+                std::runtime_error("Canceled")
+            {}
+        };
+    }
+
+    struct TimelineOpen::Private
+    {
+        ftk::Path path;
+        std::shared_ptr<ftk::Observable<TimelineOpenStage> > stage;
+        std::shared_ptr<ftk::Timer> timer;
+        std::thread thread;
+
+        struct Mutex
+        {
+            TimelineOpenStage stage = TimelineOpenStage::Queued;
+            bool canceled = false;
+            std::shared_ptr<Timeline> timeline;
+            std::string error;
+            std::mutex mutex;
+        };
+        Mutex mutex;
+    };
+
+    void TimelineOpen::_init(
+        const std::shared_ptr<ftk::Context>& context,
+        const ftk::Path& path,
+        const ftk::Path& audioPath,
+        const Options& options)
+    {
+        FTK_P();
+        p.path = path;
+        p.stage = ftk::Observable<TimelineOpenStage>::create(TimelineOpenStage::Queued);
+
+        p.thread = std::thread(
+            [this, context, path, audioPath, options]
+            {
+                FTK_P();
+                std::shared_ptr<Timeline> timeline;
+                std::string error;
+                try
+                {
+                    timeline = std::shared_ptr<Timeline>(new Timeline);
+                    timeline->_p->openStage = [this](TimelineOpenStage value)
+                        {
+                            FTK_P();
+                            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+                            if (p.mutex.canceled)
+                            {
+                                throw CanceledError();
+                            }
+                            p.mutex.stage = value;
+                        };
+                    timeline->_init(context, path, audioPath, options);
+                    timeline->_p->openStage = nullptr;
+                }
+                catch (const CanceledError&)
+                {
+                    timeline.reset();
+                }
+                catch (const std::exception& e)
+                {
+                    timeline.reset();
+                    error = e.what();
+                }
+
+                std::unique_lock<std::mutex> lock(p.mutex.mutex);
+                if (p.mutex.canceled)
+                {
+                    p.mutex.stage = TimelineOpenStage::Canceled;
+                }
+                else if (timeline)
+                {
+                    p.mutex.stage = TimelineOpenStage::Ready;
+                    p.mutex.timeline = timeline;
+                }
+                else
+                {
+                    p.mutex.stage = TimelineOpenStage::Error;
+                    p.mutex.error = error;
+                }
+            });
+
+        p.timer = ftk::Timer::create(context);
+        p.timer->setRepeating(true);
+        p.timer->start(
+            timeout,
+            [this]
+            {
+                _tick();
+            });
+    }
+
+    TimelineOpen::TimelineOpen() :
+        _p(new Private)
+    {}
+
+    TimelineOpen::~TimelineOpen()
+    {
+        FTK_P();
+        {
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            p.mutex.canceled = true;
+        }
+        if (p.thread.joinable())
+        {
+            p.thread.join();
+        }
+    }
+
+    std::shared_ptr<TimelineOpen> TimelineOpen::create(
+        const std::shared_ptr<ftk::Context>& context,
+        const ftk::Path& path,
+        const Options& options)
+    {
+        auto out = std::shared_ptr<TimelineOpen>(new TimelineOpen);
+        out->_init(context, path, ftk::Path(), options);
+        return out;
+    }
+
+    std::shared_ptr<TimelineOpen> TimelineOpen::create(
+        const std::shared_ptr<ftk::Context>& context,
+        const ftk::Path& path,
+        const ftk::Path& audioPath,
+        const Options& options)
+    {
+        auto out = std::shared_ptr<TimelineOpen>(new TimelineOpen);
+        out->_init(context, path, audioPath, options);
+        return out;
+    }
+
+    const ftk::Path& TimelineOpen::getPath() const
+    {
+        return _p->path;
+    }
+
+    std::shared_ptr<ftk::IObservable<TimelineOpenStage> > TimelineOpen::observeStage() const
+    {
+        return _p->stage;
+    }
+
+    std::shared_ptr<Timeline> TimelineOpen::getTimeline() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        return p.mutex.timeline;
+    }
+
+    std::string TimelineOpen::getError() const
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        return p.mutex.error;
+    }
+
+    void TimelineOpen::cancel()
+    {
+        FTK_P();
+        std::unique_lock<std::mutex> lock(p.mutex.mutex);
+        p.mutex.canceled = true;
+    }
+
+    void TimelineOpen::_tick()
+    {
+        FTK_P();
+        TimelineOpenStage stage = TimelineOpenStage::Queued;
+        {
+            std::unique_lock<std::mutex> lock(p.mutex.mutex);
+            stage = p.mutex.stage;
+        }
+        switch (stage)
+        {
+        case TimelineOpenStage::Ready:
+        case TimelineOpenStage::Canceled:
+        case TimelineOpenStage::Error:
+            p.timer->stop();
+            if (p.thread.joinable())
+            {
+                p.thread.join();
+            }
+            break;
+        default: break;
+        }
+        p.stage->setIfChanged(stage);
+    }
+}
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include <tlRender/Timeline/Timeline.h>
+
+#include <ftk/Core/Observable.h>
+
+namespace tl
+{
+    //! Timeline open stages.
+    enum class TL_API_TYPE TimelineOpenStage
+    {
+        Queued,
+        Probing,
+        Indexing,
+        Parsing,
+        Ready,
+        Canceled,
+        Error,
+
+        Count,
+        First = Queued
+    };
+    TL_ENUM(TimelineOpenStage);
+
+    //! Open a timeline on its own thread.
+    //!
+    //! Opening an OTIO of thousands of clips, a large bundle, or a movie
+    //! over the network can take seconds, which is too long to hold the
+    //! user interface. The timeline is created on a thread of its own, so
+    //! several can be opened at once, and the stage it has reached is
+    //! observed on the main thread.
+    //!
+    //! A cancel takes effect at the start of the next stage.
+    class TL_API_TYPE TimelineOpen : public std::enable_shared_from_this<TimelineOpen>
+    {
+        FTK_NON_COPYABLE(TimelineOpen);
+
+    protected:
+        void _init(
+            const std::shared_ptr<ftk::Context>&,
+            const ftk::Path& path,
+            const ftk::Path& audioPath,
+            const Options&);
+
+        TimelineOpen();
+
+    public:
+        TL_API ~TimelineOpen();
+
+        //! Start opening a timeline from a path. The path can point to an
+        //! .otio file, movie file, or image sequence.
+        TL_API static std::shared_ptr<TimelineOpen> create(
+            const std::shared_ptr<ftk::Context>&,
+            const ftk::Path&,
+            const Options& = Options());
+
+        //! Start opening a timeline from a path and audio path.
+        TL_API static std::shared_ptr<TimelineOpen> create(
+            const std::shared_ptr<ftk::Context>&,
+            const ftk::Path& path,
+            const ftk::Path& audioPath,
+            const Options& = Options());
+
+        //! Get the path.
+        TL_API const ftk::Path& getPath() const;
+
+        //! Observe the stage.
+        TL_API std::shared_ptr<ftk::IObservable<TimelineOpenStage> > observeStage() const;
+
+        //! Get the timeline, once the stage is ready.
+        TL_API std::shared_ptr<Timeline> getTimeline() const;
+
+        //! Get the error, once the stage is an error.
+        TL_API std::string getError() const;
+
+        //! Cancel opening the timeline.
+        TL_API void cancel();
+
+    private:
+        void _tick();
+
+        FTK_PRIVATE();
+    };
+}
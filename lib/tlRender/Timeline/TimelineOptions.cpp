@@ -38,10 +38,14 @@ namespace tl
             imageSeqAudioFileName == other.imageSeqAudioFileName &&
             compat == other.compat &&
             threaded == other.threaded &&
+            bundleIndex == other.bundleIndex &&
             readThreadCount == other.readThreadCount &&
+            prefetchThreadCount == other.prefetchThreadCount &&
+            prefetchFrames == other.prefetchFrames &&
             audioRequestMax == other.audioRequestMax &&
             readCacheMax == other.readCacheMax &&
             seqCacheMax == other.seqCacheMax &&
+            flattenCacheMax == other.flattenCacheMax &&
             ioOptions == other.ioOptions &&
             pathOptions == other.pathOptions;
     }
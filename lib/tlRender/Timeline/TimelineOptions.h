@@ -80,6 +80,19 @@ namespace tl
         //! is not silently undone by a separate limit.
         size_t readThreadCount = getDefaultReadThreadCount();
 
+        //! How many threads read sequence frames from disk ahead of
+        //! decoding them. Zero leaves each decoder to read its own file.
+        //!
+        //! Worth turning on where reading a file has a long latency, such as
+        //! network storage: the decoding threads otherwise wait on every
+        //! read, and adding decoding threads to make up for it adds memory
+        //! as well. Does nothing for a bundle, which is already in memory,
+        //! or for a timeline without a thread.
+        size_t prefetchThreadCount = 0;
+
+        //! How many sequence files are read ahead, across the whole
+        //! timeline.
+        size_t prefetchFrames = 16;
 
         //! Maximum number of audio requests in flight.
         //!
@@ -112,6 +125,32 @@ namespace tl
         //! bound if that ever starts to matter.
         size_t seqCacheMax = 1000;
 
+        //! Maximum number of flattened frames held, with zero turning
+        //! flattening off.
+        //!
+        //! A frame of stacked tracks, or of a transition, is otherwise
+        //! composited by the renderer every time it is drawn. Flattened,
+        //! the layers are composited once, on the read threads, and the
+        //! frame reaches the renderer as a single image. Frames are held by
+        //! time and I/O options, and let go when the media reference keys
+        //! change or the frames are refreshed.
+        //!
+        //! Off by default because the layers are composited in the color
+        //! space of the source rather than through their own input color
+        //! spaces, which only matches when the media share one; see
+        //! canFlatten() for which frames are left as they are.
+        size_t flattenCacheMax = 0;
+
+        //! Keep an index next to a bundle (.otioz), as the bundle's file name
+        //! with ".tlindex" appended.
+        //!
+        //! Opening a bundle reads its central directory, which for tens of
+        //! thousands of frames is megabytes. The index holds the entries as
+        //! they are after that, keyed on the bundle's size and modification
+        //! time, so a bundle that has not changed opens with one read. Off
+        //! by default since it writes beside the media.
+        bool bundleIndex = false;
+
         //! I/O options.
         IOOptions ioOptions;
 
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <tlRender/Timeline/Timeline.h>
+#include <tlRender/Timeline/TimelineOpen.h>
 
 #include <ftk/Core/LRUCache.h>
 
@@ -21,12 +22,29 @@
 
 namespace tl
 {
+    class Completion;
+    class DiskCache;
+    class FrameCache;
+    class SeqPrefetch;
     class ZipReader;
 
+    //! Media references added by key after the timeline was opened; see
+    //! Timeline::addMediaReference().
+    typedef std::map<
+        const OTIO_NS::Clip*,
+        std::map<std::string, OTIO_NS::SerializableObject::Retainer<OTIO_NS::MediaReference> > >
+        AddedMediaReferences;
+
     struct Timeline::Private
     {
         std::weak_ptr<ftk::Context> context;
         std::weak_ptr<ftk::LogSystem> logSystem;
+        // Shared with every other timeline, so frames another timeline has
+        // read are not read again. Null when the system was not created.
+        std::shared_ptr<FrameCache> frameCache;
+        // Where frames the frame cache lets go of are kept. Null when the
+        // system was not created.
+        std::shared_ptr<DiskCache> diskCache;
         std::shared_ptr<ftk::FileIO> fileIO;
         OTIO_NS::SerializableObject::Retainer<OTIO_NS::Timeline> otioTimeline;
         // OTIO works out an item's range in its track by summing the duration
@@ -176,6 +194,13 @@ namespace tl
             std::future<VideoData> imageB;
             std::string path;
             std::string pathB;
+            // Where the frames go in the frame cache once they are read.
+            std::string cacheKey;
+            std::string cacheKeyB;
+            // Names the frame that was read, or the one held in its place,
+            // once it is known which; see VideoLayer::identity.
+            std::function<std::string(const std::optional<int64_t>&)> identity;
+            std::function<std::string(const std::optional<int64_t>&)> identityB;
             std::optional<ftk::Box2F> bounds;
             std::optional<ftk::Box2F> boundsB;
             Transition transition = Transition::None;
@@ -194,8 +219,19 @@ namespace tl
             OTIO_NS::RationalTime time;
             IOOptions options;
             std::promise<VideoFrame> promise;
+            // Who to wake when the promise is set.
+            std::shared_ptr<Completion> completion;
 
             std::vector<VideoLayerData> layerData;
+
+            // When the frame is being flattened: the frame as it was built
+            // from the layers, the flattened image on its way from the pool,
+            // and where it goes in the flatten cache. See
+            // Options::flattenCacheMax.
+            std::optional<VideoFrame> frame;
+            std::future<VideoData> flattened;
+            std::string flattenKey;
+            uint64_t flattenGeneration = 0;
         };
 
         struct AudioLayerData
@@ -216,6 +252,8 @@ namespace tl
             double seconds = -1.0;
             IOOptions options;
             std::promise<AudioFrame> promise;
+            // Who to wake when the promise is set.
+            std::shared_ptr<Completion> completion;
 
             std::vector<AudioLayerData> layerData;
         };
@@ -240,7 +278,13 @@ namespace tl
             // read without locking; see Timeline::setMediaReferenceKey().
             std::string mediaReferenceKey;
             std::map<const OTIO_NS::Clip*, std::string> clipMediaReferenceKeys;
+            AddedMediaReferences addedMediaReferences;
             bool mediaReferenceKeysChanged = false;
+            // Set by refreshFrames() for the request thread to let go of the
+            // flattened frames.
+            bool flattenCacheClear = false;
+            // Set when a read completes, to wake the request thread.
+            bool completed = false;
             std::mutex mutex;
         };
         Mutex mutex;
@@ -261,8 +305,18 @@ namespace tl
             // when the main thread changes them.
             std::string mediaReferenceKey;
             std::map<const OTIO_NS::Clip*, std::string> clipMediaReferenceKeys;
+            AddedMediaReferences addedMediaReferences;
+            // Flattened frames, by time and I/O options. The generation moves
+            // on each time the cache is cleared, so that a frame flattened
+            // from what was there before is not added after.
+            ftk::LRUCache<std::string, VideoFrame> flattenCache;
+            uint64_t flattenGeneration = 0;
         };
         Thread thread;
+        // Sets mutex.completed and wakes the request thread when one of
+        // its reads completes. The reads made on the request thread carry
+        // it; see CompletionScope.
+        std::shared_ptr<Completion> completion;
 
         // Where sequence frames are decoded. One pool serves every clip in
         // the timeline rather than a reader thread per clip: with 198 clips
@@ -283,6 +337,15 @@ namespace tl
         };
         ReadPool readPool;
 
+        // Reads sequence files ahead of the pool, when the options ask for
+        // it; see SeqPrefetch. Handed to each sequence as it is made.
+        std::shared_ptr<SeqPrefetch> seqPrefetch;
+
+        // Told the stage reached while the timeline is opened by
+        // TimelineOpen, which throws from it to cancel.
+        std::function<void(TimelineOpenStage)> openStage;
+        void setOpenStage(TimelineOpenStage);
+
         // Start and stop the decoding threads.
         void startReadPool(size_t threadCount);
         void stopReadPool();
@@ -301,12 +364,22 @@ namespace tl
         // must ensure readiness (poll with wait_for, or accept the block at
         // shutdown).
         VideoFrame videoFrame(PendingVideoRequest&);
+        // Get the identity of a layer image, and swap a held frame for the
+        // cached image of the frame it holds; see VideoLayer::identity.
+        std::string videoIdentity(
+            const VideoData&,
+            const std::function<std::string(const std::optional<int64_t>&)>&,
+            std::shared_ptr<ftk::Image>&);
         AudioFrame audioFrame(PendingAudioRequest&);
         // Resolve which media reference a clip should be read from, using the
         // thread-owned key state. Request thread only; the main thread goes
         // through Timeline::getMediaReference(), which takes the mutex.
         OTIO_NS::MediaReference* mediaReference(const OTIO_NS::Clip*) const;
 
+        // The media reference audio is read from, which leaves out the
+        // added media references since they only stand in for video.
+        OTIO_NS::MediaReference* audioMediaReference(const OTIO_NS::Clip*) const;
+
         //! Get a track child's trimmed range in its parent, from
         //! trimmedRangeInParent. Anything not covered by the cache, such as an
         //! item nested below a track, falls back to asking OTIO.
@@ -10,6 +10,8 @@ namespace tl
         return
             path == other.path &&
             pathB == other.pathB &&
+            identity == other.identity &&
+            identityB == other.identityB &&
             ocioInput == other.ocioInput &&
             ocioInputB == other.ocioInputB &&
             image == other.image &&
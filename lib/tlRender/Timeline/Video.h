@@ -49,6 +49,19 @@ namespace tl
         //! The path of the media "imageB" came from.
         std::string                 pathB;
 
+        //! What the image is a picture of: the media, the frame of it that
+        //! was decoded, and the options it was decoded with. Frames that
+        //! show the same picture at different times have the same identity
+        //! -- a freeze frame, a held frame and the frame it holds, or a
+        //! slate used more than once -- so a cache can hold one image for
+        //! all of them. Stand-ins the reader made up are named by what they
+        //! were made from; see VideoData::standIn. Empty when it is not
+        //! known.
+        std::string                 identity;
+
+        //! The identity of "imageB".
+        std::string                 identityB;
+
         //! Per layer overrides of the OCIO input color space; empty uses
         //! the item's. Filled by a consumer that resolves them from the
         //! paths and the image tags; the timeline itself says nothing
@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <array>
+#include <filesystem>
 #include <vector>
 
 namespace tl
@@ -30,11 +31,30 @@ namespace tl
                 (static_cast<uint32_t>(p[3]) << 24);
         }
 
+        uint64_t readLE64(const uint8_t* p)
+        {
+            return
+                static_cast<uint64_t>(readLE32(p)) |
+                (static_cast<uint64_t>(readLE32(p + 4)) << 32);
+        }
+
         constexpr uint32_t zipHeaderMagic = 0x04034b50u;
         constexpr size_t zipHeaderNameOffset = 26;
         constexpr size_t zipHeaderExtraLenOffset = 28;
         constexpr size_t zipHeaderSize = 30;
 
+        constexpr uint32_t zipDirectoryMagic = 0x02014b50u;
+        constexpr size_t zipDirectorySize = 46;
+        constexpr uint32_t zipEndMagic = 0x06054b50u;
+        constexpr size_t zipEndSize = 22;
+        constexpr uint32_t zipEnd64LocatorMagic = 0x07064b50u;
+        constexpr size_t zipEnd64LocatorSize = 20;
+        constexpr uint32_t zipEnd64Magic = 0x06064b50u;
+        constexpr size_t zipEnd64Size = 56;
+        constexpr uint16_t zipExtraZip64 = 0x0001;
+        constexpr size_t zipMaxCommentSize = 65535;
+        constexpr uint16_t zipMaxU16 = 0xFFFF;
+
         //! The general purpose flag saying a data descriptor follows the data.
         constexpr uint16_t zipFlagDataDescriptor = 0x8;
 
@@ -69,6 +89,36 @@ namespace tl
         //! sample spread across the file sees a writer that does otherwise.
         constexpr size_t zipVerifySamples = 64;
 
+        //! How many entries have their local headers read together, when one
+        //! that the central directory cannot place is looked up. The frames
+        //! of a sequence are looked up one after another, and sit next to
+        //! each other by name as well as in the file.
+        constexpr size_t zipResolveBatch = 256;
+
+        //! The index written next to a bundle. The names and records follow
+        //! it as they are held in memory, so the version changes whenever
+        //! the record does.
+        struct IndexHeader
+        {
+            uint32_t magic       = 0;
+            uint32_t version     = 0;
+            uint64_t fileSize    = 0;
+            int64_t  modTime     = 0;
+            uint64_t nameSize    = 0;
+            uint64_t recordCount = 0;
+        };
+        constexpr uint32_t zipIndexMagic = 0x495a4c54u;
+        constexpr uint32_t zipIndexVersion = 1;
+
+        int64_t getModTime(const std::string& fileName)
+        {
+            std::error_code ec;
+            const auto time = std::filesystem::last_write_time(
+                std::filesystem::u8path(fileName),
+                ec);
+            return ec ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+        }
+
         //! Read a local header to get where an entry's data actually starts.
         int64_t readDataOffset(
             const std::shared_ptr<ftk::FileIO>& io,
@@ -110,17 +160,21 @@ namespace tl
 
     void ZipReader::open(
         const std::string& fileName,
-        size_t fileSize)
+        size_t fileSize,
+        const std::string& indexFileName)
     {
-        if (_reader)
-        {
-            _reader.reset();
-            _entries.clear();
-        }
+        std::unique_lock<std::mutex> lock(_mutex);
+        _reader.reset();
+        _io.reset();
+        _names.clear();
+        _records.clear();
+        _readCount = 0;
 
         _fileName = fileName;
         _fileSize = fileSize;
 
+        // minizip is only used to read the timeline itself, which may be
+        // compressed; the entries come from the central directory below.
         _reader.reset(mz_zip_reader_create());
         if (!_reader.get())
         {
@@ -134,85 +188,267 @@ namespace tl
                 "Cannot open zip reader: \"{0}\"").arg(fileName));
         }
 
-        err = mz_zip_reader_goto_first_entry(_reader.get());
-        if (err != MZ_OK)
+        _io = ftk::FileIO::create(
+            fileName,
+            ftk::FileMode::Read,
+            ftk::FileRead::Normal,
+            ftk::FileAccess::Random);
+        const bool indexed = !indexFileName.empty() && _readIndex(indexFileName);
+        if (!indexed)
+        {
+            _readDirectory();
+            if (!indexFileName.empty())
+            {
+                _writeIndex(indexFileName);
+            }
+        }
+
+        _logSystem->print("tl::ZipReader", ftk::Format(
+            "Opened \"{0}\": {1} entries, {2} local headers read{3}").
+            arg(fileName).
+            arg(_records.size()).
+            arg(_readCount).
+            arg(indexed ? ", from the index" : ""),
+            ftk::LogType::Message);
+    }
+
+    std::optional<ZipReader::Entry> ZipReader::find(const std::string& name)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        const auto i = std::lower_bound(
+            _records.begin(),
+            _records.end(),
+            name,
+            [this](const Record& record, const std::string& name)
+            {
+                return _getName(record) < name;
+            });
+        if (i == _records.end() || _getName(*i) != name)
+        {
+            return std::nullopt;
+        }
+        const size_t index = i - _records.begin();
+        if (unresolved == _records[index].dataOffset)
+        {
+            _resolve(index);
+        }
+        const Record& record = _records[index];
+        return record.dataOffset >= 0 ?
+            std::optional<Entry>(Entry{ record.dataOffset, record.size }) :
+            std::nullopt;
+    }
+
+    std::string_view ZipReader::_getName(const Record& record) const
+    {
+        return std::string_view(_names.data() + record.nameOffset, record.nameSize);
+    }
+
+    void ZipReader::_readDirectory()
+    {
+        // Find the end of central directory record, which ends the file but
+        // for a comment of up to 64K.
+        const size_t tailSize = std::min(
+            _fileSize,
+            zipEndSize + zipMaxCommentSize + zipEnd64LocatorSize);
+        if (tailSize < zipEndSize)
+        {
+            throw std::runtime_error(ftk::Format(
+                "Cannot find the zip central directory: \"{0}\"").arg(_fileName));
+        }
+        std::vector<uint8_t> tail(tailSize);
+        _io->readAt(tail.data(), _fileSize - tailSize, tailSize);
+        int64_t endPos = -1;
+        for (size_t i = tailSize - zipEndSize + 1; i-- > 0;)
+        {
+            if (zipEndMagic == readLE32(tail.data() + i))
+            {
+                endPos = i;
+                break;
+            }
+        }
+        if (endPos < 0)
+        {
+            throw std::runtime_error(ftk::Format(
+                "Cannot find the zip central directory: \"{0}\"").arg(_fileName));
+        }
+        const uint8_t* end = tail.data() + endPos;
+        uint64_t entryCount = readLE16(end + 10);
+        uint64_t directorySize = readLE32(end + 12);
+        uint64_t directoryOffset = readLE32(end + 16);
+        bool split = readLE16(end + 4) != 0 || readLE16(end + 6) != 0;
+        int64_t shift = 0;
+        if (zipMaxU16 == entryCount ||
+            zipMaxU32 == directorySize ||
+            zipMaxU32 == directoryOffset)
+        {
+            // Zip64, where the record above only points to the real one.
+            const uint8_t* locator = end - zipEnd64LocatorSize;
+            if (endPos < static_cast<int64_t>(zipEnd64LocatorSize) ||
+                readLE32(locator) != zipEnd64LocatorMagic)
+            {
+                throw std::runtime_error(ftk::Format(
+                    "Cannot find the zip64 central directory: \"{0}\"").arg(_fileName));
+            }
+            const uint64_t end64Offset = readLE64(locator + 8);
+            if (end64Offset + zipEnd64Size > _fileSize)
+            {
+                throw std::runtime_error(ftk::Format(
+                    "Zip64 central directory out of bounds: \"{0}\"").arg(_fileName));
+            }
+            uint8_t end64[zipEnd64Size];
+            _io->readAt(end64, end64Offset, zipEnd64Size);
+            if (readLE32(end64) != zipEnd64Magic)
+            {
+                throw std::runtime_error(ftk::Format(
+                    "Cannot find the zip64 central directory: \"{0}\"").arg(_fileName));
+            }
+            split |= readLE32(end64 + 16) != 0 || readLE32(end64 + 20) != 0;
+            entryCount = readLE64(end64 + 32);
+            directorySize = readLE64(end64 + 40);
+            directoryOffset = readLE64(end64 + 48);
+        }
+        else
+        {
+            // Anything prepended to the archive, such as a self extractor,
+            // moves every offset by the same amount, which is how far the
+            // directory is from where it says it is.
+            const int64_t endOffset = _fileSize - tailSize + endPos;
+            shift = endOffset - static_cast<int64_t>(directoryOffset + directorySize);
+        }
+        directoryOffset += shift;
+        if (shift < 0 ||
+            directoryOffset > _fileSize ||
+            directorySize > _fileSize - directoryOffset)
         {
             throw std::runtime_error(ftk::Format(
-                "Cannot goto first zip entry: \"{0}\"").arg(fileName));
+                "Zip central directory out of bounds: \"{0}\"").arg(_fileName));
         }
 
-        // Collect the central directory, which minizip has already read as one
-        // contiguous region at the end of the file. Nothing here touches the
-        // rest of the bundle.
-        struct Record
+        // The whole directory in one read, rather than a buffered read per
+        // entry through minizip. For a bundle of 25,000 frames that walk
+        // was most of the time it took to open.
+        std::vector<uint8_t> directory(directorySize);
+        _io->readAt(directory.data(), directoryOffset, directorySize);
+
+        struct Item
         {
             std::string name;
             int64_t     headerOffset = 0;
             int64_t     size = 0;
             int64_t     minDataOffset = 0;
             bool        trailer = false;
-            int64_t     dataOffset = -1;
+            int64_t     dataOffset = unresolved;
             int         group = GroupNone;
         };
-        std::vector<Record> records;
+        std::vector<Item> items;
+        items.reserve(entryCount);
         // Where every entry's local header starts, including the entries this
         // reader cannot use. An entry's data ends at the next header
         // whatever kind of entry that is, so leaving out the compressed ones
         // would put the boundary past them and derive an offset that is
         // wrong by their size -- small enough, for a small entry, to pass the
-        // bounds check below.
+        // bounds check below. The last entry's data ends where the directory
+        // starts.
         std::vector<int64_t> boundaries;
-        bool derivable = true;
-        while (MZ_OK == err)
+        boundaries.reserve(entryCount + 1);
+        boundaries.push_back(directoryOffset);
+        bool derivable = !split;
+        size_t pos = 0;
+        for (uint64_t i = 0; i < entryCount; ++i)
         {
-            mz_zip_file* fileInfo = nullptr;
-            err = mz_zip_reader_entry_get_info(_reader.get(), &fileInfo);
-            if (err != MZ_OK || !fileInfo)
+            if (pos + zipDirectorySize > directory.size() ||
+                readLE32(directory.data() + pos) != zipDirectoryMagic)
             {
                 throw std::runtime_error(ftk::Format(
-                    "Cannot get zip entry information: \"{0}\"").arg(fileName));
+                    "Bad zip central directory: \"{0}\"").arg(_fileName));
             }
-            if (fileInfo->disk_offset >= 0 &&
-                static_cast<size_t>(fileInfo->disk_offset) + zipHeaderSize <= _fileSize)
+            const uint8_t* p = directory.data() + pos;
+            const uint16_t flag = readLE16(p + 8);
+            const uint16_t method = readLE16(p + 10);
+            uint64_t size = readLE32(p + 24);
+            const size_t nameSize = readLE16(p + 28);
+            const size_t extraSize = readLE16(p + 30);
+            const size_t commentSize = readLE16(p + 32);
+            uint32_t disk = readLE16(p + 34);
+            uint64_t headerOffset = readLE32(p + 42);
+            if (pos + zipDirectorySize + nameSize + extraSize + commentSize > directory.size())
             {
-                boundaries.push_back(fileInfo->disk_offset);
+                throw std::runtime_error(ftk::Format(
+                    "Bad zip central directory: \"{0}\"").arg(_fileName));
             }
-            if (fileInfo->disk_number != 0)
+            const char* name = reinterpret_cast<const char*>(p + zipDirectorySize);
+
+            // The zip64 extra field holds, in order, whichever of the fields
+            // above did not fit.
+            const uint8_t* extra = p + zipDirectorySize + nameSize;
+            for (size_t j = 0; j + 4 <= extraSize;)
+            {
+                const uint16_t id = readLE16(extra + j);
+                const size_t size64 = readLE16(extra + j + 2);
+                if (j + 4 + size64 > extraSize)
+                {
+                    break;
+                }
+                if (zipExtraZip64 == id)
+                {
+                    const uint8_t* q = extra + j + 4;
+                    size_t k = 0;
+                    if (zipMaxU32 == size && k + 8 <= size64)
+                    {
+                        size = readLE64(q + k);
+                        k += 8;
+                    }
+                    if (zipMaxU32 == readLE32(p + 20) && k + 8 <= size64)
+                    {
+                        k += 8;
+                    }
+                    if (zipMaxU32 == headerOffset && k + 8 <= size64)
+                    {
+                        headerOffset = readLE64(q + k);
+                        k += 8;
+                    }
+                    if (zipMaxU16 == disk && k + 4 <= size64)
+                    {
+                        disk = readLE32(q + k);
+                    }
+                }
+                j += 4 + size64;
+            }
+            pos += zipDirectorySize + nameSize + extraSize + commentSize;
+
+            headerOffset += shift;
+            if (headerOffset + zipHeaderSize <= _fileSize)
+            {
+                boundaries.push_back(headerOffset);
+            }
+            if (disk != 0)
             {
                 // Split across volumes, so an offset is relative to a disk
                 // rather than to this file.
                 derivable = false;
             }
-            if (mz_zip_reader_entry_is_dir(_reader.get()) != MZ_OK &&
-                0 == fileInfo->compression_method)
+            const bool isDir = nameSize > 0 && '/' == name[nameSize - 1];
+            if (!isDir && 0 == method)
             {
-                if (fileInfo->disk_offset < 0 ||
-                    static_cast<size_t>(fileInfo->disk_offset) + zipHeaderSize > _fileSize)
+                if (headerOffset + zipHeaderSize > _fileSize)
                 {
                     throw std::runtime_error(ftk::Format(
-                        "Local zip header entry out of bounds: \"{0}\"").arg(fileName));
+                        "Local zip header entry out of bounds: \"{0}\"").arg(_fileName));
                 }
-                Record record;
-                record.name          = fileInfo->filename;
-                record.headerOffset  = fileInfo->disk_offset;
-                record.size          = fileInfo->uncompressed_size;
-                record.minDataOffset =
-                    fileInfo->disk_offset + zipHeaderSize + fileInfo->filename_size;
-                record.trailer       = (fileInfo->flag & zipFlagDataDescriptor) != 0;
-                records.push_back(record);
-            }
-            err = mz_zip_reader_goto_next_entry(_reader.get());
-            if (err != MZ_OK && err != MZ_END_OF_LIST)
-            {
-                throw std::runtime_error(ftk::Format(
-                    "Cannot goto next zip entry: \"{0}\"").arg(fileName));
+                Item item;
+                item.name          = std::string(name, nameSize);
+                item.headerOffset  = headerOffset;
+                item.size          = size;
+                item.minDataOffset = headerOffset + zipHeaderSize + nameSize;
+                item.trailer       = (flag & zipFlagDataDescriptor) != 0;
+                items.push_back(item);
             }
         }
 
         std::sort(
-            records.begin(),
-            records.end(),
-            [](const Record& a, const Record& b)
+            items.begin(),
+            items.end(),
+            [](const Item& a, const Item& b)
             {
                 return a.headerOffset < b.headerOffset;
             });
@@ -225,15 +461,9 @@ namespace tl
         //
         // They do not have to be read. An entry's data ends where the next
         // entry's local header begins, so the offset follows from the size in
-        // the central directory. That leaves the last entry, and any entry
-        // whose data is followed by a descriptor, to be read.
-        auto io = ftk::FileIO::create(
-            fileName,
-            ftk::FileMode::Read,
-            ftk::FileRead::Normal,
-            ftk::FileAccess::Random);
-        size_t readCount = 0;
-
+        // the central directory. That leaves any entry whose data is followed
+        // by a descriptor of unknown size to be read.
+        //
         // How many bytes sit between an entry's data and the next local
         // header. Nothing, for an entry written to a file. An entry written
         // to a stream is followed by a data descriptor, whose size depends on
@@ -252,14 +482,14 @@ namespace tl
         // so group by that rather than hoping a sample lands on the few large
         // entries in an archive of mostly small ones.
         std::array<std::vector<size_t>, GroupCount> groups;
-        for (size_t i = 0; i < records.size(); ++i)
+        for (size_t i = 0; i < items.size(); ++i)
         {
-            records[i].group = !records[i].trailer ?
+            items[i].group = !items[i].trailer ?
                 GroupNone :
-                (records[i].size > zipMaxU32 ? GroupTrailer64 : GroupTrailer);
-            if (nextBoundary(records[i].headerOffset) >= 0)
+                (items[i].size > zipMaxU32 ? GroupTrailer64 : GroupTrailer);
+            if (nextBoundary(items[i].headerOffset) >= 0)
             {
-                groups[records[i].group].push_back(i);
+                groups[items[i].group].push_back(i);
             }
         }
         const auto measureGap =
@@ -274,11 +504,11 @@ namespace tl
             {
                 const size_t i = group[s * group.size() / count];
                 const int64_t dataOffset =
-                    readDataOffset(io, fileName, records[i].headerOffset);
-                ++readCount;
+                    readDataOffset(_io, _fileName, items[i].headerOffset);
+                ++_readCount;
                 const int64_t measured =
-                    nextBoundary(records[i].headerOffset) -
-                    records[i].size -
+                    nextBoundary(items[i].headerOffset) -
+                    items[i].size -
                     dataOffset;
                 if (measured < 0 || measured > zipMaxTrailerSize)
                 {
@@ -302,77 +532,225 @@ namespace tl
         }
         if (derivable)
         {
-            for (size_t i = 0; i < records.size(); ++i)
+            for (auto& item : items)
             {
-                Record& record = records[i];
-                const int64_t next = nextBoundary(record.headerOffset);
+                const int64_t next = nextBoundary(item.headerOffset);
                 if (next < 0)
                 {
                     continue;
                 }
-                const int64_t derived = next - record.size - gaps[record.group];
-                if (derived >= record.minDataOffset &&
-                    derived - record.minDataOffset <= zipMaxExtraSize)
+                const int64_t derived = next - item.size - gaps[item.group];
+                if (derived >= item.minDataOffset &&
+                    derived - item.minDataOffset <= zipMaxExtraSize)
                 {
-                    record.dataOffset = derived;
+                    item.dataOffset = derived;
                 }
             }
         }
         else
         {
             // The archive is not laid out the way the derivation describes,
-            // so every offset has to come from its own header.
+            // so every offset has to come from its own header. They are
+            // read as the entries are looked up rather than all here.
             _logSystem->print("tl::ZipReader", ftk::Format(
-                "Zip entry offsets cannot be derived, reading {0} local "
-                "headers: \"{1}\"").arg(records.size()).arg(fileName),
+                "Zip entry offsets cannot be derived, reading local headers "
+                "on demand: \"{0}\"").arg(_fileName),
                 ftk::LogType::Warning);
         }
 
-        // Whatever is left: the last entry, which has no successor, and any
-        // entry the bounds check rejected.
-        for (auto& record : records)
+        for (const auto& item : items)
         {
-            if (record.dataOffset < 0)
+            if (item.dataOffset != unresolved &&
+                (static_cast<size_t>(item.dataOffset) > _fileSize ||
+                item.size < 0 ||
+                static_cast<size_t>(item.size) > _fileSize - item.dataOffset))
             {
-                record.dataOffset =
-                    readDataOffset(io, fileName, record.headerOffset);
-                ++readCount;
+                throw std::runtime_error(ftk::Format(
+                    "Local zip entry out of bounds: \"{0}\"").arg(_fileName));
             }
         }
 
-        for (const auto& record : records)
+        // Sorted by name for the lookups, keeping the first of any entries
+        // with the same name.
+        std::stable_sort(
+            items.begin(),
+            items.end(),
+            [](const Item& a, const Item& b)
+            {
+                return a.name < b.name;
+            });
+        _records.reserve(items.size());
+        for (const auto& item : items)
         {
-            if (record.dataOffset < 0 ||
-                static_cast<size_t>(record.dataOffset) > _fileSize ||
-                record.size < 0 ||
-                static_cast<size_t>(record.size) > _fileSize - record.dataOffset)
+            if (!_records.empty() && _getName(_records.back()) == item.name)
+            {
+                _logSystem->print("tl::ZipReader", ftk::Format(
+                    "Duplicate zip entry, ignoring subsequent: \"{0}\"").arg(item.name),
+                    ftk::LogType::Warning);
+                continue;
+            }
+            if (_names.size() + item.name.size() > zipMaxU32)
             {
                 throw std::runtime_error(ftk::Format(
-                    "Local zip entry out of bounds: \"{0}\"").arg(fileName));
+                    "Too many zip entries: \"{0}\"").arg(_fileName));
+            }
+            Record record;
+            record.nameOffset   = static_cast<uint32_t>(_names.size());
+            record.nameSize     = static_cast<uint32_t>(item.name.size());
+            record.headerOffset = item.headerOffset;
+            record.size         = item.size;
+            record.dataOffset   = item.dataOffset;
+            _names += item.name;
+            _records.push_back(record);
+        }
+    }
+
+    bool ZipReader::_readIndex(const std::string& indexFileName)
+    {
+        std::error_code ec;
+        if (!std::filesystem::exists(std::filesystem::u8path(indexFileName), ec))
+        {
+            return false;
+        }
+        try
+        {
+            auto io = ftk::FileIO::create(indexFileName, ftk::FileMode::Read);
+            IndexHeader header;
+            if (io->getSize() < sizeof(IndexHeader))
+            {
+                return false;
             }
-            Entry entry{ record.dataOffset, record.size };
-            if (!_entries.emplace(record.name, entry).second)
+            io->read(&header, sizeof(IndexHeader));
+            if (header.magic != zipIndexMagic ||
+                header.version != zipIndexVersion ||
+                header.fileSize != _fileSize ||
+                header.modTime != getModTime(_fileName) ||
+                io->getSize() !=
+                    sizeof(IndexHeader) +
+                    header.nameSize +
+                    header.recordCount * sizeof(Record))
             {
-                _logSystem->print("tl::ZipReader", ftk::Format(
-                    "Duplicate zip entry, ignoring subsequent: \"{0}\"").arg(record.name),
-                    ftk::LogType::Warning);
+                return false;
+            }
+            _names.resize(header.nameSize);
+            io->read(_names.data(), _names.size());
+            _records.resize(header.recordCount);
+            io->read(_records.data(), _records.size() * sizeof(Record));
+            for (auto& record : _records)
+            {
+                if (static_cast<uint64_t>(record.nameOffset) + record.nameSize > _names.size() ||
+                    record.headerOffset < 0 ||
+                    static_cast<size_t>(record.headerOffset) + zipHeaderSize > _fileSize ||
+                    record.size < 0)
+                {
+                    throw std::runtime_error("Bad index");
+                }
+                if (record.dataOffset < 0 ||
+                    static_cast<size_t>(record.dataOffset) > _fileSize ||
+                    static_cast<size_t>(record.size) > _fileSize - record.dataOffset)
+                {
+                    record.dataOffset = unresolved;
+                }
             }
         }
+        catch (const std::exception&)
+        {
+            _names.clear();
+            _records.clear();
+            return false;
+        }
+        return true;
+    }
 
-        _logSystem->print("tl::ZipReader", ftk::Format(
-            "Opened \"{0}\": {1} entries, {2} local headers read").
-            arg(fileName).arg(records.size()).arg(readCount),
-            ftk::LogType::Message);
+    void ZipReader::_writeIndex(const std::string& indexFileName)
+    {
+        // Written under another name and renamed when it is complete, so
+        // that an index is either whole or not there. Not being able to
+        // write it, next to a bundle on a read only share say, only costs
+        // the next open its speed.
+        const std::string tmpFileName = indexFileName + ".tmp";
+        std::error_code ec;
+        try
+        {
+            IndexHeader header;
+            header.magic = zipIndexMagic;
+            header.version = zipIndexVersion;
+            header.fileSize = _fileSize;
+            header.modTime = getModTime(_fileName);
+            header.nameSize = _names.size();
+            header.recordCount = _records.size();
+            {
+                auto io = ftk::FileIO::create(tmpFileName, ftk::FileMode::Write);
+                io->write(&header, sizeof(IndexHeader));
+                io->write(_names.data(), _names.size());
+                io->write(_records.data(), _records.size() * sizeof(Record));
+            }
+            std::filesystem::rename(
+                std::filesystem::u8path(tmpFileName),
+                std::filesystem::u8path(indexFileName),
+                ec);
+            if (ec)
+            {
+                throw std::runtime_error(ec.message());
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::filesystem::remove(std::filesystem::u8path(tmpFileName), ec);
+            _logSystem->print("tl::ZipReader", ftk::Format(
+                "Cannot write zip index: \"{0}\": {1}").
+                arg(indexFileName).
+                arg(e.what()),
+                ftk::LogType::Warning);
+        }
     }
 
-    std::optional<ZipReader::Entry> ZipReader::find(const std::string& name) const
+    void ZipReader::_resolve(size_t index)
     {
-        const auto i = _entries.find(name);
-        return i != _entries.end() ? std::optional<Entry>(i->second) : std::nullopt;
+        // This entry and the unresolved ones after it by name, read in the
+        // order they sit in the file.
+        std::vector<size_t> batch;
+        for (size_t i = index; i < _records.size() && batch.size() < zipResolveBatch; ++i)
+        {
+            if (unresolved == _records[i].dataOffset)
+            {
+                batch.push_back(i);
+            }
+        }
+        std::sort(
+            batch.begin(),
+            batch.end(),
+            [this](size_t a, size_t b)
+            {
+                return _records[a].headerOffset < _records[b].headerOffset;
+            });
+        for (const size_t i : batch)
+        {
+            Record& record = _records[i];
+            try
+            {
+                const int64_t dataOffset =
+                    readDataOffset(_io, _fileName, record.headerOffset);
+                ++_readCount;
+                if (static_cast<size_t>(dataOffset) > _fileSize ||
+                    static_cast<size_t>(record.size) > _fileSize - dataOffset)
+                {
+                    throw std::runtime_error(ftk::Format(
+                        "Local zip entry out of bounds: \"{0}\"").arg(_fileName));
+                }
+                record.dataOffset = dataOffset;
+            }
+            catch (const std::exception& e)
+            {
+                record.dataOffset = invalid;
+                _logSystem->print("tl::ZipReader", e.what(), ftk::LogType::Error);
+            }
+        }
     }
 
     std::string ZipReader::readText(const std::string& name)
     {
+        std::unique_lock<std::mutex> lock(_mutex);
         int32_t err = mz_zip_reader_locate_entry(
             _reader.get(),
             name.c_str(),
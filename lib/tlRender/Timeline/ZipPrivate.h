@@ -3,10 +3,12 @@
 
 #pragma once
 
+#include <ftk/Core/FileIO.h>
 #include <ftk/Core/LogSystem.h>
 
-#include <map>
+#include <mutex>
 #include <optional>
+#include <string_view>
 
 #include <mz.h>
 #include <mz_strm.h>
@@ -35,21 +37,53 @@ namespace tl
     public:
         ZipReader(const std::shared_ptr<ftk::LogSystem>&);
 
+        //! Open a bundle. Given an index file name, the entries are read
+        //! from the index when it was written for this bundle, and the index
+        //! is written when it was not.
         void open(
             const std::string& fileName,
-            size_t fileSize);
+            size_t fileSize,
+            const std::string& indexFileName = std::string());
 
         struct Entry { int64_t offset; int64_t size; };
 
-        std::optional<Entry> find(const std::string& name) const;
+        //! Find an entry. Where the data of an entry starts is read from its
+        //! local header on first use when the central directory cannot say.
+        std::optional<Entry> find(const std::string& name);
 
         std::string readText(const std::string& name);
 
     private:
+        //! An entry, sorted by name. The names are kept in one buffer, so
+        //! that a bundle of tens of thousands of frames is one allocation
+        //! rather than one per frame.
+        struct Record
+        {
+            uint32_t nameOffset   = 0;
+            uint32_t nameSize     = 0;
+            int64_t  headerOffset = 0;
+            int64_t  size         = 0;
+
+            //! Where the data starts, or one of the values below.
+            int64_t  dataOffset   = -1;
+        };
+        static constexpr int64_t unresolved = -1;
+        static constexpr int64_t invalid = -2;
+
+        std::string_view _getName(const Record&) const;
+        void _readDirectory();
+        bool _readIndex(const std::string& indexFileName);
+        void _writeIndex(const std::string& indexFileName);
+        void _resolve(size_t);
+
         std::shared_ptr<ftk::LogSystem> _logSystem;
         std::string _fileName;
         size_t _fileSize = 0;
         MZReaderPtr _reader;
-        std::map<std::string, Entry> _entries;
+        std::shared_ptr<ftk::FileIO> _io;
+        std::string _names;
+        std::vector<Record> _records;
+        size_t _readCount = 0;
+        std::mutex _mutex;
     };
 }
@@ -34,6 +34,7 @@ namespace tl
             timelineOptions(m);
             timelineSystem(m);
             timeline(m);
+            frames(m);
             playerOptions(m);
             player(m);
             transition(m);
@@ -18,6 +18,7 @@ namespace tl
         TL_API void compareOptions(pybind11::module_&);
         TL_API void displayOptions(pybind11::module_&);
         TL_API void foregroundOptions(pybind11::module_&);
+        TL_API void frames(pybind11::module_&);
         TL_API void iRender(pybind11::module_&);
         TL_API void player(pybind11::module_&);
         TL_API void playerOptions(pybind11::module_&);
@@ -41,10 +41,32 @@ namespace tl
                 .def_readwrite("wipeRotation", &CompareOptions::wipeRotation)
                 .def_readwrite("overlay", &CompareOptions::overlay)
                 .def_readwrite("differenceGain", &CompareOptions::differenceGain)
+                .def_readwrite("differenceStats", &CompareOptions::differenceStats)
+                .def_readwrite("differenceThreshold", &CompareOptions::differenceThreshold)
                 .def_readwrite("sameSize", &CompareOptions::sameSize)
                 .def(pybind11::self == pybind11::self)
                 .def(pybind11::self != pybind11::self);
 
+            py::class_<CompareStats>(m, "CompareStats")
+                .def(py::init())
+                .def_readwrite("valid", &CompareStats::valid)
+                .def_readwrite("pixelCount", &CompareStats::pixelCount)
+                .def_readwrite("maxError", &CompareStats::maxError)
+                .def_readwrite("meanError", &CompareStats::meanError)
+                .def_readwrite("psnr", &CompareStats::psnr)
+                .def_readwrite("thresholdCount", &CompareStats::thresholdCount)
+                .def_readwrite("thresholdBox", &CompareStats::thresholdBox)
+                .def(pybind11::self == pybind11::self)
+                .def(pybind11::self != pybind11::self);
+
+            m.def("to_json",
+                [](const CompareStats& value)
+                {
+                    nlohmann::json json;
+                    to_json(json, value);
+                    return json.dump();
+                });
+
             m.def("to_json",
                 [](const CompareOptions& value)
                 {
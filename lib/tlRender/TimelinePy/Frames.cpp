@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/TimelinePy/Bindings.h>
+
+#include <tlRender/Timeline/Timeline.h>
+
+#include <ftk/Core/Context.h>
+
+#include <pybind11/stl.h>
+
+#include <cmath>
+#include <functional>
+#include <list>
+
+namespace py = pybind11;
+
+namespace tl
+{
+    namespace python
+    {
+        namespace
+        {
+            //! Iterate over frames of a timeline, keeping requests for the
+            //! frames after the current one in flight. The requests are
+            //! read on the timeline's threads, and the GIL is released
+            //! while waiting, so Python can work on one frame while the
+            //! next ones are read.
+            template<typename TRequest, typename TFrame>
+            class Frames
+            {
+            public:
+                Frames(
+                    const std::shared_ptr<Timeline>& timeline,
+                    int64_t count,
+                    size_t prefetch,
+                    const std::function<TRequest(int64_t)>& request) :
+                    _timeline(timeline),
+                    _count(count),
+                    _prefetch(std::max(prefetch, size_t(1))),
+                    _request(request)
+                {}
+
+                ~Frames()
+                {
+                    std::vector<uint64_t> ids;
+                    for (const auto& request : _requests)
+                    {
+                        ids.push_back(request.id);
+                    }
+                    _timeline->cancelRequests(ids);
+                }
+
+                size_t getSize() const
+                {
+                    return static_cast<size_t>(_count);
+                }
+
+                TFrame next()
+                {
+                    _fill();
+                    if (_requests.empty())
+                    {
+                        throw py::stop_iteration();
+                    }
+                    TRequest request = std::move(_requests.front());
+                    _requests.pop_front();
+                    _fill();
+                    TFrame out;
+                    {
+                        py::gil_scoped_release release;
+                        out = request.future.get();
+                    }
+                    return out;
+                }
+
+            private:
+                void _fill()
+                {
+                    while (_requests.size() < _prefetch && _next < _count)
+                    {
+                        _requests.push_back(_request(_next));
+                        ++_next;
+                    }
+                }
+
+                std::shared_ptr<Timeline> _timeline;
+                int64_t _count = 0;
+                size_t _prefetch = 1;
+                std::function<TRequest(int64_t)> _request;
+                int64_t _next = 0;
+                std::list<TRequest> _requests;
+            };
+
+            typedef Frames<VideoRequest, VideoFrame> VideoFrames;
+            typedef Frames<AudioRequest, AudioFrame> AudioFrames;
+        }
+
+        void frames(py::module_& m)
+        {
+            py::class_<VideoFrames>(m, "VideoFrames")
+                .def(py::init(
+                    [](
+                        const std::shared_ptr<Timeline>& timeline,
+                        const std::optional<OTIO_NS::TimeRange>& timeRange,
+                        size_t prefetch,
+                        const IOOptions& options)
+                    {
+                        const OTIO_NS::TimeRange range = timeRange.value_or(timeline->getTimeRange());
+                        const OTIO_NS::RationalTime start = range.start_time();
+                        const int64_t count = static_cast<int64_t>(std::floor(
+                            range.duration().rescaled_to(start.rate()).value()));
+                        return new VideoFrames(
+                            timeline,
+                            std::max(count, static_cast<int64_t>(0)),
+                            prefetch,
+                            [timeline, start, options](int64_t index)
+                            {
+                                return timeline->getVideo(
+                                    start + OTIO_NS::RationalTime(index, start.rate()),
+                                    options);
+                            });
+                    }),
+                    py::arg("timeline"),
+                    py::arg("timeRange") = std::nullopt,
+                    py::arg("prefetch") = 16,
+                    py::arg("options") = IOOptions(),
+                    py::keep_alive<1, 2>())
+                .def("__iter__", [](VideoFrames& value) -> VideoFrames& { return value; })
+                .def("__next__", &VideoFrames::next)
+                .def("__len__", &VideoFrames::getSize);
+
+            // Audio is read by the second, so the frames are the seconds
+            // the time range touches.
+            py::class_<AudioFrames>(m, "AudioFrames")
+                .def(py::init(
+                    [](
+                        const std::shared_ptr<Timeline>& timeline,
+                        const std::optional<OTIO_NS::TimeRange>& timeRange,
+                        size_t prefetch,
+                        const IOOptions& options)
+                    {
+                        const OTIO_NS::TimeRange range = timeRange.value_or(timeline->getTimeRange());
+                        const int64_t first = static_cast<int64_t>(std::floor(
+                            range.start_time().to_seconds()));
+                        const int64_t last = static_cast<int64_t>(std::ceil(
+                            range.end_time_exclusive().to_seconds()));
+                        return new AudioFrames(
+                            timeline,
+                            std::max(last - first, static_cast<int64_t>(0)),
+                            prefetch,
+                            [timeline, first, options](int64_t index)
+                            {
+                                return timeline->getAudio(
+                                    static_cast<double>(first + index),
+                                    options);
+                            });
+                    }),
+                    py::arg("timeline"),
+                    py::arg("timeRange") = std::nullopt,
+                    py::arg("prefetch") = 4,
+                    py::arg("options") = IOOptions(),
+                    py::keep_alive<1, 2>())
+                .def("__iter__", [](AudioFrames& value) -> AudioFrames& { return value; })
+                .def("__next__", &AudioFrames::next)
+                .def("__len__", &AudioFrames::getSize);
+        }
+    }
+}
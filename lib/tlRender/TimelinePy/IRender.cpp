@@ -22,6 +22,7 @@ namespace tl
                 .def("setOCIOOptions", &IRender::setOCIOOptions)
                 .def("setOCIOInputResolver", &IRender::setOCIOInputResolver)
                 .def("drawBackground", &IRender::drawBackground)
+                .def("getCompareStats", &IRender::getCompareStats)
                 .def("drawForeground", &IRender::drawForeground);
         }
     }
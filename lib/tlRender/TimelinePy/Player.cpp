@@ -26,6 +26,8 @@ namespace tl
                 .def_readwrite("audioPercentage", &PlayerCacheInfo::audioPercentage)
                 .def_readwrite("video", &PlayerCacheInfo::video)
                 .def_readwrite("audio", &PlayerCacheInfo::audio)
+                .def_readwrite("videoByteCount", &PlayerCacheInfo::videoByteCount)
+                .def_readwrite("videoSharedByteCount", &PlayerCacheInfo::videoSharedByteCount)
                 .def(pybind11::self == pybind11::self)
                 .def(pybind11::self != pybind11::self);
 
@@ -31,6 +31,7 @@ namespace tl
                 .def_readwrite("cache", &PlayerOptions::cache)
                 .def_readwrite("videoRequestMax", &PlayerOptions::videoRequestMax)
                 .def_readwrite("audioRequestMax", &PlayerOptions::audioRequestMax)
+                .def_readwrite("compressThreadCount", &PlayerOptions::compressThreadCount)
                 .def_readwrite("audioBufferFrameCount", &PlayerOptions::audioBufferFrameCount)
                 .def_readwrite("muteTimeout", &PlayerOptions::muteTimeout)
                 .def_readwrite("sleepTimeout", &PlayerOptions::sleepTimeout)
@@ -31,8 +31,12 @@ namespace tl
                 .def_readwrite("imageSeqAudioFileName", &Options::imageSeqAudioFileName)
                 .def_readwrite("compat", &Options::compat)
                 .def_readwrite("threaded", &Options::threaded)
+                .def_readwrite("bundleIndex", &Options::bundleIndex)
                 .def_readwrite("readThreadCount", &Options::readThreadCount)
+                .def_readwrite("prefetchThreadCount", &Options::prefetchThreadCount)
+                .def_readwrite("prefetchFrames", &Options::prefetchFrames)
                 .def_readwrite("audioRequestMax", &Options::audioRequestMax)
+                .def_readwrite("flattenCacheMax", &Options::flattenCacheMax)
                 .def_readwrite("ioOptions", &Options::ioOptions)
                 .def_readwrite("pathOptions", &Options::pathOptions)
                 .def(pybind11::self == pybind11::self)
@@ -9,6 +9,8 @@
 #include <ftk/Core/Format.h>
 #include <ftk/Core/String.h>
 
+#include <limits>
+
 namespace tl
 {
     namespace timeline_tests
@@ -42,6 +44,8 @@ namespace tl
                 options.wipeRotation = 90.F;
                 options.overlay = .25F;
                 options.differenceGain = 8.F;
+                options.differenceStats = true;
+                options.differenceThreshold = .5F;
                 options.sameSize = false;
                 nlohmann::json json;
                 to_json(json, options);
@@ -57,6 +61,29 @@ namespace tl
                 FTK_CHECK(CompareOptions().differenceGain == options3.differenceGain);
                 FTK_CHECK(options.overlay == options3.overlay);
             }
+            {
+                CompareStats stats;
+                stats.valid = true;
+                stats.pixelCount = 100;
+                stats.maxError = .5F;
+                stats.meanError = .25F;
+                stats.psnr = 20.F;
+                stats.thresholdCount = 10;
+                stats.thresholdBox = ftk::Box2I(1, 2, 3, 4);
+                nlohmann::json json;
+                to_json(json, stats);
+                CompareStats stats2;
+                from_json(json, stats2);
+                FTK_CHECK(stats == stats2);
+
+                // Identical files have an infinite ratio, which JSON cannot
+                // hold.
+                stats.psnr = std::numeric_limits<float>::infinity();
+                to_json(json, stats);
+                FTK_CHECK(json["PSNR"].is_null());
+                from_json(json, stats2);
+                FTK_CHECK(stats == stats2);
+            }
             {
                 const std::vector<ftk::ImageInfo> infos =
                 {
@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/TimelineTest/DiskCacheTest.h>
+
+#include <tlRender/Timeline/DiskCache.h>
+
+#include <ftk/Core/Assert.h>
+#include <ftk/Core/Context.h>
+
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <filesystem>
+#include <thread>
+
+namespace tl
+{
+    namespace timeline_tests
+    {
+        DiskCacheTest::DiskCacheTest(const std::shared_ptr<ftk::Context>& context) :
+            ITest(context, "timeline_tests::DiskCacheTest")
+        {}
+
+        std::shared_ptr<DiskCacheTest> DiskCacheTest::create(const std::shared_ptr<ftk::Context>& context)
+        {
+            return std::shared_ptr<DiskCacheTest>(new DiskCacheTest(context));
+        }
+
+        namespace
+        {
+            // Frames are written in the background.
+            void waitForCount(const std::shared_ptr<DiskCache>& diskCache, size_t count)
+            {
+                const auto t = std::chrono::steady_clock::now();
+                while (diskCache->getCount() != count &&
+                    std::chrono::steady_clock::now() - t < std::chrono::seconds(10))
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+            }
+        }
+
+        void DiskCacheTest::run()
+        {
+            auto diskCache = DiskCache::create(_context);
+            FTK_CHECK(diskCache == DiskCache::create(_context));
+            const std::filesystem::path dir = _getTempDir() / "DiskCache";
+            std::filesystem::remove_all(dir);
+
+            const ftk::ImageInfo info(ftk::Size2I(61, 17), ftk::ImageType::RGB_F16);
+            const auto frame = [&info](double value)
+                {
+                    auto image = ftk::Image::create(info);
+                    for (size_t i = 0; i < image->getByteCount(); ++i)
+                    {
+                        image->getData()[i] = static_cast<uint8_t>(i + value);
+                    }
+                    ftk::ImageTags tags;
+                    tags["Frame"] = std::to_string(value);
+                    image->setTags(tags);
+                    return VideoData(OTIO_NS::RationalTime(value, 24.0), 1, image);
+                };
+            const size_t byteCount = frame(0.0).image->getByteCount();
+
+            // Off until there is a directory and a size.
+            FTK_CHECK(!diskCache->isEnabled());
+            diskCache->add("1", frame(1.0));
+            FTK_CHECK(!diskCache->contains("1"));
+            diskCache->setDirectory(dir.u8string());
+            diskCache->setMax(byteCount * 2);
+            FTK_CHECK(diskCache->isEnabled());
+
+            // A frame reads back as it was written.
+            const VideoData frame1 = frame(1.0);
+            diskCache->add("1", frame1);
+            FTK_CHECK(diskCache->contains("1"));
+            waitForCount(diskCache, 1);
+            FTK_CHECK(1 == diskCache->getCount());
+            FTK_CHECK(byteCount == diskCache->getByteCount());
+            VideoData data;
+            FTK_CHECK(diskCache->get("1", data));
+            FTK_CHECK(data.image && data.image != frame1.image);
+            FTK_CHECK(data.time == frame1.time);
+            FTK_CHECK(1 == data.layer);
+            FTK_CHECK(data.image->getInfo() == info);
+            FTK_CHECK(data.image->getTags() == frame1.image->getTags());
+            FTK_CHECK(0 == memcmp(data.image->getData(), frame1.image->getData(), byteCount));
+            FTK_CHECK(!diskCache->get("2", data));
+
+            // Frames standing in for missing ones are not kept.
+            VideoData missing = frame(2.0);
+            missing.missing = true;
+            diskCache->add("2", missing);
+            FTK_CHECK(!diskCache->contains("2"));
+
+            // The least recently used frame is evicted, and its file with it.
+            diskCache->add("2", frame(2.0));
+            waitForCount(diskCache, 2);
+            FTK_CHECK(diskCache->get("1", data));
+            diskCache->add("3", frame(3.0));
+            const auto t = std::chrono::steady_clock::now();
+            while (diskCache->contains("2") &&
+                std::chrono::steady_clock::now() - t < std::chrono::seconds(10))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            FTK_CHECK(!diskCache->contains("2"));
+            FTK_CHECK(diskCache->contains("1"));
+            FTK_CHECK(diskCache->contains("3"));
+            FTK_CHECK(2 == std::distance(
+                std::filesystem::directory_iterator(dir),
+                std::filesystem::directory_iterator()));
+
+            // Frames left by an earlier session are found again.
+            diskCache->setDirectory(std::string());
+            FTK_CHECK(0 == diskCache->getCount());
+            diskCache->setDirectory(dir.u8string());
+            waitForCount(diskCache, 2);
+            FTK_CHECK(2 == diskCache->getCount());
+            FTK_CHECK(diskCache->get("3", data));
+            FTK_CHECK(data.time == OTIO_NS::RationalTime(3.0, 24.0));
+
+            // A damaged file is dropped rather than read.
+            for (const auto& i : std::filesystem::directory_iterator(dir))
+            {
+                std::filesystem::resize_file(i.path(), 10);
+            }
+            FTK_CHECK(!diskCache->get("1", data));
+            FTK_CHECK(!diskCache->contains("1"));
+
+            diskCache->clear();
+            FTK_CHECK(0 == diskCache->getCount());
+            FTK_CHECK(std::filesystem::is_empty(dir));
+            diskCache->setMax(0);
+            diskCache->setDirectory(std::string());
+        }
+    }
+}
@@ -0,0 +1,164 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/TimelineTest/FlattenTest.h>
+
+#include <tlRender/Timeline/Flatten.h>
+
+#include <ftk/Core/Assert.h>
+
+#include <cmath>
+
+namespace tl
+{
+    namespace timeline_tests
+    {
+        FlattenTest::FlattenTest(const std::shared_ptr<ftk::Context>& context) :
+            ITest(context, "timeline_tests::FlattenTest")
+        {}
+
+        std::shared_ptr<FlattenTest> FlattenTest::create(const std::shared_ptr<ftk::Context>& context)
+        {
+            return std::shared_ptr<FlattenTest>(new FlattenTest(context));
+        }
+
+        namespace
+        {
+            std::shared_ptr<ftk::Image> createImage(
+                ftk::ImageType type,
+                const std::vector<uint8_t>& pixel,
+                const ftk::Size2I& size = ftk::Size2I(3, 2))
+            {
+                auto out = ftk::Image::create(ftk::ImageInfo(size, type));
+                const size_t stride = out->getByteCount() / size.h;
+                for (int y = 0; y < size.h; ++y)
+                {
+                    uint8_t* row = out->getData() + y * stride;
+                    for (int x = 0; x < size.w; ++x)
+                    {
+                        for (size_t c = 0; c < pixel.size(); ++c)
+                        {
+                            row[x * pixel.size() + c] = pixel[c];
+                        }
+                    }
+                }
+                return out;
+            }
+
+            //! Check every pixel of an RGBA_U8 image, to within rounding.
+            bool isPixel(
+                const std::shared_ptr<ftk::Image>& image,
+                const std::vector<int>& pixel)
+            {
+                const ftk::ImageInfo& info = image->getInfo();
+                if (info.type != ftk::ImageType::RGBA_U8)
+                {
+                    return false;
+                }
+                const size_t stride = image->getByteCount() / info.size.h;
+                for (int y = 0; y < info.size.h; ++y)
+                {
+                    const uint8_t* row = image->getData() + y * stride;
+                    for (int x = 0; x < info.size.w; ++x)
+                    {
+                        for (size_t c = 0; c < 4; ++c)
+                        {
+                            if (std::abs(row[x * 4 + c] - pixel[c]) > 1)
+                            {
+                                return false;
+                            }
+                        }
+                    }
+                }
+                return true;
+            }
+        }
+
+        void FlattenTest::run()
+        {
+            const auto red = createImage(ftk::ImageType::RGB_U8, { 255, 0, 0 });
+            const auto green = createImage(ftk::ImageType::RGB_U8, { 0, 255, 0 });
+            {
+                // A single layer is drawn as it is.
+                VideoFrame frame;
+                VideoLayer layer;
+                layer.image = red;
+                frame.layers.push_back(layer);
+                FTK_CHECK(!canFlatten(frame));
+                FTK_CHECK(!flattenImage(frame));
+
+                // Two layers that agree can be flattened, and the second,
+                // being opaque, covers the first.
+                layer.image = green;
+                layer.path = "green";
+                frame.layers.push_back(layer);
+                FTK_CHECK(canFlatten(frame));
+                const auto image = flattenImage(frame);
+                FTK_CHECK(image);
+                FTK_CHECK(image->getSize() == red->getSize());
+                FTK_CHECK(isPixel(image, { 0, 255, 0, 255 }));
+
+                const auto flattened = flattenFrame(frame, image);
+                FTK_CHECK(1 == flattened.layers.size());
+                FTK_CHECK(image == flattened.layers.front().image);
+                FTK_CHECK(flattened.layers.front().path.empty());
+                FTK_CHECK(!flattened.layers.front().missing);
+                frame.layers.back().missing = true;
+                FTK_CHECK(flattenFrame(frame, image).layers.front().missing);
+
+                // Named by the layers when they all have a name.
+                FTK_CHECK(flattened.layers.front().identity.empty());
+                frame.layers[0].identity = "red";
+                frame.layers[1].identity = "green";
+                const std::string identity = flattenFrame(frame, image).layers.front().identity;
+                FTK_CHECK(!identity.empty());
+                frame.layers[1].identity = "blue";
+                FTK_CHECK(identity != flattenFrame(frame, image).layers.front().identity);
+            }
+            {
+                // Images that do not agree, or that are placed within the
+                // canvas, are left to the renderer.
+                VideoFrame frame;
+                VideoLayer layer;
+                layer.image = red;
+                frame.layers.push_back(layer);
+                layer.image = createImage(ftk::ImageType::RGB_U8, { 0, 255, 0 }, ftk::Size2I(2, 2));
+                frame.layers.push_back(layer);
+                FTK_CHECK(!canFlatten(frame));
+                frame.layers.back().image = createImage(ftk::ImageType::RGBA_U8, { 0, 255, 0, 255 });
+                FTK_CHECK(!canFlatten(frame));
+                frame.layers.back().image = green;
+                frame.layers.back().bounds = ftk::Box2F(0.F, 0.F, 3.F, 2.F);
+                FTK_CHECK(!canFlatten(frame));
+            }
+            {
+                // A layer that is transparent shows the one under it.
+                VideoFrame frame;
+                VideoLayer layer;
+                layer.image = createImage(ftk::ImageType::RGBA_U8, { 255, 0, 0, 255 });
+                frame.layers.push_back(layer);
+                layer.image = createImage(ftk::ImageType::RGBA_U8, { 0, 255, 0, 0 });
+                frame.layers.push_back(layer);
+                FTK_CHECK(isPixel(flattenImage(frame), { 255, 0, 0, 255 }));
+            }
+            {
+                // A dissolve mixes its two images.
+                VideoFrame frame;
+                VideoLayer layer;
+                layer.image = red;
+                layer.imageB = green;
+                layer.transition = Transition::Dissolve;
+                layer.transitionValue = .5F;
+                frame.layers.push_back(layer);
+                FTK_CHECK(canFlatten(frame));
+                FTK_CHECK(isPixel(flattenImage(frame), { 128, 128, 0, 255 }));
+
+                // With one image it fades, keeping its color.
+                frame.layers.front().imageB.reset();
+                frame.layers.front().transitionValue = .25F;
+                FTK_CHECK(canFlatten(frame));
+                FTK_CHECK(isPixel(flattenImage(frame), { 255, 0, 0, 191 }));
+            }
+        }
+    }
+}
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/TimelineTest/FrameCacheTest.h>
+
+#include <tlRender/Timeline/FrameCache.h>
+
+#include <ftk/Core/Assert.h>
+#include <ftk/Core/Context.h>
+
+namespace tl
+{
+    namespace timeline_tests
+    {
+        FrameCacheTest::FrameCacheTest(const std::shared_ptr<ftk::Context>& context) :
+            ITest(context, "timeline_tests::FrameCacheTest")
+        {}
+
+        std::shared_ptr<FrameCacheTest> FrameCacheTest::create(const std::shared_ptr<ftk::Context>& context)
+        {
+            return std::shared_ptr<FrameCacheTest>(new FrameCacheTest(context));
+        }
+
+        void FrameCacheTest::run()
+        {
+            auto frameCache = FrameCache::create(_context);
+            FTK_CHECK(frameCache == FrameCache::create(_context));
+            frameCache->clear();
+
+            // Each part of the key tells frames apart.
+            const OTIO_NS::RationalTime time(1.0, 24.0);
+            const std::string key = FrameCache::getKey("/a.exr", time, {});
+            FTK_CHECK(key == FrameCache::getKey("/a.exr", time, {}));
+            FTK_CHECK(key != FrameCache::getKey("/b.exr", time, {}));
+            FTK_CHECK(key != FrameCache::getKey("/a.exr", OTIO_NS::RationalTime(2.0, 24.0), {}));
+            FTK_CHECK(key != FrameCache::getKey("/a.exr", time, { { "Layer", "1" } }));
+            FTK_CHECK(key == FrameCache::getKey("/a.exr", time, { { "IO/Access", "Reverse" } }));
+
+            const ftk::ImageInfo info(ftk::Size2I(16, 16), ftk::ImageType::RGBA_U8);
+            const size_t byteCount = ftk::Image::create(info)->getByteCount();
+            const auto frame = [&info](double value)
+                {
+                    return VideoData(
+                        OTIO_NS::RationalTime(value, 24.0),
+                        0,
+                        ftk::Image::create(info));
+                };
+
+            // The cache is off until it is given a maximum.
+            VideoData data;
+            FTK_CHECK(0 == frameCache->getMax());
+            frameCache->add(key, frame(1.0));
+            FTK_CHECK(!frameCache->get(key, data));
+            frameCache->setMax(byteCount * 2);
+            frameCache->add(key, frame(1.0));
+            FTK_CHECK(frameCache->get(key, data));
+            FTK_CHECK(data.image);
+            FTK_CHECK(1 == frameCache->getCount());
+            FTK_CHECK(byteCount == frameCache->getByteCount());
+
+            // A frame standing in for a missing one is not kept.
+            VideoData missing = frame(2.0);
+            missing.missing = true;
+            frameCache->add("missing", missing);
+            FTK_CHECK(!frameCache->get("missing", data));
+
+            // While a frame is held elsewhere it is pinned: it counts, but
+            // it is passed over and the next least recently used frame is
+            // evicted instead.
+            frameCache->add("2", frame(2.0));
+            frameCache->add("3", frame(3.0));
+            FTK_CHECK(2 == frameCache->getCount());
+            FTK_CHECK(2 * byteCount == frameCache->getByteCount());
+            FTK_CHECK(!frameCache->get("2", data));
+            FTK_CHECK(frameCache->get("3", data));
+            data = VideoData();
+            frameCache->add("4", frame(4.0));
+            FTK_CHECK(!frameCache->get(key, data));
+            FTK_CHECK(frameCache->get("3", data));
+            FTK_CHECK(frameCache->get("4", data));
+            data = VideoData();
+
+            frameCache->clear();
+            FTK_CHECK(0 == frameCache->getCount());
+            FTK_CHECK(0 == frameCache->getByteCount());
+            frameCache->setMax(0);
+        }
+    }
+}
@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/TimelineTest/ImageCompressTest.h>
+
+#include <tlRender/Timeline/ImageCompress.h>
+
+#include <ftk/Core/Assert.h>
+
+#include <cstring>
+
+namespace tl
+{
+    namespace timeline_tests
+    {
+        ImageCompressTest::ImageCompressTest(const std::shared_ptr<ftk::Context>& context) :
+            ITest(context, "timeline_tests::ImageCompressTest")
+        {}
+
+        std::shared_ptr<ImageCompressTest> ImageCompressTest::create(const std::shared_ptr<ftk::Context>& context)
+        {
+            return std::shared_ptr<ImageCompressTest>(new ImageCompressTest(context));
+        }
+
+        void ImageCompressTest::run()
+        {
+            // Sizes that do not divide into whole bands, and types with one
+            // to four bytes to a component.
+            for (const auto& size : { ftk::Size2I(1, 1), ftk::Size2I(67, 131) })
+            {
+                for (const auto type : {
+                    ftk::ImageType::L_U8,
+                    ftk::ImageType::RGB_U8,
+                    ftk::ImageType::RGBA_U8,
+                    ftk::ImageType::RGB_U16,
+                    ftk::ImageType::RGBA_F16,
+                    ftk::ImageType::RGBA_F32 })
+                {
+                    for (const size_t threadCount : { 1, 4 })
+                    {
+                        const ftk::ImageInfo info(size, type);
+                        auto image = ftk::Image::create(info);
+                        uint8_t* data = image->getData();
+                        for (size_t i = 0; i < image->getByteCount(); ++i)
+                        {
+                            data[i] = static_cast<uint8_t>((i / 7) ^ (i % 13));
+                        }
+                        ftk::ImageTags tags;
+                        tags["Name"] = "Value";
+                        image->setTags(tags);
+
+                        const auto compressed = compressImage(image, threadCount);
+                        FTK_CHECK(compressed->info == info);
+                        FTK_CHECK(compressed->getByteCount() > 0);
+                        const auto out = decompressImage(compressed, threadCount);
+                        FTK_CHECK(out->getInfo() == info);
+                        FTK_CHECK(out->getTags() == tags);
+                        FTK_CHECK(0 == memcmp(
+                            out->getData(),
+                            image->getData(),
+                            image->getByteCount()));
+                    }
+                }
+            }
+            {
+                // A smooth gradient compresses well.
+                const ftk::ImageInfo info(ftk::Size2I(256, 256), ftk::ImageType::RGBA_F32);
+                auto image = ftk::Image::create(info);
+                float* data = reinterpret_cast<float*>(image->getData());
+                for (int y = 0; y < 256; ++y)
+                {
+                    for (int x = 0; x < 256; ++x)
+                    {
+                        for (int c = 0; c < 4; ++c)
+                        {
+                            *data++ = (x + y) / 512.F;
+                        }
+                    }
+                }
+                const auto compressed = compressImage(image);
+                FTK_CHECK(compressed->getByteCount() < image->getByteCount() / 2);
+            }
+        }
+    }
+}
@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/TimelineTest/MemoryBudgetTest.h>
+
+#include <tlRender/Timeline/MemoryBudget.h>
+
+#include <ftk/Core/Assert.h>
+#include <ftk/Core/Format.h>
+#include <ftk/Core/String.h>
+
+namespace tl
+{
+    namespace timeline_tests
+    {
+        MemoryBudgetTest::MemoryBudgetTest(const std::shared_ptr<ftk::Context>& context) :
+            ITest(context, "timeline_tests::MemoryBudgetTest")
+        {}
+
+        std::shared_ptr<MemoryBudgetTest> MemoryBudgetTest::create(const std::shared_ptr<ftk::Context>& context)
+        {
+            return std::shared_ptr<MemoryBudgetTest>(new MemoryBudgetTest(context));
+        }
+
+        void MemoryBudgetTest::run()
+        {
+            {
+                FTK_TEST_ENUM(MemoryPriority);
+            }
+            {
+                MemoryUsage v;
+                v.byteCount = 1;
+                FTK_CHECK(v == v);
+                FTK_CHECK(v != MemoryUsage());
+            }
+            {
+                // No budget grants everything.
+                const auto shares = shareMemoryBudget(
+                    0,
+                    { { MemoryPriority::Low, 100 }, { MemoryPriority::High, 200 } });
+                FTK_CHECK(std::vector<size_t>({ 100, 200 }) == shares);
+            }
+            {
+                // Enough for everyone.
+                const auto shares = shareMemoryBudget(
+                    1000,
+                    { { MemoryPriority::Low, 100 }, { MemoryPriority::High, 200 } });
+                FTK_CHECK(std::vector<size_t>({ 100, 200 }) == shares);
+            }
+            {
+                // The higher priorities are served first, and the priority
+                // where the budget runs out shares what is left.
+                const auto shares = shareMemoryBudget(
+                    400,
+                    {
+                        { MemoryPriority::Low, 100 },
+                        { MemoryPriority::Normal, 200 },
+                        { MemoryPriority::Normal, 200 },
+                        { MemoryPriority::High, 200 }
+                    });
+                FTK_CHECK(std::vector<size_t>({ 0, 100, 100, 200 }) == shares);
+            }
+            {
+                // Not even enough for the highest priority.
+                const auto shares = shareMemoryBudget(
+                    100,
+                    { { MemoryPriority::High, 100 }, { MemoryPriority::High, 300 } });
+                FTK_CHECK(std::vector<size_t>({ 25, 75 }) == shares);
+            }
+            {
+                FTK_CHECK(!parseMemoryPressure(std::string()).has_value());
+                const auto pressure = parseMemoryPressure(
+                    "some avg10=12.50 avg60=3.00 avg300=1.00 total=1234\n"
+                    "full avg10=6.25 avg60=1.50 avg300=0.50 total=567\n");
+                FTK_CHECK(pressure.has_value());
+                FTK_CHECK(12.5F == pressure.value());
+            }
+            {
+                FTK_CHECK(!parseCgroupMemoryMax(std::string()).has_value());
+                FTK_CHECK(!parseCgroupMemoryMax("max\n").has_value());
+                FTK_CHECK(!parseCgroupMemoryMax("garbage\n").has_value());
+                const auto max = parseCgroupMemoryMax("8589934592\n");
+                FTK_CHECK(max.has_value());
+                FTK_CHECK(8589934592 == max.value());
+            }
+            if (auto context = _context.lock())
+            {
+                auto memoryBudget = MemoryBudget::create(context);
+                const size_t max = memoryBudget->getMax();
+
+                size_t lowLimit = 0;
+                size_t highLimit = 0;
+                MemoryConsumer low;
+                low.name = "Low";
+                low.priority = MemoryPriority::Low;
+                low.request = 300;
+                low.getByteCount = [] { return 10; };
+                low.setLimit = [&lowLimit](size_t value) { lowLimit = value; };
+                const uint64_t lowID = memoryBudget->addConsumer(low);
+                MemoryConsumer high;
+                high.name = "High";
+                high.priority = MemoryPriority::High;
+                high.request = 200;
+                high.getByteCount = [] { return 20; };
+                high.setLimit = [&highLimit](size_t value) { highLimit = value; };
+                const uint64_t highID = memoryBudget->addConsumer(high);
+
+                // Other consumers may already be registered, so the checks
+                // only look at these two.
+                memoryBudget->setMax(0);
+                memoryBudget->update();
+                FTK_CHECK(300 == lowLimit);
+                FTK_CHECK(200 == highLimit);
+                for (const auto& usage : memoryBudget->getUsage())
+                {
+                    _print(ftk::Format("{0}: {1}/{2}").
+                        arg(usage.name).
+                        arg(usage.byteCount).
+                        arg(usage.limit));
+                    if ("Low" == usage.name)
+                    {
+                        FTK_CHECK(10 == usage.byteCount);
+                    }
+                }
+
+                // The high priority is served first, whatever else is
+                // registered, and the low priority gets at most the rest.
+                memoryBudget->setMax(250);
+                memoryBudget->update();
+                FTK_CHECK(250 == memoryBudget->getEffectiveMax());
+                FTK_CHECK(200 == highLimit);
+                FTK_CHECK(lowLimit <= 50);
+
+                // Swapping the priorities swaps who gives up memory.
+                memoryBudget->setPriority(lowID, MemoryPriority::High);
+                memoryBudget->setPriority(highID, MemoryPriority::Low);
+                memoryBudget->update();
+                FTK_CHECK(250 == lowLimit);
+                FTK_CHECK(0 == highLimit);
+
+                memoryBudget->removeConsumer(lowID);
+                memoryBudget->removeConsumer(highID);
+                lowLimit = 0;
+                memoryBudget->setMax(max);
+                memoryBudget->update();
+                FTK_CHECK(0 == lowLimit);
+            }
+        }
+    }
+}
@@ -0,0 +1,23 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include <ftk/TestLib/ITest.h>
+
+namespace tl
+{
+    namespace timeline_tests
+    {
+        class MemoryBudgetTest : public ftk::test::ITest
+        {
+        protected:
+            MemoryBudgetTest(const std::shared_ptr<ftk::Context>&);
+
+        public:
+            static std::shared_ptr<MemoryBudgetTest> create(const std::shared_ptr<ftk::Context>&);
+
+            void run() override;
+        };
+    }
+}
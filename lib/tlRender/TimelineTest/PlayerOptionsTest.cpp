@@ -30,6 +30,9 @@ namespace tl
                 v.readBehind = 0.F;
                 FTK_CHECK(v == v);
                 FTK_CHECK(v != PlayerCacheOptions());
+                v = PlayerCacheOptions();
+                v.compressedGB = 1.F;
+                FTK_CHECK(v != PlayerCacheOptions());
             }
             {
                 // Each field on its own, so that one left out of the
@@ -46,6 +49,9 @@ namespace tl
                 v.audioRequestMax = 1;
                 FTK_CHECK(v != PlayerOptions());
                 v = PlayerOptions();
+                v.compressThreadCount = 1;
+                FTK_CHECK(v != PlayerOptions());
+                v = PlayerOptions();
                 v.audioBufferFrameCount = 1;
                 FTK_CHECK(v != PlayerOptions());
                 v = PlayerOptions();
@@ -63,11 +69,18 @@ namespace tl
                 v.videoGB = 8.F;
                 v.audioGB = 1.F;
                 v.readBehind = 2.F;
+                v.compressedGB = 2.F;
                 nlohmann::json json;
                 to_json(json, v);
                 PlayerCacheOptions v2;
                 from_json(json, v2);
                 FTK_CHECK(v == v2);
+
+                // Settings written before the compressed cache still read.
+                json.erase("CompressedGB");
+                PlayerCacheOptions v3;
+                from_json(json, v3);
+                FTK_CHECK(0.F == v3.compressedGB);
             }
         }
     }
@@ -17,7 +17,10 @@
 #include <opentimelineio/imageSequenceReference.h>
 #include <opentimelineio/timeline.h>
 
+#include <algorithm>
+#include <functional>
 #include <sstream>
+#include <thread>
 
 namespace tl
 {
@@ -41,6 +44,23 @@ namespace tl
                     diff = std::chrono::steady_clock::now() - t;
                 } while (diff < playbackTime);
             }
+
+            //! Tick the context until the function returns true, or give up
+            //! after a while.
+            bool tickUntil(
+                const std::shared_ptr<ftk::Context>& context,
+                const std::function<bool()>& f)
+            {
+                const auto t = std::chrono::steady_clock::now();
+                bool out = false;
+                while (!(out = f()) &&
+                    std::chrono::steady_clock::now() - t < std::chrono::seconds(20))
+                {
+                    context->tick();
+                    ftk::sleep(std::chrono::milliseconds(10));
+                }
+                return out;
+            }
         }
 
         PlayerTest::PlayerTest(const std::shared_ptr<ftk::Context>& context) :
@@ -58,6 +78,8 @@ namespace tl
             _player();
             _seqAndAudio();
             _compare();
+            _proxy();
+            _present();
         }
 
         void PlayerTest::_enums()
@@ -545,5 +567,130 @@ namespace tl
                 _error(e.what());
             }
         }
+
+        //! The switch to the proxies when frames are decoded slower than
+        //! they are played, and back again.
+        void PlayerTest::_proxy()
+        {
+            if (!_context->getSystem<ReadSystem>()->getPlugin(
+                ftk::Path(TLRENDER_SAMPLE_DATA, "SpatialLarge.png")))
+            {
+                _print("Skipped: no plugin reads the media reference fixtures");
+                return;
+            }
+            try
+            {
+                // A cache with room for a frame or two, so that playback
+                // keeps decoding and there is a rate to measure.
+                PlayerOptions playerOptions;
+                playerOptions.cache.videoGB = .01F;
+                playerOptions.cache.readBehind = 0.F;
+                auto player = Player::create(
+                    _context,
+                    Timeline::create(
+                        _context,
+                        ftk::Path(TLRENDER_SAMPLE_DATA, "MultipleMediaRefs.otio")),
+                    playerOptions);
+                player->setMediaReferenceKey("Full");
+                player->setProxyKey("Proxy");
+                FTK_CHECK("Proxy" == player->getProxyKey());
+
+                // Played far faster than anything decodes, it goes to the
+                // proxies once the rate has been measured.
+                player->setSpeedMult(1000000.0);
+                player->forward();
+                FTK_CHECK(tickUntil(
+                    _context,
+                    [player] { return "Proxy" == player->getMediaReferenceKey(); }));
+                _print(ftk::Format("Decode rate: {0}").arg(player->getDecodeRate()));
+
+                // Slowed to well within the rate the media was decoded at,
+                // it goes back.
+                player->setSpeedMult(1.0);
+                player->setSpeed(1.0);
+                FTK_CHECK(tickUntil(
+                    _context,
+                    [player] { return "Full" == player->getMediaReferenceKey(); }));
+
+                // And stopping goes back straight away.
+                player->setSpeedMult(1000000.0);
+                FTK_CHECK(tickUntil(
+                    _context,
+                    [player] { return "Proxy" == player->getMediaReferenceKey(); }));
+                player->stop();
+                _context->tick();
+                FTK_CHECK("Full" == player->getMediaReferenceKey());
+            }
+            catch (const std::exception& e)
+            {
+                _error(e.what());
+            }
+        }
+
+        void PlayerTest::_present()
+        {
+            try
+            {
+                // No audio, so the refreshes pace playback.
+                auto timeline = Timeline::create(
+                    _context,
+                    ftk::Path(TLRENDER_SAMPLE_DATA, "Seq/BART_2021-02-07.0001.jpg"));
+                auto player = Player::create(_context, timeline);
+                const double rate = player->getTimeRange().duration().rate();
+                player->setLoop(Loop::Loop);
+                player->forward();
+
+                // A 60Hz display, drawn on every refresh the way the viewport
+                // draws during playback: tick, then report the refresh. Once
+                // the clock has locked on, a frame that stays up for more than
+                // a few refreshes is a stall.
+                const auto period = std::chrono::microseconds(16667);
+                const size_t refreshCount = 180;
+                const size_t lockCount = 60;
+                auto t = std::chrono::steady_clock::now();
+                OTIO_NS::RationalTime time = player->getCurrentTime();
+                size_t changes = 0;
+                size_t held = 0;
+                size_t heldMax = 0;
+                for (size_t i = 0; i < refreshCount; ++i)
+                {
+                    _context->tick();
+                    player->present(std::chrono::steady_clock::now());
+                    const OTIO_NS::RationalTime& current = player->getCurrentTime();
+                    if (i >= lockCount)
+                    {
+                        if (current != time)
+                        {
+                            ++changes;
+                            held = 0;
+                        }
+                        else
+                        {
+                            heldMax = std::max(heldMax, ++held);
+                        }
+                    }
+                    time = current;
+                    t += period;
+                    std::this_thread::sleep_until(t);
+                }
+                player->stop();
+
+                // At 24 frames per second on 60Hz each frame is held for two
+                // or three refreshes. Allow some for a busy machine, but not
+                // the tenth of a second the clock takes to give up.
+                const double seconds = (refreshCount - lockCount) / 60.0;
+                _print(ftk::Format("Present: {0} frames in {1} seconds, held for at most {2} refreshes").
+                    arg(changes).
+                    arg(seconds).
+                    arg(heldMax + 1));
+                FTK_CHECK(heldMax < 5);
+                FTK_CHECK(changes > rate * seconds * .75);
+                FTK_CHECK(changes < rate * seconds * 1.25);
+            }
+            catch (const std::exception& e)
+            {
+                _error(e.what());
+            }
+        }
     }
 }
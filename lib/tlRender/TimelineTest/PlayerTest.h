@@ -27,6 +27,8 @@ namespace tl
             void _player(const std::shared_ptr<Player>&);
             void _seqAndAudio();
             void _compare();
+            void _proxy();
+            void _present();
         };
     }
 }
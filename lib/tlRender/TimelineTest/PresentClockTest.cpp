@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/TimelineTest/PresentClockTest.h>
+
+#include <tlRender/Timeline/PresentClock.h>
+
+#include <ftk/Core/Assert.h>
+#include <ftk/Core/Format.h>
+
+#include <cmath>
+#include <vector>
+
+namespace tl
+{
+    namespace timeline_tests
+    {
+        PresentClockTest::PresentClockTest(const std::shared_ptr<ftk::Context>& context) :
+            ITest(context, "timeline_tests::PresentClockTest")
+        {}
+
+        std::shared_ptr<PresentClockTest> PresentClockTest::create(const std::shared_ptr<ftk::Context>& context)
+        {
+            return std::shared_ptr<PresentClockTest>(new PresentClockTest(context));
+        }
+
+        namespace
+        {
+            // A display refreshing at a rate given as a fraction, with up to
+            // a millisecond of jitter on the reported times.
+            class VSync
+            {
+            public:
+                VSync(const std::pair<int64_t, int64_t>& rate) :
+                    _rate(rate),
+                    _start(std::chrono::steady_clock::now())
+                {}
+
+                std::chrono::steady_clock::time_point getTime(int64_t refresh)
+                {
+                    _seed = _seed * 1664525U + 1013904223U;
+                    const double jitter = ((_seed >> 8) / static_cast<double>(1 << 24) - .5) * .002;
+                    const double seconds = refresh * _rate.second / static_cast<double>(_rate.first) + jitter;
+                    return _start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        std::chrono::duration<double>(seconds));
+                }
+
+            private:
+                std::pair<int64_t, int64_t> _rate;
+                std::chrono::steady_clock::time_point _start;
+                uint32_t _seed = 1;
+            };
+        }
+
+        void PresentClockTest::run()
+        {
+            {
+                FTK_CHECK(std::make_pair(int64_t(24), int64_t(1)) == getRateFraction(24.0));
+                FTK_CHECK(std::make_pair(int64_t(24000), int64_t(1001)) == getRateFraction(24000 / 1001.0));
+                FTK_CHECK(std::make_pair(int64_t(30000), int64_t(1001)) == getRateFraction(29.97002997));
+                FTK_CHECK(std::make_pair(int64_t(0), int64_t(0)) == getRateFraction(12.3));
+                FTK_CHECK(std::make_pair(int64_t(0), int64_t(0)) == getRateFraction(0.0));
+            }
+            {
+                PresentClock clock;
+                const auto now = std::chrono::steady_clock::now();
+                FTK_CHECK(!clock.isLocked(now));
+                FTK_CHECK(0.0 == clock.getPeriod());
+                FTK_CHECK(0 == clock.getFrames(10, 24.0));
+                FTK_CHECK(now == clock.predict(now));
+            }
+            {
+                // The cadence is exact at every frame rate, on displays at
+                // both 60Hz and 59.94Hz, for ten minutes of playback and over
+                // a missed refresh.
+                const std::vector<std::pair<int64_t, int64_t> > refreshRates =
+                {
+                    { 60, 1 },
+                    { 60000, 1001 }
+                };
+                const std::vector<double> speeds =
+                {
+                    24000 / 1001.0,
+                    24.0,
+                    25.0,
+                    30000 / 1001.0,
+                    48.0,
+                    60.0
+                };
+                for (const auto& refreshRate : refreshRates)
+                {
+                    for (const double speed : speeds)
+                    {
+                        PresentClock clock;
+                        VSync vsync(refreshRate);
+                        int64_t refresh = 0;
+                        for (; refresh < 300; ++refresh)
+                        {
+                            clock.addRefresh(vsync.getTime(refresh));
+                        }
+                        FTK_CHECK(clock.isLocked(vsync.getTime(refresh - 1)));
+                        FTK_CHECK(refreshRate == clock.getRate());
+
+                        clock.reset();
+                        const auto speedRate = getRateFraction(speed);
+                        const int64_t missed = 1000;
+                        const int64_t count = 10 * 60 * 60;
+                        bool indexes = true;
+                        bool cadence = true;
+                        bool skipped = false;
+                        int64_t framesPrev = 0;
+                        for (int64_t i = 0; i < count; ++i, ++refresh)
+                        {
+                            if (missed == i)
+                            {
+                                ++refresh;
+                            }
+                            const int64_t index = clock.addRefresh(vsync.getTime(refresh));
+                            indexes &= (i + (i >= missed ? 1 : 0)) == index;
+                            const int64_t frames = clock.getFrames(index, speed);
+                            cadence &= index * speedRate.first * refreshRate.second /
+                                (speedRate.second * refreshRate.first) == frames;
+                            skipped |= i != missed && frames - framesPrev > 1;
+                            framesPrev = frames;
+                        }
+                        _print(ftk::Format("{0}fps at {1}Hz: {2} frames").
+                            arg(speed, 3).
+                            arg(refreshRate.first / static_cast<double>(refreshRate.second), 2).
+                            arg(framesPrev));
+                        FTK_CHECK(indexes);
+                        FTK_CHECK(cadence);
+                        // A display slower than the frame rate has to skip.
+                        FTK_CHECK(!skipped ||
+                            speed > refreshRate.first / static_cast<double>(refreshRate.second));
+                    }
+                }
+            }
+            {
+                // 24 frames per second at 60Hz is 3:2.
+                PresentClock clock;
+                VSync vsync(std::make_pair(60, 1));
+                int64_t refresh = 0;
+                for (; refresh < 300; ++refresh)
+                {
+                    clock.addRefresh(vsync.getTime(refresh));
+                }
+                clock.reset();
+                std::vector<int64_t> frames;
+                for (int i = 0; i < 10; ++i, ++refresh)
+                {
+                    frames.push_back(clock.getFrames(clock.addRefresh(vsync.getTime(refresh)), 24.0));
+                }
+                FTK_CHECK(std::vector<int64_t>({ 0, 0, 0, 1, 1, 2, 2, 2, 3, 3 }) == frames);
+
+                // The next refresh is predicted from the fit, not the jitter.
+                const auto time = vsync.getTime(refresh - 1);
+                const double predict = std::chrono::duration<double>(clock.predict(time) - time).count();
+                FTK_CHECK(predict > 0.0 && predict < 1.0 / 60.0 + .002);
+                FTK_CHECK(std::abs(clock.getPeriod() - 1.0 / 60.0) < 1.0e-5);
+
+                // A long gap starts again.
+                const auto later = time + std::chrono::seconds(1);
+                FTK_CHECK(!clock.isLocked(later));
+                FTK_CHECK(0 == clock.addRefresh(later));
+                FTK_CHECK(!clock.isLocked(later));
+            }
+        }
+    }
+}
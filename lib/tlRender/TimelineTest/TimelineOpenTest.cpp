@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include <tlRender/TimelineTest/TimelineOpenTest.h>
+
+#include <tlRender/Timeline/TimelineOpen.h>
+
+#include <ftk/Core/Assert.h>
+#include <ftk/Core/Context.h>
+#include <ftk/Core/Format.h>
+#include <ftk/Core/String.h>
+
+#include <thread>
+
+namespace tl
+{
+    namespace timeline_tests
+    {
+        TimelineOpenTest::TimelineOpenTest(const std::shared_ptr<ftk::Context>& context) :
+            ITest(context, "timeline_tests::TimelineOpenTest")
+        {}
+
+        std::shared_ptr<TimelineOpenTest> TimelineOpenTest::create(const std::shared_ptr<ftk::Context>& context)
+        {
+            return std::shared_ptr<TimelineOpenTest>(new TimelineOpenTest(context));
+        }
+
+        namespace
+        {
+            bool isDone(TimelineOpenStage value)
+            {
+                return
+                    TimelineOpenStage::Ready == value ||
+                    TimelineOpenStage::Canceled == value ||
+                    TimelineOpenStage::Error == value;
+            }
+        }
+
+        void TimelineOpenTest::run()
+        {
+            {
+                FTK_TEST_ENUM(TimelineOpenStage);
+            }
+
+            // Open a few at once, one of them missing, and check that each
+            // ends up as a synchronous open would.
+            const std::vector<std::string> fileNames =
+            {
+                "BART_2021-02-07.m4v",
+                "Gap.otio",
+                "Missing.otio"
+            };
+            std::vector<std::shared_ptr<TimelineOpen> > opens;
+            std::vector<std::vector<TimelineOpenStage> > stages(fileNames.size());
+            std::vector<std::shared_ptr<ftk::Observer<TimelineOpenStage> > > observers;
+            for (size_t i = 0; i < fileNames.size(); ++i)
+            {
+                const ftk::Path path(TLRENDER_SAMPLE_DATA, fileNames[i]);
+                auto open = TimelineOpen::create(_context, path);
+                FTK_CHECK(path == open->getPath());
+                opens.push_back(open);
+                observers.push_back(ftk::Observer<TimelineOpenStage>::create(
+                    open->observeStage(),
+                    [&stages, i](TimelineOpenStage value)
+                    {
+                        stages[i].push_back(value);
+                    }));
+            }
+            const auto t0 = std::chrono::steady_clock::now();
+            bool done = false;
+            while (!done &&
+                std::chrono::steady_clock::now() - t0 < std::chrono::seconds(10))
+            {
+                _context->tick();
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                done = true;
+                for (const auto& open : opens)
+                {
+                    done &= isDone(open->observeStage()->get());
+                }
+            }
+            for (size_t i = 0; i < fileNames.size(); ++i)
+            {
+                _print(ftk::Format("{0}: {1}").
+                    arg(fileNames[i]).
+                    arg(opens[i]->observeStage()->get()));
+                FTK_CHECK(!stages[i].empty());
+                FTK_CHECK(TimelineOpenStage::Queued == stages[i].front());
+            }
+            FTK_CHECK(TimelineOpenStage::Ready == opens[0]->observeStage()->get());
+            FTK_CHECK(opens[0]->getTimeline());
+            FTK_CHECK(opens[0]->getError().empty());
+            FTK_CHECK(TimelineOpenStage::Ready == opens[1]->observeStage()->get());
+            if (opens[0]->getTimeline() && opens[1]->getTimeline())
+            {
+                const ftk::Path path(TLRENDER_SAMPLE_DATA, fileNames[1]);
+                auto timeline = Timeline::create(_context, path);
+                FTK_CHECK(timeline->getTimeRange() == opens[1]->getTimeline()->getTimeRange());
+            }
+            FTK_CHECK(TimelineOpenStage::Error == opens[2]->observeStage()->get());
+            FTK_CHECK(!opens[2]->getTimeline());
+            FTK_CHECK(!opens[2]->getError().empty());
+
+            // Cancel. The open may have finished first, but if it was
+            // canceled there is no timeline.
+            {
+                auto open = TimelineOpen::create(
+                    _context,
+                    ftk::Path(TLRENDER_SAMPLE_DATA, fileNames[0]));
+                open->cancel();
+                const auto t0 = std::chrono::steady_clock::now();
+                while (!isDone(open->observeStage()->get()) &&
+                    std::chrono::steady_clock::now() - t0 < std::chrono::seconds(10))
+                {
+                    _context->tick();
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+                const TimelineOpenStage stage = open->observeStage()->get();
+                FTK_CHECK(
+                    TimelineOpenStage::Canceled == stage ||
+                    TimelineOpenStage::Ready == stage);
+                if (TimelineOpenStage::Canceled == stage)
+                {
+                    FTK_CHECK(!open->getTimeline());
+                }
+            }
+
+            // Destroyed while opening.
+            {
+                auto open = TimelineOpen::create(
+                    _context,
+                    ftk::Path(TLRENDER_SAMPLE_DATA, fileNames[0]));
+            }
+        }
+    }
+}
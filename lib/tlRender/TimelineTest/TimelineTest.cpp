@@ -3,6 +3,7 @@
 
 #include <tlRender/TimelineTest/TimelineTest.h>
 
+#include <tlRender/Timeline/Proxy.h>
 #include <tlRender/Timeline/Timeline.h>
 #include <tlRender/Timeline/Util.h>
 
@@ -14,6 +15,7 @@
 
 #include <ftk/Core/Assert.h>
 #include <ftk/Core/Context.h>
+#include <ftk/Core/FileIO.h>
 
 #include <algorithm>
 #include <cstring>
@@ -25,6 +27,7 @@
 #include <opentimelineio/timeline.h>
 
 #include <algorithm>
+#include <cmath>
 #include <filesystem>
 #include <sstream>
 #include <thread>
@@ -68,9 +71,11 @@ namespace tl
             _media();
             _readers();
             _memLifetime();
+            _bundleIndex();
             _shutdown();
             _path();
             _seqOnDisk();
+            _proxy();
             _separateAudio();
             _spatial();
             _mediaReferences();
@@ -626,6 +631,58 @@ namespace tl
             _print("a decoder outlives the timeline that opened it");
         }
 
+        void TimelineTest::_bundleIndex()
+        {
+            // A copy of the bundle, so that the index is not written into
+            // the sample data.
+            const std::filesystem::path dir = _getTempDir() / "BundleIndex";
+            std::filesystem::remove_all(dir);
+            std::filesystem::create_directory(dir);
+            const std::filesystem::path fileName = dir / "StreamedSeq.otioz";
+            std::filesystem::copy_file(
+                std::filesystem::u8path(
+                    ftk::Path(TLRENDER_SAMPLE_DATA, "StreamedSeq.otioz").get()),
+                fileName);
+            const std::filesystem::path indexFileName = dir / "StreamedSeq.otioz.tlindex";
+
+            // The first open writes the index and the second reads it; both
+            // have to see the same timeline, and the same frames.
+            Options options;
+            options.threaded = false;
+            options.bundleIndex = true;
+            std::vector<OTIO_NS::TimeRange> timeRanges;
+            std::vector<size_t> memSizes;
+            for (size_t i = 0; i < 2; ++i)
+            {
+                auto timeline = Timeline::create(
+                    _context,
+                    ftk::Path(fileName.u8string()),
+                    options);
+                FTK_CHECK(std::filesystem::exists(indexFileName));
+                timeRanges.push_back(timeline->getTimeRange());
+                const auto clips = timeline->getTimeline()->find_clips();
+                FTK_CHECK(!clips.empty());
+                memSizes.push_back(timeline->getMem(clips[0]->media_reference()).size());
+            }
+            FTK_CHECK(timeRanges[0] == timeRanges[1]);
+            FTK_CHECK(memSizes[0] > 0);
+            FTK_CHECK(memSizes[0] == memSizes[1]);
+
+            // An index that does not match the bundle is ignored and
+            // rewritten rather than trusted.
+            {
+                auto fileIO = ftk::FileIO::create(indexFileName.u8string(), ftk::FileMode::Write);
+                const std::string garbage = "Not an index";
+                fileIO->write(garbage.data(), garbage.size());
+            }
+            auto timeline = Timeline::create(
+                _context,
+                ftk::Path(fileName.u8string()),
+                options);
+            FTK_CHECK(timeRanges[0] == timeline->getTimeRange());
+            FTK_CHECK(std::filesystem::file_size(indexFileName) > 12);
+        }
+
         void TimelineTest::_shutdown()
         {
             _print("Shutdown");
@@ -767,6 +824,86 @@ namespace tl
             }
         }
 
+        void TimelineTest::_proxy()
+        {
+            // Shrinking averages each box of pixels, and converts the type.
+            {
+                auto in = ftk::Image::create(ftk::Size2I(4, 2), ftk::ImageType::L_U8);
+                const uint8_t data[] = { 0, 255, 100, 100, 255, 0, 200, 200 };
+                for (int y = 0; y < 2; ++y)
+                {
+                    std::memcpy(
+                        in->getData() + y * (in->getByteCount() / 2),
+                        data + y * 4,
+                        4);
+                }
+                auto out = ftk::Image::create(ftk::Size2I(2, 1), ftk::ImageType::RGBA_F32);
+                proxyResize(in, out);
+                const float* p = reinterpret_cast<const float*>(out->getData());
+                FTK_CHECK(std::abs(p[0] - .5F) < .01F);
+                FTK_CHECK(std::abs(p[4] - 150.F / 255.F) < .01F);
+                FTK_CHECK(1.F == p[3]);
+            }
+
+            auto readSystem = _context->getSystem<ReadSystem>();
+            auto writeSystem = _context->getSystem<WriteSystem>();
+            const std::filesystem::path dir = _getTempDir() / "Proxy";
+            std::filesystem::remove_all(dir);
+            std::filesystem::create_directory(dir);
+            const auto frameFile = [&dir](int frame)
+                {
+                    return ftk::Path((dir / ftk::Format("render.{0}.png").
+                        arg(frame, 4, '0').str()).u8string());
+                };
+            auto writePlugin = writeSystem->getPlugin(frameFile(1));
+            if (!writePlugin || !readSystem->getPlugin(frameFile(1)))
+            {
+                _print("Skipped: no plugin reads the fixture");
+                return;
+            }
+            IOInfo writeInfo;
+            writeInfo.video.push_back(writePlugin->getInfo(
+                ftk::ImageInfo(ftk::Size2I(16, 16), ftk::ImageType::RGB_U8)));
+            for (int frame = 1; frame <= 3; ++frame)
+            {
+                auto write = writeSystem->write(frameFile(frame), writeInfo);
+                write->writeVideo(
+                    OTIO_NS::RationalTime(static_cast<double>(frame), 24.0),
+                    ftk::Image::create(writeInfo.video[0]));
+            }
+
+            auto timeline = Timeline::create(_context, frameFile(1));
+            ProxyOptions options;
+            options.extension = ".png";
+            options.writeOptions.clear();
+            FTK_CHECK(options == options);
+            FTK_CHECK(options != ProxyOptions());
+            auto generator = ProxyGenerator::create(_context, timeline, options);
+            ProxyProgress progress = generator->getProgress();
+            for (int i = 0; i < 1000 && !progress.finished; ++i)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                progress = generator->getProgress();
+            }
+            _print(ftk::Format("Proxy frames: {0}/{1}").
+                arg(progress.frameDone).
+                arg(progress.frameCount));
+            FTK_CHECK(progress.finished);
+            FTK_CHECK(1 == progress.mediaCount);
+            FTK_CHECK(3 == progress.frameDone);
+            FTK_CHECK(progress.errors.empty());
+
+            // The proxy is a key like any other, and reads at its own size.
+            const auto keys = timeline->getMediaReferenceKeys();
+            FTK_CHECK(std::find(keys.begin(), keys.end(), options.key) != keys.end());
+            timeline->setMediaReferenceKey(options.key);
+            auto request = timeline->getVideo(timeline->getTimeRange().start_time());
+            const VideoFrame videoFrame = request.future.get();
+            FTK_CHECK(1 == videoFrame.layers.size());
+            FTK_CHECK(videoFrame.layers[0].image);
+            FTK_CHECK(ftk::Size2I(8, 8) == videoFrame.layers[0].image->getSize());
+        }
+
         void TimelineTest::_separateAudio()
         {
 #if defined(TLRENDER_FFMPEG_PLUGIN)
@@ -1234,8 +1371,21 @@ namespace tl
                         FTK_CHECK(have.future.get().layers[0].image);
                         auto pending = wideTimeline->getVideo(
                             OTIO_NS::RationalTime(80.0, 24.0));
-                        FTK_CHECK(pending.future.get().layers[0].image);
+                        const VideoFrame pendingFrame = pending.future.get();
+                        FTK_CHECK(pendingFrame.layers[0].image);
                         FTK_CHECK(0 == wideTimeline->getReadErrorCount());
+
+                        // Stand-ins are named by their pixels, so every frame
+                        // they fill in for has the same identity.
+                        auto pending2 = wideTimeline->getVideo(
+                            OTIO_NS::RationalTime(81.0, 24.0));
+                        const VideoFrame pendingFrame2 = pending2.future.get();
+                        FTK_CHECK(!pendingFrame.layers[0].identity.empty());
+                        FTK_CHECK(pendingFrame.layers[0].identity ==
+                            pendingFrame2.layers[0].identity);
+                        FTK_CHECK(pendingFrame.layers[0].identity !=
+                            wideTimeline->getVideo(OTIO_NS::RationalTime(1.0, 24.0)).
+                                future.get().layers[0].identity);
                     }
 
                     // A range of one frame survives being opened, as does a
@@ -1421,6 +1571,19 @@ namespace tl
                     FTK_CHECK(!heldFrame.layers.empty());
                     FTK_CHECK(heldFrame.layers[0].image);
                     FTK_CHECK(0 == held->getReadErrorCount());
+
+                    // A held frame is named by the frame it holds, so that a
+                    // cache can keep one image for both.
+                    FTK_CHECK(heldFrame.layers[0].heldFrom.has_value());
+                    FTK_CHECK(!heldFrame.layers[0].identity.empty());
+                    auto holdsRequest = held->getVideo(
+                        OTIO_NS::RationalTime(
+                            static_cast<double>(heldFrame.layers[0].heldFrom.value()),
+                            24.0));
+                    const VideoFrame holdsFrame = holdsRequest.future.get();
+                    FTK_CHECK(!holdsFrame.layers.empty());
+                    FTK_CHECK(heldFrame.layers[0].identity ==
+                        holdsFrame.layers[0].identity);
                 }
             }
             catch (const std::exception& e)
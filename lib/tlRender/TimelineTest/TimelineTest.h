@@ -32,10 +32,12 @@ namespace tl
             void _media();
             void _readers();
             void _memLifetime();
+            void _bundleIndex();
             void _shutdown();
             void _timeline(const std::shared_ptr<Timeline>&);
             void _path();
             void _seqOnDisk();
+            void _proxy();
             void _separateAudio();
             void _spatial();
             void _mediaReferences();
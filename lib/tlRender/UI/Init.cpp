@@ -14,6 +14,8 @@
 #include <ftk/UI/FileBrowser.h>
 #include <ftk/UI/IconSystem.h>
 #include <ftk/GL/System.h>
+#include <ftk/Core/DiagSystem.h>
+#include <ftk/Core/Memory.h>
 
 namespace tl_resource
 {
@@ -54,6 +56,15 @@ namespace tl
             ftk::uiInit(context);
             tl::init(context);
             context->getSystem<ftk::gl::System>()->setRenderFactory(std::make_shared<gl::RenderFactory>());
+
+            auto diagSystem = context->getSystem<ftk::DiagSystem>();
+            diagSystem->addSampler(
+                "tl Memory/Texture tiles: {0}MB",
+                [] { return gl::Render::getTileByteCount() / ftk::megabyte; });
+            diagSystem->addSampler(
+                "tl GL/Texture upload: {0}KB",
+                [] { return gl::Render::getFrameUploadByteCount() / ftk::kilobyte; });
+
             ThumbnailSystem::create(context);
 
             // The file browser draws thumbnails of whatever it is handed the
@@ -3,8 +3,10 @@
 
 #include <tlRender/UI/ThumbnailSystem.h>
 
+#include <tlRender/CPU/Render.h>
 #include <tlRender/GL/Render.h>
 
+#include <tlRender/Timeline/MemoryBudget.h>
 #include <tlRender/Timeline/Timeline.h>
 
 #include <tlRender/IO/System.h>
@@ -214,6 +216,7 @@ namespace tl
         struct ThumbnailSystem::Private
         {
             std::weak_ptr<ftk::Context> context;
+            RenderType renderType = RenderType::GL;
             std::shared_ptr<ftk::gl::Window> window;
             uint64_t requestId = 0;
             std::shared_ptr<ftk::Observable<ThumbnailCacheOptions> > cacheOptions;
@@ -291,7 +294,8 @@ namespace tl
 
             struct ThumbnailThread
             {
-                std::shared_ptr<gl::Render> render;
+                std::shared_ptr<IRender> render;
+                std::shared_ptr<cpu::Render> cpuRender;
                 std::shared_ptr<ftk::gl::OffscreenBuffer> buffer;
                 std::atomic<bool> ioCacheClear = false;
                 std::condition_variable cv;
@@ -300,6 +304,42 @@ namespace tl
             };
             ThumbnailThread thumbnailThread;
 
+            // Bind the buffer for drawing a thumbnail; the CPU renderer
+            // draws into its own.
+            std::unique_ptr<ftk::gl::OffscreenBufferBinding> thumbnailBind()
+            {
+                std::unique_ptr<ftk::gl::OffscreenBufferBinding> out;
+                if (thumbnailThread.buffer)
+                {
+                    out.reset(new ftk::gl::OffscreenBufferBinding(thumbnailThread.buffer));
+                }
+                return out;
+            }
+
+            // Read back the thumbnail that was drawn.
+            std::shared_ptr<ftk::Image> thumbnailRead(const ftk::Size2I& size)
+            {
+                auto out = ftk::Image::create(
+                    ftk::ImageInfo(size.w, size.h, ftk::ImageType::RGBA_U8));
+                if (thumbnailThread.cpuRender)
+                {
+                    thumbnailThread.cpuRender->copyImage(out);
+                }
+                else
+                {
+                    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+                    glReadPixels(
+                        0,
+                        0,
+                        size.w,
+                        size.h,
+                        GL_RGBA,
+                        GL_UNSIGNED_BYTE,
+                        out->getData());
+                }
+                return out;
+            }
+
             struct WaveformThread
             {
                 std::atomic<bool> ioCacheClear = false;
@@ -311,6 +351,12 @@ namespace tl
 
             std::shared_ptr<ftk::Timer> logTimer;
 
+            // The share of the memory budget, as a fraction of the cache
+            // sizes in the options. Set on the main thread.
+            float memoryScale = 1.F;
+            std::weak_ptr<MemoryBudget> memoryBudget;
+            uint64_t memoryID = 0;
+
             // When any of the three threads last had work. The cache is
             // shared, so one thread going quiet must not drop the timelines
             // another is still using.
@@ -338,19 +384,41 @@ namespace tl
             }
         };
 
-        ThumbnailSystem::ThumbnailSystem(const std::shared_ptr<ftk::Context>& context) :
+        ThumbnailSystem::ThumbnailSystem(
+            const std::shared_ptr<ftk::Context>& context,
+            RenderType renderType) :
             ISystem(context, "tl::ui::ThumbnailSystem"),
             _p(new Private)
         {
             FTK_P();
             
             p.context = context;
+            p.renderType = renderType;
 
-            p.window = ftk::gl::Window::create(
-                context,
-                "tl::ui::ThumbnailSystem",
-                ftk::Size2I(1, 1),
-                static_cast<int>(ftk::gl::WindowOptions::None));
+            if (RenderType::GL == p.renderType)
+            {
+                try
+                {
+                    p.window = ftk::gl::Window::create(
+                        context,
+                        "tl::ui::ThumbnailSystem",
+                        ftk::Size2I(1, 1),
+                        static_cast<int>(ftk::gl::WindowOptions::None));
+                }
+                catch (const std::exception& e)
+                {
+                    // Without a display there are still thumbnails, drawn
+                    // on the CPU.
+                    p.renderType = RenderType::CPU;
+                    if (auto logSystem = context->getLogSystem())
+                    {
+                        logSystem->print(
+                            "tl::ui::ThumbnailSystem",
+                            ftk::Format("Using the CPU renderer: {0}").arg(e.what()),
+                            ftk::LogType::Warning);
+                    }
+                }
+            }
 
             p.cacheOptions = ftk::Observable<ThumbnailCacheOptions>::create();
 
@@ -375,12 +443,26 @@ namespace tl
                 [this]
                 {
                     FTK_P();
-                    p.window->makeCurrent();
+                    if (p.window)
+                    {
+                        p.window->makeCurrent();
+                    }
                     if (auto context = p.context.lock())
                     {
-                        p.thumbnailThread.render = gl::Render::create(
-                            context->getLogSystem(),
-                            context->getSystem<ftk::FontSystem>());
+                        switch (p.renderType)
+                        {
+                        case RenderType::CPU:
+                            p.thumbnailThread.cpuRender = cpu::Render::create(
+                                context->getLogSystem(),
+                                context->getSystem<ftk::FontSystem>());
+                            p.thumbnailThread.render = p.thumbnailThread.cpuRender;
+                            break;
+                        default:
+                            p.thumbnailThread.render = gl::Render::create(
+                                context->getLogSystem(),
+                                context->getSystem<ftk::FontSystem>());
+                            break;
+                        }
                     }
                     if (p.thumbnailThread.render)
                     {
@@ -392,8 +474,12 @@ namespace tl
                     }
                     p.thumbnailThread.buffer.reset();
                     p.thumbnailThread.render.reset();
+                    p.thumbnailThread.cpuRender.reset();
                     _thumbnailCancel();
-                    p.window->clearCurrent();
+                    if (p.window)
+                    {
+                        p.window->clearCurrent();
+                    }
                 });
 
             p.waveformMutex.cache.setMax(p.cacheOptions->get().waveformMB * ftk::megabyte);
@@ -411,6 +497,44 @@ namespace tl
                     _waveformCancel();
                 });
 
+            // Thumbnails are the first to go when memory runs short.
+            if (auto memoryBudget = context->getSystem<MemoryBudget>())
+            {
+                p.memoryBudget = memoryBudget;
+                MemoryConsumer consumer;
+                consumer.name = "Thumbnails";
+                consumer.priority = MemoryPriority::Low;
+                consumer.request =
+                    (p.cacheOptions->get().thumbnailMB + p.cacheOptions->get().waveformMB) *
+                    ftk::megabyte;
+                consumer.getByteCount = [this]
+                    {
+                        FTK_P();
+                        size_t out = 0;
+                        {
+                            std::unique_lock<std::mutex> lock(p.thumbnailMutex.mutex);
+                            out += p.thumbnailMutex.cache.getSize();
+                        }
+                        {
+                            std::unique_lock<std::mutex> lock(p.waveformMutex.mutex);
+                            out += p.waveformMutex.cache.getSize();
+                        }
+                        return out;
+                    };
+                consumer.setLimit = [this](size_t value)
+                    {
+                        FTK_P();
+                        const auto& options = p.cacheOptions->get();
+                        const size_t request =
+                            (options.thumbnailMB + options.waveformMB) * ftk::megabyte;
+                        p.memoryScale = request > 0 && value < request ?
+                            (value / static_cast<float>(request)) :
+                            1.F;
+                        _setCacheMax();
+                    };
+                p.memoryID = memoryBudget->addConsumer(consumer);
+            }
+
             p.logTimer = ftk::Timer::create(context);
             p.logTimer->setRepeating(true);
             p.logTimer->start(
@@ -456,6 +580,11 @@ namespace tl
 
         ThumbnailSystem::~ThumbnailSystem()
         {
+            FTK_P();
+            if (auto memoryBudget = p.memoryBudget.lock())
+            {
+                memoryBudget->removeConsumer(p.memoryID);
+            }
             shutdown();
         }
 
@@ -480,17 +609,23 @@ namespace tl
         }
 
         std::shared_ptr<ThumbnailSystem> ThumbnailSystem::create(
-            const std::shared_ptr<ftk::Context>& context)
+            const std::shared_ptr<ftk::Context>& context,
+            RenderType renderType)
         {
             auto out = context->getSystem<ThumbnailSystem>();
             if (!out)
             {
-                out = std::shared_ptr<ThumbnailSystem>(new ThumbnailSystem(context));
+                out = std::shared_ptr<ThumbnailSystem>(new ThumbnailSystem(context, renderType));
                 context->addSystem(out);
             }
             return out;
         }
 
+        RenderType ThumbnailSystem::getRenderType() const
+        {
+            return _p->renderType;
+        }
+
         InfoRequest ThumbnailSystem::getInfo(
             const ftk::Path& path,
             const IOOptions& options)
@@ -733,14 +868,27 @@ namespace tl
             FTK_P();
             if (p.cacheOptions->setIfChanged(value))
             {
+                if (auto memoryBudget = p.memoryBudget.lock())
                 {
-                    std::unique_lock<std::mutex> lock(p.thumbnailMutex.mutex);
-                    p.thumbnailMutex.cache.setMax(value.thumbnailMB * ftk::megabyte);
-                }
-                {
-                    std::unique_lock<std::mutex> lock(p.waveformMutex.mutex);
-                    p.waveformMutex.cache.setMax(value.waveformMB * ftk::megabyte);
+                    memoryBudget->setRequest(
+                        p.memoryID,
+                        (value.thumbnailMB + value.waveformMB) * ftk::megabyte);
                 }
+                _setCacheMax();
+            }
+        }
+
+        void ThumbnailSystem::_setCacheMax()
+        {
+            FTK_P();
+            const auto& options = p.cacheOptions->get();
+            {
+                std::unique_lock<std::mutex> lock(p.thumbnailMutex.mutex);
+                p.thumbnailMutex.cache.setMax(options.thumbnailMB * p.memoryScale * ftk::megabyte);
+            }
+            {
+                std::unique_lock<std::mutex> lock(p.waveformMutex.mutex);
+                p.waveformMutex.cache.setMax(options.waveformMB * p.memoryScale * ftk::megabyte);
             }
         }
 
@@ -877,10 +1025,11 @@ namespace tl
                             }
                             if (size.isValid())
                             {
-                                if (ftk::gl::doCreate(
-                                    p.thumbnailThread.buffer,
-                                    size,
-                                    ftk::gl::TextureType::RGBA_U8))
+                                if (!p.thumbnailThread.cpuRender &&
+                                    ftk::gl::doCreate(
+                                        p.thumbnailThread.buffer,
+                                        size,
+                                        ftk::gl::TextureType::RGBA_U8))
                                 {
                                     p.thumbnailThread.buffer = ftk::gl::OffscreenBuffer::create(
                                         size,
@@ -895,11 +1044,11 @@ namespace tl
                                 {
                                     const auto videoData = videoRequest.get();
                                     if (p.thumbnailThread.render &&
-                                        p.thumbnailThread.buffer &&
+                                        (p.thumbnailThread.buffer || p.thumbnailThread.cpuRender) &&
                                         videoData.image &&
                                         p.thumbnailThread.running)
                                     {
-                                        ftk::gl::OffscreenBufferBinding binding(p.thumbnailThread.buffer);
+                                        const auto binding = p.thumbnailBind();
                                         p.thumbnailThread.render->begin(size);
                                         ftk::ImageOptions imageOptions;
                                         imageOptions.cache = false;
@@ -911,17 +1060,7 @@ namespace tl
                                             ftk::Color4F(1.F, 1.F, 1.F),
                                             imageOptions);
                                         p.thumbnailThread.render->end();
-                                        image = ftk::Image::create(
-                                            ftk::ImageInfo(size.w, size.h, ftk::ImageType::RGBA_U8));
-                                        glPixelStorei(GL_PACK_ALIGNMENT, 1);
-                                        glReadPixels(
-                                            0,
-                                            0,
-                                            size.w,
-                                            size.h,
-                                            GL_RGBA,
-                                            GL_UNSIGNED_BYTE,
-                                            image->getData());
+                                        image = p.thumbnailRead(size);
                                     }
                                 }
                             }
@@ -966,36 +1105,26 @@ namespace tl
                             }
                             if (size.isValid())
                             {
-                                if (ftk::gl::doCreate(
-                                    p.thumbnailThread.buffer,
-                                    size,
-                                    ftk::gl::TextureType::RGBA_U8))
+                                if (!p.thumbnailThread.cpuRender &&
+                                    ftk::gl::doCreate(
+                                        p.thumbnailThread.buffer,
+                                        size,
+                                        ftk::gl::TextureType::RGBA_U8))
                                 {
                                     p.thumbnailThread.buffer = ftk::gl::OffscreenBuffer::create(
                                         size,
                                         ftk::gl::TextureType::RGBA_U8);
                                 }
-                                if (p.thumbnailThread.render && p.thumbnailThread.buffer)
+                                if (p.thumbnailThread.render &&
+                                    (p.thumbnailThread.buffer || p.thumbnailThread.cpuRender))
                                 {
-                                    ftk::gl::OffscreenBufferBinding binding(p.thumbnailThread.buffer);
+                                    const auto binding = p.thumbnailBind();
                                     p.thumbnailThread.render->begin(size);
                                     p.thumbnailThread.render->drawVideo(
                                         { videoData },
                                         { ftk::Box2I(0, 0, size.w, size.h) });
                                     p.thumbnailThread.render->end();
-                                    ftk::ImageInfo info(size.w,
-                                        size.h,
-                                        ftk::ImageType::RGBA_U8);
-                                    image = ftk::Image::create(info);
-                                    glPixelStorei(GL_PACK_ALIGNMENT, 1);
-                                    glReadPixels(
-                                        0,
-                                        0,
-                                        size.w,
-                                        size.h,
-                                        GL_RGBA,
-                                        GL_UNSIGNED_BYTE,
-                                        image->getData());
+                                    image = p.thumbnailRead(size);
                                 }
                             }
                         }
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <tlRender/Timeline/IRender.h>
+
 #include <tlRender/IO/IO.h>
 
 #include <ftk/Core/FileIO.h>
@@ -60,16 +62,24 @@ namespace tl
         class TL_API_TYPE ThumbnailSystem : public ftk::ISystem
         {
         protected:
-            ThumbnailSystem(const std::shared_ptr<ftk::Context>&);
+            ThumbnailSystem(
+                const std::shared_ptr<ftk::Context>&,
+                RenderType);
 
         public:
             TL_API ~ThumbnailSystem();
 
             TL_API void shutdown() override;
 
-            //! Create a new system.
+            //! Create a new system. The thumbnails are drawn with the CPU
+            //! renderer when that is asked for, or when there is no display
+            //! to make an OpenGL context with.
             TL_API static std::shared_ptr<ThumbnailSystem> create(
-                const std::shared_ptr<ftk::Context>&);
+                const std::shared_ptr<ftk::Context>&,
+                RenderType = RenderType::GL);
+
+            //! Get the renderer the thumbnails are drawn with.
+            TL_API RenderType getRenderType() const;
 
             //! Get information.
             TL_API InfoRequest getInfo(
@@ -139,6 +149,7 @@ namespace tl
             void _infoCancel();
             void _thumbnailCancel();
             void _waveformCancel();
+            void _setCacheMax();
 
             FTK_PRIVATE();
         };
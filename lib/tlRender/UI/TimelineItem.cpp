@@ -155,6 +155,7 @@ namespace tl
 
         void TimelineItem::Private::itemColorsUpdate()
         {
+            draw.init = true;
             for (auto& track : tracks)
             {
                 const auto trackColors = itemColors.find(track.index);
@@ -488,6 +489,7 @@ namespace tl
             if (!changed)
                 return;
             _displayOptions = value;
+            p.draw.init = true;
             if (mediaChanged)
             {
                 _cancelRequests();
@@ -508,6 +510,7 @@ namespace tl
         {
             IMouseWidget::setGeometry(value);
             FTK_P();
+            p.draw.init = true;
 
             int y =
                 p.size.labelHeight +
@@ -626,6 +629,7 @@ namespace tl
                     ftk::SizeRole::MarginSmall, event.displayScale);
                 p.size.itemFontInfo = event.style->getFont(ftk::FontType::Regular, event.displayScale);
                 p.size.itemFontMetrics = event.fontSystem->getMetrics(p.size.itemFontInfo);
+                p.draw.init = true;
                 _itemsTextUpdate(event);
             }
 
@@ -770,6 +774,7 @@ namespace tl
             }
             if (drawUpdate)
             {
+                p.draw.init = true;
                 setDrawUpdate();
             }
         }
@@ -1129,6 +1134,7 @@ namespace tl
         void TimelineItem::_itemsScaleUpdate()
         {
             FTK_P();
+            p.draw.init = true;
             for (auto& track : p.tracks)
             {
                 for (auto& item : track.items)
@@ -1212,6 +1218,7 @@ namespace tl
                     item.thumbnails.clear();
                     item.waveforms.clear();
                     item.media.clear();
+                    p.draw.init = true;
                 }
             }
 
@@ -1558,11 +1565,67 @@ namespace tl
             }
             p.active.assign(p.tracks.size(), Private::Range());
             p.activePrev = p.active;
+            p.draw.init = true;
         }
 
         void TimelineItem::_drawItems(
             const ftk::Box2I& drawRect,
             const ftk::DrawEvent& event)
+        {
+            FTK_P();
+            const ftk::Box2I& g = getGeometry();
+            const bool enabled = isEnabled();
+            if (p.draw.init ||
+                g != p.draw.geometry ||
+                drawRect != p.draw.drawRect ||
+                enabled != p.draw.enabled ||
+                p.visible != p.draw.visible)
+            {
+                p.draw.init = false;
+                p.draw.geometry = g;
+                p.draw.drawRect = drawRect;
+                p.draw.enabled = enabled;
+                p.draw.visible = p.visible;
+                _drawItemsUpdate(drawRect);
+            }
+
+            if (!p.draw.items.triangles.empty())
+            {
+                event.render->drawColorMesh(p.draw.items);
+            }
+            if (!p.draw.mediaBackgrounds.triangles.empty())
+            {
+                event.render->drawMesh(
+                    p.draw.mediaBackgrounds,
+                    ftk::Color4F(0.F, 0.F, 0.F));
+            }
+            if (!p.draw.waveforms.triangles.empty())
+            {
+                event.render->drawMesh(
+                    p.draw.waveforms,
+                    ftk::Color4F(1.F, 1.F, 1.F));
+            }
+
+            // Thumbnails are one draw call each because each is its own
+            // texture, but they are cached by the renderer instead of being
+            // uploaded again on every frame.
+            if (_displayOptions.thumbnails)
+            {
+                _drawThumbnails(drawRect, event);
+            }
+
+            if (!p.draw.markers.triangles.empty())
+            {
+                event.render->drawColorMesh(p.draw.markers);
+            }
+
+            if (!_displayOptions.minimize)
+            {
+                _drawItemLabels(drawRect, event);
+            }
+        }
+
+        void TimelineItem::_drawItemsUpdate(const ftk::Box2I& drawRect)
         {
             FTK_P();
             const ftk::Box2I& g = getGeometry();
@@ -1634,41 +1697,6 @@ namespace tl
                     }
                 }
             }
-
-            if (!p.draw.items.triangles.empty())
-            {
-                event.render->drawColorMesh(p.draw.items);
-            }
-            if (!p.draw.mediaBackgrounds.triangles.empty())
-            {
-                event.render->drawMesh(
-                    p.draw.mediaBackgrounds,
-                    ftk::Color4F(0.F, 0.F, 0.F));
-            }
-            if (!p.draw.waveforms.triangles.empty())
-            {
-                event.render->drawMesh(
-                    p.draw.waveforms,
-                    ftk::Color4F(1.F, 1.F, 1.F));
-            }
-
-            // Thumbnails are one draw call each because each is its own
-            // texture, but they are cached by the renderer instead of being
-            // uploaded again on every frame.
-            if (_displayOptions.thumbnails)
-            {
-                _drawThumbnails(drawRect, event);
-            }
-
-            if (!p.draw.markers.triangles.empty())
-            {
-                event.render->drawColorMesh(p.draw.markers);
-            }
-
-            if (!_displayOptions.minimize)
-            {
-                _drawItemLabels(drawRect, event);
-            }
         }
 
         void TimelineItem::_drawThumbnails(
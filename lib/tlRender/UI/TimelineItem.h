@@ -167,6 +167,7 @@ namespace tl
             void _drawItems(
                 const ftk::Box2I&,
                 const ftk::DrawEvent&);
+            void _drawItemsUpdate(const ftk::Box2I&);
             void _drawThumbnails(
                 const ftk::Box2I&,
                 const ftk::DrawEvent&);
@@ -142,6 +142,11 @@ namespace tl
             {
                 size_t begin = 0;
                 size_t end = 0;
+
+                bool operator == (const Range& other) const
+                {
+                    return begin == other.begin && end == other.end;
+                }
             };
 
             //! The items to draw, and the wider band of items to ask the
@@ -192,10 +197,19 @@ namespace tl
             };
             SizeData size;
 
-            //! Meshes reused between frames so that batching does not allocate
-            //! every time the playhead moves.
+            //! Meshes kept between frames. They are built again only when
+            //! what they were built from changes -- the scale, the offset, the
+            //! items in view, the options, or media arriving -- so a frame
+            //! where only the playhead moved costs the draw calls and nothing
+            //! else, however many items are in view.
             struct DrawData
             {
+                bool init = true;
+                ftk::Box2I geometry;
+                ftk::Box2I drawRect;
+                bool enabled = true;
+                std::vector<Range> visible;
+
                 ftk::TriMesh2F items;
                 ftk::TriMesh2F markers;
                 ftk::TriMesh2F mediaBackgrounds;
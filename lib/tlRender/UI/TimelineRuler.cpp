@@ -81,9 +81,27 @@ namespace tl
 
             ftk::TriMesh2F cacheMesh;
 
+            //! The ticks and their labels, kept between frames. The ruler is
+            //! drawn again every time the playhead moves, but the ticks only
+            //! move when the view does, so they are laid out and their glyphs
+            //! looked up once per change of view rather than once per frame.
+            struct TickData
+            {
+                bool init = true;
+                ftk::Box2I geometry;
+                double scale = 0.0;
+                int scrollPos = 0;
+                OTIO_NS::RationalTime offset;
+                OTIO_NS::TimeRange timeRange;
+                std::vector<ftk::Box2I> rects;
+                std::vector<std::pair<ftk::V2I, std::vector<std::shared_ptr<ftk::Glyph> > > > labels;
+            };
+            TickData ticks;
+
             std::shared_ptr<ftk::Observer<OTIO_NS::RationalTime> > currentTimeObserver;
             std::shared_ptr<ftk::Observer<OTIO_NS::TimeRange> > inOutRangeObserver;
             std::shared_ptr<ftk::Observer<PlayerCacheInfo> > cacheInfoObserver;
+            std::shared_ptr<ftk::Observer<bool> > timeUnitsObserver;
         };
 
         void TimelineRuler::_init(
@@ -93,7 +111,7 @@ namespace tl
         {
             IMouseWidget::_init(context, "tl::ui::TimelineRuler", parent);
             FTK_P();
-            p.data = data;
+            setItemData(data);
             p.scrub = ftk::Observable<bool>::create(false);
             p.timeScrub = ftk::Observable<std::optional<OTIO_NS::RationalTime> >::create();
 
@@ -124,6 +142,18 @@ namespace tl
         {
             FTK_P();
             p.data = value;
+            p.timeUnitsObserver.reset();
+            if (p.data && p.data->timeUnitsModel)
+            {
+                p.timeUnitsObserver = ftk::Observer<bool>::create(
+                    p.data->timeUnitsModel->observeTimeUnitsChanged(),
+                    [this](bool)
+                    {
+                        _p->ticks.init = true;
+                        setDrawUpdate();
+                    });
+            }
+            p.ticks.init = true;
             setDrawUpdate();
         }
 
@@ -404,6 +434,7 @@ namespace tl
                 p.size.fontInfo = event.style->getFont(
                     ftk::FontType::Mono, event.displayScale);
                 p.size.fontMetrics = event.fontSystem->getMetrics(p.size.fontInfo);
+                p.ticks.init = true;
             }
 
             // The width is whatever it is given: the ruler is as wide as the
@@ -451,6 +482,7 @@ namespace tl
             _drawInOutPoints(drawRect, event);
             _drawFrameMarkers(drawRect, event);
             _drawCacheInfo(drawRect, event);
+            _ticksUpdate(event);
             _drawTimeLabels(drawRect, event);
             _drawTimeTicks(drawRect, event);
             _drawCurrentTime(drawRect, event);
@@ -592,36 +624,99 @@ namespace tl
             }
         }
 
+        void TimelineRuler::_ticksUpdate(const ftk::DrawEvent& event)
+        {
+            FTK_P();
+            const ftk::Box2I& g = getGeometry();
+            if (!p.ticks.init &&
+                g == p.ticks.geometry &&
+                p.scale == p.ticks.scale &&
+                p.scrollPos == p.ticks.scrollPos &&
+                compareExact(p.offset, p.ticks.offset) &&
+                compareExact(p.timeRange, p.ticks.timeRange))
+                return;
+            p.ticks.init = false;
+            p.ticks.geometry = g;
+            p.ticks.scale = p.scale;
+            p.ticks.scrollPos = p.scrollPos;
+            p.ticks.offset = p.offset;
+            p.ticks.timeRange = p.timeRange;
+            p.ticks.rects.clear();
+            p.ticks.labels.clear();
+
+            const double duration = p.timeRange.duration().rescaled_to(1.0).value();
+            if (p.timeRange.duration().value() <= 0.0 || duration <= 0.0)
+                return;
+            const double rate = p.timeRange.duration().rate();
+            const int w = duration * p.scale;
+
+            // The frame ticks, once a frame is wide enough that they are
+            // marks rather than a solid band. Shorter than the second ticks,
+            // so the two read apart.
+            const int frameTick = 1.0 / p.timeRange.duration().value() * w;
+            if (frameTick >= p.size.handle)
+            {
+                const OTIO_NS::RationalTime t0 = _posToTime(g.min.x);
+                const OTIO_NS::RationalTime t1 = _posToTime(g.max.x);
+                const OTIO_NS::RationalTime inc(1.0, rate);
+                for (OTIO_NS::RationalTime t = t0; t <= t1; t += inc)
+                {
+                    p.ticks.rects.emplace_back(ftk::Box2I(
+                        timeToPos(t),
+                        g.min.y +
+                        p.size.margin +
+                        p.size.fontMetrics.lineHeight,
+                        p.size.border,
+                        p.size.margin +
+                        p.size.border * 4));
+                }
+            }
+
+            const double seconds = _getSecondsInc(event.fontSystem);
+            if (seconds > 0.0)
+            {
+                const double t0 = std::floor(
+                    _posToTime(g.min.x).rescaled_to(1.0).value() / seconds) * seconds;
+                const double t1 = std::ceil(
+                    _posToTime(g.max.x).rescaled_to(1.0).value() / seconds) * seconds;
+                for (double t = t0; t <= t1; t += seconds)
+                {
+                    const int x = timeToPos(OTIO_NS::RationalTime(t, 1.0));
+                    p.ticks.rects.emplace_back(ftk::Box2I(
+                        x,
+                        g.min.y +
+                        p.size.margin +
+                        p.size.fontMetrics.lineHeight,
+                        p.size.border,
+                        p.size.margin +
+                        p.size.fontMetrics.lineHeight +
+                        p.size.margin +
+                        p.size.border * 4));
+                    const std::string label = _timeLabel(
+                        OTIO_NS::RationalTime(t, 1.0).rescaled_to(rate));
+                    p.ticks.labels.emplace_back(
+                        ftk::V2I(
+                            x + p.size.border + p.size.margin,
+                            g.min.y + p.size.margin),
+                        event.fontSystem->getGlyphs(label, p.size.fontInfo));
+                }
+            }
+        }
+
         void TimelineRuler::_drawTimeLabels(
             const ftk::Box2I& drawRect,
             const ftk::DrawEvent& event)
         {
             FTK_P();
-            if (p.timeRange.duration().value() > 0.0)
+            const ftk::Color4F color =
+                event.style->getColorRole(ftk::ColorRole::TextDisabled);
+            for (const auto& label : p.ticks.labels)
             {
-                const ftk::Box2I& g = getGeometry();
-                const double rate = p.timeRange.duration().rate();
-                const double seconds = _getSecondsInc(event.fontSystem);
-                if (seconds > 0.0)
-                {
-                    const double t0 = std::floor(
-                        _posToTime(g.min.x).rescaled_to(1.0).value() / seconds) * seconds;
-                    const double t1 = std::ceil(
-                        _posToTime(g.max.x).rescaled_to(1.0).value() / seconds) * seconds;
-                    for (double t = t0; t <= t1; t += seconds)
-                    {
-                        const int x = timeToPos(OTIO_NS::RationalTime(t, 1.0));
-                        const std::string label = _timeLabel(
-                            OTIO_NS::RationalTime(t, 1.0).rescaled_to(rate));
-                        event.render->drawText(
-                            event.fontSystem->getGlyphs(label, p.size.fontInfo),
-                            p.size.fontMetrics,
-                            ftk::V2I(
-                                x + p.size.border + p.size.margin,
-                                g.min.y + p.size.margin),
-                            event.style->getColorRole(ftk::ColorRole::TextDisabled));
-                    }
-                }
+                event.render->drawText(
+                    label.second,
+                    p.size.fontMetrics,
+                    label.first,
+                    color);
             }
         }
 
@@ -630,64 +725,12 @@ namespace tl
             const ftk::DrawEvent& event)
         {
             FTK_P();
-            if (p.timeRange.duration().value() > 0.0)
+            // Every tick in one call, however many frames are in view.
+            if (!p.ticks.rects.empty())
             {
-                const ftk::Box2I& g = getGeometry();
-                const double duration = p.timeRange.duration().rescaled_to(1.0).value();
-                const int w = duration * p.scale;
-                std::vector<ftk::Box2I> rects;
-
-                // The frame ticks, once a frame is wide enough that they are
-                // marks rather than a solid band. Shorter than the second
-                // ticks, so the two read apart.
-                const int frameTick = 1.0 / p.timeRange.duration().value() * w;
-                if (duration > 0.0 && frameTick >= p.size.handle)
-                {
-                    const OTIO_NS::RationalTime t0 = _posToTime(g.min.x);
-                    const OTIO_NS::RationalTime t1 = _posToTime(g.max.x);
-                    const OTIO_NS::RationalTime inc(
-                        1.0, p.timeRange.duration().rate());
-                    for (OTIO_NS::RationalTime t = t0; t <= t1; t += inc)
-                    {
-                        rects.emplace_back(ftk::Box2I(
-                            timeToPos(t),
-                            g.min.y +
-                            p.size.margin +
-                            p.size.fontMetrics.lineHeight,
-                            p.size.border,
-                            p.size.margin +
-                            p.size.border * 4));
-                    }
-                }
-
-                const double seconds = _getSecondsInc(event.fontSystem);
-                if (duration > 0.0 && seconds > 0.0)
-                {
-                    const double t0 = std::floor(
-                        _posToTime(g.min.x).rescaled_to(1.0).value() / seconds) * seconds;
-                    const double t1 = std::ceil(
-                        _posToTime(g.max.x).rescaled_to(1.0).value() / seconds) * seconds;
-                    for (double t = t0; t <= t1; t += seconds)
-                    {
-                        rects.emplace_back(ftk::Box2I(
-                            timeToPos(OTIO_NS::RationalTime(t, 1.0)),
-                            g.min.y +
-                            p.size.margin +
-                            p.size.fontMetrics.lineHeight,
-                            p.size.border,
-                            p.size.margin +
-                            p.size.fontMetrics.lineHeight +
-                            p.size.margin +
-                            p.size.border * 4));
-                    }
-                }
-
-                if (!rects.empty())
-                {
-                    event.render->drawRects(
-                        rects,
-                        event.style->getColorRole(ftk::ColorRole::TextDisabled));
-                }
+                event.render->drawRects(
+                    p.ticks.rects,
+                    event.style->getColorRole(ftk::ColorRole::TextDisabled));
             }
         }
 
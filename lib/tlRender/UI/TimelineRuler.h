@@ -92,6 +92,7 @@ namespace tl
             void _drawInOutPoints(const ftk::Box2I&, const ftk::DrawEvent&);
             void _drawFrameMarkers(const ftk::Box2I&, const ftk::DrawEvent&);
             void _drawCacheInfo(const ftk::Box2I&, const ftk::DrawEvent&);
+            void _ticksUpdate(const ftk::DrawEvent&);
             void _drawTimeLabels(const ftk::Box2I&, const ftk::DrawEvent&);
             void _drawTimeTicks(const ftk::Box2I&, const ftk::DrawEvent&);
             void _drawCurrentTime(const ftk::Box2I&, const ftk::DrawEvent&);
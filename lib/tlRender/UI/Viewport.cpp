@@ -22,6 +22,7 @@ namespace tl
         struct Viewport::Private
         {
             std::shared_ptr<ftk::Observable<CompareOptions> > compareOptions;
+            std::shared_ptr<ftk::Observable<CompareStats> > compareStats;
             std::shared_ptr<ftk::Observable<OCIOOptions> > ocioOptions;
             std::function<std::string(
                 const std::string&,
@@ -99,6 +100,7 @@ namespace tl
             setVStretch(ftk::Stretch::Expanding);
 
             p.compareOptions = ftk::Observable<CompareOptions>::create();
+            p.compareStats = ftk::Observable<CompareStats>::create();
             p.ocioOptions = ftk::Observable<OCIOOptions>::create();
             p.lutOptions = ftk::Observable<LUTOptions>::create();
             p.imageOptions = ftk::ObservableList<ftk::ImageOptions>::create();
@@ -154,6 +156,16 @@ namespace tl
             }
         }
 
+        const CompareStats& Viewport::getCompareStats() const
+        {
+            return _p->compareStats->get();
+        }
+
+        std::shared_ptr<ftk::IObservable<CompareStats> > Viewport::observeCompareStats() const
+        {
+            return _p->compareStats;
+        }
+
         const OCIOOptions& Viewport::getOCIOOptions() const
         {
             return _p->ocioOptions->get();
@@ -666,6 +678,25 @@ namespace tl
             p.size.sizeHint = event.style->getSizeRole(ftk::SizeRole::ScrollArea, event.displayScale);
         }
 
+        void Viewport::tickEvent(
+            bool parentsVisible,
+            bool parentsEnabled,
+            const ftk::TickEvent& event)
+        {
+            IWidget::tickEvent(parentsVisible, parentsEnabled, event);
+            FTK_P();
+
+            // The window is drawn and swapped once per display refresh while
+            // there is something to draw, so during playback a draw is asked
+            // for on every tick to report every refresh; see drawEvent(). The
+            // video is only rendered again when the frame changes, the other
+            // draws composite the buffers that are already there.
+            if (p.player && p.fpsData.has_value() && parentsVisible)
+            {
+                setDrawUpdate();
+            }
+        }
+
         void Viewport::drawEvent(const ftk::Box2I& drawRect, const ftk::DrawEvent& event)
         {
             IWidget::drawEvent(drawRect, event);
@@ -802,6 +833,7 @@ namespace tl
                             compareOptions,
                             p.colorBuffer->get());
                     }
+                    p.compareStats->setIfChanged(render->getCompareStats());
 
                     // Draw the background buffer.
                     if (p.bgBuffer)
@@ -863,6 +895,15 @@ namespace tl
             }
 
             _drawMissingIndicators(event);
+
+            // Each draw during playback is reported to the player as a
+            // refresh, once the frame is drawn. The player paces playback
+            // from them, so one must arrive for every refresh, whether or not
+            // the frame changed.
+            if (p.player && p.fpsData.has_value())
+            {
+                p.player->present(std::chrono::steady_clock::now());
+            }
         }
 
         void Viewport::_drawMissingIndicators(const ftk::DrawEvent& event)
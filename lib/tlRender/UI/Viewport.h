@@ -43,6 +43,14 @@ namespace tl
             TL_API std::shared_ptr<ftk::IObservable<CompareOptions> > observeCompareOptions() const;
             TL_API void setCompareOptions(const CompareOptions&);
 
+            //! Get the statistics of the difference comparison, measured
+            //! each time it is drawn with CompareOptions::differenceStats
+            //! on.
+            TL_API const CompareStats& getCompareStats() const;
+
+            //! Observe the statistics of the difference comparison.
+            TL_API std::shared_ptr<ftk::IObservable<CompareStats> > observeCompareStats() const;
+
             ///@}
 
             //! \name OpenColorIO Options
@@ -270,6 +278,10 @@ namespace tl
             TL_API ftk::Size2I getSizeHint() const override;
             TL_API void setGeometry(const ftk::Box2I&) override;
             TL_API void sizeHintEvent(const ftk::SizeHintEvent&) override;
+            TL_API void tickEvent(
+                bool,
+                bool,
+                const ftk::TickEvent&) override;
             TL_API void drawEvent(const ftk::Box2I&, const ftk::DrawEvent&) override;
             TL_API void mouseEnterEvent(ftk::MouseEnterEvent&) override;
             TL_API void mouseLeaveEvent() override;
@@ -9,16 +9,26 @@
 #include <tlRender/TimelineTest/BackgroundOptionsTest.h>
 #include <tlRender/TimelineTest/ColorOptionsTest.h>
 #include <tlRender/TimelineTest/CompareOptionsTest.h>
+#include <tlRender/TimelineTest/DiskCacheTest.h>
 #include <tlRender/TimelineTest/DisplayOptionsTest.h>
+#include <tlRender/TimelineTest/FlattenTest.h>
 #include <tlRender/TimelineTest/ForegroundOptionsTest.h>
+#include <tlRender/TimelineTest/FrameCacheTest.h>
+#include <tlRender/TimelineTest/ImageCompressTest.h>
+#include <tlRender/TimelineTest/MemoryBudgetTest.h>
 #include <tlRender/TimelineTest/PlayerOptionsTest.h>
 #include <tlRender/TimelineTest/PlayerTest.h>
+#include <tlRender/TimelineTest/PresentClockTest.h>
 #include <tlRender/TimelineTest/TimeUnitsTest.h>
+#include <tlRender/TimelineTest/TimelineOpenTest.h>
 #include <tlRender/TimelineTest/TimelineTest.h>
 #include <tlRender/TimelineTest/UtilTest.h>
 
 #include <tlRender/GLTest/RenderTest.h>
 
+#include <tlRender/CPUTest/RenderTest.h>
+
+#include <tlRender/IOTest/DPXTest.h>
 #include <tlRender/IOTest/IOTest.h>
 #include <tlRender/IOTest/PNGTest.h>
 #include <tlRender/IOTest/RequestQueueTest.h>
@@ -114,6 +124,7 @@ namespace tl
 
             // I/O tests.
             p.tests.push_back(io_tests::IOTest::create(context));
+            p.tests.push_back(io_tests::DPXTest::create(context));
             p.tests.push_back(io_tests::PNGTest::create(context));
             p.tests.push_back(io_tests::RequestQueueTest::create(context));
 #if defined(TLRENDER_FFMPEG_PLUGIN)
@@ -135,16 +146,26 @@ namespace tl
                 p.tests.push_back(gl_test::RenderTest::create(context));
             }
 
+            // CPU tests.
+            p.tests.push_back(cpu_test::RenderTest::create(context));
+
             // Timeline tests.
             p.tests.push_back(timeline_tests::AudioSystemTest::create(context));
             p.tests.push_back(timeline_tests::BackgroundOptionsTest::create(context));
             p.tests.push_back(timeline_tests::ColorOptionsTest::create(context));
             p.tests.push_back(timeline_tests::CompareOptionsTest::create(context));
+            p.tests.push_back(timeline_tests::DiskCacheTest::create(context));
             p.tests.push_back(timeline_tests::DisplayOptionsTest::create(context));
+            p.tests.push_back(timeline_tests::FlattenTest::create(context));
             p.tests.push_back(timeline_tests::ForegroundOptionsTest::create(context));
+            p.tests.push_back(timeline_tests::FrameCacheTest::create(context));
+            p.tests.push_back(timeline_tests::ImageCompressTest::create(context));
+            p.tests.push_back(timeline_tests::MemoryBudgetTest::create(context));
             p.tests.push_back(timeline_tests::PlayerOptionsTest::create(context));
             p.tests.push_back(timeline_tests::PlayerTest::create(context));
+            p.tests.push_back(timeline_tests::PresentClockTest::create(context));
             p.tests.push_back(timeline_tests::TimeUnitsTest::create(context));
+            p.tests.push_back(timeline_tests::TimelineOpenTest::create(context));
             p.tests.push_back(timeline_tests::TimelineTest::create(context));
             p.tests.push_back(timeline_tests::UtilTest::create(context));
 
@@ -1,10 +1,16 @@
 # SPDX-License-Identifier: BSD-3-Clause
 # Copyright Contributors to the tlRender project.
 
+import ftkPy as ftk
 import tlRenderPy as tl
 
 import unittest
 
+try:
+    import numpy as np
+except ImportError:
+    np = None
+
 class HDRTest(unittest.TestCase):
 
     def test_members(self):
@@ -58,5 +64,58 @@ class AudioResampleTest(unittest.TestCase):
         self.assertEqual(inputInfo, resample.inputInfo)
         self.assertEqual(outputInfo, resample.outputInfo)
 
+@unittest.skipIf(np is None, "NumPy is not installed")
+class ArrayTest(unittest.TestCase):
+
+    def test_audio(self):
+        info = tl.AudioInfo()
+        info.channelCount = 2
+        info.type = tl.AudioType.S16
+        info.sampleRate = 48000
+        audio = tl.Audio(info, 100)
+        a = tl.audioArray(audio)
+        self.assertEqual((100, 2), a.shape)
+        self.assertEqual(np.int16, a.dtype)
+        a[:] = 0
+        a[10, 1] = 1234
+        b = np.asarray(audio)
+        self.assertEqual(1234, b[10, 1])
+        self.assertTrue(np.shares_memory(a, b))
+
+    def test_image_padded(self):
+        # Rows of three RGB pixels are nine bytes, padded to twelve.
+        info = ftk.ImageInfo(3, 2, ftk.ImageType.RGB_U8)
+        layout = ftk.ImageLayout()
+        layout.alignment = 4
+        info.layout = layout
+        image = ftk.Image(info)
+        a = tl.imageArray(image)
+        self.assertEqual((2, 3, 3), a.shape)
+        self.assertEqual(np.uint8, a.dtype)
+        self.assertEqual((12, 3, 1), a.strides)
+        values = np.arange(18, dtype=np.uint8).reshape(2, 3, 3)
+        a[:] = values
+        b = np.asarray(tl.imageArray(image))
+        self.assertTrue(np.array_equal(values, b))
+        self.assertTrue(np.shares_memory(a, b))
+
+        # The array keeps the image alive.
+        del image
+        self.assertTrue(np.array_equal(values, b))
+
+    def test_image_f16(self):
+        image = ftk.Image(ftk.ImageInfo(2, 2, ftk.ImageType.RGBA_F16))
+        a = tl.imageArray(image)
+        self.assertEqual((2, 2, 4), a.shape)
+        self.assertEqual(np.float16, a.dtype)
+        values = np.array(
+            [[[0.0, 0.5, 1.0, 1.0], [-2.0, 0.25, 4.0, 1.0]],
+             [[65504.0, 0.125, -0.5, 0.0], [1.5, 2.5, 3.5, 0.75]]],
+            dtype=np.float16)
+        a[:] = values
+        b = np.asarray(tl.imageArray(image))
+        self.assertEqual(np.float16, b.dtype)
+        self.assertTrue(np.array_equal(values, b))
+
 if __name__ == '__main__':
     unittest.main()
@@ -8,6 +8,7 @@ import opentimelineio as otio
 
 import os
 import tempfile
+import time
 import unittest
 
 class OCIOOptionsTest(unittest.TestCase):
@@ -258,5 +259,51 @@ class TimelineTest(unittest.TestCase):
                 otio.opentime.RationalTime(6, 24),
                 player.inOutRange.start_time)
 
+class FramesTest(unittest.TestCase):
+
+    def setUp(self):
+        self.context = ftk.Context()
+        tl.init(self.context)
+
+    def test_video(self):
+        with tempfile.TemporaryDirectory() as dir:
+            fileName = TimelineTest._writeGapTimeline(dir)
+            timeline = tl.Timeline(self.context, fileName)
+            frames = tl.VideoFrames(timeline, prefetch=4)
+            self.assertEqual(24, len(frames))
+            t0 = time.perf_counter()
+            times = [frame.time for frame in frames]
+            t1 = time.perf_counter()
+            self.assertEqual(24, len(times))
+            self.assertEqual(otio.opentime.RationalTime(0, 24), times[0])
+            self.assertEqual(otio.opentime.RationalTime(23, 24), times[-1])
+            print("Video frames/sec: {0:.1f}".format(len(times) / max(t1 - t0, 1e-6)))
+
+            frames = tl.VideoFrames(
+                timeline,
+                otio.opentime.TimeRange(
+                    otio.opentime.RationalTime(6, 24),
+                    otio.opentime.RationalTime(12, 24)))
+            times = [frame.time for frame in frames]
+            self.assertEqual(12, len(times))
+            self.assertEqual(otio.opentime.RationalTime(6, 24), times[0])
+
+    def test_audio(self):
+        with tempfile.TemporaryDirectory() as dir:
+            fileName = TimelineTest._writeGapTimeline(dir)
+            timeline = tl.Timeline(self.context, fileName)
+            frames = tl.AudioFrames(timeline)
+            self.assertEqual(1, len(frames))
+            seconds = [frame.seconds for frame in frames]
+            self.assertEqual([0], seconds)
+
+    def test_cancel(self):
+        with tempfile.TemporaryDirectory() as dir:
+            fileName = TimelineTest._writeGapTimeline(dir)
+            timeline = tl.Timeline(self.context, fileName)
+            frames = tl.VideoFrames(timeline, prefetch=16)
+            next(frames)
+            del frames
+
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include "AudioBench.h"
+
+#include <tlRender/Core/AudioResample.h>
+
+#include <ftk/Core/Format.h>
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+namespace tl
+{
+    namespace bench
+    {
+        namespace
+        {
+            //! Create a second of a tone. Each channel has its own
+            //! frequency, so the channels are not copies of each other.
+            std::shared_ptr<Audio> createTone(const AudioInfo& info, float frequency)
+            {
+                auto out = Audio::create(info, info.sampleRate);
+                const size_t sampleCount = out->getSampleCount();
+                const int channelCount = info.channelCount;
+                for (size_t i = 0; i < sampleCount; ++i)
+                {
+                    for (int c = 0; c < channelCount; ++c)
+                    {
+                        const float v = .5F * std::sin(
+                            2.F * 3.14159265F * frequency * (1 + c) * i / info.sampleRate);
+                        const size_t j = i * channelCount + c;
+                        switch (info.type)
+                        {
+                        case AudioType::S16:
+                            reinterpret_cast<int16_t*>(out->getData())[j] =
+                                static_cast<int16_t>(v * std::numeric_limits<int16_t>::max());
+                            break;
+                        case AudioType::S32:
+                            reinterpret_cast<int32_t*>(out->getData())[j] =
+                                static_cast<int32_t>(v * std::numeric_limits<int32_t>::max());
+                            break;
+                        case AudioType::F32:
+                            reinterpret_cast<float*>(out->getData())[j] = v;
+                            break;
+                        case AudioType::F64:
+                            reinterpret_cast<double*>(out->getData())[j] = v;
+                            break;
+                        default: break;
+                        }
+                    }
+                }
+                return out;
+            }
+
+            std::string getInfoLabel(const AudioInfo& info)
+            {
+                std::stringstream ss;
+                ss << info.channelCount << "ch_" << info.type << "_" << info.sampleRate;
+                return ss.str();
+            }
+
+            nlohmann::json getInfoJSON(const AudioInfo& info)
+            {
+                std::stringstream ss;
+                ss << info.type;
+                nlohmann::json out;
+                out["channels"] = info.channelCount;
+                out["type"] = ss.str();
+                out["sampleRate"] = info.sampleRate;
+                return out;
+            }
+        }
+
+        AudioBench::AudioBench(
+            const std::shared_ptr<ftk::Context>& context,
+            const Settings& settings) :
+            IBench(context, "bench::AudioBench", settings)
+        {}
+
+        std::shared_ptr<AudioBench> AudioBench::create(
+            const std::shared_ptr<ftk::Context>& context,
+            const Settings& settings)
+        {
+            return std::shared_ptr<AudioBench>(new AudioBench(context, settings));
+        }
+
+        void AudioBench::run()
+        {
+            for (const auto type : { AudioType::S16, AudioType::F32 })
+            {
+                for (const size_t layerCount : { 2, 8 })
+                {
+                    _mix(type, layerCount);
+                }
+            }
+            // Resampling is done by FFmpeg; without it there is nothing to
+            // measure.
+#if defined(TLRENDER_FFMPEG)
+            _resample(
+                AudioInfo(2, AudioType::F32, 44100),
+                AudioInfo(2, AudioType::F32, 48000));
+            _resample(
+                AudioInfo(2, AudioType::S16, 48000),
+                AudioInfo(2, AudioType::F32, 44100));
+            _resample(
+                AudioInfo(6, AudioType::S32, 96000),
+                AudioInfo(2, AudioType::F32, 48000));
+#endif // TLRENDER_FFMPEG
+        }
+
+        void AudioBench::_mix(AudioType type, size_t layerCount)
+        {
+            // What the player mixes: a second of each track at a time.
+            const AudioInfo info(2, type, 48000);
+            std::vector<std::shared_ptr<Audio> > layers;
+            for (size_t i = 0; i < layerCount; ++i)
+            {
+                layers.push_back(createTone(info, 220.F * (1 + i)));
+            }
+            const size_t seconds = _settings.quick ? 10 : 100;
+            _print(ftk::Format("Mixing {0} layers of {1}").arg(layerCount).arg(getInfoLabel(info)));
+            const auto times = _time(
+                [&layers, seconds]
+                {
+                    for (size_t i = 0; i < seconds; ++i)
+                    {
+                        mixAudio(layers, .5F);
+                    }
+                });
+
+            const double median = getMedian(times);
+            nlohmann::json result;
+            result["audio"] = getInfoJSON(info);
+            result["layers"] = layerCount;
+            result["seconds"] = seconds;
+            result["milliseconds"] = getStats(times);
+            result["realTime"] = median > 0.0 ? seconds / median : 0.0;
+            _result(ftk::Format("Mix/{0}x{1}").arg(layerCount).arg(getInfoLabel(info)), result);
+        }
+
+        void AudioBench::_resample(const AudioInfo& input, const AudioInfo& output)
+        {
+            const auto audio = createTone(input, 440.F);
+            const size_t seconds = _settings.quick ? 10 : 60;
+            _print(ftk::Format("Resampling {0} to {1}").
+                arg(getInfoLabel(input)).
+                arg(getInfoLabel(output)));
+            // A resampler per run, since it holds on to the samples it has
+            // not given back yet.
+            const auto times = _time(
+                [&input, &output, &audio, seconds]
+                {
+                    auto resample = AudioResample::create(input, output);
+                    for (size_t i = 0; i < seconds; ++i)
+                    {
+                        resample->process(audio);
+                    }
+                    resample->flush();
+                });
+
+            const double median = getMedian(times);
+            nlohmann::json result;
+            result["input"] = getInfoJSON(input);
+            result["output"] = getInfoJSON(output);
+            result["seconds"] = seconds;
+            result["milliseconds"] = getStats(times);
+            result["realTime"] = median > 0.0 ? seconds / median : 0.0;
+            _result(
+                ftk::Format("Resample/{0}/{1}").
+                    arg(getInfoLabel(input)).
+                    arg(getInfoLabel(output)),
+                result);
+        }
+    }
+}
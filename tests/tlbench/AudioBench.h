@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include "IBench.h"
+
+namespace tl
+{
+    namespace bench
+    {
+        //! Audio mixing and resampling, as multiples of real time.
+        class AudioBench : public IBench
+        {
+        protected:
+            AudioBench(const std::shared_ptr<ftk::Context>&, const Settings&);
+
+        public:
+            static std::shared_ptr<AudioBench> create(
+                const std::shared_ptr<ftk::Context>&,
+                const Settings&);
+
+            void run() override;
+
+        private:
+            void _mix(AudioType, size_t layerCount);
+            void _resample(const AudioInfo& input, const AudioInfo& output);
+        };
+    }
+}
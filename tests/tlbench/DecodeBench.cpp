@@ -0,0 +1,281 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include "DecodeBench.h"
+
+#include <tlRender/IO/Decode.h>
+#include <tlRender/IO/System.h>
+#if defined(TLRENDER_EXR)
+#include <tlRender/IO/EXR.h>
+#endif // TLRENDER_EXR
+#if defined(TLRENDER_FFMPEG_PLUGIN)
+#include <tlRender/IO/FFmpeg.h>
+#endif // TLRENDER_FFMPEG_PLUGIN
+
+#include <ftk/Core/FileIO.h>
+#include <ftk/Core/Format.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace tl
+{
+    namespace bench
+    {
+        namespace
+        {
+            std::string getFileName(const std::string& name)
+            {
+                std::string out = "DecodeBench_" + name;
+                std::replace(out.begin(), out.end(), '/', '_');
+                return out;
+            }
+        }
+
+        DecodeBench::DecodeBench(
+            const std::shared_ptr<ftk::Context>& context,
+            const Settings& settings) :
+            IBench(context, "bench::DecodeBench", settings)
+        {}
+
+        std::shared_ptr<DecodeBench> DecodeBench::create(
+            const std::shared_ptr<ftk::Context>& context,
+            const Settings& settings)
+        {
+            return std::shared_ptr<DecodeBench>(new DecodeBench(context, settings));
+        }
+
+        void DecodeBench::run()
+        {
+            _still("PNG/RGB_U8", ".png", ftk::ImageType::RGB_U8);
+            _still("PNG/RGBA_U16", ".png", ftk::ImageType::RGBA_U16);
+#if defined(TLRENDER_EXR)
+            for (const auto compression : exr::getCompressionEnums())
+            {
+                IOOptions options;
+                options["OpenEXR/Compression"] = exr::to_string(compression);
+                _still(
+                    "OpenEXR/" + exr::to_string(compression),
+                    ".exr",
+                    ftk::ImageType::RGBA_F16,
+                    options);
+            }
+#endif // TLRENDER_EXR
+#if defined(TLRENDER_FFMPEG_PLUGIN)
+            auto writeSystem = _context->getSystem<WriteSystem>();
+            auto ffmpegPlugin = writeSystem->getPlugin<ffmpeg::WritePlugin>();
+            const std::vector<std::string> codecs = ffmpegPlugin ?
+                ffmpegPlugin->getCodecs() :
+                std::vector<std::string>();
+            // MP4 cannot tag the uncompressed codecs or ProRes; they
+            // require MOV.
+            for (const auto& i : std::vector<std::pair<std::string, std::string> >({
+                { "mjpeg", ".mp4" },
+                { "prores_ks", ".mov" },
+                { "v210", ".mov" } }))
+            {
+                if (std::find(codecs.begin(), codecs.end(), i.first) == codecs.end())
+                {
+                    _print(ftk::Format("No encoder: {0}").arg(i.first));
+                    continue;
+                }
+                IOOptions options;
+                options["FFmpeg/Codec"] = i.first;
+                _movie("FFmpeg/" + i.first, i.second, options);
+            }
+#endif // TLRENDER_FFMPEG_PLUGIN
+        }
+
+        void DecodeBench::_still(
+            const std::string& name,
+            const std::string& ext,
+            ftk::ImageType type,
+            const IOOptions& options)
+        {
+            auto readSystem = _context->getSystem<ReadSystem>();
+            auto writeSystem = _context->getSystem<WriteSystem>();
+            const ftk::Path path(
+                (_getTempDir() / (getFileName(name) + ".0001" + ext)).u8string());
+            auto writePlugin = writeSystem->getPlugin(path);
+            auto readPlugin = readSystem->getPlugin(path);
+            if (!writePlugin || !readPlugin)
+            {
+                return;
+            }
+            auto decode = readPlugin->decode();
+            if (!decode)
+            {
+                _print(ftk::Format("{0}: no decoder").arg(name));
+                return;
+            }
+            const ftk::Size2I size = _settings.quick ?
+                ftk::Size2I(320, 180) :
+                ftk::Size2I(1920, 1080);
+            const size_t frameCount = _settings.quick ? 4 : 24;
+            const ftk::ImageInfo info = writePlugin->getInfo(
+                ftk::ImageInfo(size, type),
+                options);
+            if (!info.isValid())
+            {
+                return;
+            }
+            _print(ftk::Format("{0}: writing {1} frames").arg(name).arg(frameCount));
+            const ftk::Path seqPath = _writeSeq(path, info, frameCount, options);
+
+            // The files are read into memory first, so that what is measured
+            // is the decoding rather than the disk.
+            std::vector<std::string> fileNames;
+            std::vector<std::vector<uint8_t> > bytes;
+            std::vector<ftk::MemFile> mem;
+            size_t byteCount = 0;
+            for (int64_t frame = 1; frame <= static_cast<int64_t>(frameCount); ++frame)
+            {
+                fileNames.push_back(seqPath.getFrame(frame, true));
+                auto fileIO = ftk::FileIO::create(fileNames.back(), ftk::FileMode::Read);
+                bytes.push_back(std::vector<uint8_t>(fileIO->getSize()));
+                fileIO->read(bytes.back().data(), bytes.back().size());
+                byteCount += bytes.back().size();
+            }
+            for (const auto& i : bytes)
+            {
+                mem.push_back(ftk::MemFile(nullptr, i.data(), i.size()));
+            }
+
+            _print(ftk::Format("{0}: decoding").arg(name));
+            const auto seconds = _time(
+                [&decode, &fileNames, &mem]
+                {
+                    for (size_t i = 0; i < fileNames.size(); ++i)
+                    {
+                        const auto videoData = decode->readVideo(
+                            fileNames[i],
+                            &mem[i],
+                            OTIO_NS::RationalTime(static_cast<double>(1 + i), 24.0));
+                        if (!videoData.image)
+                        {
+                            throw std::runtime_error(
+                                ftk::Format("Cannot decode: \"{0}\"").arg(fileNames[i]));
+                        }
+                    }
+                });
+
+            const double median = getMedian(seconds);
+            nlohmann::json result;
+            result["plugin"] = readPlugin->getPluginName();
+            result["options"] = options;
+            result["image"] = getImageJSON(info);
+            result["frames"] = frameCount;
+            result["bytesPerFrame"] = byteCount / frameCount;
+            result["milliseconds"] = getStats(seconds);
+            result["fps"] = median > 0.0 ? frameCount / median : 0.0;
+            result["megapixelsPerSecond"] = median > 0.0 ?
+                frameCount * size.w * size.h / median / 1000000.0 :
+                0.0;
+            _result(name, result);
+        }
+
+        void DecodeBench::_movie(
+            const std::string& name,
+            const std::string& ext,
+            const IOOptions& options)
+        {
+            auto readSystem = _context->getSystem<ReadSystem>();
+            auto writeSystem = _context->getSystem<WriteSystem>();
+            // Named so that nothing at the end of it reads as a frame number.
+            const ftk::Path path(
+                (_getTempDir() / (getFileName(name) + "_movie" + ext)).u8string());
+            auto writePlugin = writeSystem->getPlugin(path);
+            if (!writePlugin)
+            {
+                return;
+            }
+            const ftk::Size2I size = _settings.quick ?
+                ftk::Size2I(320, 180) :
+                ftk::Size2I(1920, 1080);
+            const size_t frameCount = _settings.quick ? 12 : 96;
+            const ftk::ImageInfo info = writePlugin->getInfo(
+                ftk::ImageInfo(size, ftk::ImageType::RGB_U8),
+                options);
+            if (!info.isValid())
+            {
+                return;
+            }
+
+            // The pictures repeat, which is cheaper to generate and does not
+            // change what an intra-frame codec has to do.
+            _print(ftk::Format("{0}: writing {1} frames").arg(name).arg(frameCount));
+            {
+                std::vector<std::shared_ptr<ftk::Image> > images;
+                for (int i = 0; i < 8; ++i)
+                {
+                    images.push_back(_createImage(info, i));
+                }
+                IOInfo writeInfo;
+                writeInfo.video.push_back(info);
+                writeInfo.videoTime = OTIO_NS::TimeRange(
+                    OTIO_NS::RationalTime(0.0, 24.0),
+                    OTIO_NS::RationalTime(static_cast<double>(frameCount), 24.0));
+                auto write = writeSystem->write(path, writeInfo, options);
+                if (!write)
+                {
+                    return;
+                }
+                for (size_t i = 0; i < frameCount; ++i)
+                {
+                    write->writeVideo(
+                        OTIO_NS::RationalTime(static_cast<double>(i), 24.0),
+                        images[i % images.size()]);
+                }
+                write->finish();
+            }
+
+            // A movie reader carries state, so the frames are read in order
+            // through one reader, which is how playback reads them. Opening
+            // it is left out of the time.
+            _print(ftk::Format("{0}: decoding").arg(name));
+            std::string pluginName;
+            std::vector<double> seconds;
+            for (size_t i = 0; i < _settings.iterations; ++i)
+            {
+                auto read = readSystem->videoRead(path);
+                if (!read)
+                {
+                    return;
+                }
+                const IOInfo ioInfo = read->getInfo().get();
+                if (!ioInfo.videoTime.has_value())
+                {
+                    return;
+                }
+                pluginName = readSystem->getPlugin(path)->getPluginName();
+                const auto t0 = std::chrono::steady_clock::now();
+                const OTIO_NS::TimeRange& timeRange = ioInfo.videoTime.value();
+                const double rate = timeRange.duration().rate();
+                for (int64_t frame = 0; frame < timeRange.duration().value(); ++frame)
+                {
+                    read->readVideo(
+                        timeRange.start_time() +
+                        OTIO_NS::RationalTime(static_cast<double>(frame), rate)).get();
+                }
+                const auto t1 = std::chrono::steady_clock::now();
+                const std::chrono::duration<double> diff = t1 - t0;
+                seconds.push_back(diff.count());
+            }
+
+            const double median = getMedian(seconds);
+            nlohmann::json result;
+            result["plugin"] = pluginName;
+            result["options"] = options;
+            result["image"] = getImageJSON(info);
+            result["frames"] = frameCount;
+            result["bytesPerFrame"] = std::filesystem::file_size(
+                std::filesystem::u8path(path.get())) / frameCount;
+            result["milliseconds"] = getStats(seconds);
+            result["fps"] = median > 0.0 ? frameCount / median : 0.0;
+            result["megapixelsPerSecond"] = median > 0.0 ?
+                frameCount * size.w * size.h / median / 1000000.0 :
+                0.0;
+            _result(name, result);
+        }
+    }
+}
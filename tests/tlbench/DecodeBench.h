@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include "IBench.h"
+
+namespace tl
+{
+    namespace bench
+    {
+        //! Decoding throughput of each plugin, with each of the compression
+        //! types or codecs it writes.
+        class DecodeBench : public IBench
+        {
+        protected:
+            DecodeBench(const std::shared_ptr<ftk::Context>&, const Settings&);
+
+        public:
+            static std::shared_ptr<DecodeBench> create(
+                const std::shared_ptr<ftk::Context>&,
+                const Settings&);
+
+            void run() override;
+
+        private:
+            void _still(
+                const std::string& name,
+                const std::string& ext,
+                ftk::ImageType,
+                const IOOptions& = IOOptions());
+            void _movie(
+                const std::string& name,
+                const std::string& ext,
+                const IOOptions&);
+        };
+    }
+}
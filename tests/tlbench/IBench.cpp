@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include "IBench.h"
+
+#include <tlRender/Timeline/PixelPrivate.h>
+
+#include <tlRender/IO/System.h>
+
+#include <ftk/Core/Format.h>
+#include <ftk/Core/LogSystem.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+
+namespace tl
+{
+    namespace bench
+    {
+        nlohmann::json getStats(std::vector<double> values)
+        {
+            nlohmann::json out;
+            out["count"] = values.size();
+            if (!values.empty())
+            {
+                std::sort(values.begin(), values.end());
+                const auto ms = [](double value) { return value * 1000.0; };
+                const auto percentile = [&values](double value)
+                {
+                    const size_t i = static_cast<size_t>(
+                        std::ceil(value * values.size())) - 1;
+                    return values[std::min(i, values.size() - 1)];
+                };
+                out["min"] = ms(values.front());
+                out["max"] = ms(values.back());
+                out["mean"] = ms(
+                    std::accumulate(values.begin(), values.end(), 0.0) /
+                    values.size());
+                out["median"] = ms(percentile(.5));
+                out["p95"] = ms(percentile(.95));
+            }
+            return out;
+        }
+
+        double getMedian(std::vector<double> values)
+        {
+            std::sort(values.begin(), values.end());
+            return !values.empty() ? values[values.size() / 2] : 0.0;
+        }
+
+        nlohmann::json getImageJSON(const ftk::ImageInfo& info)
+        {
+            std::stringstream ss;
+            ss << info.type;
+            nlohmann::json out;
+            out["width"] = info.size.w;
+            out["height"] = info.size.h;
+            out["type"] = ss.str();
+            return out;
+        }
+
+        IBench::IBench(
+            const std::shared_ptr<ftk::Context>& context,
+            const std::string& name,
+            const Settings& settings) :
+            _context(context),
+            _settings(settings),
+            _name(name),
+            _results(nlohmann::json::object())
+        {}
+
+        IBench::~IBench()
+        {}
+
+        const std::string& IBench::getName() const
+        {
+            return _name;
+        }
+
+        const nlohmann::json& IBench::getResults() const
+        {
+            return _results;
+        }
+
+        std::filesystem::path IBench::_getTempDir() const
+        {
+            std::string dirName = _name;
+            std::replace(dirName.begin(), dirName.end(), ':', '_');
+            const std::filesystem::path out = _settings.tempDir / dirName;
+            std::filesystem::create_directories(out);
+            return out;
+        }
+
+        std::shared_ptr<ftk::Image> IBench::_createImage(
+            const ftk::ImageInfo& info,
+            int seed)
+        {
+            auto out = ftk::Image::create(info);
+            int channels = 0;
+            pixel::Component component = pixel::Component::U8;
+            const int w = info.size.w;
+            const int h = info.size.h;
+            if (!pixel::getLayout(info.type, channels, component) || w <= 0 || h <= 0)
+            {
+                out->zero();
+                return out;
+            }
+            // Rows may be padded out to the alignment.
+            const size_t stride = out->getByteCount() / h;
+            const size_t pixelSize = channels * pixel::getSize(component);
+            uint32_t random = 2166136261U ^ static_cast<uint32_t>(seed);
+            float rgba[4];
+            for (int y = 0; y < h; ++y)
+            {
+                uint8_t* p = out->getData() + y * stride;
+                for (int x = 0; x < w; ++x)
+                {
+                    // A little noise on a smooth picture, which is what
+                    // footage looks like to an encoder.
+                    random = random * 1664525U + 1013904223U;
+                    const float noise = (random >> 24) / 255.F * .05F;
+                    const float u = x / static_cast<float>(w);
+                    const float v = y / static_cast<float>(h);
+                    const float phase = seed * .37F;
+                    rgba[0] = .5F + .4F * std::sin(6.F * u + phase) + noise;
+                    rgba[1] = .5F + .4F * std::sin(5.F * v + phase * 2.F) + noise;
+                    rgba[2] = .5F + .4F * std::sin(4.F * (u + v) + phase * 3.F) + noise;
+                    rgba[3] = 1.F;
+                    pixel::writePixel(rgba, channels, component, p + x * pixelSize);
+                }
+            }
+            return out;
+        }
+
+        ftk::Path IBench::_writeSeq(
+            const ftk::Path& path,
+            const ftk::ImageInfo& info,
+            size_t frameCount,
+            const IOOptions& options)
+        {
+            auto writeSystem = _context->getSystem<WriteSystem>();
+            IOInfo writeInfo;
+            writeInfo.video.push_back(info);
+            {
+                auto write = writeSystem->write(path, writeInfo, options);
+                if (!write)
+                {
+                    throw std::runtime_error(
+                        ftk::Format("Cannot write: \"{0}\"").arg(path.get()));
+                }
+                for (size_t i = 0; i < frameCount; ++i)
+                {
+                    write->writeVideo(
+                        OTIO_NS::RationalTime(static_cast<double>(1 + i), 24.0),
+                        _createImage(info, static_cast<int>(i)));
+                }
+            }
+            ftk::Path out(path);
+            out.setFrames(ftk::RangeI64(1, static_cast<int64_t>(frameCount)));
+            return out;
+        }
+
+        std::vector<double> IBench::_time(const std::function<void()>& value)
+        {
+            std::vector<double> out;
+            for (size_t i = 0; i < _settings.iterations; ++i)
+            {
+                const auto t0 = std::chrono::steady_clock::now();
+                value();
+                const auto t1 = std::chrono::steady_clock::now();
+                const std::chrono::duration<double> diff = t1 - t0;
+                out.push_back(diff.count());
+            }
+            return out;
+        }
+
+        void IBench::_result(const std::string& name, const nlohmann::json& value)
+        {
+            _results[name] = value;
+        }
+
+        void IBench::_print(const std::string& value)
+        {
+            _context->getLogSystem()->print(_name, value);
+        }
+    }
+}
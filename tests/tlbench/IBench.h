@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include <tlRender/IO/IO.h>
+
+#include <ftk/Core/Context.h>
+#include <ftk/Core/Image.h>
+#include <ftk/Core/Path.h>
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <functional>
+
+namespace tl
+{
+    namespace bench
+    {
+        //! Benchmark settings.
+        struct Settings
+        {
+            //! Small media and one iteration, to check that the benchmarks
+            //! run rather than to measure them.
+            bool quick = false;
+
+            //! Number of times each measurement is repeated.
+            size_t iterations = 5;
+
+            //! Directory the media is generated in.
+            std::filesystem::path tempDir;
+        };
+
+        //! Get statistics for a list of durations in seconds. The values
+        //! are in milliseconds.
+        nlohmann::json getStats(std::vector<double>);
+
+        //! Get the median of a list of durations in seconds.
+        double getMedian(std::vector<double>);
+
+        //! Get the size and type of an image.
+        nlohmann::json getImageJSON(const ftk::ImageInfo&);
+
+        //! Base class for benchmarks.
+        //!
+        //! A benchmark generates its own media, so that nothing has to be
+        //! downloaded and the numbers from two machines, or two commits,
+        //! measure the same work.
+        class IBench : public std::enable_shared_from_this<IBench>
+        {
+            FTK_NON_COPYABLE(IBench);
+
+        protected:
+            IBench(
+                const std::shared_ptr<ftk::Context>&,
+                const std::string& name,
+                const Settings&);
+
+        public:
+            virtual ~IBench() = 0;
+
+            //! Get the benchmark name.
+            const std::string& getName() const;
+
+            //! Run the benchmark.
+            virtual void run() = 0;
+
+            //! Get the results, by measurement name.
+            const nlohmann::json& getResults() const;
+
+        protected:
+            //! Get a directory of its own for the media.
+            std::filesystem::path _getTempDir() const;
+
+            //! Create an image with a gradient and some noise, so that it
+            //! compresses like a picture rather than like a flat color.
+            //! Images with different seeds differ everywhere.
+            static std::shared_ptr<ftk::Image> _createImage(
+                const ftk::ImageInfo&,
+                int seed);
+
+            //! Write a sequence starting at frame one, each frame a different
+            //! image, and return the path with its frames set.
+            ftk::Path _writeSeq(
+                const ftk::Path&,
+                const ftk::ImageInfo&,
+                size_t frameCount,
+                const IOOptions& = IOOptions());
+
+            //! Time a function over the iterations, returning the seconds
+            //! each call took.
+            std::vector<double> _time(const std::function<void()>&);
+
+            //! Add a result.
+            void _result(const std::string& name, const nlohmann::json&);
+
+            //! Print a progress message.
+            void _print(const std::string&);
+
+            std::shared_ptr<ftk::Context> _context;
+            Settings _settings;
+
+        private:
+            std::string _name;
+            nlohmann::json _results;
+        };
+    }
+}
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include "PlayerBench.h"
+
+#include <tlRender/Timeline/FrameCache.h>
+#include <tlRender/Timeline/Player.h>
+
+#include <tlRender/IO/System.h>
+
+#include <ftk/Core/Format.h>
+#include <ftk/Core/Memory.h>
+#include <ftk/Core/Time.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace tl
+{
+    namespace bench
+    {
+        PlayerBench::PlayerBench(
+            const std::shared_ptr<ftk::Context>& context,
+            const Settings& settings) :
+            IBench(context, "bench::PlayerBench", settings)
+        {}
+
+        std::shared_ptr<PlayerBench> PlayerBench::create(
+            const std::shared_ptr<ftk::Context>& context,
+            const Settings& settings)
+        {
+            return std::shared_ptr<PlayerBench>(new PlayerBench(context, settings));
+        }
+
+        void PlayerBench::run()
+        {
+            auto writeSystem = _context->getSystem<WriteSystem>();
+            const ftk::Path path(
+                (_getTempDir() / "PlayerBench.0001.png").u8string());
+            auto writePlugin = writeSystem->getPlugin(path);
+            if (!writePlugin)
+            {
+                return;
+            }
+            const ftk::Size2I size = _settings.quick ?
+                ftk::Size2I(320, 180) :
+                ftk::Size2I(1920, 1080);
+            const size_t frameCount = _settings.quick ? 24 : 120;
+            const ftk::ImageInfo info = writePlugin->getInfo(
+                ftk::ImageInfo(size, ftk::ImageType::RGB_U8));
+            _print(ftk::Format("Writing {0} frames").arg(frameCount));
+            const ftk::Path seqPath = _writeSeq(path, info, frameCount);
+
+            // Room for every frame, and nothing behind the start, so the
+            // cache is full when it holds the whole sequence.
+            PlayerOptions playerOptions;
+            playerOptions.cache.videoGB = std::max(
+                .1F,
+                2.F * info.getByteCount() * frameCount / ftk::gigabyte);
+            playerOptions.cache.readBehind = 0.F;
+            playerOptions.videoRequestMax = std::max(
+                playerOptions.videoRequestMax,
+                getDefaultReadThreadCount());
+
+            auto frameCache = _context->getSystem<FrameCache>();
+            std::vector<double> seconds;
+            nlohmann::json samples = nlohmann::json::array();
+            for (size_t i = 0; i < _settings.iterations; ++i)
+            {
+                _print(ftk::Format("Filling the cache: {0}").arg(i));
+                frameCache->clear();
+                auto timeline = Timeline::create(_context, seqPath);
+
+                // The cache information is published periodically rather
+                // than on every frame, so the time it shows the cache full
+                // is late by up to that period. The samples are there to
+                // see the rate while it fills.
+                const auto t0 = std::chrono::steady_clock::now();
+                auto player = Player::create(_context, timeline, playerOptions);
+                size_t cachedFrames = 0;
+                double filled = 0.0;
+                nlohmann::json iterationSamples = nlohmann::json::array();
+                auto cacheInfoObserver = ftk::Observer<PlayerCacheInfo>::create(
+                    player->observeCacheInfo(),
+                    [t0, frameCount, &cachedFrames, &filled, &iterationSamples](const PlayerCacheInfo& value)
+                    {
+                        const std::chrono::duration<double> elapsed =
+                            std::chrono::steady_clock::now() - t0;
+                        size_t frames = 0;
+                        for (const auto& range : value.video)
+                        {
+                            frames += static_cast<size_t>(range.duration().value());
+                        }
+                        if (frames != cachedFrames)
+                        {
+                            cachedFrames = frames;
+                            iterationSamples.push_back({ elapsed.count(), frames });
+                            if (frames >= frameCount)
+                            {
+                                filled = elapsed.count();
+                            }
+                        }
+                    });
+                const std::chrono::duration<double> timeout(60.0);
+                while (cachedFrames < frameCount &&
+                    std::chrono::steady_clock::now() - t0 < timeout)
+                {
+                    _context->tick();
+                    ftk::sleep(std::chrono::milliseconds(5));
+                }
+                if (cachedFrames < frameCount)
+                {
+                    throw std::runtime_error(
+                        ftk::Format("The cache did not fill: {0} of {1} frames").
+                        arg(cachedFrames).arg(frameCount));
+                }
+                seconds.push_back(filled);
+                samples.push_back(iterationSamples);
+            }
+
+            const double median = getMedian(seconds);
+            nlohmann::json result;
+            result["image"] = getImageJSON(info);
+            result["frames"] = frameCount;
+            result["milliseconds"] = getStats(seconds);
+            result["fps"] = median > 0.0 ? frameCount / median : 0.0;
+            result["samples"] = samples;
+            _result("CacheFill", result);
+        }
+    }
+}
@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include "IBench.h"
+
+namespace tl
+{
+    namespace bench
+    {
+        //! How fast a player fills its cache.
+        class PlayerBench : public IBench
+        {
+        protected:
+            PlayerBench(const std::shared_ptr<ftk::Context>&, const Settings&);
+
+        public:
+            static std::shared_ptr<PlayerBench> create(
+                const std::shared_ptr<ftk::Context>&,
+                const Settings&);
+
+            void run() override;
+        };
+    }
+}
@@ -0,0 +1,142 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include "SeqDecodeBench.h"
+
+#include <tlRender/Timeline/FrameCache.h>
+#include <tlRender/Timeline/Timeline.h>
+
+#include <tlRender/IO/System.h>
+#if defined(TLRENDER_EXR)
+#include <tlRender/IO/EXR.h>
+#endif // TLRENDER_EXR
+
+#include <ftk/Core/Format.h>
+
+#include <chrono>
+
+namespace tl
+{
+    namespace bench
+    {
+        SeqDecodeBench::SeqDecodeBench(
+            const std::shared_ptr<ftk::Context>& context,
+            const Settings& settings) :
+            IBench(context, "bench::SeqDecodeBench", settings)
+        {}
+
+        std::shared_ptr<SeqDecodeBench> SeqDecodeBench::create(
+            const std::shared_ptr<ftk::Context>& context,
+            const Settings& settings)
+        {
+            return std::shared_ptr<SeqDecodeBench>(new SeqDecodeBench(context, settings));
+        }
+
+        void SeqDecodeBench::run()
+        {
+            _scaling("PNG", ".png", ftk::ImageType::RGB_U8);
+#if defined(TLRENDER_EXR)
+            IOOptions options;
+            options["OpenEXR/Compression"] = exr::to_string(exr::Compression::ZIP);
+            _scaling("OpenEXR", ".exr", ftk::ImageType::RGBA_F16, options);
+#endif // TLRENDER_EXR
+        }
+
+        void SeqDecodeBench::_scaling(
+            const std::string& name,
+            const std::string& ext,
+            ftk::ImageType type,
+            const IOOptions& options)
+        {
+            auto writeSystem = _context->getSystem<WriteSystem>();
+            const ftk::Path path(
+                (_getTempDir() / ("SeqDecodeBench_" + name + ".0001" + ext)).u8string());
+            auto writePlugin = writeSystem->getPlugin(path);
+            if (!writePlugin)
+            {
+                return;
+            }
+            const ftk::Size2I size = _settings.quick ?
+                ftk::Size2I(320, 180) :
+                ftk::Size2I(1920, 1080);
+            const size_t frameCount = _settings.quick ? 12 : 96;
+            const ftk::ImageInfo info = writePlugin->getInfo(
+                ftk::ImageInfo(size, type),
+                options);
+            if (!info.isValid())
+            {
+                return;
+            }
+            _print(ftk::Format("{0}: writing {1} frames").arg(name).arg(frameCount));
+            const ftk::Path seqPath = _writeSeq(path, info, frameCount, options);
+
+            // Doubling up to the number of hardware threads, and the number
+            // itself when it is not a power of two.
+            std::vector<size_t> threadCounts;
+            const size_t hardwareThreads = getDefaultReadThreadCount();
+            for (size_t i = 1; i < hardwareThreads; i *= 2)
+            {
+                threadCounts.push_back(i);
+            }
+            threadCounts.push_back(hardwareThreads);
+
+            auto frameCache = _context->getSystem<FrameCache>();
+            nlohmann::json results = nlohmann::json::array();
+            double baseline = 0.0;
+            for (const size_t threadCount : threadCounts)
+            {
+                _print(ftk::Format("{0}: {1} read threads").arg(name).arg(threadCount));
+                Options timelineOptions;
+                timelineOptions.readThreadCount = threadCount;
+                std::vector<double> seconds;
+                for (size_t i = 0; i < _settings.iterations; ++i)
+                {
+                    // Frames decoded by the iteration before would otherwise
+                    // come back from the cache.
+                    frameCache->clear();
+                    auto timeline = Timeline::create(_context, seqPath, timelineOptions);
+                    const OTIO_NS::TimeRange& timeRange = timeline->getTimeRange();
+
+                    // Every frame asked for at once, which is what filling
+                    // the player's cache does.
+                    const auto t0 = std::chrono::steady_clock::now();
+                    const double rate = timeRange.duration().rate();
+                    std::vector<VideoRequest> requests;
+                    for (int64_t frame = 0; frame < timeRange.duration().value(); ++frame)
+                    {
+                        requests.push_back(timeline->getVideo(
+                            timeRange.start_time() +
+                            OTIO_NS::RationalTime(static_cast<double>(frame), rate)));
+                    }
+                    for (auto& request : requests)
+                    {
+                        request.future.get();
+                    }
+                    const auto t1 = std::chrono::steady_clock::now();
+                    const std::chrono::duration<double> diff = t1 - t0;
+                    seconds.push_back(diff.count());
+                }
+
+                const double median = getMedian(seconds);
+                const double fps = median > 0.0 ? frameCount / median : 0.0;
+                if (1 == threadCount)
+                {
+                    baseline = fps;
+                }
+                nlohmann::json result;
+                result["readThreadCount"] = threadCount;
+                result["milliseconds"] = getStats(seconds);
+                result["fps"] = fps;
+                result["speedup"] = baseline > 0.0 ? fps / baseline : 0.0;
+                results.push_back(result);
+            }
+
+            nlohmann::json result;
+            result["options"] = options;
+            result["image"] = getImageJSON(info);
+            result["frames"] = frameCount;
+            result["threads"] = results;
+            _result(name, result);
+        }
+    }
+}
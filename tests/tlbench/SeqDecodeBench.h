@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include "IBench.h"
+
+namespace tl
+{
+    namespace bench
+    {
+        //! How decoding an image sequence through a timeline scales with
+        //! the number of read threads.
+        class SeqDecodeBench : public IBench
+        {
+        protected:
+            SeqDecodeBench(const std::shared_ptr<ftk::Context>&, const Settings&);
+
+        public:
+            static std::shared_ptr<SeqDecodeBench> create(
+                const std::shared_ptr<ftk::Context>&,
+                const Settings&);
+
+            void run() override;
+
+        private:
+            void _scaling(
+                const std::string& name,
+                const std::string& ext,
+                ftk::ImageType,
+                const IOOptions& = IOOptions());
+        };
+    }
+}
@@ -0,0 +1,158 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include "TimelineBench.h"
+
+#include <tlRender/Timeline/Timeline.h>
+
+#include <tlRender/IO/System.h>
+
+#include <ftk/Core/Format.h>
+
+#include <opentimelineio/clip.h>
+#include <opentimelineio/imageSequenceReference.h>
+#include <opentimelineio/timeline.h>
+#include <opentimelineio/track.h>
+
+#include <chrono>
+
+namespace tl
+{
+    namespace bench
+    {
+        namespace
+        {
+            // The clips all take their frames from one short sequence, which
+            // is small so that decoding it is not what is measured.
+            const std::string mediaBase = "TimelineBench.";
+            const std::string mediaExt = ".png";
+            const int64_t mediaFrames = 24;
+            const int64_t clipFrames = 2;
+            const double rate = 24.0;
+        }
+
+        TimelineBench::TimelineBench(
+            const std::shared_ptr<ftk::Context>& context,
+            const Settings& settings) :
+            IBench(context, "bench::TimelineBench", settings)
+        {}
+
+        std::shared_ptr<TimelineBench> TimelineBench::create(
+            const std::shared_ptr<ftk::Context>& context,
+            const Settings& settings)
+        {
+            return std::shared_ptr<TimelineBench>(new TimelineBench(context, settings));
+        }
+
+        void TimelineBench::run()
+        {
+            auto writeSystem = _context->getSystem<WriteSystem>();
+            const ftk::Path path(
+                (_getTempDir() / (mediaBase + "0001" + mediaExt)).u8string());
+            auto writePlugin = writeSystem->getPlugin(path);
+            if (!writePlugin)
+            {
+                return;
+            }
+            _writeSeq(
+                path,
+                writePlugin->getInfo(ftk::ImageInfo(
+                    ftk::Size2I(64, 36),
+                    ftk::ImageType::RGB_U8)),
+                mediaFrames);
+
+            for (const size_t clipCount : _settings.quick ?
+                std::vector<size_t>({ 1000 }) :
+                std::vector<size_t>({ 1000, 100000 }))
+            {
+                _latency(clipCount);
+            }
+        }
+
+        void TimelineBench::_latency(size_t clipCount)
+        {
+            // One track of back to back clips, each a different part of the
+            // sequence, written out and read back so that opening it is the
+            // same work as opening a file from an editorial system.
+            _print(ftk::Format("{0} clips: writing").arg(clipCount));
+            const std::string fileName = (_getTempDir() /
+                ftk::Format("TimelineBench_{0}.otio").arg(clipCount).str()).u8string();
+            {
+                OTIO_NS::SerializableObject::Retainer<OTIO_NS::Timeline> otioTimeline(
+                    new OTIO_NS::Timeline("TimelineBench"));
+                auto otioTrack = new OTIO_NS::Track(
+                    "Video", std::nullopt, OTIO_NS::Track::Kind::video);
+                otioTimeline->tracks()->append_child(otioTrack);
+                for (size_t i = 0; i < clipCount; ++i)
+                {
+                    auto mediaReference = new OTIO_NS::ImageSequenceReference(
+                        "",
+                        mediaBase,
+                        mediaExt,
+                        1,
+                        1,
+                        rate,
+                        4);
+                    mediaReference->set_available_range(OTIO_NS::TimeRange(
+                        OTIO_NS::RationalTime(1.0, rate),
+                        OTIO_NS::RationalTime(static_cast<double>(mediaFrames), rate)));
+                    auto otioClip = new OTIO_NS::Clip;
+                    otioClip->set_media_reference(mediaReference);
+                    const int64_t start = 1 + static_cast<int64_t>(i) %
+                        (mediaFrames - clipFrames + 1);
+                    otioClip->set_source_range(OTIO_NS::TimeRange(
+                        OTIO_NS::RationalTime(static_cast<double>(start), rate),
+                        OTIO_NS::RationalTime(static_cast<double>(clipFrames), rate)));
+                    otioTrack->append_child(otioClip);
+                }
+                OTIO_NS::ErrorStatus errorStatus;
+                if (!otioTimeline->to_json_file(fileName, &errorStatus))
+                {
+                    throw std::runtime_error(
+                        ftk::Format("Cannot write: \"{0}\"").arg(fileName));
+                }
+            }
+
+            _print(ftk::Format("{0} clips: opening").arg(clipCount));
+            std::shared_ptr<Timeline> timeline;
+            const auto openSeconds = _time(
+                [this, &timeline, &fileName]
+                {
+                    timeline.reset();
+                    timeline = Timeline::create(_context, ftk::Path(fileName));
+                });
+
+            // Times spread over the whole timeline in an order that jumps
+            // about, one request at a time, so each is the latency of a seek
+            // rather than a share of a batch. The media repeats, so after
+            // the first few reads the frames come from the cache and this is
+            // the cost of finding them in the timeline.
+            _print(ftk::Format("{0} clips: getting video").arg(clipCount));
+            const OTIO_NS::TimeRange& timeRange = timeline->getTimeRange();
+            const int64_t duration = static_cast<int64_t>(timeRange.duration().value());
+            const size_t requestCount = _settings.quick ? 100 : 1000;
+            std::vector<double> seconds;
+            for (size_t i = 0; i < requestCount; ++i)
+            {
+                const int64_t frame = static_cast<int64_t>(i * 7919) % duration;
+                const auto t0 = std::chrono::steady_clock::now();
+                auto request = timeline->getVideo(
+                    timeRange.start_time() +
+                    OTIO_NS::RationalTime(static_cast<double>(frame), rate));
+                request.future.get();
+                const auto t1 = std::chrono::steady_clock::now();
+                const std::chrono::duration<double> diff = t1 - t0;
+                seconds.push_back(diff.count());
+            }
+
+            nlohmann::json result;
+            result["clips"] = clipCount;
+            result["frames"] = duration;
+            result["fileBytes"] = std::filesystem::file_size(
+                std::filesystem::u8path(fileName));
+            result["openMilliseconds"] = getStats(openSeconds);
+            result["getVideoMilliseconds"] = getStats(seconds);
+            _result(ftk::Format("{0}Clips").arg(clipCount), result);
+        }
+    }
+}
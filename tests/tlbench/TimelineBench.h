@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#pragma once
+
+#include "IBench.h"
+
+namespace tl
+{
+    namespace bench
+    {
+        //! How long opening a timeline and getting a frame from it take, for
+        //! timelines with many clips.
+        class TimelineBench : public IBench
+        {
+        protected:
+            TimelineBench(const std::shared_ptr<ftk::Context>&, const Settings&);
+
+        public:
+            static std::shared_ptr<TimelineBench> create(
+                const std::shared_ptr<ftk::Context>&,
+                const Settings&);
+
+            void run() override;
+
+        private:
+            void _latency(size_t clipCount);
+        };
+    }
+}
@@ -0,0 +1,287 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the tlRender project.
+
+#include "tlbench.h"
+
+#include "AudioBench.h"
+#include "DecodeBench.h"
+#include "PlayerBench.h"
+#include "SeqDecodeBench.h"
+#include "TimelineBench.h"
+
+#include <tlRender/Timeline/FrameCache.h>
+#include <tlRender/Timeline/Init.h>
+#include <tlRender/Timeline/PlayerOptions.h>
+
+#include <tlRender/Core/Version.h>
+
+#include <ftk/Core/CmdLine.h>
+#include <ftk/Core/Context.h>
+#include <ftk/Core/Format.h>
+#include <ftk/Core/Memory.h>
+#include <ftk/Core/String.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+namespace tl
+{
+    namespace bench
+    {
+        namespace
+        {
+            //! Get the headline number of a result, for the console. The
+            //! JSON has the rest.
+            std::string getSummary(const nlohmann::json& value)
+            {
+                std::string out;
+                if (value.contains("fps"))
+                {
+                    out = ftk::Format("{0} fps").arg(value["fps"].get<double>(), 2);
+                }
+                else if (value.contains("realTime"))
+                {
+                    out = ftk::Format("{0}x real time").arg(value["realTime"].get<double>(), 2);
+                }
+                else if (value.contains("getVideoMilliseconds"))
+                {
+                    out = ftk::Format("open {0}ms, getVideo {1}ms median, {2}ms p95").
+                        arg(value["openMilliseconds"]["median"].get<double>(), 2).
+                        arg(value["getVideoMilliseconds"]["median"].get<double>(), 3).
+                        arg(value["getVideoMilliseconds"]["p95"].get<double>(), 3);
+                }
+                else if (value.contains("threads"))
+                {
+                    std::vector<std::string> list;
+                    for (const auto& i : value["threads"])
+                    {
+                        list.push_back(ftk::Format("{0}: {1} fps").
+                            arg(i["readThreadCount"].get<size_t>()).
+                            arg(i["fps"].get<double>(), 2));
+                    }
+                    out = ftk::join(list, ", ");
+                }
+                return out;
+            }
+        }
+
+        struct App::Private
+        {
+            std::shared_ptr<ftk::CmdLineListArg<std::string> > benchNames;
+            std::shared_ptr<ftk::CmdLineOption<std::string> > json;
+            std::shared_ptr<ftk::CmdLineOption<int> > iterations;
+            std::shared_ptr<ftk::CmdLineFlag> quick;
+            Settings settings;
+            std::vector<std::shared_ptr<IBench> > benches;
+            std::chrono::steady_clock::time_point startTime;
+        };
+
+        void App::_init(
+            const std::shared_ptr<ftk::Context>& context,
+            std::vector<std::string>& argv)
+        {
+            FTK_P();
+            p.benchNames = ftk::CmdLineListArg<std::string>::create(
+                "Benchmark",
+                "Names of the benchmarks to run.",
+                true);
+            p.json = ftk::CmdLineOption<std::string>::create(
+                { "-json" },
+                "Write the results to a JSON file, for comparing one run with "
+                "another.",
+                "Output");
+            p.iterations = ftk::CmdLineOption<int>::create(
+                { "-iterations", "-i" },
+                ftk::Format("Number of times each measurement is repeated. The "
+                    "default is {0}, or one with -quick.").arg(Settings().iterations),
+                "Run");
+            p.quick = ftk::CmdLineFlag::create(
+                { "-quick" },
+                "Use small media and run each measurement once. This checks "
+                "that the benchmarks work rather than measuring anything.",
+                "Run");
+            IApp::_init(
+                context,
+                argv,
+                "tlbench",
+                "Benchmark application",
+                { p.benchNames },
+                { p.json, p.iterations, p.quick });
+            p.startTime = std::chrono::steady_clock::now();
+
+            // No OpenGL: what is measured is reading and assembling frames,
+            // which is the same with or without a display.
+            tl::init(context);
+
+            // The frame cache is sized the way tlplay sizes it, so that what
+            // is measured is what playback sees.
+            if (auto frameCache = context->getSystem<FrameCache>())
+            {
+                frameCache->setMax(PlayerCacheOptions().videoGB * ftk::gigabyte);
+            }
+
+            p.settings.quick = p.quick->found();
+            if (p.iterations->hasValue())
+            {
+                p.settings.iterations = static_cast<size_t>(
+                    std::max(1, p.iterations->getValue()));
+            }
+            else if (p.settings.quick)
+            {
+                p.settings.iterations = 1;
+            }
+            // A directory of its own, so that two runs at once do not write
+            // over each other's media.
+            p.settings.tempDir =
+                std::filesystem::temp_directory_path() /
+                ("tlbench_" + std::to_string(
+                    std::chrono::system_clock::now().time_since_epoch().count()));
+
+            p.benches.push_back(AudioBench::create(context, p.settings));
+            p.benches.push_back(DecodeBench::create(context, p.settings));
+            p.benches.push_back(PlayerBench::create(context, p.settings));
+            p.benches.push_back(SeqDecodeBench::create(context, p.settings));
+            p.benches.push_back(TimelineBench::create(context, p.settings));
+        }
+
+        App::App() :
+            _p(new Private)
+        {}
+
+        App::~App()
+        {
+            FTK_P();
+            std::error_code ec;
+            std::filesystem::remove_all(p.settings.tempDir, ec);
+        }
+
+        std::shared_ptr<App> App::create(
+            const std::shared_ptr<ftk::Context>& context,
+            std::vector<std::string>& argv)
+        {
+            auto out = std::shared_ptr<App>(new App);
+            out->_init(context, argv);
+            return out;
+        }
+
+        int App::run()
+        {
+            FTK_P();
+
+            // Get the benchmarks to run, matched the way tl-test matches
+            // test names.
+            std::vector<std::shared_ptr<IBench> > runBenches;
+            std::vector<std::string> unmatched;
+            const auto& cmdLineBenches = p.benchNames->getList();
+            if (!cmdLineBenches.empty())
+            {
+                for (const auto& bench : cmdLineBenches)
+                {
+                    size_t matched = 0;
+                    for (const auto& other : p.benches)
+                    {
+                        if (ftk::contains(other->getName(), bench, ftk::CaseCompare::Insensitive))
+                        {
+                            ++matched;
+                            if (std::find(runBenches.begin(), runBenches.end(), other) ==
+                                runBenches.end())
+                            {
+                                runBenches.push_back(other);
+                            }
+                        }
+                    }
+                    if (0 == matched)
+                    {
+                        unmatched.push_back(bench);
+                    }
+                }
+            }
+            else
+            {
+                runBenches = p.benches;
+            }
+            if (!unmatched.empty())
+            {
+                for (const auto& name : unmatched)
+                {
+                    _print(ftk::Format("ERROR: no benchmarks match: {0}").arg(name));
+                }
+                return 1;
+            }
+
+            // Run the benchmarks. One that fails is reported and the rest
+            // still run, so a broken plugin does not cost the whole run.
+            nlohmann::json benchmarks = nlohmann::json::object();
+            size_t failureCount = 0;
+            for (const auto& bench : runBenches)
+            {
+                _context->tick();
+                _print(ftk::Format("Running benchmark: {0}").arg(bench->getName()));
+                try
+                {
+                    bench->run();
+                }
+                catch (const std::exception& e)
+                {
+                    _print(ftk::Format("ERROR: {0}: {1}").arg(bench->getName()).arg(e.what()));
+                    ++failureCount;
+                }
+                const auto& results = bench->getResults();
+                for (auto i = results.begin(); i != results.end(); ++i)
+                {
+                    _print(ftk::Format("    {0}: {1}").arg(i.key()).arg(getSummary(i.value())));
+                }
+                benchmarks[bench->getName()] = results;
+            }
+
+            // What the numbers were measured on, so that results from
+            // different machines are not compared by accident.
+            if (p.json->hasValue())
+            {
+                nlohmann::json json;
+                json["version"] = TLRENDER_VERSION_FULL;
+                json["hardwareThreads"] = std::thread::hardware_concurrency();
+                json["quick"] = p.settings.quick;
+                json["iterations"] = p.settings.iterations;
+                json["benchmarks"] = benchmarks;
+                const std::string fileName = p.json->getValue();
+                std::ofstream file(fileName);
+                file << json.dump(4);
+                if (!file)
+                {
+                    _print(ftk::Format("ERROR: Cannot write: \"{0}\"").arg(fileName));
+                    return 1;
+                }
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            const std::chrono::duration<float> diff = now - p.startTime;
+            _print(ftk::Format("Seconds elapsed: {0}").arg(diff.count(), 2));
+            _print(ftk::Format("Benchmarks run: {0}").arg(runBenches.size()));
+            _print(ftk::Format("Failures: {0}").arg(failureCount));
+            return failureCount > 0 ? 1 : 0;
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        auto context = ftk::Context::create();
+        auto args = ftk::convert(argc, argv);
+        auto app = tl::bench::App::create(context, args);
+        if (app->hasCmdLineHelp())
+            return 0;
+        return app->run();
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}